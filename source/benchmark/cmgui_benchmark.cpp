@@ -0,0 +1,633 @@
+/**
+ * FILE : cmgui_benchmark.cpp
+ *
+ * Runs cmgui without a display on generated structured hexahedral meshes and
+ * writes the time taken by each phase of a canonical command sequence to a
+ * JSON file with details of the machine, so results can be compared between
+ * builds. For each mesh size a command file is written which reads the nodes
+ * and elements, defines derived fields, makes surface and iso-surface
+ * graphics, evaluates a field, writes the model and reads a time series of
+ * node files, optionally followed by an offscreen print. The graphics phases
+ * export the scene to STL so the graphics are built without a display; the
+ * iso-surface export also writes the surfaces again. After each phase the
+ * command file lists 'gfx timing' to a file, and the wall, parse and CPU
+ * seconds and heap growth of the phase's commands are collected from it.
+ *
+ * The print phase needs a display; run it under a virtual X server such as
+ * xvfb-run. Mesa is asked for its software renderer so results do not depend
+ * on the graphics card.
+ *
+ * Usage: cmgui_benchmark -cmgui CMGUI_EXECUTABLE [-directory WORK_DIRECTORY]
+ *   [-output JSON_FILE] [-elements NUMBER_OF_ELEMENTS]... [-time_steps N]
+ *   [-print] [-label LABEL]
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "configure/cmgui_configure.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+
+#if defined (UNIX)
+#include <errno.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/utsname.h>
+#include <sys/wait.h>
+
+namespace {
+
+const char *benchmark_phase_names[] =
+{
+	"read_nodes",
+	"read_elements",
+	"define_fields",
+	"surfaces",
+	"iso_surfaces",
+	"evaluate",
+	"write",
+	"read_time_series",
+	"print"
+};
+
+const int BENCHMARK_NUMBER_OF_PHASES =
+	sizeof(benchmark_phase_names)/sizeof(benchmark_phase_names[0]);
+
+const int BENCHMARK_PRINT_PHASE = BENCHMARK_NUMBER_OF_PHASES - 1;
+
+struct Benchmark_options
+{
+	const char *cmgui;
+	std::string directory, output, label;
+	std::vector<long> element_counts;
+	int number_of_time_steps;
+	bool print;
+};
+
+struct Benchmark_phase
+{
+	bool run;
+	int number_of_commands;
+	double wall_seconds, parse_seconds, cpu_seconds, heap_kB;
+	bool heap_known;
+};
+
+struct Benchmark_run
+{
+	long number_of_elements, number_of_nodes;
+	int elements_per_side;
+	int exit_status;
+	double generate_seconds, process_seconds, peak_resident_kB;
+	Benchmark_phase phases[sizeof(benchmark_phase_names)/sizeof(benchmark_phase_names[0])];
+};
+
+double benchmark_get_seconds(void)
+{
+	struct timeval time_value;
+	gettimeofday(&time_value, NULL);
+	return (double)time_value.tv_sec + 1.0E-6*(double)time_value.tv_usec;
+}
+
+/** Writes <text> as a JSON string literal to <file>. */
+void benchmark_write_json_string(FILE *file, const char *text)
+{
+	fputc('"', file);
+	for (const char *c = text; *c; ++c)
+	{
+		if (('"' == *c) || ('\\' == *c))
+			fprintf(file, "\\%c", *c);
+		else if ((unsigned char)*c < 0x20)
+			fprintf(file, "\\u%04x", (unsigned int)(unsigned char)*c);
+		else
+			fputc(*c, file);
+	}
+	fputc('"', file);
+}
+
+/** Returns the value of the first "model name" line in /proc/cpuinfo. */
+std::string benchmark_get_cpu_model(void)
+{
+	std::string model;
+	FILE *file = fopen("/proc/cpuinfo", "r");
+	if (file)
+	{
+		char line[512];
+		while (fgets(line, sizeof(line), file))
+		{
+			if (0 == strncmp(line, "model name", 10))
+			{
+				const char *value = strchr(line, ':');
+				if (value)
+				{
+					++value;
+					while (' ' == *value)
+						++value;
+					model = value;
+					while ((!model.empty()) && (('\n' == model[model.size() - 1]) ||
+						(' ' == model[model.size() - 1])))
+					{
+						model.erase(model.size() - 1);
+					}
+				}
+				break;
+			}
+		}
+		fclose(file);
+	}
+	return model;
+}
+
+/**
+ * Writes the nodes of a cube of <n>*<n>*<n> unit elements with coordinates
+ * and a scalar <value> field scaled by <time_scale>.
+ */
+int benchmark_write_nodes(const char *file_name, int n, double time_scale)
+{
+	FILE *file = fopen(file_name, "w");
+	if (!file)
+	{
+		fprintf(stderr, "cmgui_benchmark: Could not open %s for writing\n", file_name);
+		return 0;
+	}
+	fprintf(file,
+		" Group name: bench\n"
+		" #Fields=2\n"
+		" 1) coordinates, coordinate, rectangular cartesian, #Components=3\n"
+		"   x.  Value index= 1, #Derivatives= 0\n"
+		"   y.  Value index= 2, #Derivatives= 0\n"
+		"   z.  Value index= 3, #Derivatives= 0\n"
+		" 2) value, field, rectangular cartesian, #Components=1\n"
+		"   value.  Value index= 4, #Derivatives= 0\n");
+	const double centre = 0.5*(double)n;
+	long identifier = 1;
+	for (int k = 0; k <= n; ++k)
+	{
+		for (int j = 0; j <= n; ++j)
+		{
+			for (int i = 0; i <= n; ++i)
+			{
+				const double x = (double)i - centre, y = (double)j - centre,
+					z = (double)k - centre;
+				fprintf(file, " Node: %ld\n  %g %g %g\n  %g\n", identifier,
+					(double)i, (double)j, (double)k,
+					time_scale*sqrt(x*x + y*y + z*z)/centre);
+				++identifier;
+			}
+		}
+	}
+	if (0 != fclose(file))
+	{
+		fprintf(stderr, "cmgui_benchmark: Error writing %s\n", file_name);
+		return 0;
+	}
+	return 1;
+}
+
+/** Writes trilinear Lagrange hexahedra over the nodes of benchmark_write_nodes. */
+int benchmark_write_elements(const char *file_name, int n)
+{
+	FILE *file = fopen(file_name, "w");
+	if (!file)
+	{
+		fprintf(stderr, "cmgui_benchmark: Could not open %s for writing\n", file_name);
+		return 0;
+	}
+	fprintf(file,
+		" Group name: bench\n"
+		" Shape.  Dimension=3, line*line*line\n"
+		" #Scale factor sets= 0\n"
+		" #Nodes= 8\n"
+		" #Fields=1\n"
+		" 1) coordinates, coordinate, rectangular cartesian, #Components=3\n");
+	const char *component_names[] = { "x", "y", "z" };
+	for (int c = 0; c < 3; ++c)
+	{
+		fprintf(file, "   %s.  l.Lagrange*l.Lagrange*l.Lagrange, no modify, standard node based.\n"
+			"     #Nodes= 8\n", component_names[c]);
+		for (int node = 1; node <= 8; ++node)
+		{
+			fprintf(file, "      %d.  #Values=1\n"
+				"       Value indices:     1\n"
+				"       Scale factor indices:   0\n", node);
+		}
+	}
+	const long row = (long)n + 1, layer = row*row;
+	long identifier = 1;
+	for (int k = 0; k < n; ++k)
+	{
+		for (int j = 0; j < n; ++j)
+		{
+			for (int i = 0; i < n; ++i)
+			{
+				const long base = 1 + i + j*row + k*layer;
+				fprintf(file, " Element: %ld 0 0\n   Nodes:\n"
+					"   %ld %ld %ld %ld %ld %ld %ld %ld\n", identifier,
+					base, base + 1, base + row, base + row + 1,
+					base + layer, base + layer + 1, base + layer + row, base + layer + row + 1);
+				++identifier;
+			}
+		}
+	}
+	if (0 != fclose(file))
+	{
+		fprintf(stderr, "cmgui_benchmark: Error writing %s\n", file_name);
+		return 0;
+	}
+	return 1;
+}
+
+/** Writes the command to list and reset timings for phase <phase>. */
+void benchmark_end_phase(FILE *file, const std::string &directory, int phase)
+{
+	fprintf(file, "gfx timing list reset file \"%s/phase_%s.txt\"\n",
+		directory.c_str(), benchmark_phase_names[phase]);
+}
+
+int benchmark_write_command_file(const char *file_name,
+	const std::string &directory, int n, int number_of_time_steps, bool print)
+{
+	FILE *file = fopen(file_name, "w");
+	if (!file)
+	{
+		fprintf(stderr, "cmgui_benchmark: Could not open %s for writing\n", file_name);
+		return 0;
+	}
+	const char *dir = directory.c_str();
+	fprintf(file, "gfx timing on reset\n");
+	fprintf(file, "gfx read nodes region bench \"%s/bench.exnode\"\n", dir);
+	benchmark_end_phase(file, directory, 0);
+	fprintf(file, "gfx read elements region bench \"%s/bench.exelem\"\n", dir);
+	fprintf(file, "gfx define faces egroup bench\n");
+	benchmark_end_phase(file, directory, 1);
+	fprintf(file, "gfx define field bench/radius magnitude field coordinates\n");
+	fprintf(file, "gfx define field bench/weighted multiply_components fields radius value\n");
+	benchmark_end_phase(file, directory, 2);
+	fprintf(file, "gfx modify g_element bench surfaces coordinate coordinates "
+		"exterior data weighted\n");
+	/* without a display graphics are only built when used, so export them */
+	fprintf(file, "gfx export stl file \"%s/bench_surfaces.stl\"\n", dir);
+	benchmark_end_phase(file, directory, 3);
+	fprintf(file, "gfx modify g_element bench iso_surfaces coordinate coordinates "
+		"iso_scalar radius range_number_of_iso_values 5 first_iso_value %g "
+		"last_iso_value %g\n", 0.1*(double)n, 0.4*(double)n);
+	fprintf(file, "gfx export stl file \"%s/bench_iso_surfaces.stl\"\n", dir);
+	benchmark_end_phase(file, directory, 4);
+	fprintf(file, "gfx evaluate ngroup bench source weighted destination value\n");
+	benchmark_end_phase(file, directory, 5);
+	fprintf(file, "gfx write nodes group bench \"%s/bench_out.exnode\"\n", dir);
+	fprintf(file, "gfx write elements group bench \"%s/bench_out.exelem\"\n", dir);
+	benchmark_end_phase(file, directory, 6);
+	if (0 < number_of_time_steps)
+	{
+		fprintf(file, "gfx read nodes region series \"%s/series_XXXX.exnode\" "
+			"series XXXX 0 %d 1 time_from_index\n", dir, number_of_time_steps - 1);
+		benchmark_end_phase(file, directory, 7);
+	}
+	if (print)
+	{
+		fprintf(file, "gfx create window 1\n");
+		fprintf(file, "gfx print window 1 file \"%s/bench.png\" width 2048 height 2048\n", dir);
+		benchmark_end_phase(file, directory, BENCHMARK_PRINT_PHASE);
+	}
+	fprintf(file, "quit\n");
+	if (0 != fclose(file))
+	{
+		fprintf(stderr, "cmgui_benchmark: Error writing %s\n", file_name);
+		return 0;
+	}
+	return 1;
+}
+
+/**
+ * Reads a listing written by 'gfx timing list' into <phase>, ignoring the
+ * 'gfx timing' commands themselves.
+ */
+int benchmark_read_phase(const std::string &directory, int phase_index,
+	Benchmark_phase &phase)
+{
+	std::string file_name = directory + "/phase_" + benchmark_phase_names[phase_index] + ".txt";
+	FILE *file = fopen(file_name.c_str(), "r");
+	if (!file)
+		return 0;
+	phase.run = true;
+	char line[1024];
+	while (fgets(line, sizeof(line), file))
+	{
+		/* command keys are padded to 32 characters */
+		if ((strlen(line) < 33) || (0 == strncmp(line, "command ", 8)) ||
+			(0 == strncmp(line, "all ", 4)) || (0 == strncmp(line, "gfx timing ", 11)))
+		{
+			continue;
+		}
+		long count;
+		double wall_seconds, parse_seconds, cpu_seconds, mean_ms, maximum_ms;
+		char heap[32];
+		if (7 == sscanf(line + 32, " %ld %lf %lf %lf %lf %lf %31s", &count,
+			&wall_seconds, &parse_seconds, &cpu_seconds, &mean_ms, &maximum_ms, heap))
+		{
+			phase.number_of_commands += (int)count;
+			phase.wall_seconds += wall_seconds;
+			phase.parse_seconds += parse_seconds;
+			phase.cpu_seconds += cpu_seconds;
+			if (0 != strcmp(heap, "-"))
+			{
+				phase.heap_kB += atof(heap);
+				phase.heap_known = true;
+			}
+		}
+	}
+	fclose(file);
+	return 1;
+}
+
+/**
+ * Runs <cmgui> on <command_file>, without a display unless <display>.
+ * @return  Exit status, or -1 if it could not be run.
+ */
+int benchmark_run_cmgui(const char *cmgui, const char *command_file, bool display,
+	double &peak_resident_kB)
+{
+	pid_t pid = fork();
+	if (0 == pid)
+	{
+		if (display)
+		{
+			setenv("LIBGL_ALWAYS_SOFTWARE", "1", 1);
+			execl(cmgui, cmgui, command_file, (char *)NULL);
+		}
+		else
+		{
+			execl(cmgui, cmgui, "-no_display", command_file, (char *)NULL);
+		}
+		fprintf(stderr, "cmgui_benchmark: Could not run %s: %s\n", cmgui, strerror(errno));
+		_exit(127);
+	}
+	if (pid < 0)
+	{
+		fprintf(stderr, "cmgui_benchmark: Could not fork: %s\n", strerror(errno));
+		return -1;
+	}
+	int status = 0;
+	struct rusage usage;
+	if (wait4(pid, &status, 0, &usage) != pid)
+		return -1;
+	peak_resident_kB = (double)usage.ru_maxrss;
+#if defined (__APPLE__)
+	peak_resident_kB /= 1024.0;
+#endif
+	if (WIFEXITED(status))
+		return WEXITSTATUS(status);
+	return -1;
+}
+
+int benchmark_run_model(const Benchmark_options &options, long number_of_elements,
+	Benchmark_run &run)
+{
+	int n = (int)floor(pow((double)number_of_elements, 1.0/3.0) + 0.5);
+	if (n < 1)
+		n = 1;
+	run.elements_per_side = n;
+	run.number_of_elements = (long)n*n*n;
+	run.number_of_nodes = (long)(n + 1)*(n + 1)*(n + 1);
+	run.exit_status = -1;
+	run.generate_seconds = 0.0;
+	run.process_seconds = 0.0;
+	run.peak_resident_kB = 0.0;
+	for (int p = 0; p < BENCHMARK_NUMBER_OF_PHASES; ++p)
+	{
+		Benchmark_phase &phase = run.phases[p];
+		phase.run = false;
+		phase.number_of_commands = 0;
+		phase.wall_seconds = phase.parse_seconds = phase.cpu_seconds = phase.heap_kB = 0.0;
+		phase.heap_known = false;
+	}
+	char size_name[64];
+	sprintf(size_name, "/hex_%ld", run.number_of_elements);
+	const std::string directory = options.directory + size_name;
+	if ((0 != mkdir(directory.c_str(), 0755)) && (EEXIST != errno))
+	{
+		fprintf(stderr, "cmgui_benchmark: Could not create %s\n", directory.c_str());
+		return 0;
+	}
+	for (int p = 0; p < BENCHMARK_NUMBER_OF_PHASES; ++p)
+	{
+		std::string file_name = directory + "/phase_" + benchmark_phase_names[p] + ".txt";
+		remove(file_name.c_str());
+	}
+	const double start_seconds = benchmark_get_seconds();
+	if (!(benchmark_write_nodes((directory + "/bench.exnode").c_str(), n, 1.0) &&
+		benchmark_write_elements((directory + "/bench.exelem").c_str(), n)))
+	{
+		return 0;
+	}
+	for (int t = 0; t < options.number_of_time_steps; ++t)
+	{
+		char series_name[64];
+		sprintf(series_name, "/series_%04d.exnode", t);
+		if (!benchmark_write_nodes((directory + series_name).c_str(), n,
+			1.0 + (double)t/(double)options.number_of_time_steps))
+		{
+			return 0;
+		}
+	}
+	const std::string command_file = directory + "/bench.com";
+	if (!benchmark_write_command_file(command_file.c_str(), directory, n,
+		options.number_of_time_steps, options.print))
+	{
+		return 0;
+	}
+	run.generate_seconds = benchmark_get_seconds() - start_seconds;
+	printf("hex %ld elements: running cmgui\n", run.number_of_elements);
+	fflush(stdout);
+	const double process_start_seconds = benchmark_get_seconds();
+	run.exit_status = benchmark_run_cmgui(options.cmgui, command_file.c_str(),
+		options.print, run.peak_resident_kB);
+	run.process_seconds = benchmark_get_seconds() - process_start_seconds;
+	for (int p = 0; p < BENCHMARK_NUMBER_OF_PHASES; ++p)
+		benchmark_read_phase(directory, p, run.phases[p]);
+	for (int p = 0; p < BENCHMARK_NUMBER_OF_PHASES; ++p)
+	{
+		if (run.phases[p].run)
+		{
+			printf("  %-18s %10.4f s\n", benchmark_phase_names[p], run.phases[p].wall_seconds);
+		}
+	}
+	return (0 == run.exit_status) ? 1 : 0;
+}
+
+void benchmark_write_json(FILE *file, const Benchmark_options &options,
+	const std::vector<Benchmark_run> &runs)
+{
+	char text[256];
+	fprintf(file, "{\n  \"benchmark\": \"cmgui_bench\",\n  \"format_version\": 1,\n");
+	fprintf(file, "  \"label\": ");
+	benchmark_write_json_string(file, options.label.c_str());
+	time_t now = time(NULL);
+	strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+	fprintf(file, ",\n  \"date\": \"%s\",\n  \"cmgui\": ", text);
+	benchmark_write_json_string(file, options.cmgui);
+	fprintf(file, ",\n  \"machine\": {\n");
+	struct utsname system_name;
+	if (0 == uname(&system_name))
+	{
+		fprintf(file, "    \"system\": ");
+		benchmark_write_json_string(file, system_name.sysname);
+		fprintf(file, ",\n    \"release\": ");
+		benchmark_write_json_string(file, system_name.release);
+		fprintf(file, ",\n    \"architecture\": ");
+		benchmark_write_json_string(file, system_name.machine);
+		fprintf(file, ",\n    \"host\": ");
+		benchmark_write_json_string(file, system_name.nodename);
+		fprintf(file, ",\n");
+	}
+	fprintf(file, "    \"cpu\": ");
+	benchmark_write_json_string(file, benchmark_get_cpu_model().c_str());
+	fprintf(file, ",\n    \"processors\": %ld", sysconf(_SC_NPROCESSORS_ONLN));
+#if defined (_SC_PHYS_PAGES)
+	fprintf(file, ",\n    \"memory_kB\": %.0f",
+		(double)sysconf(_SC_PHYS_PAGES)*(double)sysconf(_SC_PAGESIZE)/1024.0);
+#endif
+#if defined (__VERSION__)
+	fprintf(file, ",\n    \"compiler\": ");
+	benchmark_write_json_string(file, __VERSION__);
+#endif
+	fprintf(file, "\n  },\n  \"runs\": [");
+	for (size_t r = 0; r < runs.size(); ++r)
+	{
+		const Benchmark_run &run = runs[r];
+		fprintf(file, "%s\n    {\n      \"model\": \"hex\",\n"
+			"      \"elements\": %ld,\n      \"nodes\": %ld,\n"
+			"      \"time_steps\": %d,\n      \"exit_status\": %d,\n"
+			"      \"generate_seconds\": %.4f,\n      \"process_seconds\": %.4f,\n"
+			"      \"peak_resident_kB\": %.0f,\n      \"phases\": [",
+			(0 < r) ? "," : "", run.number_of_elements, run.number_of_nodes,
+			options.number_of_time_steps, run.exit_status, run.generate_seconds,
+			run.process_seconds, run.peak_resident_kB);
+		bool first = true;
+		for (int p = 0; p < BENCHMARK_NUMBER_OF_PHASES; ++p)
+		{
+			const Benchmark_phase &phase = run.phases[p];
+			if (!phase.run)
+				continue;
+			fprintf(file, "%s\n        { \"name\": \"%s\", \"commands\": %d, "
+				"\"wall_seconds\": %.4f, \"parse_seconds\": %.4f, \"cpu_seconds\": %.4f",
+				first ? "" : ",", benchmark_phase_names[p], phase.number_of_commands,
+				phase.wall_seconds, phase.parse_seconds, phase.cpu_seconds);
+			if (phase.heap_known)
+				fprintf(file, ", \"heap_kB\": %.0f", phase.heap_kB);
+			fprintf(file, " }");
+			first = false;
+		}
+		fprintf(file, "\n      ]\n    }");
+	}
+	fprintf(file, "\n  ]\n}\n");
+}
+
+void benchmark_write_usage(const char *program)
+{
+	fprintf(stderr, "Usage: %s -cmgui CMGUI_EXECUTABLE [-directory WORK_DIRECTORY]\n"
+		"  [-output JSON_FILE] [-elements NUMBER_OF_ELEMENTS]... [-time_steps N]\n"
+		"  [-print] [-label LABEL]\n", program);
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	Benchmark_options options;
+	options.cmgui = 0;
+	options.directory = "cmgui_bench";
+	options.output = "cmgui_bench.json";
+	options.number_of_time_steps = 10;
+	options.print = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		const char *option = argv[i];
+		const bool has_value = (i + 1 < argc);
+		if ((0 == strcmp(option, "-cmgui")) && has_value)
+			options.cmgui = argv[++i];
+		else if ((0 == strcmp(option, "-directory")) && has_value)
+			options.directory = argv[++i];
+		else if ((0 == strcmp(option, "-output")) && has_value)
+			options.output = argv[++i];
+		else if ((0 == strcmp(option, "-label")) && has_value)
+			options.label = argv[++i];
+		else if ((0 == strcmp(option, "-elements")) && has_value)
+			options.element_counts.push_back(atol(argv[++i]));
+		else if ((0 == strcmp(option, "-time_steps")) && has_value)
+			options.number_of_time_steps = atoi(argv[++i]);
+		else if (0 == strcmp(option, "-print"))
+			options.print = true;
+		else
+		{
+			benchmark_write_usage(argv[0]);
+			return 1;
+		}
+	}
+	if (options.element_counts.empty())
+	{
+		options.element_counts.push_back(10000);
+		options.element_counts.push_back(100000);
+		options.element_counts.push_back(1000000);
+	}
+	if ((!options.cmgui) || (options.number_of_time_steps < 0) ||
+		(options.number_of_time_steps > 10000))
+	{
+		benchmark_write_usage(argv[0]);
+		return 1;
+	}
+	if ((0 != mkdir(options.directory.c_str(), 0755)) && (EEXIST != errno))
+	{
+		fprintf(stderr, "cmgui_benchmark: Could not create %s\n", options.directory.c_str());
+		return 1;
+	}
+	int return_code = 0;
+	std::vector<Benchmark_run> runs;
+	for (size_t i = 0; i < options.element_counts.size(); ++i)
+	{
+		Benchmark_run run;
+		if (!benchmark_run_model(options, options.element_counts[i], run))
+		{
+			fprintf(stderr, "cmgui_benchmark: Run with %ld elements failed\n",
+				options.element_counts[i]);
+			return_code = 1;
+		}
+		runs.push_back(run);
+	}
+	FILE *file = fopen(options.output.c_str(), "w");
+	if (!file)
+	{
+		fprintf(stderr, "cmgui_benchmark: Could not open %s for writing\n",
+			options.output.c_str());
+		return 1;
+	}
+	benchmark_write_json(file, options, runs);
+	if (0 != fclose(file))
+	{
+		fprintf(stderr, "cmgui_benchmark: Error writing %s\n", options.output.c_str());
+		return 1;
+	}
+	printf("Results written to %s\n", options.output.c_str());
+	return return_code;
+}
+
+#else /* defined (UNIX) */
+
+int main(int argc, char *argv[])
+{
+	(void)argc;
+	fprintf(stderr, "%s: Only supported on UNIX systems\n", argv[0]);
+	return 1;
+}
+
+#endif /* defined (UNIX) */
@@ -0,0 +1,231 @@
+/**
+ * FILE : event_dispatcher_benchmark.cpp
+ *
+ * Measures how many descriptor events per second the generic event dispatcher
+ * delivers through the Fdio API with 10, 100 and 1000 watched descriptors.
+ * Each descriptor is the read end of a pipe. A fixed number of tokens circulate
+ * between the pipes: each read callback consumes a byte and writes one to
+ * another pipe, so every dispatched event leads to exactly one more.
+ *
+ * Usage: event_dispatcher_benchmark [EVENTS_PER_RUN]
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "configure/cmgui_configure.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "general/debug.h"
+#include "general/message.h"
+#include "user_interface/event_dispatcher.h"
+
+#if defined (USE_GENERIC_EVENT_DISPATCHER) && defined (UNIX)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+namespace {
+
+const int benchmark_descriptor_counts[] = { 10, 100, 1000 };
+const int benchmark_max_tokens = 16;
+
+struct Benchmark_pipe
+{
+	int read_descriptor, write_descriptor;
+	Fdio_id io;
+};
+
+struct Benchmark_data
+{
+	struct Event_dispatcher *event_dispatcher;
+	struct Benchmark_pipe *pipes;
+	int number_of_pipes;
+	long number_of_events, target_number_of_events;
+};
+
+struct Benchmark_callback_data
+{
+	struct Benchmark_data *data;
+	int index;
+};
+
+int benchmark_token_callback(Fdio_id io, void *callback_data_void)
+{
+	USE_PARAMETER(io);
+	struct Benchmark_callback_data *callback_data =
+		static_cast<struct Benchmark_callback_data *>(callback_data_void);
+	struct Benchmark_data *data = callback_data->data;
+	char token;
+	if (1 == read(data->pipes[callback_data->index].read_descriptor, &token, 1))
+	{
+		/* pass the token on to a pipe some way around the ring */
+		int next = (callback_data->index + 7) % data->number_of_pipes;
+		if (1 != write(data->pipes[next].write_descriptor, &token, 1))
+		{
+			display_message(ERROR_MESSAGE, "event_dispatcher_benchmark.  Write failed");
+		}
+		data->number_of_events++;
+		if (data->number_of_events >= data->target_number_of_events)
+		{
+			Event_dispatcher_end_main_loop(data->event_dispatcher);
+		}
+	}
+	return 1;
+}
+
+/** Raises the soft limit on open files so 1000 pipes can be created. */
+void benchmark_raise_descriptor_limit(int number_of_descriptors)
+{
+	struct rlimit limit;
+	if ((0 == getrlimit(RLIMIT_NOFILE, &limit)) &&
+		(limit.rlim_cur != RLIM_INFINITY) &&
+		(limit.rlim_cur < (rlim_t)number_of_descriptors))
+	{
+		limit.rlim_cur = ((limit.rlim_max == RLIM_INFINITY) ||
+			(limit.rlim_max > (rlim_t)number_of_descriptors)) ?
+			(rlim_t)number_of_descriptors : limit.rlim_max;
+		setrlimit(RLIMIT_NOFILE, &limit);
+	}
+}
+
+/**
+ * Runs the token ring over <number_of_pipes> pipes until
+ * <target_number_of_events> read callbacks have been dispatched.
+ * @return  Events per second, or a negative value on failure.
+ */
+double benchmark_run(int number_of_pipes, long target_number_of_events)
+{
+	double events_per_second = -1.0;
+	struct Benchmark_data data;
+	struct Benchmark_callback_data *callback_data;
+	data.event_dispatcher = CREATE(Event_dispatcher)();
+	data.number_of_pipes = 0;
+	data.number_of_events = 0;
+	data.target_number_of_events = target_number_of_events;
+	/* the Fdio package is just a view of the event dispatcher; nothing to free */
+	Fdio_package_id package = CREATE(Fdio_package)(data.event_dispatcher);
+	ALLOCATE(data.pipes, struct Benchmark_pipe, number_of_pipes);
+	ALLOCATE(callback_data, struct Benchmark_callback_data, number_of_pipes);
+	if (data.event_dispatcher && package && data.pipes && callback_data)
+	{
+		int return_code = 1;
+		for (int i = 0; return_code && (i < number_of_pipes); ++i)
+		{
+			int descriptors[2];
+			if (0 == pipe(descriptors))
+			{
+				fcntl(descriptors[0], F_SETFL, O_NONBLOCK);
+				data.pipes[i].read_descriptor = descriptors[0];
+				data.pipes[i].write_descriptor = descriptors[1];
+				data.pipes[i].io = Fdio_package_create_Fdio(package, descriptors[0]);
+				callback_data[i].data = &data;
+				callback_data[i].index = i;
+				data.number_of_pipes++;
+				if (data.pipes[i].io)
+				{
+					Fdio_set_read_callback(data.pipes[i].io, benchmark_token_callback,
+						static_cast<void *>(&callback_data[i]));
+				}
+				else
+				{
+					return_code = 0;
+				}
+			}
+			else
+			{
+				display_message(ERROR_MESSAGE, "event_dispatcher_benchmark.  "
+					"Could not create pipe %d", i);
+				return_code = 0;
+			}
+		}
+		if (return_code)
+		{
+			int number_of_tokens = (number_of_pipes < benchmark_max_tokens) ?
+				number_of_pipes : benchmark_max_tokens;
+			char token = 't';
+			for (int i = 0; i < number_of_tokens; ++i)
+			{
+				if (1 != write(data.pipes[(i*number_of_pipes)/number_of_tokens].write_descriptor,
+					&token, 1))
+				{
+					return_code = 0;
+				}
+			}
+		}
+		if (return_code)
+		{
+			struct timeval start, end;
+			cmgui_gettimeofday(&start, NULL);
+			Event_dispatcher_main_loop(data.event_dispatcher);
+			cmgui_gettimeofday(&end, NULL);
+			double seconds = (double)(end.tv_sec - start.tv_sec) +
+				1.0E-6*(double)(end.tv_usec - start.tv_usec);
+			if (seconds > 0.0)
+				events_per_second = (double)data.number_of_events / seconds;
+		}
+		for (int i = 0; i < data.number_of_pipes; ++i)
+		{
+			if (data.pipes[i].io)
+				DESTROY(Fdio)(&data.pipes[i].io);
+			close(data.pipes[i].read_descriptor);
+			close(data.pipes[i].write_descriptor);
+		}
+	}
+	if (callback_data)
+		DEALLOCATE(callback_data);
+	if (data.pipes)
+		DEALLOCATE(data.pipes);
+	if (data.event_dispatcher)
+		DESTROY(Event_dispatcher)(&data.event_dispatcher);
+	return events_per_second;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	long target_number_of_events = 200000;
+	if (argc > 1)
+		target_number_of_events = atol(argv[1]);
+	if (target_number_of_events <= 0)
+	{
+		fprintf(stderr, "Usage: %s [EVENTS_PER_RUN]\n", argv[0]);
+		return 1;
+	}
+	int number_of_runs = sizeof(benchmark_descriptor_counts)/sizeof(int);
+	benchmark_raise_descriptor_limit(
+		2*benchmark_descriptor_counts[number_of_runs - 1] + 64);
+	int return_code = 0;
+	printf("descriptors  events/s\n");
+	for (int i = 0; i < number_of_runs; ++i)
+	{
+		double events_per_second = benchmark_run(benchmark_descriptor_counts[i],
+			target_number_of_events);
+		if (events_per_second < 0.0)
+		{
+			printf("%11d  failed\n", benchmark_descriptor_counts[i]);
+			return_code = 1;
+		}
+		else
+		{
+			printf("%11d  %.0f\n", benchmark_descriptor_counts[i], events_per_second);
+		}
+	}
+	return return_code;
+}
+
+#else /* defined (USE_GENERIC_EVENT_DISPATCHER) && defined (UNIX) */
+
+int main(int argc, char *argv[])
+{
+	USE_PARAMETER(argc);
+	USE_PARAMETER(argv);
+	fprintf(stderr, "The event dispatcher benchmark requires the generic event "
+		"dispatcher on UNIX\n");
+	return 1;
+}
+
+#endif /* defined (USE_GENERIC_EVENT_DISPATCHER) && defined (UNIX) */
@@ -0,0 +1,244 @@
+/**
+ * FILE : identifier_set_benchmark.cpp
+ *
+ * Compares Multi_range with the compressed bitmap Identifier_set for building,
+ * membership tests, union and intersection of identifier sets. Sets follow
+ * three patterns: one contiguous range, many short disjoint ranges and sparse
+ * random identifiers. Each union and intersection combines a set with a copy
+ * of the same pattern offset to overlap it partly.
+ *
+ * Usage: identifier_set_benchmark [NUMBER_OF_RANGES [NUMBER_OF_QUERIES]]
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "configure/cmgui_configure.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "general/cmgui_time.h"
+#include "general/debug.h"
+#include "general/identifier_set.h"
+#include "general/message.h"
+#include "general/multi_range.h"
+
+namespace {
+
+enum Benchmark_pattern
+{
+	BENCHMARK_PATTERN_CONTIGUOUS,
+	BENCHMARK_PATTERN_DISJOINT,
+	BENCHMARK_PATTERN_SPARSE
+};
+
+const char *benchmark_pattern_names[] = { "contiguous", "disjoint", "sparse" };
+
+/** Simple linear congruential generator so runs are repeatable. */
+unsigned int benchmark_random(unsigned int &state)
+{
+	state = state*1103515245u + 12345u;
+	return (state >> 8) & 0xFFFFFF;
+}
+
+double benchmark_seconds_since(const struct timeval &start)
+{
+	struct timeval end;
+	cmgui_gettimeofday(&end, NULL);
+	return (double)(end.tv_sec - start.tv_sec) +
+		1.0E-6*(double)(end.tv_usec - start.tv_usec);
+}
+
+/**
+ * Fills <ranges> with increasing, non-adjacent first/last pairs for the
+ * pattern, starting at <offset>.
+ * @return  One past the largest identifier.
+ */
+int benchmark_make_ranges(enum Benchmark_pattern pattern, int number_of_ranges,
+	int offset, std::vector<int> &ranges)
+{
+	ranges.clear();
+	unsigned int state = 1;
+	int next = offset + 1;
+	switch (pattern)
+	{
+		case BENCHMARK_PATTERN_CONTIGUOUS:
+		{
+			ranges.push_back(next);
+			next += 10*number_of_ranges;
+			ranges.push_back(next - 1);
+		} break;
+		case BENCHMARK_PATTERN_DISJOINT:
+		{
+			for (int i = 0; i < number_of_ranges; ++i)
+			{
+				ranges.push_back(next);
+				ranges.push_back(next + 4);
+				next += 10;
+			}
+		} break;
+		case BENCHMARK_PATTERN_SPARSE:
+		{
+			for (int i = 0; i < number_of_ranges; ++i)
+			{
+				next += 2 + benchmark_random(state) % 2000;
+				ranges.push_back(next);
+				ranges.push_back(next);
+			}
+			++next;
+		} break;
+	}
+	return next;
+}
+
+struct Benchmark_times
+{
+	double build, contains, set_union, intersect;
+	long number_found, union_size, intersect_size;
+};
+
+void benchmark_multi_range(const std::vector<int> &ranges,
+	const std::vector<int> &other_ranges, const std::vector<int> &queries,
+	struct Benchmark_times &times)
+{
+	struct timeval start;
+	cmgui_gettimeofday(&start, NULL);
+	struct Multi_range *multi_range = CREATE(Multi_range)();
+	for (size_t i = 0; i < ranges.size(); i += 2)
+		Multi_range_add_range(multi_range, ranges[i], ranges[i + 1]);
+	times.build = benchmark_seconds_since(start);
+	struct Multi_range *other = CREATE(Multi_range)();
+	for (size_t i = 0; i < other_ranges.size(); i += 2)
+		Multi_range_add_range(other, other_ranges[i], other_ranges[i + 1]);
+
+	cmgui_gettimeofday(&start, NULL);
+	times.number_found = 0;
+	for (size_t i = 0; i < queries.size(); ++i)
+	{
+		if (Multi_range_is_value_in_range(multi_range, queries[i]))
+			++times.number_found;
+	}
+	times.contains = benchmark_seconds_since(start);
+
+	struct Multi_range *union_range = CREATE(Multi_range)();
+	for (size_t i = 0; i < ranges.size(); i += 2)
+		Multi_range_add_range(union_range, ranges[i], ranges[i + 1]);
+	cmgui_gettimeofday(&start, NULL);
+	const int number_of_other_ranges = Multi_range_get_number_of_ranges(other);
+	int first, last;
+	for (int i = 0; i < number_of_other_ranges; ++i)
+	{
+		if (Multi_range_get_range(other, i, &first, &last))
+			Multi_range_add_range(union_range, first, last);
+	}
+	times.set_union = benchmark_seconds_since(start);
+	times.union_size = Multi_range_get_total_number_in_ranges(union_range);
+
+	cmgui_gettimeofday(&start, NULL);
+	Multi_range_intersect(multi_range, other);
+	times.intersect = benchmark_seconds_since(start);
+	times.intersect_size = Multi_range_get_total_number_in_ranges(multi_range);
+
+	DESTROY(Multi_range)(&union_range);
+	DESTROY(Multi_range)(&other);
+	DESTROY(Multi_range)(&multi_range);
+}
+
+void benchmark_identifier_set(const std::vector<int> &ranges,
+	const std::vector<int> &other_ranges, const std::vector<int> &queries,
+	struct Benchmark_times &times)
+{
+	struct timeval start;
+	cmgui_gettimeofday(&start, NULL);
+	struct Identifier_set *set = CREATE(Identifier_set)();
+	for (size_t i = 0; i < ranges.size(); i += 2)
+		Identifier_set_add_range(set, ranges[i], ranges[i + 1]);
+	times.build = benchmark_seconds_since(start);
+	struct Identifier_set *other = CREATE(Identifier_set)();
+	for (size_t i = 0; i < other_ranges.size(); i += 2)
+		Identifier_set_add_range(other, other_ranges[i], other_ranges[i + 1]);
+
+	cmgui_gettimeofday(&start, NULL);
+	times.number_found = 0;
+	for (size_t i = 0; i < queries.size(); ++i)
+	{
+		if (Identifier_set_contains(set, queries[i]))
+			++times.number_found;
+	}
+	times.contains = benchmark_seconds_since(start);
+
+	struct Identifier_set *union_set = CREATE(Identifier_set)();
+	Identifier_set_union(union_set, set);
+	cmgui_gettimeofday(&start, NULL);
+	Identifier_set_union(union_set, other);
+	times.set_union = benchmark_seconds_since(start);
+	times.union_size = Identifier_set_get_size(union_set);
+
+	cmgui_gettimeofday(&start, NULL);
+	Identifier_set_intersect(set, other);
+	times.intersect = benchmark_seconds_since(start);
+	times.intersect_size = Identifier_set_get_size(set);
+
+	DESTROY(Identifier_set)(&union_set);
+	DESTROY(Identifier_set)(&other);
+	DESTROY(Identifier_set)(&set);
+}
+
+void benchmark_print(const char *pattern_name, const char *backend_name,
+	const struct Benchmark_times &times)
+{
+	printf("%-10s  %-14s  %9.4f  %9.4f  %9.4f  %9.4f  %ld/%ld/%ld\n",
+		pattern_name, backend_name, times.build, times.contains, times.set_union,
+		times.intersect, times.number_found, times.union_size, times.intersect_size);
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+	int number_of_ranges = 100000;
+	long number_of_queries = 1000000;
+	if (argc > 1)
+		number_of_ranges = atoi(argv[1]);
+	if (argc > 2)
+		number_of_queries = atol(argv[2]);
+	if ((number_of_ranges <= 0) || (number_of_queries <= 0))
+	{
+		fprintf(stderr, "Usage: %s [NUMBER_OF_RANGES [NUMBER_OF_QUERIES]]\n", argv[0]);
+		return 1;
+	}
+	int return_code = 0;
+	printf("%-10s  %-14s  %9s  %9s  %9s  %9s  %s\n", "pattern", "backend",
+		"build/s", "contains/s", "union/s", "intersect/s", "found/union/intersect");
+	std::vector<int> ranges, other_ranges, queries;
+	for (int p = 0; p < 3; ++p)
+	{
+		const enum Benchmark_pattern pattern = static_cast<enum Benchmark_pattern>(p);
+		const int limit = benchmark_make_ranges(pattern, number_of_ranges, 0, ranges);
+		/* offset by a third of the span so the sets partly overlap */
+		benchmark_make_ranges(pattern, number_of_ranges, limit/3, other_ranges);
+		unsigned int state = 7;
+		queries.resize(number_of_queries);
+		for (long i = 0; i < number_of_queries; ++i)
+		{
+			queries[i] = static_cast<int>(
+				(((unsigned long)benchmark_random(state) << 24) | benchmark_random(state)) % limit);
+		}
+		struct Benchmark_times multi_range_times, identifier_set_times;
+		benchmark_multi_range(ranges, other_ranges, queries, multi_range_times);
+		benchmark_identifier_set(ranges, other_ranges, queries, identifier_set_times);
+		benchmark_print(benchmark_pattern_names[p], "Multi_range", multi_range_times);
+		benchmark_print(benchmark_pattern_names[p], "Identifier_set", identifier_set_times);
+		if ((multi_range_times.number_found != identifier_set_times.number_found) ||
+			(multi_range_times.union_size != identifier_set_times.union_size) ||
+			(multi_range_times.intersect_size != identifier_set_times.intersect_size))
+		{
+			display_message(ERROR_MESSAGE, "identifier_set_benchmark.  "
+				"Backends disagree for %s pattern", benchmark_pattern_names[p]);
+			return_code = 1;
+		}
+	}
+	return return_code;
+}
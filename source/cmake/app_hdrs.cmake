@@ -36,6 +36,9 @@ SET(APP_HDRS
     source/image_processing/computed_field_binary_threshold_image_filter_app.h
     source/image_processing/computed_field_threshold_image_filter_app.h
     source/image_processing/computed_field_image_resample_app.h
+    source/image_processing/image_filter_stream.h
+    source/image_processing/image_filter_cache.h
+    source/image_processing/connected_threshold_parallel.h
     source/computed_field/computed_field_string_constant_app.h
     source/computed_field/computed_field_deformation_app.h
     source/computed_field/computed_field_finite_element_app.h
@@ -60,8 +63,16 @@ SET(APP_HDRS
     source/graphics/element_point_ranges_app.h
     source/graphics/environment_map_app.h
     source/finite_element/finite_element_region_app.h
+    source/finite_element/export_nodal_values.h
+    source/finite_element/mesh_location_index.h
     source/graphics/font_app.h
     source/graphics/scene_viewer_app.h
+    source/graphics/frame_statistics.h
+    source/graphics/frame_sequence_writer.h
+    source/graphics/threejs_resource_writer.h
+    source/graphics/texture_volume_loader.h
+    source/graphics/texture_field_sampler.h
+    source/graphics/tiled_image_writer.h
     source/graphics/glyph_app.h
     source/graphics/tessellation_app.hpp
     source/graphics/tessellation_app.hpp
@@ -80,6 +91,12 @@ SET(APP_HDRS
     source/computed_field/computed_field_set_app.h
     source/general/multi_range_app.h
     source/general/cmgui_time.h
+    source/general/buffered_file_writer.h
+    source/general/cmgui_thread.h
+    source/general/memory_accounting.h
+    source/general/identifier_set.h
+    source/general/mapped_file.h
+    source/general/zip_writer.h
     source/choose/choose_class.hpp
     source/choose/choose_enumerator_class.hpp
     source/choose/choose_listbox_class.hpp
@@ -93,6 +110,7 @@ SET(APP_HDRS
     source/comfile/comfile.h
     source/command/cmiss.h
     source/command/command.h
+    source/command/command_timing.h
     source/command/console.h
     source/command/example_path.h
     source/command/parser.h
@@ -102,6 +120,7 @@ SET(APP_HDRS
     source/element/element_tool.h
     source/element/element_point_viewer_wx.h
     source/emoter/emoter_dialog.h
+    source/emoter/emoter_reconstruction.h
     source/graphics/graphics_window.h
     source/graphics/graphics_window_private.hpp
     source/graphics/texturemap.h
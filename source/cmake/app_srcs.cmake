@@ -22,6 +22,9 @@ SET(APP_SRCS
     source/image_processing/computed_field_threshold_image_filter_app.cpp
     source/computed_field/computed_field_time_app.cpp
     source/image_processing/computed_field_image_resample_app.cpp
+    source/image_processing/image_filter_stream.cpp
+    source/image_processing/image_filter_cache.cpp
+    source/image_processing/connected_threshold_parallel.cpp
     source/computed_field/computed_field_string_constant_app.cpp
     source/computed_field/computed_field_deformation_app.cpp
     source/computed_field/computed_field_finite_element_app.cpp
@@ -53,6 +56,8 @@ SET(APP_SRCS
     source/finite_element/finite_element_conversion_app.cpp
     source/finite_element/finite_element_app.cpp
     source/finite_element/finite_element_region_app.cpp
+    source/finite_element/export_nodal_values.cpp
+    source/finite_element/mesh_location_index.cpp
     source/graphics/glyph_app.cpp
     source/graphics/graphics_app.cpp
     source/graphics/font_app.cpp
@@ -66,6 +71,12 @@ SET(APP_SRCS
     source/computed_field/computed_field_set_app.cpp
     source/general/multi_range_app.cpp
     source/general/cmgui_time.cpp
+    source/general/buffered_file_writer.cpp
+    source/general/cmgui_thread.cpp
+    source/general/memory_accounting.cpp
+    source/general/identifier_set.cpp
+    source/general/mapped_file.cpp
+    source/general/zip_writer.cpp
     source/graphics/auxiliary_graphics_types_app.cpp
     source/graphics/light_app.cpp
     source/graphics/scene_app.cpp
@@ -76,10 +87,17 @@ SET(APP_SRCS
     source/graphics/material_app.cpp
     source/region/cmiss_region_app.cpp
     source/graphics/scene_viewer_app.cpp
+    source/graphics/frame_statistics.cpp
+    source/graphics/frame_sequence_writer.cpp
+    source/graphics/threejs_resource_writer.cpp
+    source/graphics/texture_volume_loader.cpp
+    source/graphics/texture_field_sampler.cpp
+    source/graphics/tiled_image_writer.cpp
     source/cmgui.cpp
     source/comfile/comfile.cpp
     source/command/cmiss.cpp
     source/command/command.cpp
+    source/command/command_timing.cpp
     source/command/console.cpp
     source/command/example_path.cpp
     source/command/parser.cpp
@@ -89,6 +107,7 @@ SET(APP_SRCS
     source/element/element_tool.cpp
     source/element/element_point_viewer_wx.cpp
     source/emoter/emoter_dialog.cpp
+    source/emoter/emoter_reconstruction.cpp
     source/graphics/transform_tool.cpp
     source/dialog/tessellation_dialog.cpp
     source/graphics/region_tree_viewer_wx.cpp
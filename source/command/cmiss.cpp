@@ -15,8 +15,10 @@
 
 #include <stddef.h>
 #include <stdio.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <string>
+#include <vector>
 #if defined (WIN32_SYSTEM)
 #  include <direct.h>
 #else /* !defined (WIN32_SYSTEM) */
@@ -44,6 +46,7 @@
 #include "comfile/comfile_window_wx.h"
 #endif /* defined (WX_USER_INTERFACE) */
 #include "command/console.h"
+#include "command/command_timing.h"
 #include "command/command_window.h"
 #include "command/example_path.h"
 #include "command/parser.h"
@@ -90,6 +93,7 @@
 #include "finite_element/generate_mesh_netgen.h"
 #endif /* defined (ZINC_USE_NETGEN) */
 #include "finite_element/export_finite_element.h"
+#include "finite_element/export_nodal_values.h"
 #include "finite_element/finite_element.h"
 #include "finite_element/finite_element_conversion.h"
 #include "finite_element/finite_element_mesh.hpp"
@@ -100,16 +104,23 @@
 #include "finite_element/finite_element_to_streamlines.h"
 #include "finite_element/import_finite_element.h"
 #include "finite_element/snake.h"
+#include "general/cmgui_thread.h"
 #include "general/debug.h"
 #include "general/error_handler.h"
+#include "general/identifier_set.h"
 #include "general/image_utilities.h"
 #include "general/io_stream.h"
+#include "general/mapped_file.h"
 #include "general/matrix_vector.h"
+#include "general/memory_accounting.h"
 #include "general/multi_range.h"
 #include "general/mystring.h"
+#include "general/zip_writer.h"
 #include "graphics/environment_map.h"
 #include "graphics/graphics_object.h"
 #include "graphics/graphics_window.h"
+#include "graphics/frame_sequence_writer.h"
+#include "graphics/tiled_image_writer.h"
 #include "graphics/iso_field_calculation.h"
 #include "graphics/light.hpp"
 #include "graphics/material.h"
@@ -139,12 +150,16 @@
 #endif /* defined (WX_USER_INTERFACE) */
 #include "graphics/spectrum_component.h"
 #include "graphics/texture.h"
+#include "graphics/texture_field_sampler.h"
+#include "graphics/texture_volume_loader.h"
 #include "graphics/transform_tool.h"
 #include "graphics/volume_texture.h"
 #if defined (GTK_USER_INTERFACE)
 #include "gtk/gtk_cmiss_scene_viewer.h"
 #endif /* defined (GTK_USER_INTERFACE) */
 #include "image_processing/computed_field_image_resample.h"
+#include "image_processing/connected_threshold_parallel.h"
+#include "image_processing/image_filter_cache.h"
 #if defined (ZINC_USE_ITK)
 #include "image_processing/computed_field_threshold_image_filter.h"
 #include "image_processing/computed_field_binary_threshold_image_filter.h"
@@ -189,6 +204,7 @@
 #endif /* defined (USE_PERL_INTERPRETER) */
 #include "user_interface/fd_io.h"
 #include "user_interface/idle.h"
+#include "user_interface/process_list_or_write_command.hpp"
 #include "command/cmiss.h"
 #include "mesh/cmiss_element_private.hpp"
 #include "mesh/cmiss_node_private.hpp"
@@ -334,6 +350,15 @@ DESCRIPTION :
 #endif /* defined (USE_CMGUI_GRAPHICS_WINDOW) */
 	struct MANAGER(Interactive_tool) *interactive_tool_manager;
 	struct IO_stream_package *io_stream_package;
+	/* default for gfx read mmap/no_mmap: read model files through memory maps */
+	int read_mmap;
+	/* results of image filter fields kept between sessions, see gfx set image_cache */
+	struct Image_filter_cache *image_filter_cache;
+	/* top-level and gfx option tables, built on first use and reused for every
+		 command as all their entries are bound to the command_data only */
+	struct Option_table *command_option_table, *gfx_option_table;
+	/* time spent in each command group, see gfx timing */
+	struct Command_timing *command_timing;
 	cmzn_lightmodule *lightmodule;
 	struct cmzn_light *default_light;
 	struct cmzn_materialmodule *materialmodule;
@@ -998,11 +1023,13 @@ static int process_modify_element_group(cmzn_field_group_id group,
 			{
 				iteration_mesh = from_mesh;
 			}
+			struct Identifier_set *element_identifiers = element_ranges ?
+				Identifier_set_create_from_Multi_range(element_ranges) : 0;
 			cmzn_elementiterator_id iter = cmzn_mesh_create_elementiterator(iteration_mesh);
 			cmzn_element_id element = 0;
 			while (NULL != (element = cmzn_elementiterator_next_non_access(iter)))
 			{
-				if (element_ranges && !Multi_range_is_value_in_range(element_ranges, cmzn_element_get_identifier(element)))
+				if (element_identifiers && !Identifier_set_contains(element_identifiers, cmzn_element_get_identifier(element)))
 					continue;
 				if (selection_mesh && (selection_mesh != iteration_mesh) && !cmzn_mesh_contains_element(selection_mesh, element))
 					continue;
@@ -1036,6 +1063,8 @@ static int process_modify_element_group(cmzn_field_group_id group,
 				}
 			}
 			cmzn_elementiterator_destroy(&iter);
+			if (element_identifiers)
+				DESTROY(Identifier_set)(&element_identifiers);
 			cmzn_fieldcache_destroy(&cache);
 			cmzn_field_group_set_subelement_handling_mode(group, oldSubelementHandlingMode);
 			cmzn_mesh_group_destroy(&modify_mesh_group);
@@ -1133,11 +1162,12 @@ static int gfx_create_group(struct Parse_state *state,
 									(object_type == 1) ? CMZN_FIELD_DOMAIN_TYPE_NODES : CMZN_FIELD_DOMAIN_TYPE_DATAPOINTS);
 								cmzn_field_node_group_id node_group = cmzn_field_group_create_field_node_group(group, master_nodeset);
 								cmzn_nodeset_group_id modify_nodeset_group = cmzn_field_node_group_get_nodeset_group(node_group);
+								struct Identifier_set *add_identifiers = Identifier_set_create_from_Multi_range(add_ranges);
 								cmzn_nodeiterator_id iter = cmzn_nodeset_create_nodeiterator(master_nodeset);
 								cmzn_node_id node = 0;
 								while (NULL != (node = cmzn_nodeiterator_next_non_access(iter)))
 								{
-									if (Multi_range_is_value_in_range(add_ranges, cmzn_node_get_identifier(node)))
+									if (Identifier_set_contains(add_identifiers, cmzn_node_get_identifier(node)))
 									{
 										if (!cmzn_nodeset_group_add_node(modify_nodeset_group, node))
 										{
@@ -1147,6 +1177,7 @@ static int gfx_create_group(struct Parse_state *state,
 									}
 								}
 								cmzn_nodeiterator_destroy(&iter);
+								DESTROY(Identifier_set)(&add_identifiers);
 								cmzn_nodeset_group_destroy(&modify_nodeset_group);
 								cmzn_field_node_group_destroy(&node_group);
 								cmzn_nodeset_destroy(&master_nodeset);
@@ -2545,21 +2576,29 @@ static int set_Texture_image_from_field(struct Texture *texture,
 	enum Texture_storage_type storage,
 	int image_width, int image_height, int image_depth,
 	int number_of_bytes_per_component,
-	struct Graphics_buffer_app_package *graphics_buffer_package,
-	cmzn_material *fail_material)
+	cmzn_material *fail_material, int number_of_threads,
+	const int *streaming_tile_sizes,
+	struct Image_filter_cache *image_filter_cache)
 /*******************************************************************************
-LAST MODIFIED : 30 June 2006
+LAST MODIFIED : 16 October 2026
 
 DESCRIPTION :
 Creates the image in the format given by sampling the <field> according to the
 reverse mapping of the <texture_coordinate_field>.  The values returned by
 field are converted to "colours" by applying the <spectrum>.
-Currently limited to 1 byte per component.
+Currently limited to 1 or 2 bytes per component.
 @param search_mesh  The mesh to find locations with matching texture coordinates.
+@param number_of_threads  Maximum number of threads converting field values to
+pixels, or 0 for the number of processors. The field is only evaluated on the
+calling thread.
+@param streaming_tile_sizes  If any is positive, <field> must be a chain of
+image filters which is evaluated tile by tile at its native resolution.
+@param image_filter_cache  Optional cache storing the values of image filter
+<field> if it is waiting for its first evaluation.
 ==============================================================================*/
 {
 	char *field_name;
-	int bytes_per_pixel, number_of_components, return_code,
+	int number_of_components, return_code,
 		source_dimension, *source_sizes, tex_number_of_components, use_pixel_location = 1;
 	struct Computed_field *source_texture_coordinate_field = NULL;
 
@@ -2646,13 +2685,42 @@ Currently limited to 1 byte per component.
 		if (Texture_allocate_image(texture, image_width, image_height,
 			image_depth, storage, number_of_bytes_per_component, field_name))
 		{
-			bytes_per_pixel = number_of_components*number_of_bytes_per_component;
 			double texture_width, texture_height, texture_depth;
 			Texture_get_physical_size(texture, &texture_width, &texture_height, &texture_depth);
-			Set_cmiss_field_value_to_texture(field, texture_coordinate_field,
-				texture, spectrum,	fail_material, image_width, image_height, image_depth,
-				bytes_per_pixel, number_of_bytes_per_component, use_pixel_location, texture_width, texture_height, texture_depth,
-				storage, propagate_field, Graphics_buffer_package_get_core_package(graphics_buffer_package), search_mesh);
+			if (streaming_tile_sizes && ((0 < streaming_tile_sizes[0]) ||
+				(0 < streaming_tile_sizes[1]) || (0 < streaming_tile_sizes[2])))
+			{
+				if (use_pixel_location)
+				{
+					return_code = Texture_evaluate_field_image_streamed(texture, field,
+						spectrum, fail_material, image_width, image_height, image_depth,
+						storage, number_of_bytes_per_component, texture_width,
+						texture_height, texture_depth, streaming_tile_sizes,
+						number_of_threads);
+				}
+				else
+				{
+					display_message(ERROR_MESSAGE, "Image filter streaming needs the "
+						"native texture coordinates of the field");
+					return_code = 0;
+				}
+			}
+			else
+			{
+				struct Image_filter_cache_store *image_filter_cache_store =
+					(image_filter_cache && use_pixel_location) ?
+					Image_filter_cache_begin_store(image_filter_cache, field,
+						texture_coordinate_field, image_width, image_height, image_depth) : 0;
+				return_code = Texture_evaluate_field_image(texture, field,
+					texture_coordinate_field, propagate_field, use_pixel_location, spectrum,
+					fail_material, image_width, image_height, image_depth, storage,
+					number_of_bytes_per_component, texture_width, texture_height,
+					texture_depth, search_mesh, number_of_threads,
+					image_filter_cache_store ? Image_filter_cache_store_values : 0,
+					static_cast<void *>(image_filter_cache_store));
+				if (image_filter_cache_store)
+					Image_filter_cache_end_store(image_filter_cache, &image_filter_cache_store);
+			}
 		}
 		else
 		{
@@ -2757,7 +2825,9 @@ struct Texture_evaluate_image_data
 	cmzn_field_group_id group;
 	char *field_name, *texture_coordinates_field_name;
 	int element_dimension; /* where 0 is any dimension */
+	int number_of_threads; /* where 0 is the number of processors */
 	int propagate_field;
+	int streaming_tile_size[3]; /* all 0 to evaluate the whole image at once */
 	struct Computed_field *field, *texture_coordinates_field;
 	cmzn_material *fail_material;
 	struct cmzn_spectrum *spectrum;
@@ -2766,7 +2836,7 @@ struct Texture_evaluate_image_data
 static int gfx_modify_Texture_evaluate_image(struct Parse_state *state,
 	void *data_void, void *command_data_void)
 /*******************************************************************************
-LAST MODIFIED : 16 May 2003
+LAST MODIFIED : 16 October 2026
 
 DESCRIPTION :
 Modifies the properties of a texture.
@@ -2784,6 +2854,16 @@ Modifies the properties of a texture.
 		if (state->current_token)
 		{
 			option_table = CREATE(Option_table)();
+			Option_table_add_help(option_table,
+				"Set the texture image from the colours of a field through a spectrum, "
+				"at the locations where the texture_coordinates field matches each texel. "
+				"Fields are evaluated on the main thread; up to threads threads, by "
+				"default the number of processors, convert their values to pixels. "
+				"A positive streaming_tile_size evaluates a chain of image filters one "
+				"tile of that many texels at a time, at the native resolution of the "
+				"field. Chains including curvature_anisotropic_diffusion_filter or "
+				"canny_edge_detection_filter are rejected when streaming, as their "
+				"result at a texel depends on the whole image.");
 			/* element_dimension */
 			Option_table_add_entry(option_table, "element_dimension",
 				&data->element_dimension, NULL, set_element_dimension_or_all);
@@ -2802,9 +2882,16 @@ Modifies the properties of a texture.
 			/* spectrum */
 			Option_table_add_entry(option_table, "spectrum", &data->spectrum,
 				command_data->spectrum_manager, set_Spectrum);
+			/* streaming_tile_size */
+			int number_of_tile_sizes = 3;
+			Option_table_add_int_vector_entry(option_table, "streaming_tile_size",
+				data->streaming_tile_size, &number_of_tile_sizes);
 			/* texture_coordinates */
 			Option_table_add_entry(option_table, "texture_coordinates",
 				&data->texture_coordinates_field_name, (void *)1, set_name);
+			/* threads */
+			Option_table_add_int_non_negative_entry(option_table, "threads",
+				&data->number_of_threads);
 
 			return_code = Option_table_multi_parse(option_table, state);
 			DESTROY(Option_table)(&option_table);
@@ -3024,7 +3111,8 @@ Modifies the properties of a texture.
 	double alpha, distortion_centre_x, distortion_centre_y,
 		distortion_factor_k1, mipmap_level_of_detail_bias;
 	float mipmap_level_of_detail_bias_flt;
-	int file_number, i, number_of_file_names, number_of_valid_strings, process,
+	int file_number, i, number_of_components, number_of_file_names,
+		number_of_slices_read, number_of_valid_strings, process,
 		return_code, specify_depth, specify_height,
 		specify_number_of_bytes_per_component, specify_width, texture_is_managed = 0;
 	struct Cmgui_image *cmgui_image;
@@ -3192,7 +3280,11 @@ Modifies the properties of a texture.
 					evaluate_data.region = cmzn_region_access(command_data->root_region);
 					evaluate_data.group = (cmzn_field_group_id)0;
 					evaluate_data.element_dimension = 0; /* dimension == number of texture coordinates components */
+					evaluate_data.number_of_threads = 0;
 					evaluate_data.propagate_field = 1;
+					evaluate_data.streaming_tile_size[0] = 0;
+					evaluate_data.streaming_tile_size[1] = 0;
+					evaluate_data.streaming_tile_size[2] = 0;
 					evaluate_data.field = (struct Computed_field *)NULL;
 					evaluate_data.texture_coordinates_field =
 						(struct Computed_field *)NULL;
@@ -3466,37 +3558,35 @@ Modifies the properties of a texture.
 							{
 								case TEXTURE_LUMINANCE:
 								{
-									Cmgui_image_information_set_number_of_components(
-										cmgui_image_information, 1);
+									number_of_components = 1;
 								} break;
 								case TEXTURE_LUMINANCE_ALPHA:
 								{
-									Cmgui_image_information_set_number_of_components(
-										cmgui_image_information, 2);
+									number_of_components = 2;
 								} break;
 								case TEXTURE_RGB:
 								case TEXTURE_BGR:
 								{
-									Cmgui_image_information_set_number_of_components(
-										cmgui_image_information, 3);
+									number_of_components = 3;
 								} break;
 								case TEXTURE_RGBA:
-								{
-									Cmgui_image_information_set_number_of_components(
-										cmgui_image_information, 4);
-								} break;
 								case TEXTURE_ABGR:
 								{
-									Cmgui_image_information_set_number_of_components(
-										cmgui_image_information, 4);
+									number_of_components = 4;
 								} break;
 								default:
 								{
 									display_message(ERROR_MESSAGE,
 										"gfx modify texture:  Invalid value for specify_format");
+									number_of_components = 0;
 									return_code = 0;
 								} break;
 							}
+							if (number_of_components)
+							{
+								Cmgui_image_information_set_number_of_components(
+									cmgui_image_information, number_of_components);
+							}
 							if (specify_number_of_bytes_per_component)
 							{
 								Cmgui_image_information_set_number_of_bytes_per_component(
@@ -3507,63 +3597,98 @@ Modifies the properties of a texture.
 								Image_file_format image_file_format = UNKNOWN_IMAGE_FILE_FORMAT;
 								Image_file_format_from_file_name(image_data.image_file_name, &image_file_format);
 								cmgui_image = 0;
-								if (image_file_format == ANALYZE_FILE_FORMAT)
+								number_of_file_names = 1;
+								if (0 != file_number_series_data.increment)
 								{
-									cmgui_image = Cmgui_image_read_analyze(cmgui_image_information,
-										CMZN_STREAMINFORMATION_DATA_COMPRESSION_TYPE_DEFAULT);
+									number_of_file_names = 1 + (file_number_series_data.stop -
+										file_number_series_data.start) /
+										file_number_series_data.increment;
 								}
-								else if (image_file_format == ANALYZE_OBJECT_MAP_FORMAT)
+								/* slices already in the texture */
+								number_of_slices_read = 1;
+								if ((1 < number_of_file_names) &&
+									(image_file_format != ANALYZE_FILE_FORMAT) &&
+									(image_file_format != ANALYZE_OBJECT_MAP_FORMAT))
 								{
-									cmgui_image = Cmgui_image_read_analyze_object_map(cmgui_image_information,
-										CMZN_STREAMINFORMATION_DATA_COMPRESSION_TYPE_DEFAULT);
+									/* slices are added to the texture as they are decoded so the
+									 * volume is not held twice */
+									struct Texture_volume_series volume_series;
+									volume_series.file_name_template = image_data.image_file_name;
+									volume_series.file_number_pattern = file_number_pattern;
+									volume_series.start = file_number_series_data.start;
+									volume_series.stop = file_number_series_data.stop;
+									volume_series.increment = file_number_series_data.increment;
+									volume_series.number_of_slices = number_of_file_names;
+									volume_series.width = specify_width;
+									volume_series.height = specify_height;
+									volume_series.number_of_components = number_of_components;
+									volume_series.number_of_bytes_per_component =
+										specify_number_of_bytes_per_component;
+									volume_series.raw_image_storage = raw_image_storage;
+									volume_series.io_stream_package = command_data->io_stream_package;
+									return_code = Texture_volume_series_read(texture, &volume_series,
+										image_data.crop_left_margin, image_data.crop_bottom_margin,
+										image_data.crop_width, image_data.crop_height,
+										/*number_of_threads*/1);
+									number_of_slices_read = number_of_file_names;
 								}
 								else
 								{
-									cmgui_image = Cmgui_image_read(cmgui_image_information);
-								}
-								if (cmgui_image != 0)
-								{
-									char *property, *value;
-
-									return_code = Texture_set_image(texture, cmgui_image,
-										image_data.image_file_name, file_number_pattern,
-										file_number_series_data.start,
-										file_number_series_data.stop,
-										file_number_series_data.increment,
-										image_data.crop_left_margin, image_data.crop_bottom_margin,
-										image_data.crop_width, image_data.crop_height);
-									/* Delete any existing properties as we are modifying */
-									Texture_clear_all_properties(texture);
-									/* Calling get_proprety with wildcard ensures they
-										will be available to the iterator, as well as
-										any other properties */
-									Cmgui_image_get_property(cmgui_image,"exif:*");
-									Cmgui_image_reset_property_iterator(cmgui_image);
-									while ((property = Cmgui_image_get_next_property(
-										cmgui_image)) &&
-										(value = Cmgui_image_get_property(cmgui_image,
-										property)))
+									if (image_file_format == ANALYZE_FILE_FORMAT)
 									{
-										Texture_set_property(texture, property, value);
-										DEALLOCATE(property);
-										DEALLOCATE(value);
+										cmgui_image = Cmgui_image_read_analyze(cmgui_image_information,
+											CMZN_STREAMINFORMATION_DATA_COMPRESSION_TYPE_DEFAULT);
+									}
+									else if (image_file_format == ANALYZE_OBJECT_MAP_FORMAT)
+									{
+										cmgui_image = Cmgui_image_read_analyze_object_map(cmgui_image_information,
+											CMZN_STREAMINFORMATION_DATA_COMPRESSION_TYPE_DEFAULT);
+									}
+									else
+									{
+										cmgui_image = Cmgui_image_read(cmgui_image_information);
+									}
+									if (cmgui_image != 0)
+									{
+										char *property, *value;
+
+										return_code = Texture_set_image(texture, cmgui_image,
+											image_data.image_file_name, file_number_pattern,
+											file_number_series_data.start,
+											file_number_series_data.stop,
+											file_number_series_data.increment,
+											image_data.crop_left_margin, image_data.crop_bottom_margin,
+											image_data.crop_width, image_data.crop_height);
+										/* Delete any existing properties as we are modifying */
+										Texture_clear_all_properties(texture);
+										/* Calling get_proprety with wildcard ensures they
+											will be available to the iterator, as well as
+											any other properties */
+										Cmgui_image_get_property(cmgui_image,"exif:*");
+										Cmgui_image_reset_property_iterator(cmgui_image);
+										while ((property = Cmgui_image_get_next_property(
+											cmgui_image)) &&
+											(value = Cmgui_image_get_property(cmgui_image,
+											property)))
+										{
+											Texture_set_property(texture, property, value);
+											DEALLOCATE(property);
+											DEALLOCATE(value);
+										}
+										DESTROY(Cmgui_image)(&cmgui_image);
+									}
+									else
+									{
+										display_message(ERROR_MESSAGE,
+											"gfx modify texture:  Could not read image file");
+										return_code = 0;
 									}
-									DESTROY(Cmgui_image)(&cmgui_image);
-								}
-								else
-								{
-									display_message(ERROR_MESSAGE,
-										"gfx modify texture:  Could not read image file");
-									return_code = 0;
 								}
-								if (return_code && (0 != file_number_series_data.increment))
+								if (return_code && (number_of_slices_read < number_of_file_names))
 								{
-									number_of_file_names = 1 + (file_number_series_data.stop -
-										file_number_series_data.start) /
-										file_number_series_data.increment;
 									file_number = file_number_series_data.start +
-										file_number_series_data.increment;
-									for (i = 1 ; return_code && (i < number_of_file_names) ; i++)
+										number_of_slices_read*file_number_series_data.increment;
+									for (i = number_of_slices_read ; return_code && (i < number_of_file_names) ; i++)
 									{
 										Cmgui_image_information_set_file_name_series(
 											cmgui_image_information,
@@ -3651,8 +3776,8 @@ Modifies the properties of a texture.
 								specify_format, specify_width,
 								specify_height, specify_depth,
 								specify_number_of_bytes_per_component,
-								command_data->graphics_buffer_package,
-								evaluate_data.fail_material);
+								evaluate_data.fail_material, evaluate_data.number_of_threads,
+								evaluate_data.streaming_tile_size, command_data->image_filter_cache);
 
 							if (texture_copy != texture)
 							{
@@ -5089,6 +5214,54 @@ static int gfx_define_faces(struct Parse_state *state,
 }
 
 
+/**
+ * Executes a GFX DEFINE FIELD command, then passes the field to the image
+ * filter cache so filter results are read from or written to its directory.
+ */
+static int gfx_define_field(struct Parse_state *state,
+	void *dummy_to_be_modified, void *command_data_void)
+{
+	USE_PARAMETER(dummy_to_be_modified);
+	struct cmzn_command_data *command_data = (struct cmzn_command_data *)command_data_void;
+	if (!(state && command_data))
+	{
+		display_message(ERROR_MESSAGE, "gfx_define_field.  Invalid argument(s)");
+		return 0;
+	}
+	char *field_path = 0;
+	if (state->current_token &&
+		strcmp(PARSER_HELP_STRING, state->current_token) &&
+		strcmp(PARSER_RECURSIVE_HELP_STRING, state->current_token))
+	{
+		field_path = duplicate_string(state->current_token);
+	}
+	int return_code = define_Computed_field(state, command_data->root_region,
+		command_data->computed_field_package);
+	if (return_code && field_path && command_data->image_filter_cache)
+	{
+		struct cmzn_region *region = NULL;
+		char *region_path = NULL, *field_name = NULL;
+		if (cmzn_region_get_partial_region_path(command_data->root_region,
+			field_path, &region, &region_path, &field_name) && field_name)
+		{
+			cmzn_fieldmodule_id field_module = cmzn_region_get_fieldmodule(region);
+			cmzn_field_id field = cmzn_fieldmodule_find_field_by_name(field_module, field_name);
+			/* the field is defined even if its result could not be cached */
+			if (field)
+				Image_filter_cache_define_field(command_data->image_filter_cache, field);
+			cmzn_field_destroy(&field);
+			cmzn_fieldmodule_destroy(&field_module);
+		}
+		if (region_path)
+			DEALLOCATE(region_path);
+		if (field_name)
+			DEALLOCATE(field_name);
+	}
+	if (field_path)
+		DEALLOCATE(field_path);
+	return (return_code);
+}
+
 static int execute_command_gfx_define(struct Parse_state *state,
 	void *dummy_to_be_modified,void *command_data_void)
 /*******************************************************************************
@@ -5122,8 +5295,8 @@ Executes a GFX DEFINE command.
 				Option_table_add_entry(option_table, "faces", NULL,
 					command_data_void, gfx_define_faces);
 				/* field */
-				Option_table_add_entry(option_table, "field", command_data->root_region,
-					command_data->computed_field_package, define_Computed_field);
+				Option_table_add_entry(option_table, "field", NULL,
+					command_data_void, gfx_define_field);
 				/* font */
 				Option_table_add_entry(option_table, "font", NULL,
 					fontmodule, gfx_define_font);
@@ -7026,6 +7199,184 @@ Executes a GFX EXPORT IGES command.
 	return (return_code);
 } /* gfx_export_iges */
 
+/***************************************************************************//**
+ * Executes a GFX EXPORT NODAL_VALUES command.
+ */
+static int gfx_export_nodal_values(struct Parse_state *state,
+	void *dummy_to_be_modified, void *command_data_void)
+{
+	int return_code;
+
+	ENTER(gfx_export_nodal_values);
+	USE_PARAMETER(dummy_to_be_modified);
+	cmzn_command_data *command_data = reinterpret_cast<cmzn_command_data *>(command_data_void);
+	if (state && command_data)
+	{
+		cmzn_region_id region = cmzn_region_access(command_data->root_region);
+		char *conditional_field_name = 0;
+		char data_flag = 0;
+		char *file_name = 0;
+		char *format_name = 0;
+		char selected_flag = 0;
+		FE_value time = 0.0;
+		Multiple_strings field_names;
+		Multi_range *node_ranges = CREATE(Multi_range)();
+
+		Option_table *option_table = CREATE(Option_table)();
+		Option_table_add_help(option_table,
+			"Write the values of the listed <fields> at nodes, or at data points "
+			"with <data>, to FILE_NAME as comma separated text or binary doubles. "
+			"Each row holds the node identifier followed by the field components. "
+			"Output is restricted to nodes in the <region>, and optionally to "
+			"<selected> nodes, nodes where the <conditional> field is true and "
+			"nodes with identifiers in the given ranges.");
+		/* conditional */
+		Option_table_add_string_entry(option_table, "conditional", &conditional_field_name,
+			" FIELD_NAME");
+		/* data */
+		Option_table_add_char_flag_entry(option_table, "data", &data_flag);
+		/* fields */
+		Option_table_add_multiple_strings_entry(option_table, "fields",
+			&field_names, "FIELD_NAME [& FIELD_NAME [& ...]]");
+		/* file */
+		Option_table_add_entry(option_table, "file", &file_name,
+			(void *)1, set_name);
+		/* format */
+		Option_table_add_string_entry(option_table, "format", &format_name,
+			" csv|binary");
+		/* region */
+		Option_table_add_set_cmzn_region(option_table, "region",
+			command_data->root_region, &region);
+		/* selected */
+		Option_table_add_char_flag_entry(option_table, "selected", &selected_flag);
+		/* time */
+		Option_table_add_entry(option_table, "time", &time, (void*)NULL, set_FE_value);
+		/* default option: node number ranges */
+		Option_table_add_entry(option_table, (char *)NULL, (void *)node_ranges,
+			NULL, set_Multi_range);
+		return_code = Option_table_multi_parse(option_table, state);
+		DESTROY(Option_table)(&option_table);
+		if (return_code)
+		{
+			enum Nodal_values_file_format format = NODAL_VALUES_FILE_FORMAT_CSV;
+			if (format_name && fuzzy_string_compare(format_name, "binary"))
+			{
+				format = NODAL_VALUES_FILE_FORMAT_BINARY;
+			}
+			else if (format_name && !fuzzy_string_compare(format_name, "csv"))
+			{
+				display_message(ERROR_MESSAGE,
+					"gfx export nodal_values:  Unknown format '%s'", format_name);
+				return_code = 0;
+			}
+			if (!file_name)
+			{
+				display_message(ERROR_MESSAGE,
+					"gfx export nodal_values:  Must specify file name");
+				return_code = 0;
+			}
+			if (0 == field_names.number_of_strings)
+			{
+				display_message(ERROR_MESSAGE,
+					"gfx export nodal_values:  Must specify fields");
+				return_code = 0;
+			}
+			cmzn_fieldmodule_id field_module = cmzn_region_get_fieldmodule(region);
+			cmzn_field_id conditional_field = 0;
+			if (return_code && conditional_field_name)
+			{
+				conditional_field = cmzn_fieldmodule_find_field_by_name(field_module, conditional_field_name);
+				if (!conditional_field)
+				{
+					display_message(ERROR_MESSAGE,
+						"gfx export nodal_values:  conditional field cannot be found");
+					return_code = 0;
+				}
+			}
+			std::vector<cmzn_field_id> fields(field_names.number_of_strings, static_cast<cmzn_field_id>(0));
+			for (int i = 0; return_code && (i < field_names.number_of_strings); ++i)
+			{
+				fields[i] = cmzn_fieldmodule_find_field_by_name(field_module, field_names.strings[i]);
+				if (!fields[i])
+				{
+					display_message(ERROR_MESSAGE,
+						"gfx export nodal_values:  Field '%s' cannot be found", field_names.strings[i]);
+					return_code = 0;
+				}
+			}
+			if (return_code)
+			{
+				cmzn_nodeset_id nodeset = cmzn_fieldmodule_find_nodeset_by_field_domain_type(field_module,
+					data_flag ? CMZN_FIELD_DOMAIN_TYPE_DATAPOINTS : CMZN_FIELD_DOMAIN_TYPE_NODES);
+				if (selected_flag)
+				{
+					cmzn_nodeset_id selection_nodeset = 0;
+					cmzn_scene *scene = cmzn_region_get_scene(region);
+					cmzn_field_id selection_field = cmzn_scene_get_selection_field(scene);
+					cmzn_field_group_id selection_group = cmzn_field_cast_group(selection_field);
+					cmzn_field_destroy(&selection_field);
+					if (selection_group)
+					{
+						cmzn_field_node_group_id selection_node_group =
+							cmzn_field_group_get_field_node_group(selection_group, nodeset);
+						if (selection_node_group)
+						{
+							selection_nodeset = cmzn_nodeset_group_base_cast(
+								cmzn_field_node_group_get_nodeset_group(selection_node_group));
+							cmzn_field_node_group_destroy(&selection_node_group);
+						}
+					}
+					cmzn_field_group_destroy(&selection_group);
+					cmzn_scene_destroy(&scene);
+					cmzn_nodeset_destroy(&nodeset);
+					nodeset = selection_nodeset;
+				}
+				if (nodeset)
+				{
+					int number_of_nodes = 0;
+					return_code = export_nodal_values_file_of_name(file_name, nodeset, node_ranges,
+						conditional_field, field_names.number_of_strings, &(fields[0]), time,
+						format, &number_of_nodes);
+					if (return_code && (0 == number_of_nodes))
+					{
+						display_message(WARNING_MESSAGE, data_flag ?
+							"gfx export nodal_values:  No data written" :
+							"gfx export nodal_values:  No nodes written");
+					}
+					cmzn_nodeset_destroy(&nodeset);
+				}
+				else
+				{
+					display_message(WARNING_MESSAGE, data_flag ?
+						"gfx export nodal_values:  No data selected" :
+						"gfx export nodal_values:  No nodes selected");
+				}
+			}
+			for (size_t i = 0; i < fields.size(); ++i)
+				cmzn_field_destroy(&(fields[i]));
+			cmzn_field_destroy(&conditional_field);
+			cmzn_fieldmodule_destroy(&field_module);
+		}
+		DESTROY(Multi_range)(&node_ranges);
+		if (format_name)
+			DEALLOCATE(format_name);
+		if (file_name)
+			DEALLOCATE(file_name);
+		if (conditional_field_name)
+			DEALLOCATE(conditional_field_name);
+		cmzn_region_destroy(&region);
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"gfx_export_nodal_values.  Invalid argument(s)");
+		return_code = 0;
+	}
+	LEAVE;
+
+	return (return_code);
+} /* gfx_export_nodal_values */
+
 static int gfx_export_stl(struct Parse_state *state,
 	void *dummy_to_be_modified,void *command_data_void)
 /*******************************************************************************
@@ -7122,7 +7473,7 @@ static int gfx_export_threejs(struct Parse_state *state,
 			int number_of_time_steps = 0;
 			enum cmzn_streaminformation_scene_io_data_type export_mode =
 				CMZN_STREAMINFORMATION_SCENE_IO_DATA_TYPE_COLOUR;
-			char morphVertices = 0,  morphColours = 0, morphNormals = 0;
+			char binary = 0, morphVertices = 0,  morphColours = 0, morphNormals = 0;
 			cmzn_scenefilter_id filter =
 				cmzn_scenefiltermodule_get_default_scenefilter(command_data->filter_module);
 			option_table = CREATE(Option_table)();
@@ -7141,7 +7492,15 @@ static int gfx_export_threejs(struct Parse_state *state,
 				"[filter] applies the filter the provided scene."
 				"[morph_vertices] determines rather vertices will be output for each time step;"
 				"[morph_colours] determines rather colours will be output for each time step; "
-				"[morph_normals] determines rather normals will be output for each time step; ");
+				"[morph_normals] determines rather normals will be output for each time step; "
+				"[binary] writes large numeric arrays of each graphics to a [file_prefix]_N.bin file "
+				"referenced from its json by glTF-style accessors, to reduce file size and load time. "
+				"Binary values are 32-bit: non-integer values such as coordinates are narrowed to "
+				"single precision floats, keeping about 7 significant digits, so use the default "
+				"json output where full double precision matters. The json files are written first "
+				"and then read back and rewritten, so binary export does more file I/O. ");
+			Option_table_add_char_flag_entry(option_table,
+				"binary", &binary);
 			/* file */
 			Option_table_add_entry(option_table, "file_prefix", &file_prefix,
 				(void *)1, set_name);
@@ -7172,7 +7531,8 @@ static int gfx_export_threejs(struct Parse_state *state,
 					{
 						return_code = scene_app_export_threejs(scene, filter, file_prefix,
 							(int)number_of_time_steps, begin_time, end_time, export_mode,
-							morphVertices ? 1 : 0, morphColours ? 1 :0, morphNormals ? 1 : 0);
+							morphVertices ? 1 : 0, morphColours ? 1 :0, morphNormals ? 1 : 0,
+							binary ? 1 : 0);
 					}
 					else
 					{
@@ -7674,6 +8034,8 @@ Executes a GFX EXPORT command.
 			command_data_void, gfx_export_cm);
 		Option_table_add_entry(option_table,"iges",NULL,
 			command_data_void, gfx_export_iges);
+		Option_table_add_entry(option_table,"nodal_values",NULL,
+			command_data_void, gfx_export_nodal_values);
 		Option_table_add_entry(option_table,"stl",NULL,
 			command_data_void, gfx_export_stl);
 		Option_table_add_entry(option_table,"threejs",NULL,
@@ -8361,6 +8723,32 @@ static int gfx_list_btree_statistics(struct Parse_state *state,
 	return (return_code);
 }
 
+static int gfx_list_image_cache(struct Parse_state *state,
+	void *dummy_to_be_modified, void *command_data_void)
+{
+	int return_code = 0;
+	USE_PARAMETER(dummy_to_be_modified);
+	struct cmzn_command_data *command_data = (struct cmzn_command_data *)command_data_void;
+	if (state && command_data)
+	{
+		char clear_flag = 0;
+		Option_table *option_table = CREATE(Option_table)();
+		Option_table_add_help(option_table,
+			"List the directory and use of the image filter result cache set with "
+			"gfx set image_cache. Optionally delete all results in it.");
+		Option_table_add_char_flag_entry(option_table, "clear", &clear_flag);
+		return_code = Option_table_multi_parse(option_table, state);
+		DESTROY(Option_table)(&option_table);
+		if (return_code && command_data->image_filter_cache)
+		{
+			Image_filter_cache_list(command_data->image_filter_cache);
+			if (clear_flag)
+				Image_filter_cache_clear(command_data->image_filter_cache);
+		}
+	}
+	return (return_code);
+}
+
 static int gfx_list_environment_map(struct Parse_state *state,
 	void *dummy_to_be_modified,void *command_data_void)
 /*******************************************************************************
@@ -8444,8 +8832,6 @@ Executes a GFX LIST FIELD.
 	struct cmzn_region *root_region;
 	struct cmzn_region_path_and_name region_path_and_name;
 	struct Computed_field *field;
-	struct List_Computed_field_commands_data list_commands_data;
-	struct LIST(Computed_field) *list_of_fields;
 	struct Option_table *option_table;
 
 	ENTER(gfx_list_Computed_field);
@@ -8514,26 +8900,10 @@ Executes a GFX LIST FIELD.
 					}
 					else
 					{
-						if (NULL != (list_of_fields = CREATE(LIST(Computed_field))()))
-						{
-							list_commands_data.command_prefix = command_prefix_plus_region_path;
-							list_commands_data.listed_fields = 0;
-							list_commands_data.computed_field_list = list_of_fields;
-							list_commands_data.computed_field_manager =
-								cmzn_region_get_Computed_field_manager(region_path_and_name.region);
-							while (FOR_EACH_OBJECT_IN_MANAGER(Computed_field)(
-								list_Computed_field_commands_if_managed_source_fields_in_list,
-								(void *)&list_commands_data, cmzn_region_get_Computed_field_manager(region_path_and_name.region)) &&
-								(0 != list_commands_data.listed_fields))
-							{
-								list_commands_data.listed_fields = 0;
-							}
-							DESTROY(LIST(Computed_field))(&list_of_fields);
-						}
-						else
-						{
-							return_code=0;
-						}
+						Process_list_command_class list_message;
+						return_code = process_list_or_write_Computed_field_commands_in_dependency_order(
+							cmzn_region_get_Computed_field_manager(region_path_and_name.region),
+							command_prefix_plus_region_path, &list_message);
 					}
 					DEALLOCATE(command_prefix_plus_region_path);
 				}
@@ -8680,15 +9050,17 @@ Executes a GFX LIST ELEMENT.
 				{
 					iteration_mesh = cmzn_mesh_group_base_cast(selection_mesh_group);
 				}
-				const bool use_element_ranges = Multi_range_get_number_of_ranges(element_ranges) > 0;
+				struct Identifier_set *element_identifiers = (Multi_range_get_number_of_ranges(element_ranges) > 0) ?
+					Identifier_set_create_from_Multi_range(element_ranges) : 0;
 				if (Multi_range_get_total_number_in_ranges(element_ranges) == 1)
 					verbose_flag = 1;
-				Multi_range *output_element_ranges = CREATE(Multi_range)();
+				/* identifiers are mostly visited in increasing order so appending is fast */
+				struct Identifier_set *output_element_identifiers = CREATE(Identifier_set)();
 				cmzn_elementiterator_id iter = cmzn_mesh_create_elementiterator(iteration_mesh);
 				cmzn_element_id element = 0;
 				while (NULL != (element = cmzn_elementiterator_next_non_access(iter)))
 				{
-					if (use_element_ranges && !Multi_range_is_value_in_range(element_ranges, cmzn_element_get_identifier(element)))
+					if (element_identifiers && !Identifier_set_contains(element_identifiers, cmzn_element_get_identifier(element)))
 						continue;
 					if (conditional_field)
 					{
@@ -8702,8 +9074,7 @@ Executes a GFX LIST ELEMENT.
 					}
 					else
 					{
-						int element_identifier = cmzn_element_get_identifier(element);
-						Multi_range_add_range(output_element_ranges, element_identifier, element_identifier);
+						Identifier_set_add(output_element_identifiers, cmzn_element_get_identifier(element));
 					}
 					++number_of_elements_listed;
 				}
@@ -8722,10 +9093,15 @@ Executes a GFX LIST ELEMENT.
 					{
 						display_message(INFORMATION_MESSAGE, "Elements (dimension %d):\n", use_dimension);
 					}
+					Multi_range *output_element_ranges = CREATE(Multi_range)();
+					Identifier_set_add_to_Multi_range(output_element_identifiers, output_element_ranges);
 					return_code = Multi_range_display_ranges(output_element_ranges);
+					DESTROY(Multi_range)(&output_element_ranges);
 					display_message(INFORMATION_MESSAGE, "Total number = %d\n", number_of_elements_listed);
 				}
-				DESTROY(Multi_range)(&output_element_ranges);
+				DESTROY(Identifier_set)(&output_element_identifiers);
+				if (element_identifiers)
+					DESTROY(Identifier_set)(&element_identifiers);
 				cmzn_fieldcache_destroy(&cache);
 			}
 			if (0 == number_of_elements_listed)
@@ -8852,15 +9228,17 @@ use node_manager and node_selection.
 				{
 					iteration_nodeset = cmzn_nodeset_group_base_cast(selection_nodeset_group);
 				}
-				const bool use_node_ranges = Multi_range_get_number_of_ranges(node_ranges) > 0;
+				struct Identifier_set *node_identifiers = (Multi_range_get_number_of_ranges(node_ranges) > 0) ?
+					Identifier_set_create_from_Multi_range(node_ranges) : 0;
 				if (Multi_range_get_total_number_in_ranges(node_ranges) == 1)
 					verbose_flag = 1;
-				Multi_range *output_node_ranges = CREATE(Multi_range)();
+				/* identifiers are mostly visited in increasing order so appending is fast */
+				struct Identifier_set *output_node_identifiers = CREATE(Identifier_set)();
 				cmzn_nodeiterator_id iter = cmzn_nodeset_create_nodeiterator(iteration_nodeset);
 				cmzn_node_id node = 0;
 				while (NULL != (node = cmzn_nodeiterator_next_non_access(iter)))
 				{
-					if (use_node_ranges && !Multi_range_is_value_in_range(node_ranges, cmzn_node_get_identifier(node)))
+					if (node_identifiers && !Identifier_set_contains(node_identifiers, cmzn_node_get_identifier(node)))
 						continue;
 					if (conditional_field)
 					{
@@ -8874,8 +9252,7 @@ use node_manager and node_selection.
 					}
 					else
 					{
-						int node_identifier = cmzn_node_get_identifier(node);
-						Multi_range_add_range(output_node_ranges, node_identifier, node_identifier);
+						Identifier_set_add(output_node_identifiers, cmzn_node_get_identifier(node));
 					}
 					++number_of_nodes_listed;
 				}
@@ -8883,10 +9260,15 @@ use node_manager and node_selection.
 				if ((!verbose_flag) && number_of_nodes_listed)
 				{
 					display_message(INFORMATION_MESSAGE, use_data ? "Data:\n" : "Nodes:\n");
+					Multi_range *output_node_ranges = CREATE(Multi_range)();
+					Identifier_set_add_to_Multi_range(output_node_identifiers, output_node_ranges);
 					return_code = Multi_range_display_ranges(output_node_ranges);
+					DESTROY(Multi_range)(&output_node_ranges);
 					display_message(INFORMATION_MESSAGE, "Total number = %d\n", number_of_nodes_listed);
 				}
-				DESTROY(Multi_range)(&output_node_ranges);
+				DESTROY(Identifier_set)(&output_node_identifiers);
+				if (node_identifiers)
+					DESTROY(Identifier_set)(&node_identifiers);
 				cmzn_fieldcache_destroy(&cache);
 			}
 			if (0 == number_of_nodes_listed)
@@ -9918,12 +10300,13 @@ DESCRIPTION :
 Executes a GFX LIST WINDOW.
 ==============================================================================*/
 {
-	char commands_flag;
+	char commands_flag,statistics_flag;
 	int return_code;
 	static struct Modifier_entry option_table[]=
 	{
 		{"commands",NULL,NULL,set_char_flag},
 		{"name",NULL,NULL,set_Graphics_window},
+		{"statistics",NULL,NULL,set_char_flag},
 		{NULL,NULL,NULL,set_Graphics_window}
 	};
 	struct Graphics_window *window;
@@ -9937,16 +10320,31 @@ Executes a GFX LIST WINDOW.
 			(struct MANAGER(Graphics_window) *)graphics_window_manager_void))
 		{
 			commands_flag=0;
+			statistics_flag=0;
 			/* if no window specified, list all windows */
 			window=(struct Graphics_window *)NULL;
 			(option_table[0]).to_be_modified= &commands_flag;
 			(option_table[1]).to_be_modified= &window;
 			(option_table[1]).user_data= graphics_window_manager_void;
-			(option_table[2]).to_be_modified= &window;
-			(option_table[2]).user_data= graphics_window_manager_void;
+			(option_table[2]).to_be_modified= &statistics_flag;
+			(option_table[3]).to_be_modified= &window;
+			(option_table[3]).user_data= graphics_window_manager_void;
 			if (0 != (return_code = process_multiple_options(state,option_table)))
 			{
-				if (commands_flag)
+				if (statistics_flag)
+				{
+					if (window)
+					{
+						return_code=list_Graphics_window_statistics(window,(void *)NULL);
+					}
+					else
+					{
+						return_code=FOR_EACH_OBJECT_IN_MANAGER(Graphics_window)(
+							list_Graphics_window_statistics,(void *)NULL,
+							graphics_window_manager);
+					}
+				}
+				else if (commands_flag)
 				{
 					if (window)
 					{
@@ -10062,6 +10460,9 @@ Executes a GFX LIST command.
 			/* group */
 			Option_table_add_entry(option_table, "group", (void *)0,
 				command_data->root_region, gfx_list_group);
+			/* image_cache */
+			Option_table_add_entry(option_table, "image_cache", NULL,
+				command_data_void, gfx_list_image_cache);
 			/* light */
 			Option_table_add_entry(option_table, "light", NULL,
 				cmzn_lightmodule_get_manager(command_data->lightmodule), gfx_list_light);
@@ -10776,11 +11177,12 @@ static int gfx_modify_node_group(struct Parse_state *state,
 					}
 
 					cmzn_nodeiterator_id iter = cmzn_nodeset_create_nodeiterator(iteration_nodeset);
-					const bool use_node_ranges = Multi_range_get_number_of_ranges(node_ranges) > 0;
+					struct Identifier_set *node_identifiers = (Multi_range_get_number_of_ranges(node_ranges) > 0) ?
+						Identifier_set_create_from_Multi_range(node_ranges) : 0;
 					cmzn_node_id node = 0;
 					while (NULL != (node = cmzn_nodeiterator_next_non_access(iter)))
 					{
-						if (use_node_ranges && !Multi_range_is_value_in_range(node_ranges, cmzn_node_get_identifier(node)))
+						if (node_identifiers && !Identifier_set_contains(node_identifiers, cmzn_node_get_identifier(node)))
 							continue;
 						if (selection_nodeset && (selection_nodeset != iteration_nodeset) && !cmzn_nodeset_contains_node(selection_nodeset, node))
 							continue;
@@ -10815,6 +11217,8 @@ static int gfx_modify_node_group(struct Parse_state *state,
 						}
 					}
 					cmzn_nodeiterator_destroy(&iter);
+					if (node_identifiers)
+						DESTROY(Identifier_set)(&node_identifiers);
 					cmzn_fieldcache_destroy(&cache);
 					cmzn_nodeset_group_destroy(&modify_nodeset_group);
 					cmzn_field_node_group_destroy(&modify_node_group);
@@ -11090,11 +11494,12 @@ static int gfx_modify_nodes(struct Parse_state *state,
 				cmzn_fieldcache_id cache = cmzn_fieldmodule_create_fieldcache(field_module);
 				cmzn_fieldcache_set_time(cache, time);
 				cmzn_nodeiterator_id iter = cmzn_nodeset_create_nodeiterator(nodeset);
-				const bool use_node_ranges = Multi_range_get_number_of_ranges(node_ranges) > 0;
+				struct Identifier_set *node_identifiers = (Multi_range_get_number_of_ranges(node_ranges) > 0) ?
+					Identifier_set_create_from_Multi_range(node_ranges) : 0;
 				cmzn_node_id node = 0;
 				while (NULL != (node = cmzn_nodeiterator_next_non_access(iter)))
 				{
-					if (use_node_ranges && !Multi_range_is_value_in_range(node_ranges, cmzn_node_get_identifier(node)))
+					if (node_identifiers && !Identifier_set_contains(node_identifiers, cmzn_node_get_identifier(node)))
 						continue;
 					if (conditional_field || selection_field)
 					{
@@ -11113,6 +11518,8 @@ static int gfx_modify_nodes(struct Parse_state *state,
 					++nodes_processed;
 				}
 				cmzn_nodeiterator_destroy(&iter);
+				if (node_identifiers)
+					DESTROY(Identifier_set)(&node_identifiers);
 				cmzn_fieldcache_destroy(&cache);
 				cmzn_fieldmodule_end_change(field_module);
 			}
@@ -11362,37 +11769,194 @@ Which tool that is being modified is passed in <node_tool_void>.
 			  (WIN32_USER_INTERFACE) || defined (CARBON_USER_INTERFACE) || defined(WX_USER_INTERFACE */
 
 #if defined (GTK_USER_INTERFACE) || defined (WIN32_USER_INTERFACE) || defined (WX_USER_INTERFACE)
-static int execute_command_gfx_print(struct Parse_state *state,
-	void *dummy_to_be_modified,void *command_data_void)
+static int gfx_print_write_tile(int left, int bottom, int width, int height,
+	unsigned char *pixels, void *writer_void)
 /*******************************************************************************
-LAST MODIFIED : 23 April 2002
+LAST MODIFIED : 16 October 2026
 
 DESCRIPTION :
-Executes a GFX PRINT command.
+Graphics_window_frame_tile_function passing tiles to a Tiled_image_writer.
 ==============================================================================*/
 {
-	char *file_name, force_onscreen_flag;
-	const char*image_file_format_string, **valid_strings;
-	enum Image_file_format image_file_format;
-	enum Texture_storage_type storage;
-	int antialias, height, number_of_valid_strings, return_code,
-		transparency_layers, width;
-	struct Cmgui_image *cmgui_image;
-	struct Cmgui_image_information *cmgui_image_information;
-	struct cmzn_command_data *command_data;
-	struct Graphics_window *window;
-	struct Option_table *option_table;
+	return Tiled_image_writer_add_tile((struct Tiled_image_writer *)writer_void,
+		left, bottom, width, height, pixels);
+}
 
-	ENTER(execute_command_gfx_print);
-	USE_PARAMETER(dummy_to_be_modified);
-	if (state && (command_data=(struct cmzn_command_data *)command_data_void))
-	{
-		/* initialize defaults */
-		antialias = -1;
+static int gfx_print_stream(struct Graphics_window *window,
+	const char *file_name, enum Texture_storage_type storage, int width,
+	int height, int antialias, int transparency_layers)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Draws <window> offscreen in tiles and writes each band of tiles straight to
+<file_name>, so the whole image is never held in memory.
+==============================================================================*/
+{
+	int number_of_components, return_code;
+	struct Tiled_image_writer *writer;
+
+	ENTER(gfx_print_stream);
+	return_code = 0;
+	if (!Tiled_image_writer_file_name_is_supported(file_name))
+	{
+		display_message(ERROR_MESSAGE, "gfx print stream:  File %s must be a TIFF "
+			"(.tif, .tiff) or PNM (.pgm, .ppm, .pnm, .pam) file", file_name);
+	}
+	else if (1 != Graphics_window_layout_mode_get_number_of_panes(
+		Graphics_window_get_layout_mode(window)))
+	{
+		display_message(ERROR_MESSAGE,
+			"gfx print stream:  Only single pane layouts can be streamed");
+	}
+	else
+	{
+		if (!(width && height))
+		{
+			Graphics_window_get_viewing_area_size(window, &width, &height);
+		}
+		number_of_components =
+			Texture_storage_type_get_number_of_components(storage);
+		if (NULL != (writer = CREATE(Tiled_image_writer)(file_name, width, height,
+			number_of_components)))
+		{
+			if (Graphics_window_render_frame_tiles(window, storage, &width, &height,
+				antialias, transparency_layers, gfx_print_write_tile, (void *)writer))
+			{
+				return_code = Tiled_image_writer_finish(writer);
+			}
+			DESTROY(Tiled_image_writer)(&writer);
+		}
+		if (!return_code)
+		{
+			display_message(ERROR_MESSAGE,
+				"gfx print:  Error writing image %s", file_name);
+		}
+	}
+	LEAVE;
+
+	return (return_code);
+} /* gfx_print_stream */
+
+static int gfx_print_movie(struct cmzn_command_data *command_data,
+	struct Graphics_window *window, const char *file_pattern,
+	enum Texture_storage_type storage, int width, int height, int antialias,
+	int transparency_layers, double start_time, double end_time,
+	int number_of_frames, double frame_rate)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Draws <number_of_frames> frames of <window> offscreen at times evenly spaced
+from <start_time> to <end_time> and writes them with a Frame_sequence_writer.
+The offscreen buffers are kept for all frames and only graphics changed by the
+new time are rebuilt. Each frame is encoded on a background thread while the
+next is drawn. The time is restored afterwards.
+==============================================================================*/
+{
+	double original_time;
+	int frame, return_code;
+	struct Frame_sequence_writer *writer;
+	struct Graphics_window_frame_renderer *renderer;
+	unsigned char *frame_data;
+
+	ENTER(gfx_print_movie);
+	return_code = 0;
+	if (!Frame_sequence_writer_file_pattern_is_valid(file_pattern))
+	{
+		display_message(ERROR_MESSAGE, "gfx print:  file_pattern %s must contain "
+			"one frame number such as %%04d, or end in .y4m", file_pattern);
+	}
+	else if (NULL == (renderer = CREATE(Graphics_window_frame_renderer)(window,
+		storage, &width, &height, antialias, transparency_layers)))
+	{
+		display_message(ERROR_MESSAGE,
+			"gfx print:  Could not create offscreen buffer for frames");
+	}
+	else
+	{
+		if (NULL != (writer = CREATE(Frame_sequence_writer)(file_pattern, width,
+			height, Texture_storage_type_get_number_of_components(storage),
+			frame_rate, /*queue_length*/4, command_data->io_stream_package)))
+		{
+			original_time =
+				command_data->default_time_keeper_app->getTimeKeeper()->getTime();
+			return_code = 1;
+			for (frame = 0; return_code && (frame < number_of_frames); frame++)
+			{
+				if (1 < number_of_frames)
+				{
+					command_data->default_time_keeper_app->requestNewTime(start_time +
+						(double)frame*(end_time - start_time)/(double)(number_of_frames - 1));
+				}
+				else
+				{
+					command_data->default_time_keeper_app->requestNewTime(start_time);
+				}
+				frame_data = (unsigned char *)NULL;
+				return_code = Graphics_window_frame_renderer_get_frame_pixels(renderer,
+					&frame_data) &&
+					Frame_sequence_writer_add_frame(writer, &frame_data);
+				if (frame_data)
+				{
+					DEALLOCATE(frame_data);
+				}
+			}
+			if (!Frame_sequence_writer_finish(writer))
+			{
+				return_code = 0;
+			}
+			DESTROY(Frame_sequence_writer)(&writer);
+			command_data->default_time_keeper_app->requestNewTime(original_time);
+		}
+		if (!return_code)
+		{
+			display_message(ERROR_MESSAGE,
+				"gfx print:  Error writing frames %s", file_pattern);
+		}
+		DESTROY(Graphics_window_frame_renderer)(&renderer);
+	}
+	LEAVE;
+
+	return (return_code);
+} /* gfx_print_movie */
+
+static int execute_command_gfx_print(struct Parse_state *state,
+	void *dummy_to_be_modified,void *command_data_void)
+/*******************************************************************************
+LAST MODIFIED : 23 April 2002
+
+DESCRIPTION :
+Executes a GFX PRINT command.
+==============================================================================*/
+{
+	char *file_name, *file_pattern, force_onscreen_flag, stream_flag;
+	const char*image_file_format_string, **valid_strings;
+	double end_time, frame_rate, start_time;
+	enum Image_file_format image_file_format;
+	enum Texture_storage_type storage;
+	int antialias, height, number_of_frames, number_of_valid_strings,
+		return_code, transparency_layers, width;
+	struct Cmgui_image *cmgui_image;
+	struct Cmgui_image_information *cmgui_image_information;
+	struct cmzn_command_data *command_data;
+	struct Graphics_window *window;
+	struct Option_table *option_table;
+
+	ENTER(execute_command_gfx_print);
+	USE_PARAMETER(dummy_to_be_modified);
+	if (state && (command_data=(struct cmzn_command_data *)command_data_void))
+	{
+		/* initialize defaults */
+		antialias = -1;
 		file_name = (char *)NULL;
+		file_pattern = (char *)NULL;
 		height = 0;
 		force_onscreen_flag = 0;
+		number_of_frames = 0;
+		frame_rate = 25.0;
 		storage = TEXTURE_RGBA;
+		stream_flag = 0;
 		transparency_layers = 0;
 		width = 0;
 		/* default file format is to obtain it from the filename extension */
@@ -11404,11 +11968,30 @@ Executes a GFX PRINT command.
 		{
 			ACCESS(Graphics_window)(window);
 		}
+		start_time = end_time = 0.0;
+		if (command_data->default_time_keeper_app)
+		{
+			start_time = end_time =
+				command_data->default_time_keeper_app->getTimeKeeper()->getTime();
+		}
 
 		option_table = CREATE(Option_table)();
+		Option_table_add_help(option_table,
+			"Write the contents of a graphics window to an image file. Images larger "
+			"than the window are drawn offscreen in tiles. With 'stream' each band of "
+			"tiles is written straight to an uncompressed TIFF or PNM file as it is "
+			"drawn, so very large images need not fit in memory; the file format is "
+			"then given by the file extension. With number_of_frames a movie is made "
+			"from frames at times evenly spaced from start_time to end_time, written "
+			"to image files named by file_pattern with the frame number from 0 in "
+			"place of %d or %04d etc., or to a single uncompressed video stream if "
+			"file_pattern ends in .y4m.");
 		/* antialias */
 		Option_table_add_entry(option_table, "antialias",
 			&antialias, NULL, set_int_positive);
+		/* end_time */
+		Option_table_add_entry(option_table, "end_time",
+			&end_time, NULL, set_double);
 		/* image file format */
 		image_file_format_string =
 			ENUMERATOR_STRING(Image_file_format)(image_file_format);
@@ -11422,15 +12005,30 @@ Executes a GFX PRINT command.
 		/* file */
 		Option_table_add_entry(option_table, "file", &file_name,
 			(void *)1, set_name);
+		/* file_pattern */
+		Option_table_add_entry(option_table, "file_pattern", &file_pattern,
+			(void *)1, set_name);
 		/* force_onscreen */
 		Option_table_add_entry(option_table, "force_onscreen",
 			&force_onscreen_flag, NULL, set_char_flag);
 		/* format */
 		Option_table_add_entry(option_table, "format", &storage,
 			NULL, set_Texture_storage);
+		/* frame_rate */
+		Option_table_add_entry(option_table, "frame_rate",
+			&frame_rate, NULL, set_double);
 		/* height */
 		Option_table_add_entry(option_table, "height",
 			&height, NULL, set_int_non_negative);
+		/* number_of_frames */
+		Option_table_add_entry(option_table, "number_of_frames",
+			&number_of_frames, NULL, set_int_positive);
+		/* start_time */
+		Option_table_add_entry(option_table, "start_time",
+			&start_time, NULL, set_double);
+		/* stream */
+		Option_table_add_entry(option_table, "stream",
+			&stream_flag, NULL, set_char_flag);
 		/* transparency_layers */
 		Option_table_add_entry(option_table, "transparency_layers",
 			&transparency_layers, NULL, set_int_positive);
@@ -11444,7 +12042,34 @@ Executes a GFX PRINT command.
 		return_code = Option_table_multi_parse(option_table, state);
 		DESTROY(Option_table)(&option_table);
 		/* no errors, not asking for help */
-		if (return_code)
+		if (return_code && (number_of_frames || file_pattern))
+		{
+			if (!(number_of_frames && file_pattern))
+			{
+				display_message(ERROR_MESSAGE,
+					"gfx print:  number_of_frames and file_pattern must be given together");
+				return_code = 0;
+			}
+			else if (file_name || stream_flag || force_onscreen_flag)
+			{
+				display_message(ERROR_MESSAGE, "gfx print:  file, stream and "
+					"force_onscreen cannot be used with number_of_frames");
+				return_code = 0;
+			}
+			else if (frame_rate <= 0.0)
+			{
+				display_message(ERROR_MESSAGE,
+					"gfx print:  frame_rate must be positive");
+				return_code = 0;
+			}
+			else if (!(window && command_data->default_time_keeper_app))
+			{
+				display_message(ERROR_MESSAGE,
+					"gfx print:  No graphics windows to print");
+				return_code = 0;
+			}
+		}
+		else if (return_code)
 		{
 			if (!file_name)
 			{
@@ -11465,8 +12090,25 @@ Executes a GFX PRINT command.
 					"gfx print:  No graphics windows to print");
 				return_code = 0;
 			}
+			if (stream_flag && force_onscreen_flag)
+			{
+				display_message(ERROR_MESSAGE,
+					"gfx print:  Cannot stream when forced onscreen");
+				return_code = 0;
+			}
 		}
-		if (return_code)
+		if (return_code && number_of_frames)
+		{
+			return_code = gfx_print_movie(command_data, window, file_pattern,
+				storage, width, height, antialias, transparency_layers, start_time,
+				end_time, number_of_frames, frame_rate);
+		}
+		else if (return_code && stream_flag)
+		{
+			return_code = gfx_print_stream(window, file_name, storage, width, height,
+				antialias, transparency_layers);
+		}
+		else if (return_code)
 		{
 			cmgui_image_information = CREATE(Cmgui_image_information)();
 			if (image_file_format_string)
@@ -11512,6 +12154,10 @@ Executes a GFX PRINT command.
 		{
 			DEALLOCATE(file_name);
 		}
+		if (file_pattern)
+		{
+			DEALLOCATE(file_pattern);
+		}
 	}
 	else
 	{
@@ -11676,6 +12322,61 @@ int offset_region_identifier(cmzn_region_id region, char element_flag, int eleme
 	return return_code;
 }
 
+/**
+ * Parses an EX file into a new private region created from top_region, ready
+ * for merging. Mapped files too large for one IO_stream memory block are
+ * parsed a window at a time, each into its own region merged into the first.
+ * Reports open and read errors.
+ * @return  Accessed parsed region, or NULL on failure.
+ */
+static cmzn_region *read_ex_file_region(struct cmzn_command_data *command_data,
+	cmzn_region *top_region, const char *file_name, int use_data,
+	struct FE_import_time_index *time_index, int use_mmap)
+{
+	const char *file_type = use_data ? "data" : "node or element";
+	cmzn_region *region = 0;
+	struct Mapped_file *mapped_file = 0;
+	struct IO_stream *input_file = IO_stream_open_for_read_mapped(
+		command_data->io_stream_package, file_name, use_mmap, &mapped_file);
+	if (input_file)
+	{
+		region = cmzn_region_create_region(top_region);
+		int return_code = use_data ?
+			read_exdata_file(region, input_file, time_index) :
+			read_exregion_file(region, input_file, time_index);
+		const int number_of_windows = Mapped_file_get_number_of_windows(mapped_file);
+		for (int w = 1; return_code && (w < number_of_windows); ++w)
+		{
+			return_code = IO_stream_open_mapped_window(command_data->io_stream_package,
+				&input_file, mapped_file, w);
+			if (return_code)
+			{
+				cmzn_region *window_region = cmzn_region_create_region(top_region);
+				return_code = (use_data ?
+					read_exdata_file(window_region, input_file, time_index) :
+					read_exregion_file(window_region, input_file, time_index)) &&
+					cmzn_region_can_merge(region, window_region) &&
+					cmzn_region_merge(region, window_region);
+				DEACCESS(cmzn_region)(&window_region);
+			}
+		}
+		if (!return_code)
+		{
+			display_message(ERROR_MESSAGE,
+				"Error reading %s file: %s", file_type, file_name);
+			DEACCESS(cmzn_region)(&region);
+		}
+		IO_stream_close_mapped(command_data->io_stream_package,
+			&input_file, &mapped_file);
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"Could not open %s file: %s", file_type, file_name);
+	}
+	return region;
+}
+
 static int gfx_read_elements(struct Parse_state *state,
 	void *dummy_to_be_modified,void *command_data_void)
 /*******************************************************************************
@@ -11687,17 +12388,15 @@ user, otherwise the elements file is read.
 ==============================================================================*/
 {
 	char *file_name, *region_path,
-		element_flag, face_flag, line_flag, node_flag;
+		element_flag, face_flag, line_flag, node_flag, offset_flag;
 	int element_offset, face_offset, line_offset, node_offset,
-		return_code;
+		return_code, use_mmap;
 	struct cmzn_command_data *command_data;
 	struct cmzn_region *region, *top_region;
-	struct IO_stream *input_file;
 	struct Option_table *option_table;
 
 	ENTER(gfx_read_elements);
 	USE_PARAMETER(dummy_to_be_modified);
-	input_file = NULL;
 	if (state && (command_data = (struct cmzn_command_data *)command_data_void))
 	{
 		element_flag = 0;
@@ -11710,6 +12409,7 @@ user, otherwise the elements file is read.
 		node_offset = 0;
 		file_name = (char *)NULL;
 		region_path = (char *)NULL;
+		use_mmap = command_data->read_mmap;
 		option_table = CREATE(Option_table)();
 		/* element_offset */
 		Option_table_add_entry(option_table, "element_offset", &element_offset,
@@ -11723,6 +12423,8 @@ user, otherwise the elements file is read.
 		/* line_offset */
 		Option_table_add_entry(option_table, "line_offset", &line_offset,
 			&line_flag, set_int_and_char_flag);
+		/* mmap/no_mmap */
+		Option_table_add_switch(option_table, "mmap", "no_mmap", &use_mmap);
 		/* node_offset */
 		Option_table_add_entry(option_table, "node_offset", &node_offset,
 			&node_flag, set_int_and_char_flag);
@@ -11764,101 +12466,485 @@ user, otherwise the elements file is read.
 			top_region = (struct cmzn_region *)NULL;
 			if (region_path)
 			{
-				top_region = cmzn_region_find_subregion_at_path(
-					command_data->root_region, region_path);
-				if (NULL == top_region)
+				top_region = cmzn_region_find_subregion_at_path(
+					command_data->root_region, region_path);
+				if (NULL == top_region)
+				{
+					top_region = cmzn_region_create_subregion(
+						command_data->root_region, region_path);
+					if (NULL == top_region)
+					{
+						display_message(ERROR_MESSAGE, "gfx_read_elements.  "
+							"Unable to find or create region '%s'.", region_path);
+						return_code = 0;
+					}
+				}
+			}
+			else
+			{
+				top_region = ACCESS(cmzn_region)(command_data->root_region);
+			}
+			if (return_code)
+			{
+				offset_flag = (element_flag || face_flag || line_flag || node_flag);
+				region = read_ex_file_region(command_data, top_region, file_name,
+					/*use_data*/0, (struct FE_import_time_index *)NULL, use_mmap);
+				if (region)
+				{
+					if (offset_flag)
+					{
+						return_code = offset_region_identifier(region, element_flag, element_offset, face_flag,
+							face_offset, line_flag, line_offset, node_flag, node_offset, /*use_data*/0);
+					}
+					if (return_code)
+					{
+						if (cmzn_region_can_merge(top_region, region))
+						{
+							if (!cmzn_region_merge(top_region, region))
+							{
+								display_message(ERROR_MESSAGE,
+									"Error merging elements from file: %s", file_name);
+								return_code = 0;
+							}
+						}
+						else
+						{
+							display_message(ERROR_MESSAGE,
+								"Contents of file %s not compatible with global objects",
+								file_name);
+							return_code = 0;
+						}
+					}
+					DEACCESS(cmzn_region)(&region);
+				}
+				else
+				{
+					return_code = 0;
+				}
+			}
+			DEACCESS(cmzn_region)(&top_region);
+		}
+		DESTROY(Option_table)(&option_table);
+		if (file_name)
+		{
+			DEALLOCATE(file_name);
+		}
+		if (region_path)
+		{
+			DEALLOCATE(region_path);
+		}
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE, "gfx_read_elements.  Invalid argument(s)");
+		return_code = 0;
+	}
+	LEAVE;
+
+	return (return_code);
+} /* gfx_read_elements */
+
+struct Read_nodes_series_data
+{
+	char *pattern;
+	int start, stop, increment;
+};
+
+static int set_Read_nodes_series_data(struct Parse_state *state,
+	void *data_void, void *dummy_user_data)
+/*******************************************************************************
+DESCRIPTION :
+Reads PATTERN START STOP INCREMENT for gfx read nodes/data series. Follows the
+same rules for the number range as the texture number_series option.
+==============================================================================*/
+{
+	const char *current_token;
+	int range, return_code;
+	struct Read_nodes_series_data *data;
+
+	ENTER(set_Read_nodes_series_data);
+	USE_PARAMETER(dummy_user_data);
+	if (state && (data = (struct Read_nodes_series_data *)data_void))
+	{
+		return_code = 1;
+		if (NULL != (current_token = state->current_token))
+		{
+			if (strcmp(PARSER_HELP_STRING, current_token) &&
+				strcmp(PARSER_RECURSIVE_HELP_STRING, current_token))
+			{
+				if (data->pattern)
+				{
+					DEALLOCATE(data->pattern);
+				}
+				data->pattern = duplicate_string(current_token);
+				if (data->pattern && shift_Parse_state(state, 1) &&
+					(current_token = state->current_token) &&
+					(1 == sscanf(current_token, " %d", &(data->start))) &&
+					shift_Parse_state(state, 1) &&
+					(current_token = state->current_token) &&
+					(1 == sscanf(current_token, " %d", &(data->stop))) &&
+					shift_Parse_state(state, 1) &&
+					(current_token = state->current_token) &&
+					(1 == sscanf(current_token, " %d", &(data->increment))) &&
+					shift_Parse_state(state, 1))
+				{
+					if (!(((0 < data->increment) &&
+						(0 <= (range = data->stop - data->start)) &&
+						(0 == (range % data->increment))) ||
+						((0 > data->increment) &&
+							(0 <= (range = data->start - data->stop))
+							&& (0 == (range % -data->increment)))))
+					{
+						display_message(ERROR_MESSAGE, "Invalid file number series");
+						display_parse_state_location(state);
+						return_code = 0;
+					}
+				}
+				else
+				{
+					display_message(ERROR_MESSAGE,
+						"Missing series PATTERN, START, STOP or INCREMENT");
+					display_parse_state_location(state);
+					return_code = 0;
+				}
+			}
+			else
+			{
+				display_message(INFORMATION_MESSAGE, " PATTERN START STOP INCREMENT");
+			}
+		}
+		else
+		{
+			display_message(ERROR_MESSAGE, "Missing series PATTERN START STOP INCREMENT");
+			display_parse_state_location(state);
+			return_code = 0;
+		}
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"set_Read_nodes_series_data.  Invalid argument(s)");
+		return_code = 0;
+	}
+	LEAVE;
+
+	return (return_code);
+} /* set_Read_nodes_series_data */
+
+/**
+ * Returns a copy of file_name_template with the first occurrence of pattern
+ * replaced by number, zero padded to the length of the pattern.
+ */
+static char *series_file_name_from_template(const char *file_name_template,
+	const char *pattern, int number)
+{
+	char *file_name = 0;
+	const char *pattern_location = strstr(file_name_template, pattern);
+	if (pattern_location)
+	{
+		const int pattern_length = static_cast<int>(strlen(pattern));
+		char number_string[32];
+		sprintf(number_string, "%0*d", pattern_length, number);
+		const int prefix_length = static_cast<int>(pattern_location - file_name_template);
+		if (ALLOCATE(file_name, char, strlen(file_name_template) + strlen(number_string) + 1))
+		{
+			memcpy(file_name, file_name_template, prefix_length);
+			strcpy(file_name + prefix_length, number_string);
+			strcat(file_name, pattern_location + pattern_length);
+		}
+	}
+	return file_name;
+}
+
+/** Outcome of prefetching a series file, reported by the parsing thread. */
+enum Read_nodes_series_prefetch_result
+{
+	READ_NODES_SERIES_PREFETCH_OK,
+	READ_NODES_SERIES_PREFETCH_OPEN_FAILED,
+	READ_NODES_SERIES_PREFETCH_NO_MEMORY,
+	READ_NODES_SERIES_PREFETCH_READ_FAILED
+};
+
+/** A file in a node series and its contents once prefetched into memory. */
+struct Read_nodes_series_file
+{
+	char *file_name;
+	/* whole file in memory, or NULL if it is read from file by the parser */
+	char *buffer;
+	long buffer_size;
+	struct Mapped_file *mapped_file;
+	double time;
+	enum Read_nodes_series_prefetch_result result;
+};
+
+/**
+ * cmgui_parallel_for function bringing a whole series file into memory, either
+ * by touching every page of its mapping or by reading it into a malloc
+ * buffer. Mappings are made on the calling thread beforehand. Compressed files
+ * and files too large for an IO_stream memory block are left for the parsing
+ * thread to read from file. Displays no messages and uses no cmgui allocation
+ * as it is called from worker threads; failures are recorded in the file's
+ * result.
+ */
+static int Read_nodes_series_file_prefetch(int index, void *files_void)
+{
+	struct Read_nodes_series_file *file =
+		(struct Read_nodes_series_file *)files_void + index;
+	file->buffer = 0;
+	file->buffer_size = 0;
+	file->result = READ_NODES_SERIES_PREFETCH_OK;
+	if (file->mapped_file)
+	{
+		const char *data = Mapped_file_get_data(file->mapped_file);
+		const size_t size = Mapped_file_get_size(file->mapped_file);
+		volatile char sum = 0;
+		for (size_t offset = 0; offset < size; offset += 4096)
+			sum += data[offset];
+		file->buffer = const_cast<char *>(data);
+		file->buffer_size = static_cast<long>(size);
+		return 1;
+	}
+	if (file_name_is_compressed(file->file_name))
+		return 1;
+	FILE *stream = fopen(file->file_name, "rb");
+	if (!stream)
+	{
+		file->result = READ_NODES_SERIES_PREFETCH_OPEN_FAILED;
+		return 1;
+	}
+	long size = -1;
+	if ((0 == fseek(stream, 0, SEEK_END)) && (0 <= (size = ftell(stream))) &&
+		(0 == fseek(stream, 0, SEEK_SET)))
+	{
+		if (static_cast<unsigned long>(size) <= static_cast<unsigned long>(INT_MAX))
+		{
+			file->buffer = static_cast<char *>(malloc(size + 1));
+			if (!file->buffer)
+			{
+				file->result = READ_NODES_SERIES_PREFETCH_NO_MEMORY;
+			}
+			else if (static_cast<size_t>(size) == fread(file->buffer, 1, size, stream))
+			{
+				file->buffer[size] = '\0';
+				file->buffer_size = size;
+			}
+			else
+			{
+				free(file->buffer);
+				file->buffer = 0;
+				file->result = READ_NODES_SERIES_PREFETCH_READ_FAILED;
+			}
+		}
+	}
+	else
+	{
+		file->result = READ_NODES_SERIES_PREFETCH_READ_FAILED;
+	}
+	fclose(stream);
+	return 1;
+}
+
+/**
+ * Reads a numbered series of node or data files into top_region in file
+ * order. Worker threads read each batch of files, or touch their mappings,
+ * into memory ahead of the parser. Mapping, parsing, merging and messages stay
+ * on the calling thread since regions created from the same context share
+ * basis and time managers. All merges happen inside one hierarchical change
+ * so dependent graphics update once.
+ * @param minimum_time_address, maximum_time_address  On success with
+ * time_from_index set, receive the time range read.
+ */
+static int gfx_read_nodes_series(struct cmzn_command_data *command_data,
+	struct cmzn_region *top_region, const char *file_name_template,
+	struct Read_nodes_series_data *series_data, int use_data,
+	char node_offset_flag, int node_offset, char time_from_index,
+	int use_mapping, int number_of_threads, double *minimum_time_address,
+	double *maximum_time_address)
+{
+	if (!strstr(file_name_template, series_data->pattern))
+	{
+		display_message(ERROR_MESSAGE, "gfx read %s:  "
+			"File number pattern \"%s\" not found in file name \"%s\"",
+			use_data ? "data" : "nodes", series_data->pattern, file_name_template);
+		return 0;
+	}
+	const int number_of_files = 1 +
+		(series_data->stop - series_data->start) / series_data->increment;
+	struct Read_nodes_series_file *files;
+	if (!ALLOCATE(files, struct Read_nodes_series_file, number_of_files))
+	{
+		display_message(ERROR_MESSAGE, "gfx_read_nodes_series.  Not enough memory");
+		return 0;
+	}
+	int return_code = 1;
+	int i;
+	for (i = 0; i < number_of_files; ++i)
+	{
+		const int file_number = series_data->start + i*series_data->increment;
+		files[i].file_name = series_file_name_from_template(file_name_template,
+			series_data->pattern, file_number);
+		files[i].buffer = 0;
+		files[i].mapped_file = 0;
+		files[i].result = READ_NODES_SERIES_PREFETCH_OK;
+		files[i].time = static_cast<double>(file_number);
+		if (!files[i].file_name)
+			return_code = 0;
+	}
+	if (number_of_threads <= 0)
+		number_of_threads = cmgui_get_number_of_processors();
+	/* limit prefetched memory to a few files per thread */
+	const int batch_size = 4*number_of_threads;
+	struct FE_import_time_index time_index;
+	char block_name[64];
+	cmzn_region_begin_hierarchical_change(top_region);
+	for (int batch_start = 0; return_code && (batch_start < number_of_files);
+		batch_start += batch_size)
+	{
+		const int batch_end = (batch_start + batch_size < number_of_files) ?
+			(batch_start + batch_size) : number_of_files;
+		if (use_mapping)
+		{
+			for (i = batch_start; i < batch_end; ++i)
+			{
+				if (!file_name_is_compressed(files[i].file_name))
 				{
-					top_region = cmzn_region_create_subregion(
-						command_data->root_region, region_path);
-					if (NULL == top_region)
+					files[i].mapped_file = CREATE(Mapped_file)(files[i].file_name);
+					/* larger files are read in windows by the parsing thread */
+					if (files[i].mapped_file && (Mapped_file_get_size(files[i].mapped_file) >
+						static_cast<size_t>(INT_MAX)))
 					{
-						display_message(ERROR_MESSAGE, "gfx_read_elements.  "
-							"Unable to find or create region '%s'.", region_path);
-						return_code = 0;
+						DESTROY(Mapped_file)(&files[i].mapped_file);
 					}
 				}
 			}
-			else
-			{
-				top_region = ACCESS(cmzn_region)(command_data->root_region);
-			}
+		}
+		cmgui_parallel_for(number_of_threads, batch_end - batch_start,
+			Read_nodes_series_file_prefetch, (void *)(files + batch_start));
+		for (i = batch_start; i < batch_end; ++i)
+		{
+			struct Read_nodes_series_file *file = files + i;
 			if (return_code)
 			{
-				/* open the file */
-				if ((input_file = CREATE(IO_stream)(command_data->io_stream_package))
-					&& (IO_stream_open_for_read(input_file, file_name)))
+				struct FE_import_time_index *node_time_index = 0;
+				if (time_from_index)
+				{
+					time_index.time = file->time;
+					node_time_index = &time_index;
+				}
+				cmzn_region *region = 0;
+				if (READ_NODES_SERIES_PREFETCH_OK != file->result)
+				{
+					display_message(ERROR_MESSAGE, "%s node file: %s",
+						(READ_NODES_SERIES_PREFETCH_OPEN_FAILED == file->result) ? "Could not open" :
+						(READ_NODES_SERIES_PREFETCH_NO_MEMORY == file->result) ?
+							"Not enough memory to read" : "Could not read", file->file_name);
+					return_code = 0;
+				}
+				else if (file->buffer)
 				{
-					region = cmzn_region_create_region(top_region);
-					if (read_exregion_file(region, input_file,
-						(struct FE_import_time_index *)NULL))
+					char memory_uri[72];
+					sprintf(block_name, "gfx_read_nodes_series_%d", i);
+					sprintf(memory_uri, "memory:%s", block_name);
+					struct IO_stream *input_file = 0;
+					if (IO_stream_package_define_memory_block(command_data->io_stream_package,
+						block_name, (void *)file->buffer, static_cast<int>(file->buffer_size)))
 					{
-						if (element_flag || face_flag || line_flag || node_flag)
-						{
-							return_code = offset_region_identifier(region, element_flag, element_offset, face_flag,
-								face_offset, line_flag, line_offset, node_flag, node_offset, /*use_data*/0);
-						}
-						if (return_code)
+						if ((input_file = CREATE(IO_stream)(command_data->io_stream_package)) &&
+							IO_stream_open_for_read(input_file, memory_uri))
 						{
-							if (cmzn_region_can_merge(top_region, region))
-							{
-								if (!cmzn_region_merge(top_region, region))
-								{
-									display_message(ERROR_MESSAGE,
-										"Error merging elements from file: %s", file_name);
-									return_code = 0;
-								}
-							}
-							else
+							region = cmzn_region_create_region(top_region);
+							if (!(use_data ?
+								read_exdata_file(region, input_file, node_time_index) :
+								read_exregion_file(region, input_file, node_time_index)))
 							{
 								display_message(ERROR_MESSAGE,
-									"Contents of file %s not compatible with global objects",
-									file_name);
-								return_code = 0;
+									"Error reading node file: %s", file->file_name);
+								DEACCESS(cmzn_region)(&region);
 							}
+							IO_stream_close(input_file);
+						}
+						else
+						{
+							display_message(ERROR_MESSAGE,
+								"Could not open node file: %s", file->file_name);
+						}
+						if (input_file)
+						{
+							DESTROY(IO_stream)(&input_file);
 						}
+						IO_stream_package_free_memory_block(command_data->io_stream_package,
+							block_name);
 					}
-					else
+					if (!region)
+						return_code = 0;
+				}
+				else
+				{
+					/* compressed or too large to prefetch */
+					region = read_ex_file_region(command_data, top_region, file->file_name,
+						use_data, node_time_index, use_mapping);
+					if (!region)
+						return_code = 0;
+				}
+				if (region)
+				{
+					if (node_offset_flag)
+					{
+						return_code = offset_region_identifier(region, 0, 0, 0,
+							0, 0, 0, node_offset_flag, node_offset, use_data);
+					}
+					if (return_code && cmzn_region_can_merge(top_region, region))
+					{
+						if (!cmzn_region_merge(top_region, region))
+						{
+							display_message(ERROR_MESSAGE,
+								"Error merging %s from file: %s", use_data ? "data" : "nodes",
+								file->file_name);
+							return_code = 0;
+						}
+					}
+					else if (return_code)
 					{
 						display_message(ERROR_MESSAGE,
-							"Error reading element file: %s", file_name);
+							"Contents of file %s not compatible with global objects",
+							file->file_name);
 						return_code = 0;
 					}
 					DEACCESS(cmzn_region)(&region);
-					IO_stream_close(input_file);
-					DESTROY(IO_stream)(&input_file);
-				}
-				else
-				{
-					display_message(ERROR_MESSAGE,
-						"Could not open element file: %s", file_name);
-					return_code = 0;
 				}
 			}
-			DEACCESS(cmzn_region)(&top_region);
-		}
-		DESTROY(Option_table)(&option_table);
-#if defined (WX_USER_INTERFACE)
-		if (input_file)
-			 DESTROY(IO_stream)(&input_file);
-#endif /*defined (WX_USER_INTERFACE)*/
-		if (file_name)
-		{
-			DEALLOCATE(file_name);
+			if (file->mapped_file)
+			{
+				DESTROY(Mapped_file)(&file->mapped_file);
+			}
+			else if (file->buffer)
+			{
+				free(file->buffer);
+			}
+			file->buffer = 0;
 		}
-		if (region_path)
+	}
+	cmzn_region_end_hierarchical_change(top_region);
+	if (return_code && time_from_index)
+	{
+		*minimum_time_address = files[0].time;
+		*maximum_time_address = files[number_of_files - 1].time;
+		if (*minimum_time_address > *maximum_time_address)
 		{
-			DEALLOCATE(region_path);
+			*minimum_time_address = files[number_of_files - 1].time;
+			*maximum_time_address = files[0].time;
 		}
 	}
-	else
+	for (i = 0; i < number_of_files; ++i)
 	{
-		display_message(ERROR_MESSAGE, "gfx_read_elements.  Invalid argument(s)");
-		return_code = 0;
+		if (files[i].file_name)
+		{
+			DEALLOCATE(files[i].file_name);
+		}
 	}
-	LEAVE;
-
-	return (return_code);
-} /* gfx_read_elements */
+	DEALLOCATE(files);
+	return return_code;
+}
 
 static int gfx_read_nodes(struct Parse_state *state,
 	void *use_data, void *command_data_void)
@@ -11869,20 +12955,22 @@ DESCRIPTION :
 If a nodes file is not specified a file selection box is presented to the user,
 otherwise the nodes file is read.
 If the <use_data> flag is set, then read data, otherwise nodes.
+With the series option, the file name is a template in which the series
+pattern is replaced by each number in the range to read a time series of files.
 ==============================================================================*/
 {
-	char *file_name, node_offset_flag, *region_path, time_set_flag;
-	double maximum, minimum;
+	char *file_name, node_offset_flag, *region_path, time_from_index,
+		time_set_flag;
+	double maximum, minimum, series_maximum_time, series_minimum_time;
 	float time;
-	int node_offset, return_code;
+	int node_offset, number_of_threads, return_code, use_mmap;
 	struct cmzn_command_data *command_data;
 	struct cmzn_region *region, *top_region;
 	struct FE_import_time_index *node_time_index, node_time_index_data;
-	struct IO_stream *input_file;
 	struct Option_table *option_table;
+	struct Read_nodes_series_data series_data;
 
 	ENTER(gfx_read_nodes);
-	input_file=NULL;
 	if (state)
 	{
 		if (NULL != (command_data = (struct cmzn_command_data *)command_data_void))
@@ -11893,11 +12981,21 @@ If the <use_data> flag is set, then read data, otherwise nodes.
 			region_path = (char *)NULL;
 			time = 0;
 			time_set_flag = 0;
+			time_from_index = 0;
+			number_of_threads = 0;
+			use_mmap = command_data->read_mmap;
+			series_data.pattern = (char *)NULL;
+			series_data.start = 0;
+			series_data.stop = 0;
+			/* increment must be non-zero for series to be "set" */
+			series_data.increment = 0;
 			node_time_index = (struct FE_import_time_index *)NULL;
 			option_table=CREATE(Option_table)();
 			/* example */
 			Option_table_add_entry(option_table,CMGUI_EXAMPLE_DIRECTORY_SYMBOL,
 				&file_name, &(command_data->example_directory), set_file_name);
+			/* mmap/no_mmap */
+			Option_table_add_switch(option_table, "mmap", "no_mmap", &use_mmap);
 			if (!use_data)
 			{
 				/* node_offset */
@@ -11912,9 +13010,18 @@ If the <use_data> flag is set, then read data, otherwise nodes.
 			}
 			/* region */
 			Option_table_add_entry(option_table,"region", &region_path, (void *)1, set_name);
+			/* series */
+			Option_table_add_entry(option_table, "series",
+				&series_data, NULL, set_Read_nodes_series_data);
+			/* threads */
+			Option_table_add_int_non_negative_entry(option_table, "threads",
+				&number_of_threads);
 			/* time */
 			Option_table_add_entry(option_table,"time",
 				&time, &time_set_flag, set_float_and_char_flag);
+			/* time_from_index */
+			Option_table_add_char_flag_entry(option_table, "time_from_index",
+				&time_from_index);
 			/* default */
 			Option_table_add_entry(option_table, NULL, &file_name,
 				NULL, set_file_name);
@@ -11953,6 +13060,21 @@ If the <use_data> flag is set, then read data, otherwise nodes.
 					node_time_index_data.time = time;
 					node_time_index = &node_time_index_data;
 				}
+				if (time_from_index)
+				{
+					if (0 == series_data.increment)
+					{
+						display_message(ERROR_MESSAGE,
+							"gfx read nodes.  time_from_index requires a file series");
+						return_code = 0;
+					}
+					else if (time_set_flag)
+					{
+						display_message(ERROR_MESSAGE,
+							"gfx read nodes.  Specify only one of time or time_from_index");
+						return_code = 0;
+					}
+				}
 				if (return_code)
 				{
 #if defined (WX_USER_INTERFACE) && defined (WIN32_SYSTEM)
@@ -11991,105 +13113,82 @@ If the <use_data> flag is set, then read data, otherwise nodes.
 					{
 						top_region = ACCESS(cmzn_region)(command_data->root_region);
 					}
-					if (return_code)
+					if (return_code && (0 != series_data.increment))
 					{
-						if ((input_file = CREATE(IO_stream)(command_data->io_stream_package))
-							&& (IO_stream_open_for_read(input_file, file_name)))
+						return_code = gfx_read_nodes_series(command_data, top_region,
+							file_name, &series_data, (use_data != 0), node_offset_flag, node_offset,
+							time_from_index, use_mmap, number_of_threads,
+							&series_minimum_time, &series_maximum_time);
+					}
+					else if (return_code)
+					{
+						region = read_ex_file_region(command_data, top_region, file_name,
+							(use_data != 0), node_time_index, use_mmap);
+						if (region)
 						{
-							region = cmzn_region_create_region(top_region);
-							if (use_data)
-							{
-								return_code = read_exdata_file(region, input_file, node_time_index);
-							}
-							else
+							if (node_offset_flag)
 							{
-								return_code = read_exregion_file(region, input_file, node_time_index);
+								/* Offset these nodes before merging */
+								return_code = offset_region_identifier(region, 0, 0, 0,
+									0, 0, 0, node_offset_flag, node_offset, /*use_data*/(use_data != 0));
 							}
-							if (return_code)
+							if (cmzn_region_can_merge(top_region, region))
 							{
-								if (node_offset_flag)
+								if (!cmzn_region_merge(top_region, region))
 								{
-									/* Offset these nodes before merging */
 									if (use_data)
 									{
-										return_code = offset_region_identifier(region, 0, 0, 0,
-											0, 0, 0, node_offset_flag, node_offset, /*use_data*/1);
+										display_message(ERROR_MESSAGE,
+											"Error merging data from file: %s", file_name);
 									}
 									else
 									{
-										return_code = offset_region_identifier(region, 0, 0, 0,
-											0, 0, 0, node_offset_flag, node_offset, /*use_data*/0);
-									}
-								}
-								if (cmzn_region_can_merge(top_region, region))
-								{
-									if (!cmzn_region_merge(top_region, region))
-									{
-										if (use_data)
-										{
-											display_message(ERROR_MESSAGE,
-												"Error merging data from file: %s", file_name);
-										}
-										else
-										{
-											display_message(ERROR_MESSAGE,
-												"Error merging nodes from file: %s", file_name);
-										}
-										return_code = 0;
+										display_message(ERROR_MESSAGE,
+											"Error merging nodes from file: %s", file_name);
 									}
-								}
-								else
-								{
-									display_message(ERROR_MESSAGE,
-										"Contents of file %s not compatible with global objects",
-										file_name);
 									return_code = 0;
 								}
 							}
 							else
 							{
 								display_message(ERROR_MESSAGE,
-									"Error reading node file: %s", file_name);
+									"Contents of file %s not compatible with global objects",
+									file_name);
 								return_code = 0;
 							}
 							DEACCESS(cmzn_region)(&region);
-							IO_stream_close(input_file);
-							DESTROY(IO_stream)(&input_file);
-							input_file =NULL;
 						}
 						else
 						{
-							display_message(ERROR_MESSAGE,
-								"Could not open node file: %s", file_name);
 							return_code = 0;
 						}
 					}
 					DEACCESS(cmzn_region)(&top_region);
 					if (return_code && time_set_flag)
+					{
+						series_minimum_time = time;
+						series_maximum_time = time;
+					}
+					if (return_code && (time_set_flag || time_from_index))
 					{
 						/* Increase the range of the default time keepeer and set the
-						   minimum and maximum if we set anything */
+						   minimum and maximum if we set anything. Done once for a
+						   whole series */
 						maximum = command_data->default_time_keeper_app->getTimeKeeper()->getMaximum();
 						minimum = command_data->default_time_keeper_app->getTimeKeeper()->getMinimum();
-						if (time < minimum)
-						{
-							command_data->default_time_keeper_app->setMinimum(time);
-							command_data->default_time_keeper_app->setMaximum(maximum);
-						}
-						if (time > maximum)
+						if ((series_minimum_time < minimum) || (series_maximum_time > maximum))
 						{
+							if (series_minimum_time < minimum)
+								minimum = series_minimum_time;
+							if (series_maximum_time > maximum)
+								maximum = series_maximum_time;
 							command_data->default_time_keeper_app->setMinimum(minimum);
-							command_data->default_time_keeper_app->setMaximum(time);
+							command_data->default_time_keeper_app->setMaximum(maximum);
 						}
 					}
 				}
 			}
 			DESTROY(Option_table)(&option_table);
-#if defined (WX_USER_INTERFACE)
-			if (input_file)
-				 DESTROY(IO_stream)(&input_file);
-			input_file =NULL;
-#endif /*defined (WX_USER_INTERFACE)*/
 			if (file_name)
 			{
 				DEALLOCATE(file_name);
@@ -12098,6 +13197,10 @@ If the <use_data> flag is set, then read data, otherwise nodes.
 			{
 				DEALLOCATE(region_path);
 			}
+			if (series_data.pattern)
+			{
+				DEALLOCATE(series_data.pattern);
+			}
 		}
 		else
 		{
@@ -13307,6 +14410,53 @@ static int gfx_set_visibility(struct Parse_state *state,
 	return (return_code);
 }
 
+/**
+ * Executes a GFX SET IMAGE_CACHE command.
+ */
+static int gfx_set_image_cache(struct Parse_state *state,
+	void *dummy_to_be_modified, void *command_data_void)
+{
+	int return_code = 0;
+	USE_PARAMETER(dummy_to_be_modified);
+	struct cmzn_command_data *command_data = (struct cmzn_command_data *)command_data_void;
+	if (state && command_data && command_data->image_filter_cache)
+	{
+		char *directory = NULL;
+		char off_flag = 0;
+		double maximum_size = -1.0;
+		Option_table *option_table = CREATE(Option_table)();
+		Option_table_add_help(option_table,
+			"Keep the results of image filter fields defined with gfx define field in "
+			"an existing directory, and read them back instead of running the filters "
+			"when the same source image and filter parameters are defined again, "
+			"including in later sessions. A result is stored the first time the field "
+			"is evaluated with gfx modify texture evaluate_image at its native "
+			"resolution, as 4 byte reals. "
+			"Least recently used results are deleted beyond the maximum_size in "
+			"megabytes, 1024 by default. Use off to stop using the directory.");
+		Option_table_add_string_entry(option_table, "directory", &directory, " PATH");
+		Option_table_add_non_negative_double_entry(option_table, "maximum_size",
+			&maximum_size);
+		Option_table_add_char_flag_entry(option_table, "off", &off_flag);
+		return_code = Option_table_multi_parse(option_table, state);
+		DESTROY(Option_table)(&option_table);
+		if (return_code)
+		{
+			if (0.0 <= maximum_size)
+				return_code = Image_filter_cache_set_maximum_size(
+					command_data->image_filter_cache, maximum_size);
+			if (off_flag)
+				Image_filter_cache_set_directory(command_data->image_filter_cache, NULL);
+			else if (directory)
+				return_code = Image_filter_cache_set_directory(
+					command_data->image_filter_cache, directory) && return_code;
+		}
+		if (directory)
+			DEALLOCATE(directory);
+	}
+	return (return_code);
+}
+
 static int execute_command_gfx_set(struct Parse_state *state,
 	void *dummy_to_be_modified, void *command_data_void)
 /*******************************************************************************
@@ -13328,6 +14478,8 @@ Executes a GFX SET command.
 		{
 			double point_size = 0.0;
 			option_table=CREATE(Option_table)();
+			Option_table_add_entry(option_table, "image_cache", NULL,
+				command_data_void, gfx_set_image_cache);
 			Option_table_add_entry(option_table, "node_value", NULL,
 				command_data_void, gfx_set_FE_nodal_value);
 			Option_table_add_entry(option_table, "order", NULL,
@@ -13657,6 +14809,94 @@ DESCRIPTION :
 	return (return_code);
 } /* gfx_timekeeper */
 
+/***************************************************************************//**
+ * Executes a GFX TIMING command.
+ */
+static int gfx_timing(struct Parse_state *state,
+	void *dummy_to_be_modified, void *command_data_void)
+{
+	int return_code;
+
+	ENTER(gfx_timing);
+	USE_PARAMETER(dummy_to_be_modified);
+	cmzn_command_data *command_data = reinterpret_cast<cmzn_command_data *>(command_data_void);
+	if (state && command_data)
+	{
+		char *file_name = 0;
+		char list_flag = 0;
+		char reset_flag = 0;
+		char *sort_name = 0;
+		int enabled = Command_timing_is_enabled(command_data->command_timing);
+
+		Option_table *option_table = CREATE(Option_table)();
+		Option_table_add_help(option_table,
+			"Turn recording of command timings on or off, list or reset them. "
+			"Commands are grouped by their first two words, or three for gfx "
+			"commands, e.g. 'gfx read nodes'. Each group lists its count, total "
+			"wall time, parse time, CPU time, mean and maximum wall time, net heap "
+			"growth where known and a histogram of wall times by decade. Times "
+			"exclude commands run from within a command such as 'open comfile'. "
+			"List by largest <sort> total, mean, max or count, and optionally "
+			"write the listing to FILE_NAME instead of the command window. "
+			"Recording is off at startup; turn it on to collect timings.");
+		/* file */
+		Option_table_add_entry(option_table, "file", &file_name,
+			(void *)1, set_name);
+		/* list */
+		Option_table_add_char_flag_entry(option_table, "list", &list_flag);
+		/* on/off */
+		Option_table_add_switch(option_table, "on", "off", &enabled);
+		/* reset */
+		Option_table_add_char_flag_entry(option_table, "reset", &reset_flag);
+		/* sort */
+		Option_table_add_string_entry(option_table, "sort", &sort_name,
+			" total|mean|max|count");
+		return_code = Option_table_multi_parse(option_table, state);
+		DESTROY(Option_table)(&option_table);
+		enum Command_timing_sort sort = COMMAND_TIMING_SORT_TOTAL;
+		if (return_code && sort_name)
+		{
+			if (fuzzy_string_compare(sort_name, "mean"))
+				sort = COMMAND_TIMING_SORT_MEAN;
+			else if (fuzzy_string_compare(sort_name, "max"))
+				sort = COMMAND_TIMING_SORT_MAXIMUM;
+			else if (fuzzy_string_compare(sort_name, "count"))
+				sort = COMMAND_TIMING_SORT_COUNT;
+			else if (!fuzzy_string_compare(sort_name, "total"))
+			{
+				display_message(ERROR_MESSAGE,
+					"gfx timing:  Unknown sort '%s'", sort_name);
+				return_code = 0;
+			}
+		}
+		if (return_code)
+		{
+			Command_timing_set_enabled(command_data->command_timing, enabled);
+			/* sort and file only apply to listing */
+			if (list_flag || sort_name || file_name)
+			{
+				return_code = Command_timing_list(command_data->command_timing, sort, file_name);
+			}
+			if (reset_flag)
+			{
+				Command_timing_reset(command_data->command_timing);
+			}
+		}
+		if (sort_name)
+			DEALLOCATE(sort_name);
+		if (file_name)
+			DEALLOCATE(file_name);
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE, "gfx_timing.  Invalid argument(s)");
+		return_code = 0;
+	}
+	LEAVE;
+
+	return (return_code);
+} /* gfx_timing */
+
 static int gfx_transform_tool(struct Parse_state *state,
 	void *dummy_user_data,void *command_data_void)
 /*******************************************************************************
@@ -13765,53 +15005,93 @@ Executes a GFX UPDATE command.
 } /* execute_command_gfx_update */
 #endif /* defined (WX_USER_INTERFACE) */
 
+#if defined (USE_CMGUI_COMMAND_WINDOW)
+static void display_command_window_message(cmzn_loggerevent_id event,
+	void *command_window_void);
+#endif /* defined (USE_CMGUI_COMMAND_WINDOW) */
+
+/** Strings receiving the messages captured while writing all. */
+struct Gfx_write_all_captured_messages
+{
+	std::string *information;
+	std::string errors;
+};
+
+static void gfx_write_all_capture_message(cmzn_loggerevent_id event,
+	void *captured_messages_void)
+{
+	struct Gfx_write_all_captured_messages *captured_messages =
+		static_cast<struct Gfx_write_all_captured_messages *>(captured_messages_void);
+	if (event && captured_messages)
+	{
+		char *message = cmzn_loggerevent_get_message_text(event);
+		if (message)
+		{
+			if (CMZN_LOGGER_MESSAGE_TYPE_INFORMATION ==
+				cmzn_loggerevent_get_message_type(event))
+			{
+				captured_messages->information->append(message);
+			}
+			else
+			{
+				captured_messages->errors.append(message);
+				captured_messages->errors.append("\n");
+			}
+			DEALLOCATE(message);
+		}
+	}
+}
+
+static int gfx_write_all_spectrum_commands(struct cmzn_spectrum *spectrum,
+	void *process_message_void)
+{
+	return process_list_or_write_Spectrum_commands(spectrum, "gfx modify spectrum",
+		(char *)NULL, static_cast<Process_list_or_write_command_class *>(process_message_void));
+}
+
+#if defined (USE_CMGUI_GRAPHICS_WINDOW)
+static int gfx_write_all_graphics_window_commands(struct Graphics_window *window,
+	void *process_message_void)
+{
+	return process_list_or_write_Graphics_window_commands(window,
+		static_cast<Process_list_or_write_command_class *>(process_message_void));
+}
+#endif /* defined (USE_CMGUI_GRAPHICS_WINDOW) */
+
 static int gfx_write_all(struct Parse_state *state,
 	 void *dummy_to_be_modified,void *command_data_void)
 /*******************************************************************************
-LAST MODIFIED : 3 August 2007
+LAST MODIFIED : 16 October 2026
 
 DESCRIPTION :
-If an zip file is not specified a file selection box is presented to the
-user, otherwise files are written.
+Writes the region and a comfile recreating the fields, spectrums, materials and
+graphics windows into a zip file. If the zip file is not specified a file
+selection box is presented to the user.
 Can also write individual groups with the <group> option.
+Both entries are deflated into the zip. The region is first written to a
+temporary file named after the zip file and removed afterwards, so it is never
+held in memory and several jobs can write different zip files from the same
+directory.
 ==============================================================================*/
 {
-	 FILE *com_file;
-	 char *com_file_name, *exfile_name, *file_name;
+	 char *file_name;
 	 enum FE_write_criterion write_criterion;
 	 enum FE_write_recursion write_recursion;
-	 int exfile_return_code, return_code, exfile_fd, com_return_code;
+	 int return_code;
 	 struct cmzn_command_data *command_data;
 	 struct Option_table *option_table;
 	 struct MANAGER(cmzn_material) *graphical_material_manager;
 	 struct MANAGER(Computed_field) *computed_field_manager;
-	 struct LIST(Computed_field) *list_of_fields;
-	 struct List_Computed_field_commands_data list_commands_data;
-	 static const char	*command_prefix;
-	 FE_value time;
-#if defined (WX_USER_INTERFACE)
-#if defined (WIN32_SYSTEM)
-	 char temp_exfile[L_tmpnam];
-#else /* (WIN32_SYSTEM) */
-	 char temp_exfile[] = "regionXXXXXX";
-#endif /* (WIN32_SYSTEM) */
-#else /* (WX_USER_INTERFACE) */
-	 char *temp_exfile = NULL;
-#endif /* (WX_USER_INTERFACE) */
+	 FE_value time;
 
 	 ENTER(gfx_write_all);
 	 USE_PARAMETER(dummy_to_be_modified);
 	 if (state && (command_data=(struct cmzn_command_data *)command_data_void))
 	 {
-			exfile_fd = 1;
-			exfile_return_code = 1;
-			com_return_code = 1;
 			return_code = 1;
 			file_name = 0;
 			cmzn_region_id root_region = cmzn_region_access(command_data->root_region);
 			char *region_or_group_path = 0;
-			exfile_name = (char *)NULL;
-			com_file_name = (char *)NULL;
 			time = 0.0;
 			Multiple_strings field_names;
 			write_criterion = FE_WRITE_COMPLETE_GROUP;
@@ -13839,22 +15119,6 @@ Can also write individual groups with the <group> option.
 
 			if (0 != (return_code = Option_table_multi_parse(option_table, state)))
 			{
-				 if (file_name)
-				 {
-						int length = strlen(file_name);
-						if (ALLOCATE(com_file_name, char, length+6))
-						{
-							 strcpy(com_file_name, file_name);
-							 strcat(com_file_name, ".com");
-							 com_file_name[length+5]='\0';
-						}
-						if (ALLOCATE(exfile_name, char, length+11))
-						{
-							 strcpy(exfile_name, file_name);
-							 strcat(exfile_name, ".exregion");
-							 exfile_name[length+10]='\0';
-						}
-				 }
 				enum FE_write_fields_mode write_fields_mode = FE_WRITE_ALL_FIELDS;
 				if ((1 == field_names.number_of_strings) && field_names.strings)
 				{
@@ -13882,7 +15146,6 @@ Can also write individual groups with the <group> option.
 						"gfx write all:  Must specify fields to use %s",
 						ENUMERATOR_STRING(FE_write_criterion)(write_criterion));
 					return_code = 0;
-					exfile_return_code = 0;
 				}
 				cmzn_region_id region = 0;
 				char *group_name = 0;
@@ -13902,193 +15165,140 @@ Can also write individual groups with the <group> option.
 				}
 				if (region == 0)
 					region = root_region;
-				if (return_code)
+				if (return_code && !file_name)
 				{
-					if (!file_name)
-					{
-/* 						com_file_name = "temp.com"; */
-						if (!(com_file_name = confirmation_get_write_filename(".com",
-										 command_data->user_interface
-#if defined(WX_USER_INTERFACE)
-										 , command_data->execute_command
-#endif /*defined (WX_USER_INTERFACE) */
-																																	 )))
-						{
-							 com_return_code = 0;
-						}
-						if (!(exfile_name = confirmation_get_write_filename(".exregion",
-										 command_data->user_interface
-#if defined(WX_USER_INTERFACE)
-										 , command_data->execute_command
-#endif /*defined (WX_USER_INTERFACE) */
-																																	 )))
-						{
-							exfile_return_code = 0;
-						}
+					if (!(file_name = confirmation_get_write_filename(".zip",
+						command_data->user_interface
 #if defined(WX_USER_INTERFACE)
-						file_name = confirmation_get_write_filename(".zip",
-							 command_data->user_interface
-							 , command_data->execute_command);
+						, command_data->execute_command
 #endif /*defined (WX_USER_INTERFACE) */
-					}
-#if defined (WX_USER_INTERFACE) && defined (WIN32_SYSTEM)
-					if (com_file_name)
-					{
-						CMZN_set_directory_and_filename_WIN32(&com_file_name, command_data);
-					}
-					if (exfile_name)
+						)))
 					{
-						CMZN_set_directory_and_filename_WIN32(&exfile_name, command_data);
+						return_code = 0;
 					}
-#endif /* defined (WX_USER_INTERFACE) && defined (WIN32_SYSTEM) */
 				}
-				if (com_return_code)
+				if (return_code)
 				{
-					com_return_code = check_suffix(&com_file_name,".com");
+#if defined (WX_USER_INTERFACE) && defined (WIN32_SYSTEM)
+					CMZN_set_directory_and_filename_WIN32(&file_name, command_data);
+#endif /* defined (WX_USER_INTERFACE) && defined (WIN32_SYSTEM) */
+					return_code = check_suffix(&file_name, ".zip");
 				}
-				if (exfile_return_code)
+				struct Zip_writer *zip_writer = 0;
+				if (return_code && (!(zip_writer = CREATE(Zip_writer)(file_name))))
 				{
-					exfile_return_code = check_suffix(&exfile_name,".exregion");
+					return_code = 0;
 				}
-#if defined (WX_USER_INTERFACE)
-#if defined (WIN32_SYSTEM)
-				 /* 	Non MS-windows platform does not have mkstemp implemented,
-						therefore tmpnam is used.*/
-				 if (exfile_return_code)
-				 {
-						tmpnam(temp_exfile);
-						if (temp_exfile == NULL)
+				if (return_code)
+				{
+					/* entries are named after the zip file without its directory, so
+					 * the comfile reads the region from beside itself when extracted */
+					const char *base_name = file_name;
+					for (const char *c = file_name; *c; ++c)
+					{
+						if (('/' == *c) || ('\\' == *c))
+							base_name = c + 1;
+					}
+					const std::string entry_prefix(base_name, strlen(base_name) - strlen(".zip"));
+					const std::string exfile_name = entry_prefix + ".exregion";
+					const std::string com_file_name = entry_prefix + ".com";
+					cmzn_streaminformation_region_recursion_mode recursion_mode = CMZN_STREAMINFORMATION_REGION_RECURSION_MODE_ON;
+					if (write_recursion == FE_WRITE_NON_RECURSIVE)
+						recursion_mode = CMZN_STREAMINFORMATION_REGION_RECURSION_MODE_OFF;
+					/* Zinc only streams regions to files; memory resources hold the
+					 * whole region with a 32-bit length */
+					char *temporary_exfile_name = Zip_writer_create_temporary_file();
+					if (!(temporary_exfile_name && export_region_file_of_name(temporary_exfile_name,
+							region, group_name, root_region,
+							/*write_elements*/CMZN_FIELD_DOMAIN_TYPE_MESH1D|CMZN_FIELD_DOMAIN_TYPE_MESH2D|
+							CMZN_FIELD_DOMAIN_TYPE_MESH3D|CMZN_FIELD_DOMAIN_TYPE_MESH_HIGHEST_DIMENSION,
+							/*write_nodes*/1, /*write_data*/1,
+							field_names.number_of_strings, field_names.strings,
+							time, recursion_mode,/*isFieldML*/0) &&
+						Zip_writer_begin_entry(zip_writer, exfile_name.c_str()) &&
+						Zip_writer_write_file(zip_writer, temporary_exfile_name) &&
+						Zip_writer_end_entry(zip_writer)))
+					{
+						display_message(ERROR_MESSAGE,
+							"gfx write all.  Could not write region to %s", file_name);
+						return_code = 0;
+					}
+					if (temporary_exfile_name)
+					{
+						remove(temporary_exfile_name);
+						DEALLOCATE(temporary_exfile_name);
+					}
+					/* build the comfile in memory */
+					std::string commands("gfx read nodes ");
+					commands += exfile_name;
+					commands += "\n";
+					Process_write_command_to_string_class write_message(commands);
+					if (command_data->computed_field_package && (computed_field_manager=
+						Computed_field_package_get_computed_field_manager(
+							command_data->computed_field_package)))
+					{
+						if (!process_list_or_write_Computed_field_commands_in_dependency_order(
+							computed_field_manager, "gfx define field ", &write_message))
 						{
-							 exfile_fd = -1;
+							display_message(ERROR_MESSAGE,
+								"gfx write all.  Could not list field commands");
+							return_code = 0;
 						}
-				 }
-#else
-				 /* Non MS-windows platform has mkstemp implemented into it*/
-				 if (exfile_return_code)
-				 {
-					 exfile_fd = mkstemp((char *)temp_exfile);
-				 }
-#endif /* (WIN32_SYSTEM) */
-#else /* (WX_USER_INTERFACE) */
-				 /* Non wx_user_interface won't be able to stored the file in
-						a zip file at the moment */
-				 if (exfile_return_code)
-				 {
-					 temp_exfile = exfile_name;
-				 }
-#endif /* (WX_USER_INTERFACE) */
-				 if (exfile_fd == -1)
-				 {
-						display_message(ERROR_MESSAGE,
-							 "gfx_write_all.  Could not open temporary exregion file");
-				 }
-				 else
-				 {
-					 cmzn_streaminformation_region_recursion_mode recursion_mode = CMZN_STREAMINFORMATION_REGION_RECURSION_MODE_ON;
-					 if (write_recursion == FE_WRITE_NON_RECURSIVE)
-						 recursion_mode = CMZN_STREAMINFORMATION_REGION_RECURSION_MODE_OFF;
-					 if (!(exfile_return_code = export_region_file_of_name(temp_exfile,
-						 region, group_name, root_region,
-						 /*write_elements*/CMZN_FIELD_DOMAIN_TYPE_MESH1D|CMZN_FIELD_DOMAIN_TYPE_MESH2D|
-						 CMZN_FIELD_DOMAIN_TYPE_MESH3D|CMZN_FIELD_DOMAIN_TYPE_MESH_HIGHEST_DIMENSION,
-						 /*write_nodes*/1, /*write_data*/1,
-						 field_names.number_of_strings, field_names.strings,
-						 time, recursion_mode,/*isFieldML*/0)))
-					 {
-						 display_message(ERROR_MESSAGE,
-							 "gfx_write_all.  Could not create temporary data file");
-					 }
-				 }
-				 if (com_return_code)
-				 {
-						if (NULL != (com_file = fopen("temp_file_com.com", "w")))
+					}
+					if (command_data->spectrum_manager)
+					{
+						FOR_EACH_OBJECT_IN_MANAGER(cmzn_spectrum)(
+							gfx_write_all_spectrum_commands, static_cast<void *>(&write_message),
+							command_data->spectrum_manager);
+					}
+					if (NULL != (graphical_material_manager =
+						cmzn_materialmodule_get_manager(command_data->materialmodule)))
+					{
+						/* material commands are only available as messages, so divert
+						 * them from the command window into the comfile */
+						struct Gfx_write_all_captured_messages captured_messages;
+						captured_messages.information = &commands;
+						if (command_data->loggerNotifier)
+							cmzn_loggernotifier_clear_callback(command_data->loggerNotifier);
+						cmzn_loggernotifier_id capture_notifier =
+							cmzn_logger_create_loggernotifier(command_data->logger);
+						cmzn_loggernotifier_set_callback(capture_notifier,
+							gfx_write_all_capture_message, static_cast<void *>(&captured_messages));
+						FOR_EACH_OBJECT_IN_MANAGER(cmzn_material)(
+							list_Graphical_material_commands, (void *)"gfx create material ",
+							graphical_material_manager);
+						cmzn_loggernotifier_clear_callback(capture_notifier);
+						cmzn_loggernotifier_destroy(&capture_notifier);
+#if defined (USE_CMGUI_COMMAND_WINDOW)
+						if (command_data->loggerNotifier)
 						{
-							 if (exfile_name)
-							 {
-									fprintf(com_file, "gfx read nodes %s\n",exfile_name);
-							 }
-							 fclose(com_file);
-							 if (command_data->computed_field_package && (computed_field_manager=
-										 Computed_field_package_get_computed_field_manager(
-												command_data->computed_field_package)))
-							 {
-									if (NULL != (list_of_fields = CREATE(LIST(Computed_field))()))
-									{
-										 command_prefix="gfx define field ";
-										 list_commands_data.command_prefix = command_prefix;
-										 list_commands_data.listed_fields = 0;
-										 list_commands_data.computed_field_list = list_of_fields;
-										 list_commands_data.computed_field_manager =
-												computed_field_manager;
-										 while (FOR_EACH_OBJECT_IN_MANAGER(Computed_field)(
-															 write_Computed_field_commands_if_managed_source_fields_in_list_to_comfile,
-															 (void *)&list_commands_data, computed_field_manager) &&
-												(0 != list_commands_data.listed_fields))
-										 {
-												list_commands_data.listed_fields = 0;
-										 }
-										 DESTROY(LIST(Computed_field))(&list_of_fields);
-									}
-									else
-									{
-										 return_code=0;
-									}
-									if (!return_code)
-									{
-										 display_message(ERROR_MESSAGE,
-												"gfx_write_all.  Could not list field commands");
-									}
-							 }
-
-							 if (command_data->spectrum_manager)
-							 {
-									FOR_EACH_OBJECT_IN_MANAGER(cmzn_spectrum)(
-										 for_each_spectrum_list_or_write_commands, (void *)"true", command_data->spectrum_manager);
-							 }
-							 if (NULL != (graphical_material_manager =
-									cmzn_materialmodule_get_manager(command_data->materialmodule)))
-							 {
-									command_prefix="gfx create material ";
-									return_code=FOR_EACH_OBJECT_IN_MANAGER(cmzn_material)(
-										 write_Graphical_material_commands_to_comfile,(void *)command_prefix,
-										 graphical_material_manager);
-							 }
-							 return_code =1;
+							cmzn_loggernotifier_set_callback(command_data->loggerNotifier,
+								display_command_window_message, command_data->command_window);
+						}
+#endif /* defined (USE_CMGUI_COMMAND_WINDOW) */
+						if (0 < captured_messages.errors.size())
+						{
+							display_message(ERROR_MESSAGE, "%s", captured_messages.errors.c_str());
+						}
+					}
 #if defined (USE_CMGUI_GRAPHICS_WINDOW)
-							 return_code=FOR_EACH_OBJECT_IN_MANAGER(Graphics_window)(
-									write_Graphics_window_commands_to_comfile,(void *)NULL,
-									command_data->graphics_window_manager);
+					FOR_EACH_OBJECT_IN_MANAGER(Graphics_window)(
+						gfx_write_all_graphics_window_commands, static_cast<void *>(&write_message),
+						command_data->graphics_window_manager);
 #endif /*defined (USE_CMGUI_GRAPHICS_WINDOW)*/
-							 rename("temp_file_com.com", com_file_name);
-						}
-				 }
-#if defined (WX_USER_INTERFACE)
-				 if (exfile_name)
-				 {
-						filedir_compressing_process_wx_compress(com_file_name, exfile_name,
-							 exfile_return_code, file_name, temp_exfile);
-				 }
-#if !defined (WIN32_SYSTEM)
-				 if (unlink(temp_exfile) == -1)
-				 {
-						display_message(ERROR_MESSAGE,
-							 "gfx_write_all.  Could not unlink temporary exregion file");
-				 }
-				 if (unlink(com_file_name) == -1)
-				 {
+					if (!(Zip_writer_begin_entry(zip_writer, com_file_name.c_str()) &&
+						Zip_writer_write(zip_writer, commands.data(), commands.size()) &&
+						Zip_writer_finish(zip_writer)))
+					{
 						display_message(ERROR_MESSAGE,
-							 "compressing_process_wx_compress.  Could not unlink temporary com file");
-				 }
-#endif /*!definde (WIN32_SYSTEM)*/
-#endif /* defined (WX_USER_INTERFACE) */
-				 if (com_file_name)
-				 {
-						DEALLOCATE(com_file_name);
-				 }
-				 if (exfile_name)
-				 {
-						DEALLOCATE(exfile_name);
-				 }
+							"gfx write all.  Could not write %s", file_name);
+						return_code = 0;
+					}
+				}
+				if (zip_writer)
+				{
+					DESTROY(Zip_writer)(&zip_writer);
+				}
 				if (group_name)
 					DEALLOCATE(group_name);
 			}
@@ -14991,106 +16201,130 @@ Executes a GFX WRITE command.
 	return (return_code);
 } /* execute_command_gfx_write */
 
-static int execute_command_gfx(struct Parse_state *state,
-	void *dummy_to_be_modified,void *command_data_void)
+static struct Option_table *create_gfx_option_table(
+	struct cmzn_command_data *command_data)
 /*******************************************************************************
-LAST MODIFIED : 6 March 2003
+LAST MODIFIED : 16 October 2026
 
 DESCRIPTION :
-Executes a GFX command.
+Creates the option table for GFX commands. Since all its entries are bound to
+the <command_data> only, it is built once and reused for every GFX command.
 ==============================================================================*/
 {
-	int return_code;
 	struct Option_table *option_table;
-	struct cmzn_command_data *command_data;
-
-	ENTER(execute_command_gfx);
-	USE_PARAMETER(dummy_to_be_modified);
-	if (state && (command_data = (struct cmzn_command_data *)command_data_void))
-	{
-		if (state->current_token)
-		{
-			option_table=CREATE(Option_table)();
-			Option_table_add_entry(option_table, "change_identifier", NULL,
-				command_data_void, gfx_change_identifier);
-			Option_table_add_entry(option_table, "convert", NULL,
-				command_data_void, gfx_convert);
-			Option_table_add_entry(option_table, "create", NULL,
-				command_data_void, execute_command_gfx_create);
+	void *command_data_void;
+
+	ENTER(create_gfx_option_table);
+	command_data_void = (void *)command_data;
+	option_table=CREATE(Option_table)();
+	Option_table_add_entry(option_table, "change_identifier", NULL,
+		command_data_void, gfx_change_identifier);
+	Option_table_add_entry(option_table, "convert", NULL,
+		command_data_void, gfx_convert);
+	Option_table_add_entry(option_table, "create", NULL,
+		command_data_void, execute_command_gfx_create);
 #if defined (GTK_USER_INTERFACE) || defined (WIN32_USER_INTERFACE) || defined (WX_USER_INTERFACE)
-			Option_table_add_entry(option_table, "data_tool", /*data_tool*/(void *)1,
-			   command_data_void, execute_command_gfx_node_tool);
+	Option_table_add_entry(option_table, "data_tool", /*data_tool*/(void *)1,
+	   command_data_void, execute_command_gfx_node_tool);
 #endif /* defined (GTK_USER_INTERFACE) || defined (WIN32_USER_INTERFACE) || defined (WX_USER_INTERFACE)*/
-			Option_table_add_entry(option_table, "define", NULL,
-				command_data_void, execute_command_gfx_define);
-			Option_table_add_entry(option_table, "destroy", NULL,
-				command_data_void, execute_command_gfx_destroy);
-			Option_table_add_entry(option_table, "draw", NULL,
-				command_data_void, execute_command_gfx_draw);
-			Option_table_add_entry(option_table, "edit", NULL,
-				command_data_void, execute_command_gfx_edit);
+	Option_table_add_entry(option_table, "define", NULL,
+		command_data_void, execute_command_gfx_define);
+	Option_table_add_entry(option_table, "destroy", NULL,
+		command_data_void, execute_command_gfx_destroy);
+	Option_table_add_entry(option_table, "draw", NULL,
+		command_data_void, execute_command_gfx_draw);
+	Option_table_add_entry(option_table, "edit", NULL,
+		command_data_void, execute_command_gfx_edit);
 #if defined (WX_USER_INTERFACE)
-			Option_table_add_entry(option_table, "element_creator", NULL,
-				command_data_void, execute_command_gfx_element_creator);
+	Option_table_add_entry(option_table, "element_creator", NULL,
+		command_data_void, execute_command_gfx_element_creator);
 #endif /* defined (WX_USER_INTERFACE) */
 #if defined (GTK_USER_INTERFACE) || defined (WIN32_USER_INTERFACE) || defined (CARBON_USER_INTERFACE) || defined (WX_USER_INTERFACE)
-			Option_table_add_entry(option_table, "element_point_tool", NULL,
-				command_data_void, execute_command_gfx_element_point_tool);
+	Option_table_add_entry(option_table, "element_point_tool", NULL,
+		command_data_void, execute_command_gfx_element_point_tool);
 #endif /* defined (GTK_USER_INTERFACE) || defined	(WIN32_USER_INTERFACE) || defined (CARBON_USER_INTERFACE)  || defined (WX_USER_INTERFACE)*/
 #if defined (GTK_USER_INTERFACE) || defined (WIN32_USER_INTERFACE) || defined (CARBON_USER_INTERFACE) || defined (WX_USER_INTERFACE)
-			Option_table_add_entry(option_table, "element_tool", NULL,
-				command_data_void, execute_command_gfx_element_tool);
+	Option_table_add_entry(option_table, "element_tool", NULL,
+		command_data_void, execute_command_gfx_element_tool);
 #endif /* defined (GTK_USER_INTERFACE) || defined (WIN32_USER_INTERFACE) || defined (CARBON_USER_INTERFACE) || defined (WX_USER_INTERFACE) */
-			Option_table_add_entry(option_table, "evaluate", NULL,
-				command_data_void, gfx_evaluate);
-			Option_table_add_entry(option_table, "export", NULL,
-				command_data_void, execute_command_gfx_export);
+	Option_table_add_entry(option_table, "evaluate", NULL,
+		command_data_void, gfx_evaluate);
+	Option_table_add_entry(option_table, "export", NULL,
+		command_data_void, execute_command_gfx_export);
 #if defined (USE_OPENCASCADE)
-			Option_table_add_entry(option_table, "import", NULL,
-				command_data_void, execute_command_gfx_import);
+	Option_table_add_entry(option_table, "import", NULL,
+		command_data_void, execute_command_gfx_import);
 #endif /* defined (USE_OPENCASCADE) */
-			Option_table_add_entry(option_table, "list", NULL,
-				command_data_void, execute_command_gfx_list);
-			Option_table_add_entry(option_table, "minimise",
-				NULL, (void *)command_data->root_region, gfx_minimise);
-			Option_table_add_entry(option_table, "modify", NULL,
-				command_data_void, execute_command_gfx_modify);
+	Option_table_add_entry(option_table, "list", NULL,
+		command_data_void, execute_command_gfx_list);
+	Option_table_add_entry(option_table, "minimise",
+		NULL, (void *)command_data->root_region, gfx_minimise);
+	Option_table_add_entry(option_table, "modify", NULL,
+		command_data_void, execute_command_gfx_modify);
 #if defined (SGI_MOVIE_FILE)
-			Option_table_add_entry(option_table, "movie", NULL,
-				command_data_void, gfx_movie);
+	Option_table_add_entry(option_table, "movie", NULL,
+		command_data_void, gfx_movie);
 #endif /* defined (SGI_MOVIE_FILE) */
 #if defined (GTK_USER_INTERFACE) || defined (WIN32_USER_INTERFACE) || defined (CARBON_USER_INTERFACE) || defined (WX_USER_INTERFACE)
-			Option_table_add_entry(option_table, "node_tool", /*data_tool*/(void *)0,
-				command_data_void, execute_command_gfx_node_tool);
+	Option_table_add_entry(option_table, "node_tool", /*data_tool*/(void *)0,
+		command_data_void, execute_command_gfx_node_tool);
 #endif /* defined (GTK_USER_INTERFACE) || defined	(WIN32_USER_INTERFACE) || defined (CARBON_USER_INTERFACE) || defined (WX_USER_INTERFACE) */
 #if defined (GTK_USER_INTERFACE) || defined (WIN32_USER_INTERFACE) || defined (WX_USER_INTERFACE)
-			Option_table_add_entry(option_table, "print", NULL,
-				command_data_void, execute_command_gfx_print);
+	Option_table_add_entry(option_table, "print", NULL,
+		command_data_void, execute_command_gfx_print);
 #endif
-			Option_table_add_entry(option_table, "read", NULL,
-				command_data_void, execute_command_gfx_read);
-			Option_table_add_entry(option_table, "select", /*unselect*/0,
-				command_data_void, execute_command_gfx_select);
-			Option_table_add_entry(option_table, "set", NULL,
-				command_data_void, execute_command_gfx_set);
-			Option_table_add_entry(option_table, "mesh", NULL,
-				command_data_void, execute_command_gfx_mesh);
-			Option_table_add_entry(option_table, "smooth", NULL,
-				command_data_void, execute_command_gfx_smooth);
-			Option_table_add_entry(option_table, "timekeeper", NULL,
-				command_data_void, gfx_timekeeper);
-			Option_table_add_entry(option_table, "transform_tool", NULL,
-				command_data_void, gfx_transform_tool);
-			Option_table_add_entry(option_table, "unselect", /*unselect*/reinterpret_cast<void *>(1),
-				command_data_void, execute_command_gfx_select);
+	Option_table_add_entry(option_table, "read", NULL,
+		command_data_void, execute_command_gfx_read);
+	Option_table_add_entry(option_table, "select", /*unselect*/0,
+		command_data_void, execute_command_gfx_select);
+	Option_table_add_entry(option_table, "set", NULL,
+		command_data_void, execute_command_gfx_set);
+	Option_table_add_entry(option_table, "mesh", NULL,
+		command_data_void, execute_command_gfx_mesh);
+	Option_table_add_entry(option_table, "smooth", NULL,
+		command_data_void, execute_command_gfx_smooth);
+	Option_table_add_entry(option_table, "timekeeper", NULL,
+		command_data_void, gfx_timekeeper);
+	Option_table_add_entry(option_table, "timing", NULL,
+		command_data_void, gfx_timing);
+	Option_table_add_entry(option_table, "transform_tool", NULL,
+		command_data_void, gfx_transform_tool);
+	Option_table_add_entry(option_table, "unselect", /*unselect*/reinterpret_cast<void *>(1),
+		command_data_void, execute_command_gfx_select);
 #if defined (WX_USER_INTERFACE)
-			Option_table_add_entry(option_table, "update", NULL,
-				command_data_void, execute_command_gfx_update);
+	Option_table_add_entry(option_table, "update", NULL,
+		command_data_void, execute_command_gfx_update);
 #endif /* defined (WX_USER_INTERFACE) */
-			Option_table_add_entry(option_table, "write", NULL,
-				command_data_void, execute_command_gfx_write);
-			return_code = Option_table_parse(option_table, state);
-			DESTROY(Option_table)(&option_table);
+	Option_table_add_entry(option_table, "write", NULL,
+		command_data_void, execute_command_gfx_write);
+	LEAVE;
+
+	return (option_table);
+} /* create_gfx_option_table */
+
+static int execute_command_gfx(struct Parse_state *state,
+	void *dummy_to_be_modified,void *command_data_void)
+/*******************************************************************************
+LAST MODIFIED : 6 March 2003
+
+DESCRIPTION :
+Executes a GFX command.
+==============================================================================*/
+{
+	int return_code;
+	struct cmzn_command_data *command_data;
+
+	ENTER(execute_command_gfx);
+	USE_PARAMETER(dummy_to_be_modified);
+	if (state && (command_data = (struct cmzn_command_data *)command_data_void))
+	{
+		if (state->current_token)
+		{
+			if (!command_data->gfx_option_table)
+			{
+				command_data->gfx_option_table = create_gfx_option_table(command_data);
+			}
+			return_code = Option_table_parse(command_data->gfx_option_table, state);
 		}
 		else
 		{
@@ -15108,8 +16342,143 @@ Executes a GFX command.
 	return (return_code);
 } /* execute_command_gfx */
 
+/***************************************************************************//**
+ * Writes the number of fields, nodes, data points and elements of each
+ * dimension in <region> and its subregions to the command window.
+ */
+static int list_memory_region_summary(cmzn_region_id region)
+{
+	int return_code = 1;
+	char *region_path = cmzn_region_get_path(region);
+	cmzn_fieldmodule_id field_module = cmzn_region_get_fieldmodule(region);
+	int number_of_fields = 0;
+	cmzn_fielditerator_id field_iterator = cmzn_fieldmodule_create_fielditerator(field_module);
+	cmzn_field_id field;
+	while (0 != (field = cmzn_fielditerator_next_non_access(field_iterator)))
+		++number_of_fields;
+	cmzn_fielditerator_destroy(&field_iterator);
+	int nodeset_sizes[2];
+	for (int i = 0; i < 2; ++i)
+	{
+		cmzn_nodeset_id nodeset = cmzn_fieldmodule_find_nodeset_by_field_domain_type(field_module,
+			(0 == i) ? CMZN_FIELD_DOMAIN_TYPE_NODES : CMZN_FIELD_DOMAIN_TYPE_DATAPOINTS);
+		nodeset_sizes[i] = cmzn_nodeset_get_size(nodeset);
+		cmzn_nodeset_destroy(&nodeset);
+	}
+	int mesh_sizes[3];
+	for (int dimension = 1; dimension <= 3; ++dimension)
+	{
+		cmzn_mesh_id mesh = cmzn_fieldmodule_find_mesh_by_dimension(field_module, dimension);
+		mesh_sizes[dimension - 1] = cmzn_mesh_get_size(mesh);
+		cmzn_mesh_destroy(&mesh);
+	}
+	cmzn_fieldmodule_destroy(&field_module);
+	display_message(INFORMATION_MESSAGE, "%-32s %8d %10d %10d %10d %10d %10d\n",
+		region_path, number_of_fields, nodeset_sizes[0], nodeset_sizes[1],
+		mesh_sizes[2], mesh_sizes[1], mesh_sizes[0]);
+	DEALLOCATE(region_path);
+	cmzn_region_id child = cmzn_region_get_first_child(region);
+	while (child)
+	{
+		if (!list_memory_region_summary(child))
+		{
+			cmzn_region_destroy(&child);
+			return_code = 0;
+			break;
+		}
+		cmzn_region_reaccess_next_sibling(&child);
+	}
+	return return_code;
+}
+
+/***************************************************************************//**
+ * Executes a LIST_MEMORY SUMMARY command. Sets the char flag
+ * <summary_flag_void> so the allocation listing is not also written.
+ */
+static int list_memory_summary(struct Parse_state *state,
+	void *summary_flag_void, void *command_data_void)
+{
+	int return_code;
+
+	ENTER(list_memory_summary);
+	char *summary_flag = reinterpret_cast<char *>(summary_flag_void);
+	cmzn_command_data *command_data = reinterpret_cast<cmzn_command_data *>(command_data_void);
+	if (state && summary_flag && command_data)
+	{
+		char *by_name = 0;
+		char *file_name = 0;
+		double sample_seconds = -1.0;
+
+		Option_table *option_table = CREATE(Option_table)();
+		Option_table_add_help(option_table,
+			"List the current and peak bytes held by each kind of large buffer cmgui "
+			"allocates itself, with the process heap and peak resident sizes where "
+			"known, or with <by region> the number of fields, nodes, data points and "
+			"elements in each region. The buffers are not totals by category: "
+			"textures, graphics and node and element storage are allocated inside "
+			"the Zinc library and only included in the process figures. With "
+			"<sample> SECONDS, write these figures at most every SECONDS while "
+			"command files run, to the command window or <file>; sample 0 stops "
+			"sampling.");
+		/* by */
+		Option_table_add_string_entry(option_table, "by", &by_name,
+			" buffer|region");
+		/* file */
+		Option_table_add_entry(option_table, "file", &file_name,
+			(void *)1, set_name);
+		/* sample */
+		Option_table_add_non_negative_double_entry(option_table, "sample",
+			&sample_seconds);
+		return_code = Option_table_multi_parse(option_table, state);
+		DESTROY(Option_table)(&option_table);
+		if (return_code)
+		{
+			*summary_flag = 1;
+			if (0.0 <= sample_seconds)
+			{
+				return_code = Memory_accounting_set_sampling(sample_seconds, file_name);
+			}
+			else if (file_name)
+			{
+				display_message(WARNING_MESSAGE,
+					"list_memory summary:  file is only used with sample");
+			}
+			if (by_name && fuzzy_string_compare(by_name, "region"))
+			{
+				display_message(INFORMATION_MESSAGE, "%-32s %8s %10s %10s %10s %10s %10s\n",
+					"region", "fields", "nodes", "data", "3-D", "2-D", "1-D");
+				if (!list_memory_region_summary(command_data->root_region))
+					return_code = 0;
+			}
+			else if ((!by_name) || fuzzy_string_compare(by_name, "buffer"))
+			{
+				if (!Memory_accounting_list())
+					return_code = 0;
+			}
+			else
+			{
+				display_message(ERROR_MESSAGE,
+					"list_memory summary:  Unknown grouping '%s'", by_name);
+				return_code = 0;
+			}
+		}
+		if (file_name)
+			DEALLOCATE(file_name);
+		if (by_name)
+			DEALLOCATE(by_name);
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE, "list_memory_summary.  Invalid argument(s)");
+		return_code = 0;
+	}
+	LEAVE;
+
+	return (return_code);
+} /* list_memory_summary */
+
 static int execute_command_list_memory(struct Parse_state *state,
-	void *dummy_to_be_modified,void *dummy_user_data)
+	void *dummy_to_be_modified,void *command_data_void)
 /*******************************************************************************
 LAST MODIFIED : 16 June 1999
 
@@ -15117,29 +16486,32 @@ DESCRIPTION :
 Executes a LIST_MEMORY command.
 ==============================================================================*/
 {
-	char increment_counter, suppress_pointers;
+	char increment_counter, summary_flag, suppress_pointers;
 	int count_number,return_code,set_counter;
 	static struct Modifier_entry option_table[]=
 	{
 		{"increment_counter",NULL,NULL,set_char_flag},
+		{"summary",NULL,NULL,list_memory_summary},
 		{"suppress_pointers",NULL,NULL,set_char_flag},
 		{NULL,NULL,NULL,set_int}
 	};
 
 	ENTER(execute_command_list_memory);
 	USE_PARAMETER(dummy_to_be_modified);
-	USE_PARAMETER(dummy_user_data);
 	if (state)
 	{
 		count_number=0;
 		increment_counter = 0;
+		summary_flag = 0;
 		suppress_pointers = 0;
 		(option_table[0]).to_be_modified= &increment_counter;
-		(option_table[1]).to_be_modified= &suppress_pointers;
-		(option_table[2]).to_be_modified= &count_number;
+		(option_table[1]).to_be_modified= &summary_flag;
+		(option_table[1]).user_data= command_data_void;
+		(option_table[2]).to_be_modified= &suppress_pointers;
+		(option_table[3]).to_be_modified= &count_number;
 		return_code=process_multiple_options(state,option_table);
 		/* no errors, not asking for help */
-		if (return_code)
+		if (return_code && (!summary_flag))
 		{
 			if (increment_counter)
 			{
@@ -15655,6 +17027,9 @@ Executes a SET command.
 				/* directory */
 				Option_table_add_entry(option_table, "directory", NULL,
 					command_data_void, set_dir);
+				/* mmap_read/no_mmap_read */
+				Option_table_add_switch(option_table, "mmap_read", "no_mmap_read",
+					&(command_data->read_mmap));
 				return_code=Option_table_parse(option_table, state);
 				DESTROY(Option_table)(&option_table);
 			}
@@ -15746,6 +17121,98 @@ Executes a SET DIR #CMGUI_EXAMPLE_DIRECTORY_SYMBOL command.
 	return (return_code);
 } /* execute_command_system */
 
+#if defined (WIN32_USER_INTERFACE) || defined (GTK_USER_INTERFACE)
+static int execute_command_command_window(struct Parse_state *state,
+	void *dummy_to_be_modified, void *command_data_void)
+/*******************************************************************************
+LAST MODIFIED : 17 October 2026
+
+DESCRIPTION :
+Executes a COMMAND_WINDOW command on the current command window, looked up from
+the <command_data_void> each time since the window may be created or replaced
+after the top-level option table is built.
+==============================================================================*/
+{
+	int return_code;
+	struct cmzn_command_data *command_data;
+
+	ENTER(execute_command_command_window);
+	if (state && (command_data = (struct cmzn_command_data *)command_data_void))
+	{
+		return_code = modify_Command_window(state, dummy_to_be_modified,
+			(void *)command_data->command_window);
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"execute_command_command_window.  Invalid argument(s)");
+		return_code = 0;
+	}
+	LEAVE;
+
+	return (return_code);
+} /* execute_command_command_window */
+#endif /* defined (WIN32_USER_INTERFACE) || defined (GTK_USER_INTERFACE) */
+
+static struct Option_table *create_command_option_table(
+	struct cmzn_command_data *command_data)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Creates the option table for top-level commands. Since all its entries are
+bound to the <command_data> only, looking up anything which may change, such as
+the command window, when executed, it is built once and reused for every
+command.
+==============================================================================*/
+{
+	struct Option_table *option_table;
+	void *command_data_void;
+
+	ENTER(create_command_option_table);
+	command_data_void = (void *)command_data;
+	option_table = CREATE(Option_table)();
+#if defined (SELECT_DESCRIPTORS)
+	/* attach */
+	Option_table_add_entry(option_table, "attach", NULL, command_data_void,
+		execute_command_attach);
+#endif /* !defined (SELECT_DESCRIPTORS) */
+#if defined (WIN32_USER_INTERFACE) || defined (GTK_USER_INTERFACE)
+	/* command_window */
+	Option_table_add_entry(option_table, "command_window", NULL, command_data_void,
+		execute_command_command_window);
+#endif /* defined (WIN32_USER_INTERFACE) || defined (GTK_USER_INTERFACE) */
+#if defined (SELECT_DESCRIPTORS)
+	/* detach */
+	Option_table_add_entry(option_table, "detach", NULL, command_data_void,
+		execute_command_detach);
+#endif /* !defined (SELECT_DESCRIPTORS) */
+	/* gfx */
+	Option_table_add_entry(option_table, "gfx", NULL, command_data_void,
+		execute_command_gfx);
+	/* open */
+	Option_table_add_entry(option_table, "open", NULL, command_data_void,
+		execute_command_open);
+	/* quit */
+	Option_table_add_entry(option_table, "quit", NULL, command_data_void,
+		execute_command_quit);
+	/* list_memory */
+	Option_table_add_entry(option_table, "list_memory", NULL, command_data_void,
+		execute_command_list_memory);
+	/* read */
+	Option_table_add_entry(option_table, "read", NULL, command_data_void,
+		execute_command_read);
+	/* set */
+	Option_table_add_entry(option_table, "set", NULL, command_data_void,
+		execute_command_set);
+	/* system */
+	Option_table_add_entry(option_table, "system", NULL, command_data_void,
+		execute_command_system);
+	LEAVE;
+
+	return (option_table);
+} /* create_command_option_table */
+
 /*
 Global functions
 ----------------
@@ -15759,19 +17226,22 @@ LAST MODIFIED : 17 July 2002
 DESCRIPTION:
 ==============================================================================*/
 {
-	char **token;
+	char **token, timing_key[64];
 	int i,return_code = 1;
 	struct cmzn_command_data *command_data;
-	struct Option_table *option_table;
 	struct Parse_state *state;
 
 	ENTER(execute_command);
 	USE_PARAMETER(quit);
 	if (NULL != (command_data = (struct cmzn_command_data *)command_data_void))
 	{
+		timing_key[0] = '\0';
+		Command_timing_begin(command_data->command_timing);
 		if (NULL != (state = create_Parse_state(command_string)))
 			/*???DB.  create_Parse_state has to be extended */
 		{
+			Command_timing_make_key(timing_key, sizeof(timing_key), state->tokens,
+				state->number_of_tokens);
 			i=state->number_of_tokens;
 			/* check for comment */
 			if (i>0)
@@ -15791,45 +17261,13 @@ DESCRIPTION:
 				}
 				else
 				{
-					option_table = CREATE(Option_table)();
-#if defined (SELECT_DESCRIPTORS)
-					/* attach */
-					Option_table_add_entry(option_table, "attach", NULL, command_data_void,
-						execute_command_attach);
-#endif /* !defined (SELECT_DESCRIPTORS) */
-#if defined (WIN32_USER_INTERFACE) || defined (GTK_USER_INTERFACE)
-					/* command_window */
-					Option_table_add_entry(option_table, "command_window", NULL, command_data->command_window,
-						modify_Command_window);
-#endif /* defined (WIN32_USER_INTERFACE) || defined (GTK_USER_INTERFACE) */
-#if defined (SELECT_DESCRIPTORS)
-					/* detach */
-					Option_table_add_entry(option_table, "detach", NULL, command_data_void,
-						execute_command_detach);
-#endif /* !defined (SELECT_DESCRIPTORS) */
-					/* gfx */
-					Option_table_add_entry(option_table, "gfx", NULL, command_data_void,
-						execute_command_gfx);
-					/* open */
-					Option_table_add_entry(option_table, "open", NULL, command_data_void,
-						execute_command_open);
-					/* quit */
-					Option_table_add_entry(option_table, "quit", NULL, command_data_void,
-						execute_command_quit);
-					/* list_memory */
-					Option_table_add_entry(option_table, "list_memory", NULL, NULL,
-						execute_command_list_memory);
-					/* read */
-					Option_table_add_entry(option_table, "read", NULL, command_data_void,
-						execute_command_read);
-					/* set */
-					Option_table_add_entry(option_table, "set", NULL, command_data_void,
-						execute_command_set);
-					/* system */
-					Option_table_add_entry(option_table, "system", NULL, command_data_void,
-						execute_command_system);
-					return_code=Option_table_parse(option_table, state);
-					DESTROY(Option_table)(&option_table);
+					if (!command_data->command_option_table)
+					{
+						command_data->command_option_table =
+							create_command_option_table(command_data);
+					}
+					Command_timing_parsed(command_data->command_timing);
+					return_code=Option_table_parse(command_data->command_option_table, state);
 				}
 				// Catching case where a fail returned code is returned but we are
 				// asking for help, reseting the return code to pass if this is the case.
@@ -15849,6 +17287,7 @@ DESCRIPTION:
 				"cmiss_execute_command.  Could not create parse state");
 			return_code=0;
 		}
+		Command_timing_end(command_data->command_timing, timing_key);
 	}
 	else
 	{
@@ -15920,18 +17359,21 @@ DESCRIPTION:
 Execute a <command_string>. If there is a command
 ==============================================================================*/
 {
-	char **token;
+	char **token, timing_key[64];
 	int i,return_code = 0;
 	struct cmzn_command_data *command_data;
-	struct Option_table *option_table;
 	struct Parse_state *state;
 
 	ENTER(cmiss_execute_command);
 	if (NULL != (command_data = (struct cmzn_command_data *)command_data_void))
 	{
+		timing_key[0] = '\0';
+		Command_timing_begin(command_data->command_timing);
 		if (NULL != (state = create_Parse_state(command_string)))
 			/*???DB.  create_Parse_state has to be extended */
 		{
+			Command_timing_make_key(timing_key, sizeof(timing_key), state->tokens,
+				state->number_of_tokens);
 			i=state->number_of_tokens;
 			/* check for comment */
 			if (i>0)
@@ -15959,45 +17401,13 @@ Execute a <command_string>. If there is a command
 				}
 				else
 				{
-					option_table = CREATE(Option_table)();
-#if defined (SELECT_DESCRIPTORS)
-					/* attach */
-					Option_table_add_entry(option_table, "attach", NULL, command_data_void,
-						execute_command_attach);
-#endif /* !defined (SELECT_DESCRIPTORS) */
-#if defined (WIN32_USER_INTERFACE) || defined (GTK_USER_INTERFACE)
-					/* command_window */
-					Option_table_add_entry(option_table, "command_window", NULL, command_data->command_window,
-						modify_Command_window);
-#endif /* defined (WIN32_USER_INTERFACE) || defined (GTK_USER_INTERFACE) */
-#if defined (SELECT_DESCRIPTORS)
-					/* detach */
-					Option_table_add_entry(option_table, "detach", NULL, command_data_void,
-						execute_command_detach);
-#endif /* !defined (SELECT_DESCRIPTORS) */
-					/* gfx */
-					Option_table_add_entry(option_table, "gfx", NULL, command_data_void,
-						execute_command_gfx);
-					/* open */
-					Option_table_add_entry(option_table, "open", NULL, command_data_void,
-						execute_command_open);
-					/* quit */
-					Option_table_add_entry(option_table, "quit", NULL, command_data_void,
-						execute_command_quit);
-					/* list_memory */
-					Option_table_add_entry(option_table, "list_memory", NULL, NULL,
-						execute_command_list_memory);
-					/* read */
-					Option_table_add_entry(option_table, "read", NULL, command_data_void,
-						execute_command_read);
-					/* set */
-					Option_table_add_entry(option_table, "set", NULL, command_data_void,
-						execute_command_set);
-					/* system */
-					Option_table_add_entry(option_table, "system", NULL, command_data_void,
-						execute_command_system);
-					return_code=Option_table_parse(option_table, state);
-					DESTROY(Option_table)(&option_table);
+					if (!command_data->command_option_table)
+					{
+						command_data->command_option_table =
+							create_command_option_table(command_data);
+					}
+					Command_timing_parsed(command_data->command_timing);
+					return_code=Option_table_parse(command_data->command_option_table, state);
 				}
 			}
 #if defined (WIN32_USER_INTERFACE) || defined (GTK_USER_INTERFACE) || defined (WX_USER_INTERFACE)
@@ -16014,6 +17424,7 @@ Execute a <command_string>. If there is a command
 				"cmiss_execute_command.  Could not create parse state");
 			return_code=0;
 		}
+		Command_timing_end(command_data->command_timing, timing_key);
 	}
 	else
 	{
@@ -16537,6 +17948,11 @@ Initialise all the subcomponents of cmgui and create the cmzn_command_data
 		command_data->element_point_ranges_selection=(struct Element_point_ranges_selection *)NULL;
 		command_data->interactive_tool_manager=(struct MANAGER(Interactive_tool) *)NULL;
 		command_data->io_stream_package = (struct IO_stream_package *)NULL;
+		command_data->read_mmap = 0;
+		command_data->image_filter_cache = (struct Image_filter_cache *)NULL;
+		command_data->command_option_table = (struct Option_table *)NULL;
+		command_data->gfx_option_table = (struct Option_table *)NULL;
+		command_data->command_timing = (struct Command_timing *)NULL;
 		command_data->computed_field_package=(struct Computed_field_package *)NULL;
 		command_data->default_scene=(struct Scene *)NULL;
 		command_data->scene_manager=(struct MANAGER(Scene) *)NULL;
@@ -16676,6 +18092,8 @@ Initialise all the subcomponents of cmgui and create the cmzn_command_data
 		}
 
 		command_data->io_stream_package = cmzn_context_get_default_IO_stream_package(cmzn_context_app_get_core_context(context));
+		command_data->image_filter_cache = CREATE(Image_filter_cache)();
+		command_data->command_timing = CREATE(Command_timing)();
 
 #if defined (F90_INTERPRETER) || defined (USE_PERL_INTERPRETER)
 		/* SAB I want to do this before CREATEing the User_interface
@@ -17287,6 +18705,18 @@ NOTE: Do not call this directly: call cmzn_command_data_destroy() to deaccess.
 		DESTROY(LIST(Io_device))(&command_data->device_list);
 #endif /* defined (SELECT_DESCRIPTORS) */
 
+		if (command_data->image_filter_cache)
+			DESTROY(Image_filter_cache)(&command_data->image_filter_cache);
+		Connected_threshold_parallel_clear();
+		if (command_data->command_option_table)
+		{
+			DESTROY(Option_table)(&command_data->command_option_table);
+		}
+		if (command_data->gfx_option_table)
+		{
+			DESTROY(Option_table)(&command_data->gfx_option_table);
+		}
+		DESTROY(Command_timing)(&command_data->command_timing);
 		DEACCESS(cmzn_region)(&(command_data->root_region));
 		DESTROY(MANAGER(FE_basis))(&command_data->basis_manager);
 		DESTROY(LIST(FE_element_shape))(&command_data->element_shape_list);
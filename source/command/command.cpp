@@ -17,6 +17,7 @@ Functions associated with commands.
 #include <stdio.h>
 #include "command/command.h"
 #include "general/debug.h"
+#include "general/memory_accounting.h"
 #include "general/mystring.h"
 #include "general/message.h"
 #include "user_interface/user_interface.h"
@@ -260,6 +261,7 @@ Opens, executes and then closes a com file.  No window is created.
 				{
 					Execute_command_execute_string(execute_command, command_string);
 					DEALLOCATE(command_string);
+					Memory_accounting_sample_if_due();
 					IO_stream_scan(comfile," ");
 				}
 				IO_stream_close(comfile);
@@ -0,0 +1,378 @@
+/**
+ * FILE : command_timing.cpp
+ *
+ * Accumulates the time spent parsing and executing commands.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+#include "configure/cmgui_configure.h"
+#include "command/command_timing.h"
+#include "general/debug.h"
+#include "general/memory_accounting.h"
+#include "general/message.h"
+#include "general/cmgui_time.h"
+#if defined (UNIX)
+#include <sys/resource.h>
+#endif /* defined (UNIX) */
+
+namespace {
+
+/** Histogram buckets of command times by decade: under 1 ms, under 10 ms,
+ * under 100 ms, under 1 s, under 10 s and 10 s or more. */
+const int COMMAND_TIMING_HISTOGRAM_SIZE = 6;
+
+struct Command_timing_entry
+{
+	long count;
+	double parse_seconds, total_seconds, maximum_seconds, cpu_seconds, heap_bytes;
+	long histogram[COMMAND_TIMING_HISTOGRAM_SIZE];
+
+	Command_timing_entry() :
+		count(0),
+		parse_seconds(0.0),
+		total_seconds(0.0),
+		maximum_seconds(0.0),
+		cpu_seconds(0.0),
+		heap_bytes(0.0)
+	{
+		for (int i = 0; i < COMMAND_TIMING_HISTOGRAM_SIZE; ++i)
+			histogram[i] = 0;
+	}
+};
+
+typedef std::map<std::string, Command_timing_entry> Command_timing_map;
+
+/** Timing of a command in progress. */
+struct Command_timing_frame
+{
+	/* only set if recording was on when the command began; otherwise the
+	 * frame just keeps nesting correct and no clocks or heap are read */
+	bool recording;
+	double start_seconds, parsed_seconds, nested_seconds;
+	double start_cpu_seconds, nested_cpu_seconds;
+	double start_heap_bytes, nested_heap_bytes;
+};
+
+typedef std::pair<std::string, Command_timing_entry> Command_timing_item;
+
+class Command_timing_item_greater
+{
+	enum Command_timing_sort sort;
+
+	double value(const Command_timing_entry &entry) const
+	{
+		switch (sort)
+		{
+			case COMMAND_TIMING_SORT_MEAN:
+				return entry.total_seconds/(double)entry.count;
+			case COMMAND_TIMING_SORT_MAXIMUM:
+				return entry.maximum_seconds;
+			case COMMAND_TIMING_SORT_COUNT:
+				return (double)entry.count;
+			case COMMAND_TIMING_SORT_TOTAL:
+				break;
+		}
+		return entry.total_seconds;
+	}
+
+public:
+	explicit Command_timing_item_greater(enum Command_timing_sort sort_in) :
+		sort(sort_in)
+	{
+	}
+
+	bool operator()(const Command_timing_item &item1,
+		const Command_timing_item &item2) const
+	{
+		return value(item1.second) > value(item2.second);
+	}
+};
+
+/** Writes <line> to <file>, or to the command window if <file> is NULL. */
+void Command_timing_write_line(FILE *file, const char *line)
+{
+	if (file)
+		fputs(line, file);
+	else
+		display_message(INFORMATION_MESSAGE, "%s", line);
+}
+
+}
+
+struct Command_timing
+{
+	Command_timing_map entries;
+	std::vector<Command_timing_frame> frames;
+	bool enabled;
+
+	Command_timing() :
+		enabled(false)
+	{
+	}
+};
+
+struct Command_timing *CREATE(Command_timing)(void)
+{
+	return new Command_timing();
+}
+
+int DESTROY(Command_timing)(struct Command_timing **timing_address)
+{
+	if (timing_address && (*timing_address))
+	{
+		delete *timing_address;
+		*timing_address = 0;
+		return 1;
+	}
+	return 0;
+}
+
+double Command_timing_get_seconds(void)
+{
+	struct timeval time_value;
+	cmgui_gettimeofday(&time_value, NULL);
+	return (double)time_value.tv_sec + 1.0E-6*(double)time_value.tv_usec;
+}
+
+double Command_timing_get_cpu_seconds(void)
+{
+#if defined (UNIX)
+	struct rusage usage;
+	if (0 == getrusage(RUSAGE_SELF, &usage))
+	{
+		return (double)usage.ru_utime.tv_sec + 1.0E-6*(double)usage.ru_utime.tv_usec +
+			(double)usage.ru_stime.tv_sec + 1.0E-6*(double)usage.ru_stime.tv_usec;
+	}
+	return 0.0;
+#elif defined (WIN32_SYSTEM)
+	FILETIME creation_time, exit_time, kernel_time, user_time;
+	if (GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time,
+		&kernel_time, &user_time))
+	{
+		/* FILETIME counts 100 ns intervals */
+		return 1.0E-7*((double)kernel_time.dwLowDateTime + (double)user_time.dwLowDateTime +
+			4294967296.0*((double)kernel_time.dwHighDateTime + (double)user_time.dwHighDateTime));
+	}
+	return 0.0;
+#else
+	return (double)clock()/(double)CLOCKS_PER_SEC;
+#endif
+}
+
+void Command_timing_make_key(char *key, int key_size, char **tokens,
+	int number_of_tokens)
+{
+	if (key && (0 < key_size))
+	{
+		int length = 0;
+		/* gfx commands are grouped by their object type, e.g. gfx read nodes */
+		const int maximum_number_of_words = ((0 < number_of_tokens) && tokens[0] &&
+			(0 == strcmp(tokens[0], "gfx"))) ? 3 : 2;
+		for (int i = 0; (i < number_of_tokens) && (i < maximum_number_of_words); ++i)
+		{
+			const char *token = tokens[i];
+			if ((!token) || (!isalpha((unsigned char)token[0])))
+				break;
+			if ((0 < i) && (length < key_size - 1))
+				key[length++] = ' ';
+			for (; *token && (length < key_size - 1); ++token)
+				key[length++] = (char)tolower((unsigned char)*token);
+		}
+		key[length] = '\0';
+	}
+}
+
+int Command_timing_set_enabled(struct Command_timing *timing, int enabled)
+{
+	if (timing)
+	{
+		timing->enabled = (0 != enabled);
+		return 1;
+	}
+	return 0;
+}
+
+int Command_timing_is_enabled(struct Command_timing *timing)
+{
+	return (timing && timing->enabled) ? 1 : 0;
+}
+
+int Command_timing_begin(struct Command_timing *timing)
+{
+	if (timing)
+	{
+		Command_timing_frame frame;
+		frame.recording = timing->enabled;
+		frame.start_seconds = frame.recording ? Command_timing_get_seconds() : 0.0;
+		frame.parsed_seconds = frame.start_seconds;
+		frame.nested_seconds = 0.0;
+		frame.start_cpu_seconds = frame.recording ? Command_timing_get_cpu_seconds() : 0.0;
+		frame.nested_cpu_seconds = 0.0;
+		frame.start_heap_bytes = frame.recording ? Memory_accounting_get_heap_bytes() : 0.0;
+		frame.nested_heap_bytes = 0.0;
+		timing->frames.push_back(frame);
+		return 1;
+	}
+	return 0;
+}
+
+int Command_timing_parsed(struct Command_timing *timing)
+{
+	if (timing && (!timing->frames.empty()))
+	{
+		if (timing->frames.back().recording)
+			timing->frames.back().parsed_seconds = Command_timing_get_seconds();
+		return 1;
+	}
+	return 0;
+}
+
+int Command_timing_end(struct Command_timing *timing, const char *key)
+{
+	if (timing && (!timing->frames.empty()) && key)
+	{
+		Command_timing_frame frame = timing->frames.back();
+		timing->frames.pop_back();
+		/* also skips commands during which recording was turned on */
+		if (!frame.recording)
+			return 1;
+		double elapsed_seconds = Command_timing_get_seconds() - frame.start_seconds;
+		double elapsed_cpu_seconds = Command_timing_get_cpu_seconds() - frame.start_cpu_seconds;
+		double heap_bytes = Memory_accounting_get_heap_bytes() - frame.start_heap_bytes;
+		if (!timing->frames.empty())
+		{
+			Command_timing_frame &parent = timing->frames.back();
+			parent.nested_seconds += elapsed_seconds;
+			parent.nested_cpu_seconds += elapsed_cpu_seconds;
+			parent.nested_heap_bytes += heap_bytes;
+		}
+		if (('\0' == key[0]) || (!timing->enabled))
+			return 1;
+		double own_seconds = elapsed_seconds - frame.nested_seconds;
+		Command_timing_entry &entry = timing->entries[std::string(key)];
+		++entry.count;
+		entry.parse_seconds += frame.parsed_seconds - frame.start_seconds;
+		entry.total_seconds += own_seconds;
+		if (own_seconds > entry.maximum_seconds)
+			entry.maximum_seconds = own_seconds;
+		entry.cpu_seconds += elapsed_cpu_seconds - frame.nested_cpu_seconds;
+		entry.heap_bytes += heap_bytes - frame.nested_heap_bytes;
+		int bucket = 0;
+		for (double limit = 0.001; (bucket < COMMAND_TIMING_HISTOGRAM_SIZE - 1) &&
+			(own_seconds >= limit); limit *= 10.0)
+		{
+			++bucket;
+		}
+		++entry.histogram[bucket];
+		return 1;
+	}
+	return 0;
+}
+
+int Command_timing_reset(struct Command_timing *timing)
+{
+	if (timing)
+	{
+		timing->entries.clear();
+		return 1;
+	}
+	return 0;
+}
+
+int Command_timing_list(struct Command_timing *timing,
+	enum Command_timing_sort sort, const char *file_name)
+{
+	if (!timing)
+	{
+		display_message(ERROR_MESSAGE, "Command_timing_list.  Invalid argument(s)");
+		return 0;
+	}
+	FILE *file = 0;
+	if (file_name)
+	{
+		file = fopen(file_name, "w");
+		if (!file)
+		{
+			display_message(ERROR_MESSAGE,
+				"Could not open file %s for writing", file_name);
+			return 0;
+		}
+	}
+	char line[512];
+	if (timing->entries.empty())
+	{
+		Command_timing_write_line(file, "No command timings recorded\n");
+	}
+	else
+	{
+		std::vector<Command_timing_item> items(timing->entries.begin(),
+			timing->entries.end());
+		std::stable_sort(items.begin(), items.end(), Command_timing_item_greater(sort));
+		sprintf(line, "%-32s %8s %12s %12s %12s %12s %12s %12s  %s\n", "command",
+			"count", "total (s)", "parse (s)", "cpu (s)", "mean (ms)", "max (ms)",
+			"heap (kB)", "<1ms/<10ms/<100ms/<1s/<10s/>=10s");
+		Command_timing_write_line(file, line);
+		long total_count = 0;
+		double total_seconds = 0.0, total_parse_seconds = 0.0, total_cpu_seconds = 0.0;
+		double total_heap_bytes = 0.0;
+		for (std::vector<Command_timing_item>::iterator iter = items.begin();
+			iter != items.end(); ++iter)
+		{
+			const Command_timing_entry &entry = iter->second;
+			char heap[32];
+			if (Memory_accounting_heap_bytes_available())
+				sprintf(heap, "%12.0f", entry.heap_bytes/1024.0);
+			else
+				sprintf(heap, "%12s", "-");
+			int length = sprintf(line, "%-32.32s %8ld %12.4f %12.4f %12.4f %12.4f %12.4f %s ",
+				iter->first.c_str(), entry.count, entry.total_seconds,
+				entry.parse_seconds, entry.cpu_seconds,
+				1000.0*entry.total_seconds/(double)entry.count,
+				1000.0*entry.maximum_seconds, heap);
+			for (int i = 0; i < COMMAND_TIMING_HISTOGRAM_SIZE; ++i)
+			{
+				length += sprintf(line + length, (0 == i) ? " %ld" : "/%ld",
+					entry.histogram[i]);
+			}
+			sprintf(line + length, "\n");
+			Command_timing_write_line(file, line);
+			total_count += entry.count;
+			total_seconds += entry.total_seconds;
+			total_parse_seconds += entry.parse_seconds;
+			total_cpu_seconds += entry.cpu_seconds;
+			total_heap_bytes += entry.heap_bytes;
+		}
+		char heap[32];
+		if (Memory_accounting_heap_bytes_available())
+			sprintf(heap, "%12.0f", total_heap_bytes/1024.0);
+		else
+			sprintf(heap, "%12s", "-");
+		sprintf(line, "%-32s %8ld %12.4f %12.4f %12.4f %12s %12s %s\n", "all",
+			total_count, total_seconds, total_parse_seconds, total_cpu_seconds,
+			"", "", heap);
+		Command_timing_write_line(file, line);
+	}
+	int return_code = 1;
+	if (file)
+	{
+		if (0 != fclose(file))
+		{
+			display_message(ERROR_MESSAGE, "Error writing file %s", file_name);
+			return_code = 0;
+		}
+	}
+	return return_code;
+}
@@ -0,0 +1,98 @@
+/**
+ * FILE : command_timing.h
+ *
+ * Accumulates the wall time, CPU time and heap growth of parsing and executing
+ * commands, grouped by the leading words of each command, e.g.
+ * "gfx read nodes", so slow parts of long command files can be found.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (COMMAND_TIMING_H)
+#define COMMAND_TIMING_H
+
+#include "general/object.h"
+
+struct Command_timing;
+
+/** Order of command groups in timing listings. */
+enum Command_timing_sort
+{
+	COMMAND_TIMING_SORT_TOTAL,
+	COMMAND_TIMING_SORT_MEAN,
+	COMMAND_TIMING_SORT_MAXIMUM,
+	COMMAND_TIMING_SORT_COUNT
+};
+
+struct Command_timing *CREATE(Command_timing)(void);
+
+int DESTROY(Command_timing)(struct Command_timing **timing_address);
+
+/**
+ * @return  Wall clock time in seconds from an arbitrary origin.
+ */
+double Command_timing_get_seconds(void);
+
+/**
+ * @return  User plus system CPU time used by the process in seconds, from an
+ * arbitrary origin.
+ */
+double Command_timing_get_cpu_seconds(void);
+
+/**
+ * Writes the normalised command group of a command into <key>: the lower case
+ * form of its first two tokens, or three for gfx commands, e.g.
+ * "gfx modify g_element", stopping at the first token which is not a plain
+ * word. Words are separated by single spaces.
+ * @param key_size  Size of key buffer including the terminating null.
+ */
+void Command_timing_make_key(char *key, int key_size, char **tokens,
+	int number_of_tokens);
+
+/**
+ * Turns recording of command timings on or off. Recording is off initially.
+ * Commands in progress are still tracked while off so nesting stays correct,
+ * but no clocks or heap sizes are read for them and they are never recorded.
+ */
+int Command_timing_set_enabled(struct Command_timing *timing, int enabled);
+
+int Command_timing_is_enabled(struct Command_timing *timing);
+
+/**
+ * Starts timing a command. Commands may be nested, e.g. when executing a
+ * command file; time spent in nested commands is not counted against the
+ * command which ran them.
+ */
+int Command_timing_begin(struct Command_timing *timing);
+
+/**
+ * Marks the end of tokenising the command started by the last
+ * Command_timing_begin and building its top-level option tables.
+ */
+int Command_timing_parsed(struct Command_timing *timing);
+
+/**
+ * Ends timing the command started by the last Command_timing_begin and adds
+ * its times and heap growth to the command group <key>. Nothing is recorded if
+ * <key> is empty, e.g. for blank and comment lines, or if recording is off.
+ */
+int Command_timing_end(struct Command_timing *timing, const char *key);
+
+/**
+ * Clears all accumulated timings.
+ */
+int Command_timing_reset(struct Command_timing *timing);
+
+/**
+ * Writes the count, total, parse, CPU, mean and maximum times, heap growth and a
+ * histogram of times for each command group.
+ * @param sort  Order of the command groups, largest first.
+ * @param file_name  File to write the listing to, or NULL for the command
+ * window.
+ */
+int Command_timing_list(struct Command_timing *timing,
+	enum Command_timing_sort sort, const char *file_name);
+
+#endif /* !defined (COMMAND_TIMING_H) */
@@ -36,6 +36,9 @@ A module for supporting command parsing.
 
 /* size of blocks allocated onto option table - to reduce number of reallocs */
 #define OPTION_TABLE_ALLOCATE_SIZE 10
+/* number of tokens above which duplicates are found with a hashed token index
+	 instead of comparing against every entry */
+#define OPTION_TABLE_TOKEN_INDEX_THRESHOLD 16
 
 /*
 Module types
@@ -52,6 +55,13 @@ DESCRIPTION :
 	struct Modifier_entry *entry;
 	char *help;
 	int allocated_entries,number_of_entries,valid;
+	/* flag set when the blank entry needed by process_option ends the table, so
+		 a table kept for repeated parsing is only terminated once */
+	int terminated;
+	/* open-addressed hash of entry numbers by token for large tables, used to
+		 detect duplicate tokens; -1 marks an empty slot */
+	int *token_index;
+	int token_index_size,number_of_indexed_tokens;
 	/* store suboption_tables added to table for destroying with option_table */
 	int number_of_suboption_tables;
 	struct Option_table **suboption_tables;
@@ -992,6 +1002,10 @@ Creates an Option_table for text parsing.
 		option_table->help = (char *)NULL;
 		/* flag indicating all options successfully added */
 		option_table->valid = 1;
+		option_table->terminated = 0;
+		option_table->token_index = (int *)NULL;
+		option_table->token_index_size = 0;
+		option_table->number_of_indexed_tokens = 0;
 		/* store suboption_tables added to table for destroying with option_table */
 		option_table->number_of_suboption_tables = 0;
 		option_table->suboption_tables = (struct Option_table **)NULL;
@@ -1043,6 +1057,10 @@ DESCRIPTION :
 			{
 				DEALLOCATE(option_table->entry);
 			}
+			if (option_table->token_index)
+			{
+				DEALLOCATE(option_table->token_index);
+			}
 			DEALLOCATE(*option_table_address);
 		}
 	}
@@ -1056,38 +1074,180 @@ DESCRIPTION :
 	return (return_code);
 } /* DESTROY(Option_table) */
 
+static unsigned int Option_table_token_hash(const char *token)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Returns a hash of the exact characters in <token> for the token index.
+==============================================================================*/
+{
+	unsigned int hash;
+
+	hash = 2166136261u;
+	while (*token)
+	{
+		hash = (hash ^ (unsigned char)(*token))*16777619u;
+		token++;
+	}
+
+	return (hash);
+} /* Option_table_token_hash */
+
+static int Option_table_index_token(struct Option_table *option_table,
+	int entry_number)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Adds entry <entry_number> of <option_table> to its token index, first growing
+the index if it is more than half full. Creates the index once the table has
+more than OPTION_TABLE_TOKEN_INDEX_THRESHOLD tokens; smaller tables are
+searched directly.
+==============================================================================*/
+{
+	int i, *new_index, new_size, return_code, slot;
+
+	ENTER(Option_table_index_token);
+	return_code = 1;
+	if (2*(option_table->number_of_indexed_tokens + 1) >
+		option_table->token_index_size)
+	{
+		if (option_table->token_index ||
+			(option_table->number_of_entries > OPTION_TABLE_TOKEN_INDEX_THRESHOLD))
+		{
+			new_size = (option_table->token_index_size) ?
+				2*option_table->token_index_size : 4*OPTION_TABLE_TOKEN_INDEX_THRESHOLD;
+			if (ALLOCATE(new_index, int, new_size))
+			{
+				for (i = 0; i < new_size; i++)
+				{
+					new_index[i] = -1;
+				}
+				if (option_table->token_index)
+				{
+					DEALLOCATE(option_table->token_index);
+				}
+				option_table->token_index = new_index;
+				option_table->token_index_size = new_size;
+				option_table->number_of_indexed_tokens = 0;
+				/* re-index all earlier tokens */
+				for (i = 0; i < entry_number; i++)
+				{
+					if (option_table->entry[i].option)
+					{
+						slot = (int)(Option_table_token_hash(option_table->entry[i].option) &
+							(unsigned int)(new_size - 1));
+						while (new_index[slot] >= 0)
+						{
+							slot = (slot + 1) & (new_size - 1);
+						}
+						new_index[slot] = i;
+						option_table->number_of_indexed_tokens++;
+					}
+				}
+			}
+			else
+			{
+				/* fall back to searching every entry */
+				if (option_table->token_index)
+				{
+					DEALLOCATE(option_table->token_index);
+				}
+				option_table->token_index_size = 0;
+				option_table->number_of_indexed_tokens = 0;
+				return_code = 0;
+			}
+		}
+	}
+	if (return_code && option_table->token_index)
+	{
+		slot = (int)(Option_table_token_hash(option_table->entry[entry_number].option) &
+			(unsigned int)(option_table->token_index_size - 1));
+		while (option_table->token_index[slot] >= 0)
+		{
+			slot = (slot + 1) & (option_table->token_index_size - 1);
+		}
+		option_table->token_index[slot] = entry_number;
+		option_table->number_of_indexed_tokens++;
+	}
+	LEAVE;
+
+	return (return_code);
+} /* Option_table_index_token */
+
+static int Option_table_has_token(struct Option_table *option_table,
+	const char *token)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Returns true if an entry in <option_table> has exactly the option <token>.
+==============================================================================*/
+{
+	int i, return_code, slot;
+
+	ENTER(Option_table_has_token);
+	return_code = 0;
+	if (option_table->token_index)
+	{
+		slot = (int)(Option_table_token_hash(token) &
+			(unsigned int)(option_table->token_index_size - 1));
+		while ((!return_code) && (option_table->token_index[slot] >= 0))
+		{
+			if (!strcmp(token,
+				option_table->entry[option_table->token_index[slot]].option))
+			{
+				return_code = 1;
+			}
+			slot = (slot + 1) & (option_table->token_index_size - 1);
+		}
+	}
+	else
+	{
+		for (i = 0; (!return_code) && (i < option_table->number_of_entries); i++)
+		{
+			if (option_table->entry[i].option
+				&& (!strcmp(token, option_table->entry[i].option)))
+			{
+				return_code = 1;
+			}
+		}
+	}
+	LEAVE;
+
+	return (return_code);
+} /* Option_table_has_token */
+
 static int Option_table_add_entry_private(struct Option_table *option_table,
 	const char *token,void *to_be_modified,void *user_data,modifier_function modifier)
 /*******************************************************************************
-LAST MODIFIED : 23 December 1999
+LAST MODIFIED : 16 October 2026
 
 DESCRIPTION :
 Adds the given entry to the option table, enlarging the table as needed.
+Any blank terminating entry from an earlier parse is removed first.
 If fails, marks the option_table as invalid.
 ==============================================================================*/
 {
-	int i, return_code;
+	int return_code;
 	struct Modifier_entry *temp_entry;
 
 	ENTER(Option_table_add_entry_private);
 	if (option_table)
 	{
 		return_code=1;
-		if (token)
+		if (option_table->terminated)
 		{
-			i=0;
-			while (return_code && (i<option_table->number_of_entries))
-			{
-				if (option_table->entry[i].option
-					&& (!strcmp(token, option_table->entry[i].option)))
-				{
-					display_message(ERROR_MESSAGE,
-						"Option_table_add_entry_private.  Token '%s' already in option table",
-						token);
-					return_code=0;
-				}
-				i++;
-			}
+			option_table->number_of_entries--;
+			option_table->terminated=0;
+		}
+		if (token && Option_table_has_token(option_table, token))
+		{
+			display_message(ERROR_MESSAGE,
+				"Option_table_add_entry_private.  Token '%s' already in option table",
+				token);
+			return_code=0;
 		}
 		if (option_table->number_of_entries == option_table->allocated_entries)
 		{
@@ -1113,6 +1273,11 @@ If fails, marks the option_table as invalid.
 			temp_entry->user_data=user_data;
 			temp_entry->modifier=modifier;
 			option_table->number_of_entries++;
+			if (token)
+			{
+				Option_table_index_token(option_table,
+					option_table->number_of_entries - 1);
+			}
 		}
 	}
 	else
@@ -1126,6 +1291,32 @@ If fails, marks the option_table as invalid.
 	return (return_code);
 } /* Option_table_add_entry_private */
 
+static int Option_table_terminate(struct Option_table *option_table)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Adds the blank entry needed for process_option to the end of <option_table>,
+unless already there from an earlier parse of the same table.
+==============================================================================*/
+{
+	int return_code;
+
+	ENTER(Option_table_terminate);
+	if (option_table->terminated)
+	{
+		return_code=1;
+	}
+	else if (0 != (return_code=Option_table_add_entry_private(option_table,
+		(char *)NULL,(void *)NULL,(void *)NULL,(modifier_function)NULL)))
+	{
+		option_table->terminated=1;
+	}
+	LEAVE;
+
+	return (return_code);
+} /* Option_table_terminate */
+
 int Option_table_add_help(struct Option_table *option_table,
 	const char *help_string)
 /*******************************************************************************
@@ -1213,8 +1404,7 @@ of option_table!
 	if (option_table&&suboption_table)
 	{
 		/* add blank entry needed for process_option */
-		Option_table_add_entry_private(suboption_table,(char *)NULL,(void *)NULL,
-			(void *)NULL,(modifier_function)NULL);
+		Option_table_terminate(suboption_table);
 		if (suboption_table->valid)
 		{
 			if (REALLOCATE(temp_suboption_tables,option_table->suboption_tables,
@@ -1489,8 +1679,7 @@ entered.
 	if (option_table&&state)
 	{
 		/* add blank entry needed for process_option */
-		Option_table_add_entry_private(option_table,(char *)NULL,(void *)NULL,
-			(void *)NULL,(modifier_function)NULL);
+		Option_table_terminate(option_table);
 		if (option_table->valid)
 		{
 			return_code=process_option(state,option_table->entry);
@@ -1569,8 +1758,7 @@ entered.
 			}
 		}
 		/* add blank entry needed for process_option */
-		Option_table_add_entry_private(option_table,(char *)NULL,(void *)NULL,
-			(void *)NULL,(modifier_function)NULL);
+		Option_table_terminate(option_table);
 		if (option_table->valid)
 		{
 			return_code=process_multiple_options(state,option_table->entry);
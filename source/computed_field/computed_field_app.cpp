@@ -5,6 +5,9 @@
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include <stdio.h>
+#include <map>
+#include <utility>
+#include <vector>
 
 #include "general/message.h"
 #include "general/mystring.h"
@@ -683,6 +686,76 @@ Writes the commands needed to reproduce <field> to the command window.
 	 return (return_code);
 }
 
+namespace {
+
+int Computed_field_add_to_vector(struct Computed_field *field,
+	void *fields_void)
+{
+	static_cast<std::vector<struct Computed_field *> *>(fields_void)->push_back(field);
+	return 1;
+}
+
+}
+
+int process_list_or_write_Computed_field_commands_in_dependency_order(
+	struct MANAGER(Computed_field) *computed_field_manager,
+	const char *command_prefix, Process_list_or_write_command_class *process_message)
+{
+	if (!(computed_field_manager && command_prefix && process_message))
+	{
+		display_message(ERROR_MESSAGE,
+			"process_list_or_write_Computed_field_commands_in_dependency_order.  "
+			"Invalid argument(s)");
+		return 0;
+	}
+	std::vector<struct Computed_field *> fields;
+	FOR_EACH_OBJECT_IN_MANAGER(Computed_field)(Computed_field_add_to_vector,
+		static_cast<void *>(&fields), computed_field_manager);
+	/* 0 = not visited, 1 = sources being visited, 2 = listed. Only fields in
+	 * this map are managed, so other source fields are not followed */
+	std::map<struct Computed_field *, int> field_states;
+	for (size_t i = 0; i < fields.size(); ++i)
+		field_states[fields[i]] = 0;
+	int return_code = 1;
+	/* depth-first post-order walk so each field is listed once, after all its
+	 * managed source fields */
+	std::vector<std::pair<struct Computed_field *, int> > stack;
+	for (size_t i = 0; i < fields.size(); ++i)
+	{
+		if (0 != field_states[fields[i]])
+			continue;
+		field_states[fields[i]] = 1;
+		stack.push_back(std::make_pair(fields[i], 0));
+		while (!stack.empty())
+		{
+			struct Computed_field *field = stack.back().first;
+			const int source_index = stack.back().second;
+			if (source_index < field->number_of_source_fields)
+			{
+				++(stack.back().second);
+				std::map<struct Computed_field *, int>::iterator source_state =
+					field_states.find(field->source_fields[source_index]);
+				if ((source_state != field_states.end()) && (0 == source_state->second))
+				{
+					source_state->second = 1;
+					stack.push_back(std::make_pair(source_state->first, 0));
+				}
+			}
+			else
+			{
+				if (!process_list_or_write_Computed_field_commands(field,
+					const_cast<char *>(command_prefix), process_message))
+				{
+					return_code = 0;
+				}
+				field_states[field] = 2;
+				stack.pop_back();
+			}
+		}
+	}
+	return (return_code);
+}
+
 int list_Computed_field_commands_if_managed_source_fields_in_list(
 	struct Computed_field *field, void *list_commands_data_void)
 /*******************************************************************************
@@ -12,6 +12,7 @@
 #include "general/message.h"
 
 struct Computed_field_package;
+class Process_list_or_write_command_class;
 
 int define_Computed_field(struct Parse_state *state,void *field_copy_void,
 	void *define_field_package_void);
@@ -73,6 +74,17 @@ Note, must be cycled through as many times as it takes till listed_fields -> 0.
 Second argument is a struct List_Computed_field_commands_data.
 ==============================================================================*/
 
+/**
+ * Lists or writes the commands for every field in <computed_field_manager>,
+ * each after the managed fields it is defined from, in time linear in the
+ * number of fields and source field references.
+ * @param command_prefix  Prefix for each command, e.g. "gfx define field ".
+ * @return  1 if the commands for all fields were processed, otherwise 0.
+ */
+int process_list_or_write_Computed_field_commands_in_dependency_order(
+	struct MANAGER(Computed_field) *computed_field_manager,
+	const char *command_prefix, Process_list_or_write_command_class *process_message);
+
 struct Computed_field_package *CREATE(Computed_field_package)(
 	struct MANAGER(Computed_field) *computed_field_manager);
 /*******************************************************************************
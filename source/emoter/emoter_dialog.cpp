@@ -43,6 +43,7 @@ group of nodes
 #include "general/message.h"
 #include "curve/curve.h"
 #include "emoter/emoter_dialog.h"
+#include "emoter/emoter_reconstruction.h"
 #include "region/cmiss_region.h"
 #include "region/cmiss_region_app.h"
 
@@ -83,6 +84,8 @@ DESCRIPTION :
 #endif /* defined (USE_CMGUI_GRAPHICS_WINDOW) */
 	struct MANAGER(Curve) *curve_manager;
 	struct EM_Object *em_object;
+	/* created from em_object when the nodes are first updated */
+	struct Emoter_reconstruction *reconstruction;
 	int transform_graphics;
 	struct Scene *viewer_scene;
 	struct User_interface *user_interface;
@@ -181,12 +184,10 @@ Updates the node locations for the <emoter_slider>
 ==============================================================================*/
 {
 	char input_filename[200];
-	double position[3], temp_two, temp_cos, temp_sin, *u,*weights;
 	float euler_angles[3];
 	gtMatrix transformation; /* 4 x 4 */
-	int i,j,k,offset,return_code,versions;
+	int return_code;
 	struct cmzn_region *input_sequence;
-	struct FE_field *field;
 	struct FE_node *node;
 	struct EM_Object *em_object;
 	struct IO_stream *input_file;
@@ -201,8 +202,8 @@ Updates the node locations for the <emoter_slider>
 			cmzn_fieldmodule_id fieldmodule = cmzn_region_get_fieldmodule(shared_data->region);
 			cmzn_nodeset_id nodeset = cmzn_fieldmodule_find_nodeset_by_field_domain_type(fieldmodule,
 				CMZN_FIELD_DOMAIN_TYPE_NODES);
-			if ((node = cmzn_nodeset_find_node_by_identifier(nodeset, (em_object->index)[0])) &&
-				(field=get_FE_node_default_coordinate_field(node)))
+			node = cmzn_nodeset_find_node_by_identifier(nodeset, (em_object->index)[0]);
+			if (node && get_FE_node_default_coordinate_field(node))
 			{
 				/* Read from an input sequence which the emoter is overriding */
 				if (shared_data->input_sequence)
@@ -272,82 +273,24 @@ Updates the node locations for the <emoter_slider>
 					cmzn_scene_set_transformation_matrix(scene, mat);
 					cmzn_scene_destroy(&scene);
 				}
-				i=0;
-				offset=em_object->m;
-				while (return_code&&(i<em_object->n_nodes))
+				if (return_code && !shared_data->reconstruction)
 				{
-					if ((node = cmzn_nodeset_find_node_by_identifier(nodeset, (em_object->index)[i])))
-					{
-						position[0] = 0;
-						position[1] = 0;
-						position[2] = 0;
-						u=(em_object->u)+(3*i);
-						weights=shared_data->weights + SOLID_BODY_MODES;
-						for (k=shared_data->mode_limit;k>0;k--)
-						{
-							position[0] += u[0]*(*weights);
-							position[1] += u[1]*(*weights);
-							position[2] += u[2]*(*weights);
-							u += offset;
-							weights++;
-						}
-
-						if ( solid_body_motion )
-						{
-							if (!shared_data->transform_graphics)
-							{
-								/* Need to apply rotations in reverse order */
-								weights = shared_data->weights + 5;
-								temp_sin = sin( -*weights );
-								temp_cos = cos( -*weights );
-								temp_two = temp_cos * position[0] - temp_sin * position[1];
-								position[1] = temp_sin * position[0] + temp_cos * position[1];
-								position[0] = temp_two;
-								weights--;
-
-								temp_sin = sin( -*weights );
-								temp_cos = cos( -*weights );
-								temp_two = temp_cos * position[2] - temp_sin * position[0];
-								position[0] = temp_sin * position[2] + temp_cos * position[0];
-								position[2] = temp_two;
-								weights--;
-
-								temp_sin = sin( -*weights );
-								temp_cos = cos( -*weights );
-								temp_two = temp_cos * position[1] - temp_sin * position[2];
-								position[2] = temp_sin * position[1] + temp_cos * position[2];
-								position[1] = temp_two;
-								weights--;
-
-								position[2] -= *weights;
-								weights--;
-								position[1] -= *weights;
-								weights--;
-								position[0] -= *weights;
-							}
-						}
-
-						for (k = 0 ; k < 3 ; k++)
-						{
-							versions = get_FE_node_field_component_number_of_versions(
-								node, field, k);
-							for (j = 0 ; j < versions ; j++)
-							{
-								return_code=set_FE_nodal_FE_value_value(node,
-									field, /*component_number*/k, j, FE_NODAL_VALUE,
-									/*time*/0, (FE_value)position[k]);
-							}
-						}
-
-					}
-					else
-					{
-						display_message(ERROR_MESSAGE,
-							"emoter_update_nodes.  Unknown node %d",
-							(em_object->index)[i]);
-						return_code=0;
-					}
-					i++;
+					/* built on first use and kept, with handles to the nodes */
+					shared_data->reconstruction = CREATE(Emoter_reconstruction)(nodeset,
+						em_object->n_nodes, em_object->index, shared_data->number_of_modes,
+						em_object->u, em_object->m);
+				}
+				if (return_code && shared_data->reconstruction)
+				{
+					return_code = Emoter_reconstruction_update_nodes(
+						shared_data->reconstruction, shared_data->mode_limit,
+						shared_data->weights + SOLID_BODY_MODES,
+						(solid_body_motion && !shared_data->transform_graphics) ?
+							shared_data->weights : (double *)NULL);
+				}
+				else
+				{
+					return_code = 0;
 				}
 				cmzn_fieldmodule_end_change(fieldmodule);
 			}
@@ -357,6 +300,10 @@ Updates the node locations for the <emoter_slider>
 					"emoter_update_nodes.  Could not find coordinate_field");
 				return_code=0;
 			}
+			if (node)
+			{
+				cmzn_node_destroy(&node);
+			}
 			cmzn_nodeset_destroy(&nodeset);
 			cmzn_fieldmodule_destroy(&fieldmodule);
 		}
@@ -945,6 +892,11 @@ Callback for the emoter dialog - tidies up all details - mem etc
 		/* Destroy shared slider data */
 		DEALLOCATE(emoter_dialog->shared->weights);
 		DEALLOCATE(emoter_dialog->shared->sliders);
+		/* the reconstruction holds nodes of the region */
+		if (emoter_dialog->shared->reconstruction)
+		{
+			DESTROY(Emoter_reconstruction)(&(emoter_dialog->shared->reconstruction));
+		}
 		DEACCESS(cmzn_region)(&emoter_dialog->shared->region);
 		destroy_EM_Object(&(emoter_dialog->shared->em_object));
 		cmzn_nodeset_group_destroy(&emoter_dialog->minimum_nodeset_group);
@@ -3341,6 +3293,8 @@ int gfx_create_emoter(struct Parse_state *state,void *dummy_to_be_modified,
 								shared_emoter_slider_data->execute_command =
 									create_emoter_slider_data->execute_command;
 								shared_emoter_slider_data->em_object = em_object;
+								shared_emoter_slider_data->reconstruction =
+									(struct Emoter_reconstruction *)NULL;
 								shared_emoter_slider_data->active_slider =
 									(struct Emoter_slider *)NULL;
 								shared_emoter_slider_data->time = 1;
@@ -0,0 +1,276 @@
+/**
+ * FILE : emoter_reconstruction.cpp
+ *
+ * Reconstructs emoter node positions from an EM basis and mode weights.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+#include "opencmiss/zinc/node.h"
+#include "finite_element/finite_element.h"
+#include "general/cmgui_thread.h"
+#include "general/debug.h"
+#include "general/message.h"
+#include "emoter/emoter_reconstruction.h"
+
+namespace {
+
+/** Rows are padded to a multiple of this many values, and aligned to it. */
+const int EMOTER_ROW_ALIGNMENT = 4;
+/** Nodes evaluated by each item of the parallel loop. */
+const int EMOTER_NODE_BLOCK_SIZE = 1024;
+/** Below this many node-mode products the positions are evaluated serially. */
+const int EMOTER_PARALLEL_MINIMUM_PRODUCTS = 1 << 18;
+
+}
+
+struct Emoter_reconstruction
+{
+	int number_of_nodes, number_of_modes;
+	/* number of values in each row of basis, a multiple of EMOTER_ROW_ALIGNMENT */
+	int row_length;
+	/* 3 rows per node, x then y then z, each holding the value of every mode */
+	std::vector<double> basis_storage;
+	double *basis;
+	/* mode weights padded with zeros to row_length */
+	std::vector<double> weights;
+	std::vector<double> positions;
+	std::vector<cmzn_node_id> nodes;
+	/* number of value versions of each node's x, y and z */
+	std::vector<int> versions;
+	struct FE_field *field;
+};
+
+namespace {
+
+struct Emoter_reconstruction_evaluate_data
+{
+	struct Emoter_reconstruction *reconstruction;
+	/* weights beyond this are zero */
+	int mode_count;
+};
+
+/**
+ * Evaluates the positions of one block of nodes as a product of their rows
+ * of the basis with the weights. Four partial sums per row keep the loop
+ * free of dependencies so it vectorises.
+ */
+int emoter_reconstruction_evaluate_block(int index, void *evaluate_data_void)
+{
+	Emoter_reconstruction_evaluate_data *evaluate_data =
+		static_cast<Emoter_reconstruction_evaluate_data *>(evaluate_data_void);
+	Emoter_reconstruction *reconstruction = evaluate_data->reconstruction;
+	const int row_length = reconstruction->row_length;
+	const int mode_count = evaluate_data->mode_count;
+	const double *weights = &(reconstruction->weights[0]);
+	const int first_row = 3*index*EMOTER_NODE_BLOCK_SIZE;
+	int end_row = first_row + 3*EMOTER_NODE_BLOCK_SIZE;
+	if (end_row > 3*reconstruction->number_of_nodes)
+		end_row = 3*reconstruction->number_of_nodes;
+	const double *row = reconstruction->basis + (size_t)first_row*row_length;
+	double *position = &(reconstruction->positions[0]) + first_row;
+	for (int r = first_row; r < end_row; ++r)
+	{
+		double sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
+		for (int k = 0; k < mode_count; k += EMOTER_ROW_ALIGNMENT)
+		{
+			sum0 += row[k]*weights[k];
+			sum1 += row[k + 1]*weights[k + 1];
+			sum2 += row[k + 2]*weights[k + 2];
+			sum3 += row[k + 3]*weights[k + 3];
+		}
+		*position = (sum0 + sum1) + (sum2 + sum3);
+		++position;
+		row += row_length;
+	}
+	return 1;
+}
+
+/**
+ * Applies the emoter's inverse solid body rotation to <vector>: rotations
+ * about z, y then x by the negated angles.
+ */
+void emoter_inverse_rotate(const double *sines, const double *cosines,
+	double *vector)
+{
+	double temp = cosines[2]*vector[0] - sines[2]*vector[1];
+	vector[1] = sines[2]*vector[0] + cosines[2]*vector[1];
+	vector[0] = temp;
+	temp = cosines[1]*vector[2] - sines[1]*vector[0];
+	vector[0] = sines[1]*vector[2] + cosines[1]*vector[0];
+	vector[2] = temp;
+	temp = cosines[0]*vector[1] - sines[0]*vector[2];
+	vector[2] = sines[0]*vector[1] + cosines[0]*vector[2];
+	vector[1] = temp;
+}
+
+}
+
+struct Emoter_reconstruction *CREATE(Emoter_reconstruction)(
+	cmzn_nodeset_id nodeset, int number_of_nodes, const int *node_identifiers,
+	int number_of_modes, const double *basis, int mode_offset)
+{
+	if (!(nodeset && (0 < number_of_nodes) && node_identifiers &&
+		(0 < number_of_modes) && basis && (3*number_of_nodes <= mode_offset)))
+	{
+		display_message(ERROR_MESSAGE,
+			"CREATE(Emoter_reconstruction).  Invalid argument(s)");
+		return 0;
+	}
+	Emoter_reconstruction *reconstruction = new Emoter_reconstruction();
+	reconstruction->number_of_nodes = number_of_nodes;
+	reconstruction->number_of_modes = number_of_modes;
+	reconstruction->row_length = EMOTER_ROW_ALIGNMENT*
+		((number_of_modes + EMOTER_ROW_ALIGNMENT - 1)/EMOTER_ROW_ALIGNMENT);
+	const int row_length = reconstruction->row_length;
+	const size_t basis_size = (size_t)3*number_of_nodes*row_length;
+	/* over-allocate so the rows can start on an aligned address */
+	reconstruction->basis_storage.assign(basis_size + EMOTER_ROW_ALIGNMENT, 0.0);
+	double *basis_start = &(reconstruction->basis_storage[0]);
+	const uintptr_t alignment = EMOTER_ROW_ALIGNMENT*sizeof(double);
+	reconstruction->basis = reinterpret_cast<double *>(
+		(reinterpret_cast<uintptr_t>(basis_start) + alignment - 1) & ~(alignment - 1));
+	for (int r = 0; r < 3*number_of_nodes; ++r)
+	{
+		double *row = reconstruction->basis + (size_t)r*row_length;
+		for (int k = 0; k < number_of_modes; ++k)
+			row[k] = basis[(size_t)k*mode_offset + r];
+	}
+	reconstruction->weights.assign(row_length, 0.0);
+	reconstruction->positions.assign(3*number_of_nodes, 0.0);
+	reconstruction->nodes.assign(number_of_nodes, static_cast<cmzn_node_id>(0));
+	reconstruction->versions.assign(3*number_of_nodes, 0);
+	reconstruction->field = 0;
+	for (int i = 0; i < number_of_nodes; ++i)
+	{
+		cmzn_node_id node = cmzn_nodeset_find_node_by_identifier(nodeset, node_identifiers[i]);
+		if (!node)
+		{
+			display_message(ERROR_MESSAGE,
+				"CREATE(Emoter_reconstruction).  Unknown node %d", node_identifiers[i]);
+			DESTROY(Emoter_reconstruction)(&reconstruction);
+			return 0;
+		}
+		reconstruction->nodes[i] = node;
+		if (0 == i)
+		{
+			reconstruction->field = get_FE_node_default_coordinate_field(node);
+			if (!reconstruction->field)
+			{
+				display_message(ERROR_MESSAGE,
+					"CREATE(Emoter_reconstruction).  Could not find coordinate_field");
+				DESTROY(Emoter_reconstruction)(&reconstruction);
+				return 0;
+			}
+		}
+		for (int c = 0; c < 3; ++c)
+		{
+			reconstruction->versions[3*i + c] = get_FE_node_field_component_number_of_versions(
+				node, reconstruction->field, c);
+		}
+	}
+	return reconstruction;
+}
+
+int DESTROY(Emoter_reconstruction)(
+	struct Emoter_reconstruction **reconstruction_address)
+{
+	if (!(reconstruction_address && *reconstruction_address))
+		return 0;
+	Emoter_reconstruction *reconstruction = *reconstruction_address;
+	for (size_t i = 0; i < reconstruction->nodes.size(); ++i)
+	{
+		if (reconstruction->nodes[i])
+			cmzn_node_destroy(&(reconstruction->nodes[i]));
+	}
+	delete reconstruction;
+	*reconstruction_address = 0;
+	return 1;
+}
+
+int Emoter_reconstruction_update_nodes(
+	struct Emoter_reconstruction *reconstruction, int mode_limit,
+	const double *mode_weights, const double *solid_body)
+{
+	if (!(reconstruction && (0 <= mode_limit) && ((0 == mode_limit) || mode_weights)))
+	{
+		display_message(ERROR_MESSAGE,
+			"Emoter_reconstruction_update_nodes.  Invalid argument(s)");
+		return 0;
+	}
+	if (mode_limit > reconstruction->number_of_modes)
+		mode_limit = reconstruction->number_of_modes;
+	for (int k = 0; k < reconstruction->row_length; ++k)
+		reconstruction->weights[k] = (k < mode_limit) ? mode_weights[k] : 0.0;
+	const int number_of_nodes = reconstruction->number_of_nodes;
+	Emoter_reconstruction_evaluate_data evaluate_data;
+	evaluate_data.reconstruction = reconstruction;
+	evaluate_data.mode_count = EMOTER_ROW_ALIGNMENT*
+		((mode_limit + EMOTER_ROW_ALIGNMENT - 1)/EMOTER_ROW_ALIGNMENT);
+	const int number_of_blocks =
+		(number_of_nodes + EMOTER_NODE_BLOCK_SIZE - 1)/EMOTER_NODE_BLOCK_SIZE;
+	const int number_of_threads =
+		((double)number_of_nodes*mode_limit < EMOTER_PARALLEL_MINIMUM_PRODUCTS) ? 1 : 0;
+	cmgui_parallel_for(number_of_threads, number_of_blocks,
+		emoter_reconstruction_evaluate_block, static_cast<void *>(&evaluate_data));
+
+	double *positions = &(reconstruction->positions[0]);
+	if (solid_body)
+	{
+		/* the rotation is the same for every node so build its matrix once */
+		double sines[3], cosines[3];
+		for (int a = 0; a < 3; ++a)
+		{
+			sines[a] = sin(-solid_body[3 + a]);
+			cosines[a] = cos(-solid_body[3 + a]);
+		}
+		double rotation[3][3];
+		for (int j = 0; j < 3; ++j)
+		{
+			double column[3] = { 0.0, 0.0, 0.0 };
+			column[j] = 1.0;
+			emoter_inverse_rotate(sines, cosines, column);
+			for (int i = 0; i < 3; ++i)
+				rotation[i][j] = column[i];
+		}
+		for (int n = 0; n < number_of_nodes; ++n)
+		{
+			double *position = positions + 3*n;
+			const double x = position[0], y = position[1], z = position[2];
+			for (int i = 0; i < 3; ++i)
+			{
+				position[i] = rotation[i][0]*x + rotation[i][1]*y + rotation[i][2]*z
+					- solid_body[i];
+			}
+		}
+	}
+
+	int return_code = 1;
+	for (int n = 0; (n < number_of_nodes) && return_code; ++n)
+	{
+		for (int c = 0; (c < 3) && return_code; ++c)
+		{
+			const int versions = reconstruction->versions[3*n + c];
+			for (int v = 0; v < versions; ++v)
+			{
+				if (!set_FE_nodal_FE_value_value(reconstruction->nodes[n],
+					reconstruction->field, /*component_number*/c, v, FE_NODAL_VALUE,
+					/*time*/0, (FE_value)positions[3*n + c]))
+				{
+					display_message(ERROR_MESSAGE,
+						"Emoter_reconstruction_update_nodes.  Could not set node %d",
+						cmzn_node_get_identifier(reconstruction->nodes[n]));
+					return_code = 0;
+					break;
+				}
+			}
+		}
+	}
+	return return_code;
+}
@@ -0,0 +1,49 @@
+/**
+ * FILE : emoter_reconstruction.h
+ *
+ * Reconstructs emoter node positions from an EM basis and mode weights for
+ * all nodes at once, and writes them to the nodes' coordinate field.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (EMOTER_RECONSTRUCTION_H)
+#define EMOTER_RECONSTRUCTION_H
+
+#include "opencmiss/zinc/types/nodesetid.h"
+#include "general/object.h"
+
+struct Emoter_reconstruction;
+
+/**
+ * Creates a reconstruction for the nodes with <node_identifiers> in
+ * <nodeset>. The basis is copied so each node's x, y and z rows of mode
+ * values are contiguous and aligned, and handles to the nodes are kept until
+ * the reconstruction is destroyed.
+ * @param basis  Mode values, with component c of node i in mode k at
+ * basis[k*mode_offset + 3*i + c], as in an EM_Object.
+ * @return  New reconstruction, or NULL if any node is missing or has no
+ * coordinate field.
+ */
+struct Emoter_reconstruction *CREATE(Emoter_reconstruction)(
+	cmzn_nodeset_id nodeset, int number_of_nodes, const int *node_identifiers,
+	int number_of_modes, const double *basis, int mode_offset);
+
+int DESTROY(Emoter_reconstruction)(
+	struct Emoter_reconstruction **reconstruction_address);
+
+/**
+ * Sets every value version of the coordinates of all nodes to the sum of
+ * the first <mode_limit> modes scaled by <mode_weights>. If <solid_body> is
+ * supplied, the positions are then rotated by the inverse of the euler
+ * angles solid_body[3..5] and translated by -solid_body[0..2].
+ * Callers should bracket this with field module begin/end change.
+ * @return  1 on success, 0 if any node could not be set.
+ */
+int Emoter_reconstruction_update_nodes(
+	struct Emoter_reconstruction *reconstruction, int mode_limit,
+	const double *mode_weights, const double *solid_body);
+
+#endif /* !defined (EMOTER_RECONSTRUCTION_H) */
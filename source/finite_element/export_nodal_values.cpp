@@ -0,0 +1,224 @@
+/**
+ * FILE : export_nodal_values.cpp
+ *
+ * Writes the values of fields at nodes to CSV or binary files for analysis
+ * outside cmgui.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <limits>
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "opencmiss/zinc/core.h"
+#include "opencmiss/zinc/field.h"
+#include "opencmiss/zinc/fieldcache.h"
+#include "opencmiss/zinc/fieldmodule.h"
+#include "opencmiss/zinc/node.h"
+#include "opencmiss/zinc/status.h"
+#include "finite_element/export_nodal_values.h"
+#include "general/buffered_file_writer.h"
+#include "general/debug.h"
+#include "general/identifier_set.h"
+#include "general/message.h"
+#include "general/multi_range.h"
+
+namespace {
+
+/** Number of nodes evaluated at a time. */
+const int NODAL_VALUES_BLOCK_SIZE = 4096;
+/** Size of each of the writer's two buffers. */
+const size_t NODAL_VALUES_BUFFER_SIZE = 8*1024*1024;
+
+/** Appends the column names for <field>: the field name for scalars, or
+ * field.component for each component. */
+void Nodal_values_append_column_names(std::string &header, cmzn_field_id field)
+{
+	char *field_name = cmzn_field_get_name(field);
+	const int number_of_components = cmzn_field_get_number_of_components(field);
+	if (1 == number_of_components)
+	{
+		header += ",";
+		header += field_name;
+	}
+	else
+	{
+		for (int c = 1; c <= number_of_components; ++c)
+		{
+			char *component_name = cmzn_field_get_component_name(field, c);
+			header += ",";
+			header += field_name;
+			header += ".";
+			header += component_name;
+			cmzn_deallocate(component_name);
+		}
+	}
+	cmzn_deallocate(field_name);
+}
+
+/** Appends the CSV text for one node's values, leaving cells of fields not
+ * defined at the node empty. */
+void Nodal_values_append_csv_row(std::string &text, int identifier,
+	int number_of_fields, const int *field_number_of_components,
+	const double *values, const unsigned char *defined)
+{
+	char number[32];
+	sprintf(number, "%d", identifier);
+	text += number;
+	for (int f = 0; f < number_of_fields; ++f)
+	{
+		for (int c = 0; c < field_number_of_components[f]; ++c)
+		{
+			text += ',';
+			if (defined[f])
+			{
+				/* 17 significant digits are enough to read back any double exactly */
+				sprintf(number, "%.17g", values[c]);
+				text += number;
+			}
+		}
+		values += field_number_of_components[f];
+	}
+	text += '\n';
+}
+
+}
+
+int export_nodal_values_file_of_name(const char *file_name,
+	cmzn_nodeset_id nodeset, struct Multi_range *node_ranges,
+	cmzn_field_id conditional_field, int number_of_fields, cmzn_field_id *fields,
+	double time, enum Nodal_values_file_format format,
+	int *number_of_nodes_address)
+{
+	if (number_of_nodes_address)
+		*number_of_nodes_address = 0;
+	if (!(file_name && nodeset && (0 < number_of_fields) && fields))
+	{
+		display_message(ERROR_MESSAGE,
+			"export_nodal_values_file_of_name.  Invalid argument(s)");
+		return 0;
+	}
+	std::vector<int> field_number_of_components(number_of_fields);
+	int number_of_values = 0;
+	for (int f = 0; f < number_of_fields; ++f)
+	{
+		if (!(fields[f] &&
+			(CMZN_FIELD_VALUE_TYPE_REAL == cmzn_field_get_value_type(fields[f]))))
+		{
+			display_message(ERROR_MESSAGE,
+				"export_nodal_values_file_of_name.  Fields must be real valued");
+			return 0;
+		}
+		field_number_of_components[f] = cmzn_field_get_number_of_components(fields[f]);
+		number_of_values += field_number_of_components[f];
+	}
+	struct Buffered_file_writer *writer =
+		CREATE(Buffered_file_writer)(file_name, NODAL_VALUES_BUFFER_SIZE);
+	if (!writer)
+		return 0;
+	std::string header("identifier");
+	for (int f = 0; f < number_of_fields; ++f)
+		Nodal_values_append_column_names(header, fields[f]);
+	header += '\n';
+	if (NODAL_VALUES_FILE_FORMAT_BINARY == format)
+	{
+		const unsigned int one = 1;
+		const bool little_endian = (1 == *reinterpret_cast<const unsigned char *>(&one));
+		char description[128];
+		sprintf(description, "cmgui nodal values binary float64 %s_endian %d columns\n",
+			little_endian ? "little" : "big", 1 + number_of_values);
+		header.insert(0, description);
+	}
+	int return_code = Buffered_file_writer_write(writer, header.data(), header.size());
+
+	struct Identifier_set *node_identifiers =
+		(node_ranges && (0 < Multi_range_get_number_of_ranges(node_ranges))) ?
+		Identifier_set_create_from_Multi_range(node_ranges) : 0;
+	const double not_defined = std::numeric_limits<double>::quiet_NaN();
+	cmzn_fieldmodule_id field_module = cmzn_nodeset_get_fieldmodule(nodeset);
+	cmzn_fieldcache_id field_cache = cmzn_fieldmodule_create_fieldcache(field_module);
+	cmzn_fieldcache_set_time(field_cache, time);
+	/* per node in block: identifier and values of all fields, as written in the
+	 * binary format */
+	std::vector<double> records(static_cast<size_t>(NODAL_VALUES_BLOCK_SIZE)*(1 + number_of_values));
+	std::vector<unsigned char> defined(static_cast<size_t>(NODAL_VALUES_BLOCK_SIZE)*number_of_fields);
+	std::string text;
+	int number_of_nodes = 0;
+	cmzn_nodeiterator_id iterator = cmzn_nodeset_create_nodeiterator(nodeset);
+	cmzn_node_id node = 0;
+	bool more_nodes = true;
+	while (return_code && more_nodes)
+	{
+		/* evaluate a block of nodes */
+		int block_size = 0;
+		while (block_size < NODAL_VALUES_BLOCK_SIZE)
+		{
+			node = cmzn_nodeiterator_next_non_access(iterator);
+			if (!node)
+			{
+				more_nodes = false;
+				break;
+			}
+			const int identifier = cmzn_node_get_identifier(node);
+			if (node_identifiers && !Identifier_set_contains(node_identifiers, identifier))
+				continue;
+			cmzn_fieldcache_set_node(field_cache, node);
+			if (conditional_field &&
+				!cmzn_field_evaluate_boolean(conditional_field, field_cache))
+				continue;
+			double *record = &(records[static_cast<size_t>(block_size)*(1 + number_of_values)]);
+			unsigned char *record_defined = &(defined[static_cast<size_t>(block_size)*number_of_fields]);
+			record[0] = static_cast<double>(identifier);
+			double *values = record + 1;
+			for (int f = 0; f < number_of_fields; ++f)
+			{
+				record_defined[f] = (CMZN_OK == cmzn_field_evaluate_real(fields[f],
+					field_cache, field_number_of_components[f], values));
+				if (!record_defined[f])
+				{
+					for (int c = 0; c < field_number_of_components[f]; ++c)
+						values[c] = not_defined;
+				}
+				values += field_number_of_components[f];
+			}
+			++block_size;
+		}
+		/* write the block */
+		if (0 < block_size)
+		{
+			if (NODAL_VALUES_FILE_FORMAT_BINARY == format)
+			{
+				return_code = Buffered_file_writer_write(writer, &(records[0]),
+					sizeof(double)*static_cast<size_t>(block_size)*(1 + number_of_values));
+			}
+			else
+			{
+				text.clear();
+				for (int i = 0; i < block_size; ++i)
+				{
+					const double *record = &(records[static_cast<size_t>(i)*(1 + number_of_values)]);
+					Nodal_values_append_csv_row(text, static_cast<int>(record[0]),
+						number_of_fields, &(field_number_of_components[0]), record + 1,
+						&(defined[static_cast<size_t>(i)*number_of_fields]));
+				}
+				return_code = Buffered_file_writer_write(writer, text.data(), text.size());
+			}
+			number_of_nodes += block_size;
+		}
+	}
+	cmzn_nodeiterator_destroy(&iterator);
+	if (node_identifiers)
+		DESTROY(Identifier_set)(&node_identifiers);
+	cmzn_fieldcache_destroy(&field_cache);
+	cmzn_fieldmodule_destroy(&field_module);
+	if (!Buffered_file_writer_finish(writer))
+		return_code = 0;
+	DESTROY(Buffered_file_writer)(&writer);
+	if (number_of_nodes_address)
+		*number_of_nodes_address = number_of_nodes;
+	return return_code;
+}
@@ -0,0 +1,48 @@
+/**
+ * FILE : export_nodal_values.h
+ *
+ * Writes the values of fields at nodes to CSV or binary files for analysis
+ * outside cmgui.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (EXPORT_NODAL_VALUES_H)
+#define EXPORT_NODAL_VALUES_H
+
+#include "opencmiss/zinc/types/fieldid.h"
+#include "opencmiss/zinc/types/nodesetid.h"
+
+struct Multi_range;
+
+enum Nodal_values_file_format
+{
+	/** Comma separated text with a header row naming each column. */
+	NODAL_VALUES_FILE_FORMAT_CSV,
+	/** The CSV header preceded by a line describing the encoding, then one
+	 * record per node of native byte order doubles, the first being the node
+	 * identifier. Values not defined at a node are NaN. */
+	NODAL_VALUES_FILE_FORMAT_BINARY
+};
+
+/**
+ * Writes the identifier and the values of <fields> at <time> for each node in
+ * <nodeset>, optionally restricted to identifiers in <node_ranges> and nodes
+ * where <conditional_field> is true. Fields are evaluated in blocks of nodes
+ * and written through a buffered writer overlapping evaluation and output.
+ * Values are written with enough digits to be read back exactly.
+ * @param node_ranges  Identifier ranges to write, or NULL or empty for all.
+ * @param fields  Array of <number_of_fields> real valued fields.
+ * @param number_of_nodes_address  If not NULL, receives the number of nodes
+ * written.
+ * @return  1 on success, 0 on failure.
+ */
+int export_nodal_values_file_of_name(const char *file_name,
+	cmzn_nodeset_id nodeset, struct Multi_range *node_ranges,
+	cmzn_field_id conditional_field, int number_of_fields, cmzn_field_id *fields,
+	double time, enum Nodal_values_file_format format,
+	int *number_of_nodes_address);
+
+#endif /* !defined (EXPORT_NODAL_VALUES_H) */
@@ -0,0 +1,584 @@
+/**
+ * FILE : mesh_location_index.cpp
+ *
+ * Bounding volume hierarchy over the elements of a mesh.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include "opencmiss/zinc/differentialoperator.h"
+#include "opencmiss/zinc/element.h"
+#include "opencmiss/zinc/field.h"
+#include "opencmiss/zinc/fieldcache.h"
+#include "opencmiss/zinc/fieldmodule.h"
+#include "opencmiss/zinc/status.h"
+#include "finite_element/mesh_location_index.h"
+#include "general/debug.h"
+#include "general/memory_accounting.h"
+#include "general/message.h"
+
+namespace {
+
+/** Maximum number of elements in a leaf of the hierarchy. */
+const int MESH_LOCATION_LEAF_SIZE = 4;
+/** Fraction of each element's size its range is padded by. */
+const double MESH_LOCATION_RANGE_PADDING = 0.1;
+const int MESH_LOCATION_MAXIMUM_ITERATIONS = 20;
+/** Tolerance on xi for accepting a location, and for convergence */
+const double MESH_LOCATION_XI_TOLERANCE = 1.0E-6;
+/** Tolerance on the coordinates relative to the element size */
+const double MESH_LOCATION_VALUE_TOLERANCE = 1.0E-6;
+
+struct Mesh_location_box
+{
+	double minimum[3], maximum[3];
+};
+
+struct Mesh_location_node
+{
+	struct Mesh_location_box box;
+	/* children for internal nodes, or the range of element_order for leaves */
+	int first, count;
+	bool leaf;
+};
+
+inline bool Mesh_location_box_contains(const struct Mesh_location_box &box,
+	const double *values, int number_of_components)
+{
+	for (int c = 0; c < number_of_components; ++c)
+	{
+		if ((values[c] < box.minimum[c]) || (values[c] > box.maximum[c]))
+			return false;
+	}
+	return true;
+}
+
+/**
+ * Solves the d x d system a x = b by Gaussian elimination with partial
+ * pivoting, d <= 3.
+ * @return  1 on success, 0 if singular.
+ */
+int Mesh_location_solve(int d, double a[3][3], double *b, double *x)
+{
+	for (int k = 0; k < d; ++k)
+	{
+		int pivot = k;
+		for (int i = k + 1; i < d; ++i)
+		{
+			if (fabs(a[i][k]) > fabs(a[pivot][k]))
+				pivot = i;
+		}
+		if (0.0 == a[pivot][k])
+			return 0;
+		if (pivot != k)
+		{
+			for (int j = 0; j < d; ++j)
+				std::swap(a[k][j], a[pivot][j]);
+			std::swap(b[k], b[pivot]);
+		}
+		for (int i = k + 1; i < d; ++i)
+		{
+			const double factor = a[i][k]/a[k][k];
+			for (int j = k; j < d; ++j)
+				a[i][j] -= factor*a[k][j];
+			b[i] -= factor*b[k];
+		}
+	}
+	for (int k = d - 1; k >= 0; --k)
+	{
+		double sum = b[k];
+		for (int j = k + 1; j < d; ++j)
+			sum -= a[k][j]*x[j];
+		x[k] = sum/a[k][k];
+	}
+	return 1;
+}
+
+}
+
+struct Mesh_location_index
+{
+	int dimension, number_of_components;
+	cmzn_mesh_id mesh;
+	cmzn_field_id coordinate_field;
+	/* first derivative with respect to each xi */
+	cmzn_differentialoperator_id derivatives[3];
+	std::vector<cmzn_element_id> elements;
+	/* number of xi which must sum to at most 1 for each element, 0 for cubes */
+	std::vector<int> simplex_dimensions;
+	std::vector<struct Mesh_location_box> element_boxes;
+	/* element numbers in leaf order */
+	std::vector<int> element_order;
+	/* node 0 is the root */
+	std::vector<struct Mesh_location_node> nodes;
+	/* bytes of the vectors recorded with the memory accounting */
+	size_t accounted_bytes;
+
+	size_t getBytes() const
+	{
+		return elements.capacity()*sizeof(cmzn_element_id) +
+			simplex_dimensions.capacity()*sizeof(int) +
+			element_boxes.capacity()*sizeof(struct Mesh_location_box) +
+			element_order.capacity()*sizeof(int) +
+			nodes.capacity()*sizeof(struct Mesh_location_node);
+	}
+};
+
+namespace {
+
+/** Number of leading xi coordinates limited to a simplex for element shape. */
+int Mesh_location_element_simplex_dimension(cmzn_element_id element)
+{
+	switch (cmzn_element_get_shape_type(element))
+	{
+		case CMZN_ELEMENT_SHAPE_TYPE_TRIANGLE:
+		case CMZN_ELEMENT_SHAPE_TYPE_WEDGE12:
+			return 2;
+		case CMZN_ELEMENT_SHAPE_TYPE_TETRAHEDRON:
+			return 3;
+		default:
+			break;
+	}
+	return 0;
+}
+
+bool Mesh_location_xi_in_element(int dimension, int simplex_dimension,
+	const double *xi)
+{
+	double sum = 0.0;
+	for (int i = 0; i < dimension; ++i)
+	{
+		if ((xi[i] < -MESH_LOCATION_XI_TOLERANCE) ||
+			(xi[i] > 1.0 + MESH_LOCATION_XI_TOLERANCE))
+			return false;
+		if (i < simplex_dimension)
+			sum += xi[i];
+	}
+	return (sum <= 1.0 + MESH_LOCATION_XI_TOLERANCE);
+}
+
+/**
+ * @return  True if xi is further than the tolerance inside the element, so no
+ * neighbouring element can also contain the location.
+ */
+bool Mesh_location_xi_inside_element(int dimension, int simplex_dimension,
+	const double *xi)
+{
+	double sum = 0.0;
+	for (int i = 0; i < dimension; ++i)
+	{
+		if ((xi[i] <= MESH_LOCATION_XI_TOLERANCE) ||
+			(xi[i] >= 1.0 - MESH_LOCATION_XI_TOLERANCE))
+			return false;
+		if (i < simplex_dimension)
+			sum += xi[i];
+	}
+	return (sum < 1.0 - MESH_LOCATION_XI_TOLERANCE);
+}
+
+/**
+ * Evaluates the range of the coordinate field over the element from its
+ * values and first xi derivatives at xi = 0, 0.5 and 1 in each direction,
+ * then pads it. Each point is offset by a third of the sample spacing times
+ * each combination of signed derivatives, which are the Bezier control points
+ * of a cubic through neighbouring samples, so the box bounds elements up to
+ * cubic Hermite bulging along lines of xi.
+ * @return  1 if the field could be evaluated, otherwise 0.
+ */
+int Mesh_location_index_element_box(struct Mesh_location_index *index,
+	cmzn_fieldcache_id field_cache, cmzn_element_id element,
+	struct Mesh_location_box *box)
+{
+	const int dimension = index->dimension;
+	const int number_of_components = index->number_of_components;
+	int number_of_points = 1;
+	for (int i = 0; i < dimension; ++i)
+		number_of_points *= 3;
+	const int number_of_offsets = 1 << dimension;
+	for (int c = 0; c < 3; ++c)
+	{
+		box->minimum[c] = 0.0;
+		box->maximum[c] = 0.0;
+	}
+	/* samples are 0.5 apart in xi */
+	const double offset_scale = 0.5/3.0;
+	double xi[3], values[3], derivatives[3][3];
+	for (int p = 0; p < number_of_points; ++p)
+	{
+		int remainder = p;
+		for (int i = 0; i < dimension; ++i)
+		{
+			xi[i] = 0.5*(double)(remainder % 3);
+			remainder /= 3;
+		}
+		if ((CMZN_OK != cmzn_fieldcache_set_mesh_location(field_cache, element,
+				dimension, xi)) ||
+			(CMZN_OK != cmzn_field_evaluate_real(index->coordinate_field,
+				field_cache, number_of_components, values)))
+			return 0;
+		for (int i = 0; i < dimension; ++i)
+		{
+			if (CMZN_OK != cmzn_field_evaluate_derivative(index->coordinate_field,
+					index->derivatives[i], field_cache, number_of_components, derivatives[i]))
+				return 0;
+		}
+		for (int c = 0; c < number_of_components; ++c)
+		{
+			for (int o = 0; o < number_of_offsets; ++o)
+			{
+				double value = values[c];
+				for (int i = 0; i < dimension; ++i)
+				{
+					if (o & (1 << i))
+						value += offset_scale*derivatives[i][c];
+					else
+						value -= offset_scale*derivatives[i][c];
+				}
+				if (((0 == p) && (0 == o)) || (value < box->minimum[c]))
+					box->minimum[c] = value;
+				if (((0 == p) && (0 == o)) || (value > box->maximum[c]))
+					box->maximum[c] = value;
+			}
+		}
+	}
+	double size = 0.0;
+	for (int c = 0; c < number_of_components; ++c)
+	{
+		if (box->maximum[c] - box->minimum[c] > size)
+			size = box->maximum[c] - box->minimum[c];
+	}
+	const double padding = MESH_LOCATION_RANGE_PADDING*size;
+	for (int c = 0; c < number_of_components; ++c)
+	{
+		box->minimum[c] -= padding;
+		box->maximum[c] += padding;
+	}
+	return 1;
+}
+
+/** Orders element numbers by the centre of their boxes along one axis. */
+class Mesh_location_centre_less
+{
+	const std::vector<struct Mesh_location_box> &element_boxes;
+	const int axis;
+
+public:
+	Mesh_location_centre_less(const std::vector<struct Mesh_location_box> &element_boxes_in,
+			int axis_in) :
+		element_boxes(element_boxes_in),
+		axis(axis_in)
+	{
+	}
+
+	bool operator()(int a, int b) const
+	{
+		return (element_boxes[a].minimum[axis] + element_boxes[a].maximum[axis]) <
+			(element_boxes[b].minimum[axis] + element_boxes[b].maximum[axis]);
+	}
+};
+
+/** Builds the node for element_order[first..first+count) and its
+ * descendants, splitting at the median along the longest axis. */
+int Mesh_location_index_build_node(struct Mesh_location_index *index,
+	int first, int count)
+{
+	const int number_of_components = index->number_of_components;
+	const int node_number = static_cast<int>(index->nodes.size());
+	index->nodes.push_back(Mesh_location_node());
+	struct Mesh_location_box box = index->element_boxes[index->element_order[first]];
+	double centre_minimum[3], centre_maximum[3];
+	for (int i = 0; i < count; ++i)
+	{
+		const struct Mesh_location_box &element_box =
+			index->element_boxes[index->element_order[first + i]];
+		for (int c = 0; c < number_of_components; ++c)
+		{
+			if (element_box.minimum[c] < box.minimum[c])
+				box.minimum[c] = element_box.minimum[c];
+			if (element_box.maximum[c] > box.maximum[c])
+				box.maximum[c] = element_box.maximum[c];
+			const double centre = element_box.minimum[c] + element_box.maximum[c];
+			if ((0 == i) || (centre < centre_minimum[c]))
+				centre_minimum[c] = centre;
+			if ((0 == i) || (centre > centre_maximum[c]))
+				centre_maximum[c] = centre;
+		}
+	}
+	index->nodes[node_number].box = box;
+	if (count <= MESH_LOCATION_LEAF_SIZE)
+	{
+		index->nodes[node_number].leaf = true;
+		index->nodes[node_number].first = first;
+		index->nodes[node_number].count = count;
+		return node_number;
+	}
+	int axis = 0;
+	for (int c = 1; c < number_of_components; ++c)
+	{
+		if (centre_maximum[c] - centre_minimum[c] >
+				centre_maximum[axis] - centre_minimum[axis])
+			axis = c;
+	}
+	const int half = count/2;
+	std::nth_element(index->element_order.begin() + first,
+		index->element_order.begin() + first + half,
+		index->element_order.begin() + first + count,
+		Mesh_location_centre_less(index->element_boxes, axis));
+	const int left = Mesh_location_index_build_node(index, first, half);
+	const int right = Mesh_location_index_build_node(index, first + half, count - half);
+	index->nodes[node_number].leaf = false;
+	index->nodes[node_number].first = left;
+	index->nodes[node_number].count = right;
+	return node_number;
+}
+
+/**
+ * Solves for xi in element number <element_number> by Gauss-Newton from its
+ * centre. Least squares handles fields with more components than the mesh
+ * dimension, where the location must still lie on the element.
+ * @return  1 if converged to a location within the element, otherwise 0.
+ */
+int Mesh_location_index_find_in_element(struct Mesh_location_index *index,
+	cmzn_fieldcache_id field_cache, int element_number, const double *values,
+	double *xi)
+{
+	const int dimension = index->dimension;
+	const int number_of_components = index->number_of_components;
+	cmzn_element_id element = index->elements[element_number];
+	const int simplex_dimension = index->simplex_dimensions[element_number];
+	const struct Mesh_location_box &box = index->element_boxes[element_number];
+	double size = 0.0;
+	for (int c = 0; c < number_of_components; ++c)
+	{
+		if (box.maximum[c] - box.minimum[c] > size)
+			size = box.maximum[c] - box.minimum[c];
+	}
+	const double value_tolerance = MESH_LOCATION_VALUE_TOLERANCE*size;
+	for (int i = 0; i < dimension; ++i)
+		xi[i] = (i < simplex_dimension) ? (1.0/(simplex_dimension + 1)) : 0.5;
+	double current_values[3], residual[3], jacobian[3][3], normal[3][3],
+		right_hand_side[3], delta_xi[3];
+	for (int iteration = 0; iteration < MESH_LOCATION_MAXIMUM_ITERATIONS; ++iteration)
+	{
+		if ((CMZN_OK != cmzn_fieldcache_set_mesh_location(field_cache, element,
+				dimension, xi)) ||
+			(CMZN_OK != cmzn_field_evaluate_real(index->coordinate_field,
+				field_cache, number_of_components, current_values)))
+			return 0;
+		double residual_size = 0.0;
+		for (int c = 0; c < number_of_components; ++c)
+		{
+			residual[c] = values[c] - current_values[c];
+			if (fabs(residual[c]) > residual_size)
+				residual_size = fabs(residual[c]);
+		}
+		if (residual_size <= value_tolerance)
+			return Mesh_location_xi_in_element(dimension, simplex_dimension, xi);
+		for (int i = 0; i < dimension; ++i)
+		{
+			double derivatives[3];
+			if (CMZN_OK != cmzn_field_evaluate_derivative(index->coordinate_field,
+					index->derivatives[i], field_cache, number_of_components, derivatives))
+				return 0;
+			for (int c = 0; c < number_of_components; ++c)
+				jacobian[c][i] = derivatives[c];
+		}
+		for (int i = 0; i < dimension; ++i)
+		{
+			right_hand_side[i] = 0.0;
+			for (int c = 0; c < number_of_components; ++c)
+				right_hand_side[i] += jacobian[c][i]*residual[c];
+			for (int j = 0; j < dimension; ++j)
+			{
+				normal[i][j] = 0.0;
+				for (int c = 0; c < number_of_components; ++c)
+					normal[i][j] += jacobian[c][i]*jacobian[c][j];
+			}
+		}
+		if (!Mesh_location_solve(dimension, normal, right_hand_side, delta_xi))
+			return 0;
+		double step_size = 0.0;
+		for (int i = 0; i < dimension; ++i)
+		{
+			xi[i] += delta_xi[i];
+			/* keep iterates near the element so the field stays defined */
+			if (xi[i] < -0.5)
+				xi[i] = -0.5;
+			else if (xi[i] > 1.5)
+				xi[i] = 1.5;
+			if (fabs(delta_xi[i]) > step_size)
+				step_size = fabs(delta_xi[i]);
+		}
+		if ((step_size < MESH_LOCATION_XI_TOLERANCE) &&
+			(number_of_components > dimension))
+		{
+			/* converged to the nearest point, which is not on the element */
+			return 0;
+		}
+	}
+	return 0;
+}
+
+}
+
+struct Mesh_location_index *CREATE(Mesh_location_index)(cmzn_mesh_id mesh,
+	cmzn_field_id coordinate_field)
+{
+	const int dimension = cmzn_mesh_get_dimension(mesh);
+	const int number_of_components = cmzn_field_get_number_of_components(coordinate_field);
+	if (!(mesh && coordinate_field && (0 < dimension) && (dimension <= 3) &&
+		(0 < number_of_components) && (number_of_components <= 3)))
+	{
+		display_message(ERROR_MESSAGE,
+			"CREATE(Mesh_location_index).  Invalid argument(s)");
+		return 0;
+	}
+	struct Mesh_location_index *index = new Mesh_location_index();
+	index->dimension = dimension;
+	index->number_of_components = number_of_components;
+	index->mesh = cmzn_mesh_access(mesh);
+	index->coordinate_field = cmzn_field_access(coordinate_field);
+	for (int i = 0; i < 3; ++i)
+	{
+		index->derivatives[i] = (i < dimension) ?
+			cmzn_mesh_get_chart_differentialoperator(mesh, /*order*/1, /*term*/i + 1) : 0;
+	}
+	cmzn_fieldmodule_id field_module = cmzn_field_get_fieldmodule(coordinate_field);
+	cmzn_fieldcache_id field_cache = cmzn_fieldmodule_create_fieldcache(field_module);
+	const int size = cmzn_mesh_get_size(mesh);
+	if (0 < size)
+	{
+		index->elements.reserve(size);
+		index->element_boxes.reserve(size);
+	}
+	cmzn_elementiterator_id iterator = cmzn_mesh_create_elementiterator(mesh);
+	cmzn_element_id element;
+	struct Mesh_location_box box;
+	while (0 != (element = cmzn_elementiterator_next(iterator)))
+	{
+		/* elements where the field is not defined are not indexed */
+		if (Mesh_location_index_element_box(index, field_cache, element, &box))
+		{
+			index->elements.push_back(element);
+			index->simplex_dimensions.push_back(
+				Mesh_location_element_simplex_dimension(element));
+			index->element_boxes.push_back(box);
+		}
+		else
+		{
+			cmzn_element_destroy(&element);
+		}
+	}
+	cmzn_elementiterator_destroy(&iterator);
+	cmzn_fieldcache_destroy(&field_cache);
+	cmzn_fieldmodule_destroy(&field_module);
+	const int number_of_elements = static_cast<int>(index->elements.size());
+	if (0 < number_of_elements)
+	{
+		index->element_order.resize(number_of_elements);
+		for (int i = 0; i < number_of_elements; ++i)
+			index->element_order[i] = i;
+		index->nodes.reserve(2*number_of_elements/MESH_LOCATION_LEAF_SIZE + 1);
+		Mesh_location_index_build_node(index, 0, number_of_elements);
+	}
+	index->accounted_bytes = index->getBytes();
+	Memory_accounting_add(MEMORY_ACCOUNTING_TAG_MESH_INDEXES, index->accounted_bytes);
+	return index;
+}
+
+int DESTROY(Mesh_location_index)(struct Mesh_location_index **index_address)
+{
+	if (!(index_address && *index_address))
+		return 0;
+	struct Mesh_location_index *index = *index_address;
+	Memory_accounting_remove(MEMORY_ACCOUNTING_TAG_MESH_INDEXES, index->accounted_bytes);
+	for (size_t i = 0; i < index->elements.size(); ++i)
+		cmzn_element_destroy(&(index->elements[i]));
+	for (int i = 0; i < 3; ++i)
+	{
+		if (index->derivatives[i])
+			cmzn_differentialoperator_destroy(&(index->derivatives[i]));
+	}
+	cmzn_field_destroy(&(index->coordinate_field));
+	cmzn_mesh_destroy(&(index->mesh));
+	delete index;
+	*index_address = 0;
+	return 1;
+}
+
+int Mesh_location_index_get_dimension(struct Mesh_location_index *index)
+{
+	if (index)
+		return index->dimension;
+	return 0;
+}
+
+cmzn_element_id Mesh_location_index_get_element(
+	struct Mesh_location_index *index, int element_number)
+{
+	if (index && (0 <= element_number) &&
+		(element_number < static_cast<int>(index->elements.size())))
+		return index->elements[element_number];
+	return 0;
+}
+
+int Mesh_location_index_find(struct Mesh_location_index *index,
+	cmzn_fieldcache_id field_cache, const double *values,
+	int *element_number_address, double *xi)
+{
+	if (!(index && field_cache && values && element_number_address && xi))
+		return 0;
+	if (index->nodes.empty())
+		return 0;
+	const int number_of_components = index->number_of_components;
+	/* the warm start is only used if no other element can contain the
+	 * location, so the element found is the first in tree order whatever
+	 * was found before, and results do not depend on the order of searches */
+	const int warm_start = *element_number_address;
+	if ((0 <= warm_start) && (warm_start < static_cast<int>(index->elements.size())) &&
+		Mesh_location_box_contains(index->element_boxes[warm_start], values,
+			number_of_components) &&
+		Mesh_location_index_find_in_element(index, field_cache, warm_start, values, xi) &&
+		Mesh_location_xi_inside_element(index->dimension,
+			index->simplex_dimensions[warm_start], xi))
+	{
+		return 1;
+	}
+	/* depth of a median split tree is logarithmic in the number of elements */
+	int stack[64];
+	int stack_size = 0;
+	stack[stack_size++] = 0;
+	while (0 < stack_size)
+	{
+		const struct Mesh_location_node &node = index->nodes[stack[--stack_size]];
+		if (!Mesh_location_box_contains(node.box, values, number_of_components))
+			continue;
+		if (node.leaf)
+		{
+			for (int i = 0; i < node.count; ++i)
+			{
+				const int element_number = index->element_order[node.first + i];
+				if (Mesh_location_box_contains(index->element_boxes[element_number],
+						values, number_of_components) &&
+					Mesh_location_index_find_in_element(index, field_cache,
+						element_number, values, xi))
+				{
+					*element_number_address = element_number;
+					return 1;
+				}
+			}
+		}
+		else
+		{
+			stack[stack_size++] = node.count;
+			stack[stack_size++] = node.first;
+		}
+	}
+	return 0;
+}
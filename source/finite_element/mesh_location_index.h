@@ -0,0 +1,64 @@
+/**
+ * FILE : mesh_location_index.h
+ *
+ * Bounding volume hierarchy over the elements of a mesh for finding the
+ * element and xi at which a field has given values.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (MESH_LOCATION_INDEX_H)
+#define MESH_LOCATION_INDEX_H
+
+#include "opencmiss/zinc/types/elementid.h"
+#include "opencmiss/zinc/types/fieldcacheid.h"
+#include "opencmiss/zinc/types/fieldid.h"
+#include "general/object.h"
+
+struct Mesh_location_index;
+
+/**
+ * Builds an index of the range of <coordinate_field> over each element of
+ * <mesh>. Ranges are grown from the values and xi derivatives at the corners,
+ * mid-sides and centre of each element and padded, which bounds elements
+ * bulging like cubic Hermite curves along lines of xi. The index keeps handles
+ * to the elements and is not updated if the mesh or field changes.
+ * @param coordinate_field  Field with 1 to 3 components defined on the mesh.
+ * @return  New index, or NULL on failure.
+ */
+struct Mesh_location_index *CREATE(Mesh_location_index)(cmzn_mesh_id mesh,
+	cmzn_field_id coordinate_field);
+
+int DESTROY(Mesh_location_index)(struct Mesh_location_index **index_address);
+
+/**
+ * @return  Dimension of the indexed mesh, or 0 if invalid.
+ */
+int Mesh_location_index_get_dimension(struct Mesh_location_index *index);
+
+/**
+ * @return  Non-accessed element number <element_number> in the index.
+ */
+cmzn_element_id Mesh_location_index_get_element(
+	struct Mesh_location_index *index, int element_number);
+
+/**
+ * Finds an element and xi where the coordinate field equals <values>, trying
+ * the element number in <element_number_address> first, then any elements
+ * whose ranges contain <values>. The first element is only taken if xi is
+ * inside it by more than the tolerance, so a location on a boundary between
+ * elements is always found in the same one whatever element is tried first.
+ * The index is not modified, so several threads may search it at once if
+ * each uses its own <field_cache>.
+ * @param element_number_address  On input, element number to try first or -1.
+ * On success, receives the number of the element found.
+ * @param xi  Array of the mesh dimension, receiving xi on success.
+ * @return  1 if a location was found, otherwise 0.
+ */
+int Mesh_location_index_find(struct Mesh_location_index *index,
+	cmzn_fieldcache_id field_cache, const double *values,
+	int *element_number_address, double *xi);
+
+#endif /* !defined (MESH_LOCATION_INDEX_H) */
@@ -0,0 +1,263 @@
+/**
+ * FILE : buffered_file_writer.cpp
+ *
+ * Writes a file through two large buffers, one being filled by the caller
+ * while the other is written on a background thread.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <stdio.h>
+#include <string.h>
+#include "general/buffered_file_writer.h"
+#include "general/cmgui_thread.h"
+#include "general/debug.h"
+#include "general/memory_accounting.h"
+#include "general/message.h"
+#include "general/mystring.h"
+
+struct Buffered_file_writer
+{
+	char *file_name;
+	FILE *file;
+	size_t buffer_size;
+	/* buffer being filled by the caller and the number of bytes in it */
+	char *buffer;
+	size_t buffer_fill;
+	/* buffer handed to the thread, or NULL when it has been written */
+	char *pending;
+	size_t pending_size;
+	/* empty buffer available for the caller to swap in */
+	char *spare;
+	/* bytes of both buffers recorded with the memory accounting */
+	size_t accounted_bytes;
+	int finishing, finished, error;
+	struct Cmgui_mutex *mutex;
+	/* signalled whenever pending or finishing changes */
+	struct Cmgui_condition *condition;
+	struct Cmgui_thread *thread;
+};
+
+namespace {
+
+int Buffered_file_writer_write_data(struct Buffered_file_writer *writer,
+	const char *data, size_t size)
+{
+	return (0 == size) || (size == fwrite(data, 1, size, writer->file));
+}
+
+/** Body of the writing thread: writes each pending buffer until the writer
+ * is finishing with nothing pending. After an error buffers are discarded. */
+int Buffered_file_writer_thread_function(int dummy_index, void *writer_void)
+{
+	USE_PARAMETER(dummy_index);
+	struct Buffered_file_writer *writer =
+		(struct Buffered_file_writer *)writer_void;
+	Cmgui_mutex_lock(writer->mutex);
+	while (true)
+	{
+		while ((!writer->pending) && (!writer->finishing))
+			Cmgui_condition_wait(writer->condition, writer->mutex);
+		if (!writer->pending)
+			break;
+		char *data = writer->pending;
+		size_t size = writer->pending_size;
+		int error = writer->error;
+		Cmgui_mutex_unlock(writer->mutex);
+		int result = (!error) && Buffered_file_writer_write_data(writer, data, size);
+		Cmgui_mutex_lock(writer->mutex);
+		writer->spare = data;
+		writer->pending = 0;
+		if (!result)
+			writer->error = 1;
+		Cmgui_condition_broadcast(writer->condition);
+	}
+	Cmgui_mutex_unlock(writer->mutex);
+	return 1;
+}
+
+/** Hands the current buffer to the thread, or writes it if there is no
+ * thread, and continues in the spare buffer. */
+int Buffered_file_writer_flush_buffer(struct Buffered_file_writer *writer)
+{
+	if (0 == writer->buffer_fill)
+		return !writer->error;
+	if (!writer->thread)
+	{
+		if ((!writer->error) && (!Buffered_file_writer_write_data(writer,
+			writer->buffer, writer->buffer_fill)))
+		{
+			writer->error = 1;
+		}
+		writer->buffer_fill = 0;
+		return !writer->error;
+	}
+	Cmgui_mutex_lock(writer->mutex);
+	while (writer->pending)
+		Cmgui_condition_wait(writer->condition, writer->mutex);
+	writer->pending = writer->buffer;
+	writer->pending_size = writer->buffer_fill;
+	writer->buffer = writer->spare;
+	writer->spare = 0;
+	writer->buffer_fill = 0;
+	Cmgui_condition_broadcast(writer->condition);
+	int return_code = !writer->error;
+	Cmgui_mutex_unlock(writer->mutex);
+	return return_code;
+}
+
+}
+
+struct Buffered_file_writer *CREATE(Buffered_file_writer)(
+	const char *file_name, size_t buffer_size)
+{
+	struct Buffered_file_writer *writer = 0;
+	if (!(file_name && (0 < buffer_size)))
+	{
+		display_message(ERROR_MESSAGE,
+			"CREATE(Buffered_file_writer).  Invalid argument(s)");
+		return 0;
+	}
+	if (ALLOCATE(writer, struct Buffered_file_writer, 1))
+	{
+		writer->file_name = duplicate_string(file_name);
+		writer->file = 0;
+		writer->buffer_size = buffer_size;
+		writer->buffer = 0;
+		writer->buffer_fill = 0;
+		writer->pending = 0;
+		writer->pending_size = 0;
+		writer->spare = 0;
+		writer->accounted_bytes = 0;
+		writer->finishing = 0;
+		writer->finished = 0;
+		writer->error = 0;
+		writer->mutex = CREATE(Cmgui_mutex)();
+		writer->condition = CREATE(Cmgui_condition)();
+		writer->thread = 0;
+		if (writer->file_name && writer->mutex && writer->condition &&
+			ALLOCATE(writer->buffer, char, buffer_size) &&
+			ALLOCATE(writer->spare, char, buffer_size))
+		{
+			writer->accounted_bytes = 2*buffer_size;
+			Memory_accounting_add(MEMORY_ACCOUNTING_TAG_FILE_BUFFERS, writer->accounted_bytes);
+			if (0 != (writer->file = fopen(file_name, "wb")))
+			{
+				/* the buffers replace stdio buffering */
+				setvbuf(writer->file, 0, _IONBF, 0);
+				/* if no thread can be started buffers are written as they fill */
+				writer->thread = Cmgui_thread_start(Buffered_file_writer_thread_function,
+					(void *)writer);
+			}
+			else
+			{
+				display_message(ERROR_MESSAGE,
+					"Could not open file %s for writing", file_name);
+				DESTROY(Buffered_file_writer)(&writer);
+			}
+		}
+		else
+		{
+			display_message(ERROR_MESSAGE,
+				"CREATE(Buffered_file_writer).  Not enough memory");
+			DESTROY(Buffered_file_writer)(&writer);
+		}
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"CREATE(Buffered_file_writer).  Not enough memory");
+	}
+	return writer;
+}
+
+int DESTROY(Buffered_file_writer)(
+	struct Buffered_file_writer **writer_address)
+{
+	struct Buffered_file_writer *writer;
+	if (writer_address && (writer = *writer_address))
+	{
+		if (writer->file)
+		{
+			Buffered_file_writer_finish(writer);
+			fclose(writer->file);
+		}
+		if (writer->accounted_bytes)
+			Memory_accounting_remove(MEMORY_ACCOUNTING_TAG_FILE_BUFFERS, writer->accounted_bytes);
+		if (writer->buffer)
+			DEALLOCATE(writer->buffer);
+		if (writer->spare)
+			DEALLOCATE(writer->spare);
+		if (writer->condition)
+			DESTROY(Cmgui_condition)(&writer->condition);
+		if (writer->mutex)
+			DESTROY(Cmgui_mutex)(&writer->mutex);
+		if (writer->file_name)
+			DEALLOCATE(writer->file_name);
+		DEALLOCATE(*writer_address);
+		return 1;
+	}
+	return 0;
+}
+
+int Buffered_file_writer_write(struct Buffered_file_writer *writer,
+	const void *data, size_t size)
+{
+	if (!(writer && (data || (0 == size)) && (!writer->finished)))
+	{
+		display_message(ERROR_MESSAGE,
+			"Buffered_file_writer_write.  Invalid argument(s)");
+		return 0;
+	}
+	const char *source = static_cast<const char *>(data);
+	while (0 < size)
+	{
+		size_t space = writer->buffer_size - writer->buffer_fill;
+		if (0 == space)
+		{
+			if (!Buffered_file_writer_flush_buffer(writer))
+				return 0;
+			space = writer->buffer_size;
+		}
+		const size_t copy_size = (size < space) ? size : space;
+		memcpy(writer->buffer + writer->buffer_fill, source, copy_size);
+		writer->buffer_fill += copy_size;
+		source += copy_size;
+		size -= copy_size;
+	}
+	return !writer->error;
+}
+
+int Buffered_file_writer_finish(struct Buffered_file_writer *writer)
+{
+	if (!writer)
+	{
+		display_message(ERROR_MESSAGE,
+			"Buffered_file_writer_finish.  Invalid argument(s)");
+		return 0;
+	}
+	if (!writer->finished)
+	{
+		Buffered_file_writer_flush_buffer(writer);
+		if (writer->thread)
+		{
+			Cmgui_mutex_lock(writer->mutex);
+			writer->finishing = 1;
+			Cmgui_condition_broadcast(writer->condition);
+			Cmgui_mutex_unlock(writer->mutex);
+			Cmgui_thread_join(&writer->thread);
+		}
+		if (0 != fflush(writer->file))
+			writer->error = 1;
+		writer->finished = 1;
+		if (writer->error)
+		{
+			display_message(ERROR_MESSAGE,
+				"Error writing file %s", writer->file_name);
+		}
+	}
+	return !writer->error;
+}
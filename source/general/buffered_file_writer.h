@@ -0,0 +1,50 @@
+/**
+ * FILE : buffered_file_writer.h
+ *
+ * Writes a file through two large buffers, one being filled by the caller
+ * while the other is written on a background thread.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (BUFFERED_FILE_WRITER_H)
+#define BUFFERED_FILE_WRITER_H
+
+#include <stddef.h>
+#include "general/object.h"
+
+struct Buffered_file_writer;
+
+/**
+ * Opens <file_name> for binary writing, replacing any existing file.
+ * @param buffer_size  Size of each of the two buffers in bytes.
+ * @return  New writer, or NULL on failure.
+ */
+struct Buffered_file_writer *CREATE(Buffered_file_writer)(
+	const char *file_name, size_t buffer_size);
+
+/**
+ * Finishes the writer if not already finished and closes the file.
+ */
+int DESTROY(Buffered_file_writer)(
+	struct Buffered_file_writer **writer_address);
+
+/**
+ * Copies <size> bytes of <data> to the file. When the current buffer fills it
+ * is handed to the background thread, waiting for the previous one to be
+ * written first. Writes synchronously if no thread could be started.
+ * @return  1 on success, 0 if this or an earlier write failed.
+ */
+int Buffered_file_writer_write(struct Buffered_file_writer *writer,
+	const void *data, size_t size);
+
+/**
+ * Writes any buffered data, waits for the background thread to finish and
+ * flushes the file. No more data may be written afterwards.
+ * @return  1 if all data was written, otherwise 0.
+ */
+int Buffered_file_writer_finish(struct Buffered_file_writer *writer);
+
+#endif /* !defined (BUFFERED_FILE_WRITER_H) */
@@ -0,0 +1,349 @@
+/**
+ * FILE : cmgui_thread.cpp
+ *
+ * Minimal portable threading used by cmgui commands.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "configure/cmgui_configure.h"
+#if defined (WIN32_SYSTEM)
+//#define WINDOWS_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <process.h>
+#else /* defined (WIN32_SYSTEM) */
+#include <pthread.h>
+#include <unistd.h>
+#endif /* defined (WIN32_SYSTEM) */
+#include "general/cmgui_thread.h"
+#include "general/debug.h"
+#include "general/message.h"
+
+struct Cmgui_mutex
+{
+#if defined (WIN32_SYSTEM)
+	CRITICAL_SECTION critical_section;
+#else /* defined (WIN32_SYSTEM) */
+	pthread_mutex_t mutex;
+#endif /* defined (WIN32_SYSTEM) */
+};
+
+struct Cmgui_condition
+{
+#if defined (WIN32_SYSTEM)
+	CONDITION_VARIABLE condition_variable;
+#else /* defined (WIN32_SYSTEM) */
+	pthread_cond_t condition;
+#endif /* defined (WIN32_SYSTEM) */
+};
+
+struct Cmgui_thread
+{
+	Cmgui_thread_function function;
+	void *user_data;
+	int result;
+#if defined (WIN32_SYSTEM)
+	HANDLE handle;
+#else /* defined (WIN32_SYSTEM) */
+	pthread_t thread;
+#endif /* defined (WIN32_SYSTEM) */
+};
+
+#if defined (WIN32_SYSTEM)
+static unsigned __stdcall Cmgui_thread_entry(void *thread_void)
+#else /* defined (WIN32_SYSTEM) */
+static void *Cmgui_thread_entry(void *thread_void)
+#endif /* defined (WIN32_SYSTEM) */
+{
+	struct Cmgui_thread *thread = (struct Cmgui_thread *)thread_void;
+	thread->result = (thread->function)(/*index*/0, thread->user_data);
+	return 0;
+}
+
+int cmgui_get_number_of_processors(void)
+{
+	int number_of_processors = 1;
+#if defined (WIN32_SYSTEM)
+	SYSTEM_INFO system_info;
+	GetSystemInfo(&system_info);
+	number_of_processors = (int)system_info.dwNumberOfProcessors;
+#elif defined (_SC_NPROCESSORS_ONLN)
+	number_of_processors = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif /* defined (WIN32_SYSTEM) */
+	if (number_of_processors < 1)
+		number_of_processors = 1;
+	return number_of_processors;
+}
+
+struct Cmgui_mutex *CREATE(Cmgui_mutex)(void)
+{
+	struct Cmgui_mutex *mutex;
+	if (ALLOCATE(mutex, struct Cmgui_mutex, 1))
+	{
+#if defined (WIN32_SYSTEM)
+		InitializeCriticalSection(&(mutex->critical_section));
+#else /* defined (WIN32_SYSTEM) */
+		if (0 != pthread_mutex_init(&(mutex->mutex), (pthread_mutexattr_t *)NULL))
+		{
+			display_message(ERROR_MESSAGE, "CREATE(Cmgui_mutex).  Could not initialise mutex");
+			DEALLOCATE(mutex);
+		}
+#endif /* defined (WIN32_SYSTEM) */
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE, "CREATE(Cmgui_mutex).  Not enough memory");
+	}
+	return mutex;
+}
+
+int DESTROY(Cmgui_mutex)(struct Cmgui_mutex **mutex_address)
+{
+	if (mutex_address && (*mutex_address))
+	{
+#if defined (WIN32_SYSTEM)
+		DeleteCriticalSection(&((*mutex_address)->critical_section));
+#else /* defined (WIN32_SYSTEM) */
+		pthread_mutex_destroy(&((*mutex_address)->mutex));
+#endif /* defined (WIN32_SYSTEM) */
+		DEALLOCATE(*mutex_address);
+		return 1;
+	}
+	return 0;
+}
+
+int Cmgui_mutex_lock(struct Cmgui_mutex *mutex)
+{
+	if (mutex)
+	{
+#if defined (WIN32_SYSTEM)
+		EnterCriticalSection(&(mutex->critical_section));
+		return 1;
+#else /* defined (WIN32_SYSTEM) */
+		return (0 == pthread_mutex_lock(&(mutex->mutex)));
+#endif /* defined (WIN32_SYSTEM) */
+	}
+	return 0;
+}
+
+int Cmgui_mutex_unlock(struct Cmgui_mutex *mutex)
+{
+	if (mutex)
+	{
+#if defined (WIN32_SYSTEM)
+		LeaveCriticalSection(&(mutex->critical_section));
+		return 1;
+#else /* defined (WIN32_SYSTEM) */
+		return (0 == pthread_mutex_unlock(&(mutex->mutex)));
+#endif /* defined (WIN32_SYSTEM) */
+	}
+	return 0;
+}
+
+struct Cmgui_condition *CREATE(Cmgui_condition)(void)
+{
+	struct Cmgui_condition *condition;
+	if (ALLOCATE(condition, struct Cmgui_condition, 1))
+	{
+#if defined (WIN32_SYSTEM)
+		InitializeConditionVariable(&(condition->condition_variable));
+#else /* defined (WIN32_SYSTEM) */
+		if (0 != pthread_cond_init(&(condition->condition), (pthread_condattr_t *)NULL))
+		{
+			display_message(ERROR_MESSAGE, "CREATE(Cmgui_condition).  Could not initialise condition");
+			DEALLOCATE(condition);
+		}
+#endif /* defined (WIN32_SYSTEM) */
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE, "CREATE(Cmgui_condition).  Not enough memory");
+	}
+	return condition;
+}
+
+int DESTROY(Cmgui_condition)(struct Cmgui_condition **condition_address)
+{
+	if (condition_address && (*condition_address))
+	{
+#if !defined (WIN32_SYSTEM)
+		pthread_cond_destroy(&((*condition_address)->condition));
+#endif /* !defined (WIN32_SYSTEM) */
+		DEALLOCATE(*condition_address);
+		return 1;
+	}
+	return 0;
+}
+
+int Cmgui_condition_wait(struct Cmgui_condition *condition,
+	struct Cmgui_mutex *mutex)
+{
+	if (condition && mutex)
+	{
+#if defined (WIN32_SYSTEM)
+		return (0 != SleepConditionVariableCS(&(condition->condition_variable),
+			&(mutex->critical_section), INFINITE));
+#else /* defined (WIN32_SYSTEM) */
+		return (0 == pthread_cond_wait(&(condition->condition), &(mutex->mutex)));
+#endif /* defined (WIN32_SYSTEM) */
+	}
+	return 0;
+}
+
+int Cmgui_condition_broadcast(struct Cmgui_condition *condition)
+{
+	if (condition)
+	{
+#if defined (WIN32_SYSTEM)
+		WakeAllConditionVariable(&(condition->condition_variable));
+		return 1;
+#else /* defined (WIN32_SYSTEM) */
+		return (0 == pthread_cond_broadcast(&(condition->condition)));
+#endif /* defined (WIN32_SYSTEM) */
+	}
+	return 0;
+}
+
+struct Cmgui_thread *Cmgui_thread_start(Cmgui_thread_function function,
+	void *user_data)
+{
+	struct Cmgui_thread *thread = 0;
+	if (function)
+	{
+		if (ALLOCATE(thread, struct Cmgui_thread, 1))
+		{
+			thread->function = function;
+			thread->user_data = user_data;
+			thread->result = 0;
+#if defined (WIN32_SYSTEM)
+			thread->handle = (HANDLE)_beginthreadex(NULL, 0, Cmgui_thread_entry,
+				(void *)thread, 0, NULL);
+			if (!thread->handle)
+#else /* defined (WIN32_SYSTEM) */
+			if (0 != pthread_create(&(thread->thread), (pthread_attr_t *)NULL,
+				Cmgui_thread_entry, (void *)thread))
+#endif /* defined (WIN32_SYSTEM) */
+			{
+				display_message(ERROR_MESSAGE, "Cmgui_thread_start.  Could not start thread");
+				DEALLOCATE(thread);
+			}
+		}
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE, "Cmgui_thread_start.  Invalid argument(s)");
+	}
+	return thread;
+}
+
+int Cmgui_thread_join(struct Cmgui_thread **thread_address)
+{
+	int return_code = 0;
+	if (thread_address && (*thread_address))
+	{
+#if defined (WIN32_SYSTEM)
+		WaitForSingleObject((*thread_address)->handle, INFINITE);
+		CloseHandle((*thread_address)->handle);
+#else /* defined (WIN32_SYSTEM) */
+		pthread_join((*thread_address)->thread, (void **)NULL);
+#endif /* defined (WIN32_SYSTEM) */
+		return_code = (*thread_address)->result;
+		DEALLOCATE(*thread_address);
+	}
+	return return_code;
+}
+
+namespace {
+
+/** Shared state of a cmgui_parallel_for loop. Items are handed out one at a
+ * time under the mutex so uneven item costs balance across threads. */
+struct Cmgui_parallel_for_data
+{
+	struct Cmgui_mutex *mutex;
+	int next_index;
+	int number_of_items;
+	int return_code;
+	Cmgui_thread_function function;
+	void *user_data;
+};
+
+int Cmgui_parallel_for_worker(int dummy_index, void *data_void)
+{
+	USE_PARAMETER(dummy_index);
+	struct Cmgui_parallel_for_data *data = (struct Cmgui_parallel_for_data *)data_void;
+	int index, result;
+	while (true)
+	{
+		Cmgui_mutex_lock(data->mutex);
+		index = (data->return_code) ? data->next_index++ : data->number_of_items;
+		Cmgui_mutex_unlock(data->mutex);
+		if (index >= data->number_of_items)
+			break;
+		result = (data->function)(index, data->user_data);
+		if (!result)
+		{
+			Cmgui_mutex_lock(data->mutex);
+			data->return_code = 0;
+			Cmgui_mutex_unlock(data->mutex);
+		}
+	}
+	return 1;
+}
+
+}
+
+int cmgui_parallel_for(int number_of_threads, int number_of_items,
+	Cmgui_thread_function function, void *user_data)
+{
+	if ((number_of_items < 0) || (!function))
+	{
+		display_message(ERROR_MESSAGE, "cmgui_parallel_for.  Invalid argument(s)");
+		return 0;
+	}
+	if (number_of_threads <= 0)
+		number_of_threads = cmgui_get_number_of_processors();
+	if (number_of_threads > number_of_items)
+		number_of_threads = number_of_items;
+	int return_code = 1;
+	if (number_of_threads <= 1)
+	{
+		for (int i = 0; return_code && (i < number_of_items); ++i)
+			return_code = (function)(i, user_data);
+		return return_code;
+	}
+	struct Cmgui_parallel_for_data data;
+	data.mutex = CREATE(Cmgui_mutex)();
+	if (!data.mutex)
+		return 0;
+	data.next_index = 0;
+	data.number_of_items = number_of_items;
+	data.return_code = 1;
+	data.function = function;
+	data.user_data = user_data;
+	struct Cmgui_thread **threads;
+	if (ALLOCATE(threads, struct Cmgui_thread *, number_of_threads - 1))
+	{
+		for (int t = 0; t < number_of_threads - 1; ++t)
+			threads[t] = Cmgui_thread_start(Cmgui_parallel_for_worker, (void *)&data);
+		/* calling thread is the last worker; any threads which failed to start
+		 * simply leave more items for the others */
+		Cmgui_parallel_for_worker(0, (void *)&data);
+		for (int t = 0; t < number_of_threads - 1; ++t)
+		{
+			if (threads[t])
+				Cmgui_thread_join(&(threads[t]));
+		}
+		DEALLOCATE(threads);
+	}
+	else
+	{
+		Cmgui_parallel_for_worker(0, (void *)&data);
+	}
+	return_code = data.return_code;
+	DESTROY(Cmgui_mutex)(&data.mutex);
+	return return_code;
+}
@@ -0,0 +1,84 @@
+/**
+ * FILE : cmgui_thread.h
+ *
+ * Minimal portable threading used by cmgui commands which can overlap work
+ * that does not touch shared Zinc objects, e.g. file input and pure array
+ * computations. Uses pthreads on UNIX and native threads on WIN32_SYSTEM.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (GENERAL_CMGUI_THREAD_H)
+#define GENERAL_CMGUI_THREAD_H
+
+#include "general/object.h"
+
+struct Cmgui_condition;
+struct Cmgui_mutex;
+struct Cmgui_thread;
+
+/**
+ * Function called for each item of a cmgui_parallel_for loop, or as the body
+ * of a Cmgui_thread. Must return 1 on success, 0 on failure.
+ * @param index  Index of the item to process, or 0 for a Cmgui_thread.
+ * @param user_data  User data passed through unchanged.
+ */
+typedef int (*Cmgui_thread_function)(int index, void *user_data);
+
+/**
+ * @return  Number of processors available to this process, at least 1.
+ */
+int cmgui_get_number_of_processors(void);
+
+/**
+ * Calls <function> for every index from 0 to number_of_items - 1, sharing the
+ * items dynamically between up to <number_of_threads> threads including the
+ * calling thread. Returns when all items have been processed. The order in
+ * which items are processed is unspecified.
+ * @param number_of_threads  Maximum number of threads to use. If not positive,
+ * the number of processors is used. 1 runs serially on the calling thread.
+ * @return  1 if all calls succeeded, otherwise 0.
+ */
+int cmgui_parallel_for(int number_of_threads, int number_of_items,
+	Cmgui_thread_function function, void *user_data);
+
+struct Cmgui_mutex *CREATE(Cmgui_mutex)(void);
+
+int DESTROY(Cmgui_mutex)(struct Cmgui_mutex **mutex_address);
+
+int Cmgui_mutex_lock(struct Cmgui_mutex *mutex);
+
+int Cmgui_mutex_unlock(struct Cmgui_mutex *mutex);
+
+struct Cmgui_condition *CREATE(Cmgui_condition)(void);
+
+int DESTROY(Cmgui_condition)(struct Cmgui_condition **condition_address);
+
+/**
+ * Atomically releases <mutex>, which must be locked by the caller, and waits
+ * until <condition> is signalled, then locks <mutex> again. May wake
+ * spuriously so callers must recheck their predicate in a loop.
+ */
+int Cmgui_condition_wait(struct Cmgui_condition *condition,
+	struct Cmgui_mutex *mutex);
+
+/** Wakes all threads waiting on <condition>. */
+int Cmgui_condition_broadcast(struct Cmgui_condition *condition);
+
+/**
+ * Starts a thread calling <function> with index 0 and <user_data>.
+ * Must be finished with Cmgui_thread_join.
+ * @return  New thread, or NULL on failure.
+ */
+struct Cmgui_thread *Cmgui_thread_start(Cmgui_thread_function function,
+	void *user_data);
+
+/**
+ * Waits for thread to finish and frees it. Clears the thread address.
+ * @return  Result of the thread function, or 0 if invalid.
+ */
+int Cmgui_thread_join(struct Cmgui_thread **thread_address);
+
+#endif /* !defined (GENERAL_CMGUI_THREAD_H) */
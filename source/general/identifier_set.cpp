@@ -0,0 +1,734 @@
+/**
+ * FILE : identifier_set.cpp
+ *
+ * Set of integer identifiers stored as a compressed bitmap with runs, for
+ * fast membership tests against large or fragmented Multi_range selections.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <limits.h>
+#include <stdint.h>
+#include <algorithm>
+#include <vector>
+#include "general/debug.h"
+#include "general/identifier_set.h"
+#include "general/message.h"
+#include "general/multi_range.h"
+
+namespace {
+
+/** Containers with more values than this are stored as bitmaps or runs. */
+const int IDENTIFIER_ARRAY_MAXIMUM_SIZE = 4096;
+const int IDENTIFIER_BITMAP_WORDS = 65536/64;
+/** Bytes taken by each form, used to pick the smallest. */
+const size_t IDENTIFIER_ARRAY_VALUE_BYTES = 2;
+const size_t IDENTIFIER_BITMAP_BYTES = 8192;
+const size_t IDENTIFIER_RUN_BYTES = 4;
+
+/** Maps identifiers to unsigned values with the same order. */
+inline uint32_t Identifier_to_unsigned(int value)
+{
+	return static_cast<uint32_t>(value) ^ 0x80000000u;
+}
+
+inline int Identifier_from_unsigned(uint32_t value)
+{
+	return static_cast<int>(value ^ 0x80000000u);
+}
+
+inline int Identifier_bit_count(uint64_t word)
+{
+	word = word - ((word >> 1) & 0x5555555555555555ULL);
+	word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+	word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return static_cast<int>((word*0x0101010101010101ULL) >> 56);
+}
+
+/** Mask of bits <first> to <last> inclusive of a word. */
+inline uint64_t Identifier_bit_mask(unsigned int first, unsigned int last)
+{
+	const uint64_t high = (63 == last) ? ~0ULL : ((1ULL << (last + 1)) - 1ULL);
+	return high & ~((1ULL << first) - 1ULL);
+}
+
+/** Consecutive values <first> to <last> inclusive. */
+struct Identifier_run
+{
+	uint16_t first;
+	uint16_t last;
+};
+
+/** Orders runs before values they cannot contain or be merged with. */
+struct Identifier_run_ends_before
+{
+	bool operator()(const Identifier_run &run, unsigned int value) const
+	{
+		return static_cast<unsigned int>(run.last) + 1 < value;
+	}
+};
+
+struct Identifier_run_ends_below
+{
+	bool operator()(const Identifier_run &run, unsigned int value) const
+	{
+		return run.last < value;
+	}
+};
+
+struct Identifier_run_starts_after
+{
+	bool operator()(unsigned int value, const Identifier_run &run) const
+	{
+		return value < run.first;
+	}
+};
+
+/**
+ * Values sharing the same high 16 bits, stored as the low 16 bits in a sorted
+ * array, a bitmap or a list of runs, whichever is smallest.
+ */
+class Identifier_container
+{
+	enum Type
+	{
+		TYPE_ARRAY,
+		TYPE_BITMAP,
+		TYPE_RUNS
+	};
+
+	Type type;
+	/* sorted values for TYPE_ARRAY */
+	std::vector<uint16_t> values;
+	/* for TYPE_BITMAP */
+	std::vector<uint64_t> bits;
+	/* for TYPE_RUNS: sorted, with at least one value missing between runs */
+	std::vector<Identifier_run> runs;
+	int cardinality;
+
+	/** @return  Number of runs of consecutive values. */
+	size_t getNumberOfRuns() const
+	{
+		if (TYPE_RUNS == type)
+			return runs.size();
+		size_t number_of_runs = 0;
+		unsigned int start = 0, first, last;
+		while ((start <= 65535) && getRangeFrom(start, first, last))
+		{
+			++number_of_runs;
+			start = last + 1;
+		}
+		return number_of_runs;
+	}
+
+	void convertTo(Type new_type)
+	{
+		if (new_type == type)
+			return;
+		std::vector<Identifier_run> old_runs;
+		if (TYPE_RUNS == type)
+		{
+			old_runs.swap(runs);
+		}
+		else
+		{
+			unsigned int start = 0, first, last;
+			while ((start <= 65535) && getRangeFrom(start, first, last))
+			{
+				Identifier_run run = { static_cast<uint16_t>(first), static_cast<uint16_t>(last) };
+				old_runs.push_back(run);
+				start = last + 1;
+			}
+			std::vector<uint16_t>().swap(values);
+			std::vector<uint64_t>().swap(bits);
+		}
+		type = new_type;
+		if (TYPE_RUNS == type)
+		{
+			runs.swap(old_runs);
+			return;
+		}
+		if (TYPE_BITMAP == type)
+			bits.assign(IDENTIFIER_BITMAP_WORDS, 0ULL);
+		else
+			values.reserve(cardinality);
+		cardinality = 0;
+		for (size_t i = 0; i < old_runs.size(); ++i)
+		{
+			if (TYPE_BITMAP == type)
+			{
+				setBitRange(old_runs[i].first, old_runs[i].last);
+			}
+			else
+			{
+				for (unsigned int v = old_runs[i].first; v <= old_runs[i].last; ++v)
+					values.push_back(static_cast<uint16_t>(v));
+				cardinality += old_runs[i].last - old_runs[i].first + 1;
+			}
+		}
+	}
+
+	/** Converts to the form taking the least memory. */
+	void optimise()
+	{
+		const size_t run_bytes = IDENTIFIER_RUN_BYTES*getNumberOfRuns();
+		const Type other_type = (cardinality <= IDENTIFIER_ARRAY_MAXIMUM_SIZE) ?
+			TYPE_ARRAY : TYPE_BITMAP;
+		const size_t other_bytes = (TYPE_ARRAY == other_type) ?
+			IDENTIFIER_ARRAY_VALUE_BYTES*cardinality : IDENTIFIER_BITMAP_BYTES;
+		convertTo((run_bytes < other_bytes) ? TYPE_RUNS : other_type);
+	}
+
+	bool bitIsSet(unsigned int low) const
+	{
+		return 0 != (bits[low >> 6] & (1ULL << (low & 63)));
+	}
+
+	void setBitRange(unsigned int low, unsigned int high)
+	{
+		const unsigned int first_word = low >> 6;
+		const unsigned int last_word = high >> 6;
+		for (unsigned int w = first_word; w <= last_word; ++w)
+		{
+			const uint64_t mask = Identifier_bit_mask((w == first_word) ? (low & 63) : 0,
+				(w == last_word) ? (high & 63) : 63);
+			cardinality += Identifier_bit_count(mask & ~bits[w]);
+			bits[w] |= mask;
+		}
+	}
+
+	/** Adds values <low> to <high> inclusive to the runs, merging any they
+	 * touch. */
+	void addRunRange(unsigned int low, unsigned int high)
+	{
+		std::vector<Identifier_run>::iterator start = std::lower_bound(runs.begin(),
+			runs.end(), low, Identifier_run_ends_before());
+		std::vector<Identifier_run>::iterator end = std::upper_bound(start,
+			runs.end(), high + 1, Identifier_run_starts_after());
+		Identifier_run merged = { static_cast<uint16_t>(low), static_cast<uint16_t>(high) };
+		if (start != end)
+		{
+			if (start->first < merged.first)
+				merged.first = start->first;
+			if ((end - 1)->last > merged.last)
+				merged.last = (end - 1)->last;
+			for (std::vector<Identifier_run>::iterator run = start; run != end; ++run)
+				cardinality -= run->last - run->first + 1;
+			start = runs.erase(start, end);
+		}
+		runs.insert(start, merged);
+		cardinality += merged.last - merged.first + 1;
+	}
+
+	/** Adds values <low> to <high> inclusive without changing form unless the
+	 * array is full. */
+	void addRangeInPlace(unsigned int low, unsigned int high)
+	{
+		/* ranges start as runs so large ones never make a bitmap */
+		if ((TYPE_ARRAY == type) && values.empty())
+			type = TYPE_RUNS;
+		if (TYPE_RUNS == type)
+		{
+			addRunRange(low, high);
+			return;
+		}
+		if (TYPE_ARRAY == type)
+		{
+			const uint16_t first = static_cast<uint16_t>(low);
+			const uint16_t last = static_cast<uint16_t>(high);
+			std::vector<uint16_t>::iterator start =
+				std::lower_bound(values.begin(), values.end(), first);
+			std::vector<uint16_t>::iterator end =
+				std::upper_bound(start, values.end(), last);
+			const size_t new_size = values.size() - (end - start) + (high - low + 1);
+			if (new_size <= static_cast<size_t>(IDENTIFIER_ARRAY_MAXIMUM_SIZE))
+			{
+				std::vector<uint16_t> merged;
+				merged.reserve(new_size);
+				merged.insert(merged.end(), values.begin(), start);
+				for (unsigned int v = low; v <= high; ++v)
+					merged.push_back(static_cast<uint16_t>(v));
+				merged.insert(merged.end(), end, values.end());
+				values.swap(merged);
+				cardinality = static_cast<int>(values.size());
+				return;
+			}
+			convertTo(TYPE_BITMAP);
+		}
+		setBitRange(low, high);
+	}
+
+public:
+	const uint16_t key;
+
+	explicit Identifier_container(uint16_t key_in) :
+		type(TYPE_ARRAY),
+		cardinality(0),
+		key(key_in)
+	{
+	}
+
+	int getCardinality() const
+	{
+		return cardinality;
+	}
+
+	bool contains(unsigned int low) const
+	{
+		if (TYPE_ARRAY == type)
+			return std::binary_search(values.begin(), values.end(), static_cast<uint16_t>(low));
+		if (TYPE_BITMAP == type)
+			return bitIsSet(low);
+		std::vector<Identifier_run>::const_iterator run = std::upper_bound(runs.begin(),
+			runs.end(), low, Identifier_run_starts_after());
+		return (run != runs.begin()) && (low <= (run - 1)->last);
+	}
+
+	void add(unsigned int low)
+	{
+		if (TYPE_ARRAY == type)
+		{
+			const uint16_t value = static_cast<uint16_t>(low);
+			if (values.empty() || (values.back() < value))
+			{
+				values.push_back(value);
+			}
+			else
+			{
+				std::vector<uint16_t>::iterator position =
+					std::lower_bound(values.begin(), values.end(), value);
+				if (*position == value)
+					return;
+				values.insert(position, value);
+			}
+			++cardinality;
+			if (cardinality > IDENTIFIER_ARRAY_MAXIMUM_SIZE)
+				optimise();
+		}
+		else if (TYPE_BITMAP == type)
+		{
+			if (!bitIsSet(low))
+			{
+				bits[low >> 6] |= 1ULL << (low & 63);
+				++cardinality;
+			}
+		}
+		else
+		{
+			const size_t number_of_runs = runs.size();
+			addRunRange(low, low);
+			if (runs.size() > number_of_runs)
+				optimise();
+		}
+	}
+
+	/** Adds values <low> to <high> inclusive. */
+	void addRange(unsigned int low, unsigned int high)
+	{
+		addRangeInPlace(low, high);
+		optimise();
+	}
+
+	void unionWith(const Identifier_container &other)
+	{
+		if (TYPE_BITMAP == other.type)
+		{
+			convertTo(TYPE_BITMAP);
+			cardinality = 0;
+			for (int w = 0; w < IDENTIFIER_BITMAP_WORDS; ++w)
+			{
+				bits[w] |= other.bits[w];
+				cardinality += Identifier_bit_count(bits[w]);
+			}
+		}
+		else if (TYPE_RUNS == other.type)
+		{
+			for (size_t i = 0; i < other.runs.size(); ++i)
+				addRangeInPlace(other.runs[i].first, other.runs[i].last);
+		}
+		else
+		{
+			for (size_t i = 0; i < other.values.size(); ++i)
+				addRangeInPlace(other.values[i], other.values[i]);
+		}
+		optimise();
+	}
+
+	void intersectWith(const Identifier_container &other)
+	{
+		if ((TYPE_RUNS == type) && (TYPE_RUNS == other.type))
+		{
+			std::vector<Identifier_run> kept;
+			cardinality = 0;
+			size_t i = 0, j = 0;
+			while ((i < runs.size()) && (j < other.runs.size()))
+			{
+				Identifier_run overlap = {
+					std::max(runs[i].first, other.runs[j].first),
+					std::min(runs[i].last, other.runs[j].last) };
+				if (overlap.first <= overlap.last)
+				{
+					kept.push_back(overlap);
+					cardinality += overlap.last - overlap.first + 1;
+				}
+				if (runs[i].last < other.runs[j].last)
+					++i;
+				else
+					++j;
+			}
+			runs.swap(kept);
+		}
+		else
+		{
+			if (TYPE_RUNS == type)
+			{
+				convertTo((cardinality <= IDENTIFIER_ARRAY_MAXIMUM_SIZE) ?
+					TYPE_ARRAY : TYPE_BITMAP);
+			}
+			if ((TYPE_ARRAY == type) || (TYPE_ARRAY == other.type))
+			{
+				const std::vector<uint16_t> &candidates =
+					(TYPE_ARRAY == type) ? values : other.values;
+				const Identifier_container &test = (TYPE_ARRAY == type) ? other : *this;
+				std::vector<uint16_t> kept;
+				kept.reserve(candidates.size());
+				for (size_t i = 0; i < candidates.size(); ++i)
+				{
+					if (test.contains(candidates[i]))
+						kept.push_back(candidates[i]);
+				}
+				std::vector<uint64_t>().swap(bits);
+				values.swap(kept);
+				type = TYPE_ARRAY;
+				cardinality = static_cast<int>(values.size());
+			}
+			else if (TYPE_RUNS == other.type)
+			{
+				std::vector<uint64_t> kept(IDENTIFIER_BITMAP_WORDS, 0ULL);
+				for (size_t i = 0; i < other.runs.size(); ++i)
+				{
+					const unsigned int first_word = other.runs[i].first >> 6;
+					const unsigned int last_word = other.runs[i].last >> 6;
+					for (unsigned int w = first_word; w <= last_word; ++w)
+					{
+						kept[w] |= bits[w] & Identifier_bit_mask(
+							(w == first_word) ? (other.runs[i].first & 63) : 0,
+							(w == last_word) ? (other.runs[i].last & 63) : 63);
+					}
+				}
+				bits.swap(kept);
+				cardinality = 0;
+				for (int w = 0; w < IDENTIFIER_BITMAP_WORDS; ++w)
+					cardinality += Identifier_bit_count(bits[w]);
+			}
+			else
+			{
+				cardinality = 0;
+				for (int w = 0; w < IDENTIFIER_BITMAP_WORDS; ++w)
+				{
+					bits[w] &= other.bits[w];
+					cardinality += Identifier_bit_count(bits[w]);
+				}
+			}
+		}
+		optimise();
+	}
+
+	/**
+	 * Finds the first value at or after <start> and the last value of the run
+	 * of consecutive values from it within this container.
+	 * @return  true if found.
+	 */
+	bool getRangeFrom(unsigned int start, unsigned int &first, unsigned int &last) const
+	{
+		if (TYPE_RUNS == type)
+		{
+			std::vector<Identifier_run>::const_iterator run = std::lower_bound(runs.begin(),
+				runs.end(), start, Identifier_run_ends_below());
+			if (run == runs.end())
+				return false;
+			first = (start > run->first) ? start : run->first;
+			last = run->last;
+			return true;
+		}
+		if (TYPE_ARRAY == type)
+		{
+			std::vector<uint16_t>::const_iterator position =
+				std::lower_bound(values.begin(), values.end(), static_cast<uint16_t>(start));
+			if (position == values.end())
+				return false;
+			first = last = *position;
+			for (++position; (position != values.end()) && (*position == last + 1); ++position)
+				last = *position;
+			return true;
+		}
+		unsigned int w = start >> 6;
+		uint64_t word = bits[w] & Identifier_bit_mask(start & 63, 63);
+		while (0ULL == word)
+		{
+			if (++w == static_cast<unsigned int>(IDENTIFIER_BITMAP_WORDS))
+				return false;
+			word = bits[w];
+		}
+		first = 64*w + Identifier_bit_count((word & (~word + 1ULL)) - 1ULL);
+		/* find the first clear bit after first */
+		word = ~bits[w] & Identifier_bit_mask(first & 63, 63);
+		while (0ULL == word)
+		{
+			if (++w == static_cast<unsigned int>(IDENTIFIER_BITMAP_WORDS))
+			{
+				last = 65535;
+				return true;
+			}
+			word = ~bits[w];
+		}
+		last = 64*w + Identifier_bit_count((word & (~word + 1ULL)) - 1ULL) - 1;
+		return true;
+	}
+};
+
+struct Identifier_container_key_less
+{
+	bool operator()(const Identifier_container *container, uint16_t key) const
+	{
+		return container->key < key;
+	}
+};
+
+}
+
+struct Identifier_set
+{
+	/* sorted by key; only non-empty containers are kept */
+	std::vector<Identifier_container *> containers;
+
+	~Identifier_set()
+	{
+		for (size_t i = 0; i < containers.size(); ++i)
+			delete containers[i];
+	}
+
+	/** @return  Index of the first container with key not less than <key>. */
+	size_t lowerBound(uint16_t key) const
+	{
+		return std::lower_bound(containers.begin(), containers.end(), key,
+			Identifier_container_key_less()) - containers.begin();
+	}
+
+	const Identifier_container *findContainer(uint16_t key) const
+	{
+		const size_t index = lowerBound(key);
+		if ((index < containers.size()) && (containers[index]->key == key))
+			return containers[index];
+		return 0;
+	}
+
+	Identifier_container *getOrCreateContainer(uint16_t key)
+	{
+		/* values are usually added in increasing order */
+		if ((!containers.empty()) && (containers.back()->key == key))
+			return containers.back();
+		const size_t index = lowerBound(key);
+		if ((index < containers.size()) && (containers[index]->key == key))
+			return containers[index];
+		Identifier_container *container = new Identifier_container(key);
+		containers.insert(containers.begin() + index, container);
+		return container;
+	}
+};
+
+struct Identifier_set *CREATE(Identifier_set)(void)
+{
+	return new Identifier_set();
+}
+
+int DESTROY(Identifier_set)(struct Identifier_set **set_address)
+{
+	if (set_address && (*set_address))
+	{
+		delete *set_address;
+		*set_address = 0;
+		return 1;
+	}
+	return 0;
+}
+
+struct Identifier_set *Identifier_set_create_from_Multi_range(
+	struct Multi_range *multi_range)
+{
+	if (!multi_range)
+	{
+		display_message(ERROR_MESSAGE,
+			"Identifier_set_create_from_Multi_range.  Invalid argument(s)");
+		return 0;
+	}
+	struct Identifier_set *set = CREATE(Identifier_set)();
+	const int number_of_ranges = Multi_range_get_number_of_ranges(multi_range);
+	int start, stop;
+	for (int i = 0; i < number_of_ranges; ++i)
+	{
+		if (Multi_range_get_range(multi_range, i, &start, &stop))
+			Identifier_set_add_range(set, start, stop);
+	}
+	return set;
+}
+
+int Identifier_set_add_range(struct Identifier_set *set, int first, int last)
+{
+	if (!set)
+	{
+		display_message(ERROR_MESSAGE,
+			"Identifier_set_add_range.  Invalid argument(s)");
+		return 0;
+	}
+	if (first > last)
+		std::swap(first, last);
+	const uint32_t low = Identifier_to_unsigned(first);
+	const uint32_t high = Identifier_to_unsigned(last);
+	const uint32_t first_key = low >> 16;
+	const uint32_t last_key = high >> 16;
+	for (uint32_t key = first_key; key <= last_key; ++key)
+	{
+		set->getOrCreateContainer(static_cast<uint16_t>(key))->addRange(
+			(key == first_key) ? (low & 0xFFFFu) : 0u,
+			(key == last_key) ? (high & 0xFFFFu) : 0xFFFFu);
+	}
+	return 1;
+}
+
+int Identifier_set_add(struct Identifier_set *set, int value)
+{
+	if (!set)
+	{
+		display_message(ERROR_MESSAGE, "Identifier_set_add.  Invalid argument(s)");
+		return 0;
+	}
+	const uint32_t u = Identifier_to_unsigned(value);
+	set->getOrCreateContainer(static_cast<uint16_t>(u >> 16))->add(u & 0xFFFFu);
+	return 1;
+}
+
+int Identifier_set_contains(const struct Identifier_set *set, int value)
+{
+	if (!set)
+		return 0;
+	const uint32_t u = Identifier_to_unsigned(value);
+	const Identifier_container *container = set->findContainer(static_cast<uint16_t>(u >> 16));
+	return (container && container->contains(u & 0xFFFFu)) ? 1 : 0;
+}
+
+long Identifier_set_get_size(const struct Identifier_set *set)
+{
+	long size = 0;
+	if (set)
+	{
+		for (size_t i = 0; i < set->containers.size(); ++i)
+			size += set->containers[i]->getCardinality();
+	}
+	return size;
+}
+
+int Identifier_set_union(struct Identifier_set *set,
+	const struct Identifier_set *other_set)
+{
+	if (!(set && other_set))
+	{
+		display_message(ERROR_MESSAGE, "Identifier_set_union.  Invalid argument(s)");
+		return 0;
+	}
+	if (set == other_set)
+		return 1;
+	for (size_t i = 0; i < other_set->containers.size(); ++i)
+	{
+		const Identifier_container *other = other_set->containers[i];
+		set->getOrCreateContainer(other->key)->unionWith(*other);
+	}
+	return 1;
+}
+
+int Identifier_set_intersect(struct Identifier_set *set,
+	const struct Identifier_set *other_set)
+{
+	if (!(set && other_set))
+	{
+		display_message(ERROR_MESSAGE, "Identifier_set_intersect.  Invalid argument(s)");
+		return 0;
+	}
+	if (set == other_set)
+		return 1;
+	std::vector<Identifier_container *> kept;
+	kept.reserve(set->containers.size());
+	for (size_t i = 0; i < set->containers.size(); ++i)
+	{
+		Identifier_container *container = set->containers[i];
+		const Identifier_container *other = other_set->findContainer(container->key);
+		if (other)
+			container->intersectWith(*other);
+		if (other && (0 < container->getCardinality()))
+			kept.push_back(container);
+		else
+			delete container;
+	}
+	set->containers.swap(kept);
+	return 1;
+}
+
+int Identifier_set_get_range_from(const struct Identifier_set *set, int start,
+	int *first_address, int *last_address)
+{
+	if (!(set && first_address && last_address))
+		return 0;
+	const uint32_t u = Identifier_to_unsigned(start);
+	size_t index = set->lowerBound(static_cast<uint16_t>(u >> 16));
+	unsigned int low = (index < set->containers.size()) &&
+		(set->containers[index]->key == (u >> 16)) ? (u & 0xFFFFu) : 0u;
+	unsigned int first, last;
+	for (; index < set->containers.size(); ++index, low = 0)
+	{
+		if (set->containers[index]->getRangeFrom(low, first, last))
+			break;
+	}
+	if (index >= set->containers.size())
+		return 0;
+	const uint32_t first_key = set->containers[index]->key;
+	*first_address = Identifier_from_unsigned((first_key << 16) | first);
+	/* runs continue into following containers starting at 0 */
+	uint32_t last_key = first_key;
+	unsigned int next_first, next_last;
+	while ((0xFFFFu == last) && (index + 1 < set->containers.size()) &&
+		(set->containers[index + 1]->key == last_key + 1) &&
+		set->containers[index + 1]->getRangeFrom(0, next_first, next_last) &&
+		(0 == next_first))
+	{
+		++index;
+		++last_key;
+		last = next_last;
+	}
+	*last_address = Identifier_from_unsigned((last_key << 16) | last);
+	return 1;
+}
+
+int Identifier_set_add_to_Multi_range(const struct Identifier_set *set,
+	struct Multi_range *multi_range)
+{
+	if (!(set && multi_range))
+	{
+		display_message(ERROR_MESSAGE,
+			"Identifier_set_add_to_Multi_range.  Invalid argument(s)");
+		return 0;
+	}
+	int return_code = 1;
+	int start = INT_MIN;
+	int first, last;
+	while (return_code && Identifier_set_get_range_from(set, start, &first, &last))
+	{
+		return_code = Multi_range_add_range(multi_range, first, last);
+		if (INT_MAX == last)
+			break;
+		start = last + 1;
+	}
+	return return_code;
+}
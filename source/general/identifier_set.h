@@ -0,0 +1,90 @@
+/**
+ * FILE : identifier_set.h
+ *
+ * Set of integer identifiers stored as a compressed bitmap with runs, for
+ * fast membership tests against large or fragmented Multi_range selections.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (IDENTIFIER_SET_H)
+#define IDENTIFIER_SET_H
+
+#include "general/object.h"
+
+struct Identifier_set;
+struct Multi_range;
+
+/**
+ * Creates an empty identifier set. Identifiers are split into blocks of 65536
+ * sharing their high bits, each holding a sorted array of up to 4096 values, a
+ * bitmap or a list of runs of consecutive values, whichever is smallest. A
+ * few large ranges take little more memory than in a Multi_range, and
+ * membership tests stay fast however fragmented the set is. Not safe to modify
+ * while other threads use it.
+ */
+struct Identifier_set *CREATE(Identifier_set)(void);
+
+int DESTROY(Identifier_set)(struct Identifier_set **set_address);
+
+/**
+ * Creates a set holding all values in the ranges of <multi_range>.
+ * @return  New set, or NULL on failure.
+ */
+struct Identifier_set *Identifier_set_create_from_Multi_range(
+	struct Multi_range *multi_range);
+
+/**
+ * Adds all values from <first> to <last> to <set>. The limits may be given in
+ * either order.
+ */
+int Identifier_set_add_range(struct Identifier_set *set, int first, int last);
+
+/**
+ * Adds <value> to <set>. Fastest when values are added in increasing order.
+ */
+int Identifier_set_add(struct Identifier_set *set, int value);
+
+/**
+ * @return  1 if <value> is in <set>, otherwise 0.
+ */
+int Identifier_set_contains(const struct Identifier_set *set, int value);
+
+/**
+ * @return  Number of values in <set>.
+ */
+long Identifier_set_get_size(const struct Identifier_set *set);
+
+/**
+ * Adds every value in <other_set> to <set>.
+ */
+int Identifier_set_union(struct Identifier_set *set,
+	const struct Identifier_set *other_set);
+
+/**
+ * Removes values from <set> which are not in <other_set>.
+ */
+int Identifier_set_intersect(struct Identifier_set *set,
+	const struct Identifier_set *other_set);
+
+/**
+ * Finds the lowest run of consecutive values in <set> starting at or after
+ * <start>. Iterate over the set in increasing order by passing last + 1 as the
+ * next <start> until the last value is INT_MAX or none is found.
+ * @param first_address  On success, receives the first value of the run.
+ * @param last_address  On success, receives the last value of the run.
+ * @return  1 if a run was found, otherwise 0.
+ */
+int Identifier_set_get_range_from(const struct Identifier_set *set, int start,
+	int *first_address, int *last_address);
+
+/**
+ * Adds the runs of consecutive values in <set> to <multi_range> in increasing
+ * order.
+ */
+int Identifier_set_add_to_Multi_range(const struct Identifier_set *set,
+	struct Multi_range *multi_range);
+
+#endif /* !defined (IDENTIFIER_SET_H) */
@@ -0,0 +1,478 @@
+/**
+ * FILE : mapped_file.cpp
+ *
+ * Read-only memory mapping of whole files.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "configure/cmgui_configure.h"
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#if defined (WIN32_SYSTEM)
+//#define WINDOWS_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else /* defined (WIN32_SYSTEM) */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif /* defined (WIN32_SYSTEM) */
+#include "general/debug.h"
+#include "general/io_stream.h"
+#include "general/mapped_file.h"
+#include "general/memory_accounting.h"
+#include "general/message.h"
+
+namespace {
+
+/** Largest file read from a single IO_stream memory block. */
+const size_t MAPPED_FILE_MAXIMUM_BLOCK_SIZE = (size_t)INT_MAX;
+
+/** Longest region, group and header lines repeated ahead of a window. */
+const size_t MAPPED_FILE_MAXIMUM_PREFIX_SIZE = 1024*1024;
+
+/**
+ * Part of a mapped file read through its own IO_stream memory block. The
+ * block starts with <prefix>, the region, group and field header lines in
+ * effect at <start>, written over the end of the previous window, so each
+ * window parses as a file of its own.
+ */
+struct Mapped_file_window
+{
+	size_t start, end;
+	std::string prefix;
+};
+
+/** Line of an EX file, from its start up to and including its newline. */
+struct Mapped_file_line
+{
+	size_t start, end;
+
+	Mapped_file_line() :
+		start(0),
+		end(0)
+	{
+	}
+};
+
+}
+
+struct Mapped_file
+{
+	const char *data;
+	size_t size;
+	/* name of the IO_stream memory block while a stream is open on it */
+	char block_name[40];
+	/* more than one if the file is too large for one memory block */
+	std::vector<Mapped_file_window> windows;
+#if defined (WIN32_SYSTEM)
+	HANDLE file_handle, mapping_handle;
+#endif /* defined (WIN32_SYSTEM) */
+
+	Mapped_file() :
+		data(0),
+		size(0)
+	{
+		block_name[0] = '\0';
+#if defined (WIN32_SYSTEM)
+		file_handle = INVALID_HANDLE_VALUE;
+		mapping_handle = NULL;
+#endif /* defined (WIN32_SYSTEM) */
+	}
+};
+
+namespace {
+
+/**
+ * @return  True if the line of <length> characters at <line> starts with
+ * <keyword> after any spaces.
+ */
+bool Mapped_file_line_starts_with(const char *line, size_t length,
+	const char *keyword)
+{
+	size_t i = 0;
+	while ((i < length) && ((' ' == line[i]) || ('\t' == line[i])))
+		++i;
+	const size_t keyword_length = strlen(keyword);
+	return (keyword_length <= length - i) &&
+		(0 == strncmp(line + i, keyword, keyword_length));
+}
+
+/**
+ * Splits the EX file in <mapped_file> into windows no larger than an IO_stream
+ * memory block, each ending before a Node: or Element: record. Every window
+ * but the first gets a prefix of the last Region: and Group name: lines and
+ * the node or element field header its first record needs.
+ * @return  True on success, false for EX version 2 files, whose named
+ * templates cannot be repeated this way, or if any window has no record to
+ * end at.
+ */
+bool Mapped_file_split_windows(struct Mapped_file *mapped_file)
+{
+	const char *data = mapped_file->data;
+	const size_t size = mapped_file->size;
+	mapped_file->windows.clear();
+	Mapped_file_window window;
+	window.start = 0;
+	Mapped_file_line region, group, node_header, element_header,
+		previous_line;
+	bool node_header_open = false, element_header_open = false;
+	/* last record line a window could end before, and its prefix */
+	size_t candidate = 0;
+	std::string candidate_prefix;
+	size_t line_start = 0;
+	while (true)
+	{
+		const bool at_end = (line_start >= size);
+		if (window.prefix.size() + (line_start - window.start) >
+			MAPPED_FILE_MAXIMUM_BLOCK_SIZE)
+		{
+			if (candidate <= window.start)
+				return false;
+			window.end = candidate;
+			mapped_file->windows.push_back(window);
+			window.start = candidate;
+			window.prefix = candidate_prefix;
+			continue;
+		}
+		if (at_end)
+			break;
+		const char *line = data + line_start;
+		const char *newline = static_cast<const char *>(
+			memchr(line, '\n', size - line_start));
+		const size_t line_end = newline ? (newline - data + 1) : size;
+		const size_t length = line_end - line_start;
+		if ((0 == line_start) && Mapped_file_line_starts_with(line, length, "EX Version:"))
+			return false;
+		if (Mapped_file_line_starts_with(line, length, "!#"))
+			return false;
+		const bool node_record = Mapped_file_line_starts_with(line, length, "Node:");
+		const bool element_record = (!node_record) &&
+			Mapped_file_line_starts_with(line, length, "Element:");
+		if (node_record || element_record)
+		{
+			if (node_record && node_header_open)
+			{
+				node_header.end = line_start;
+				node_header_open = false;
+			}
+			if (element_record && element_header_open)
+			{
+				element_header.end = line_start;
+				element_header_open = false;
+			}
+			const Mapped_file_line &header = node_record ? node_header : element_header;
+			if ((line_start > window.start) && (header.end > header.start))
+			{
+				candidate = line_start;
+				candidate_prefix.assign(data + region.start, region.end - region.start);
+				candidate_prefix.append(data + group.start, group.end - group.start);
+				candidate_prefix.append(data + header.start, header.end - header.start);
+				if (candidate_prefix.size() > MAPPED_FILE_MAXIMUM_PREFIX_SIZE)
+					return false;
+			}
+		}
+		else if (Mapped_file_line_starts_with(line, length, "Region:"))
+		{
+			region.start = line_start;
+			region.end = line_end;
+			group = node_header = element_header = Mapped_file_line();
+			node_header_open = element_header_open = false;
+		}
+		else if (Mapped_file_line_starts_with(line, length, "Group name:"))
+		{
+			group.start = line_start;
+			group.end = line_end;
+		}
+		else if (Mapped_file_line_starts_with(line, length, "Shape."))
+		{
+			element_header.start = element_header.end = line_start;
+			element_header_open = true;
+		}
+		else if (Mapped_file_line_starts_with(line, length, "#Fields=") &&
+			!Mapped_file_line_starts_with(data + previous_line.start,
+				previous_line.end - previous_line.start, "#Nodes="))
+		{
+			/* element headers have #Nodes= before #Fields= */
+			node_header.start = node_header.end = line_start;
+			node_header_open = true;
+		}
+		previous_line.start = line_start;
+		previous_line.end = line_end;
+		line_start = line_end;
+	}
+	window.end = size;
+	mapped_file->windows.push_back(window);
+	return true;
+}
+
+}
+
+int file_name_is_compressed(const char *file_name)
+{
+	if (file_name)
+	{
+		const size_t length = strlen(file_name);
+		if (((length > 3) && (0 == strcmp(file_name + length - 3, ".gz"))) ||
+			((length > 4) && (0 == strcmp(file_name + length - 4, ".bz2"))))
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+struct Mapped_file *CREATE(Mapped_file)(const char *file_name)
+{
+	struct Mapped_file *mapped_file = 0;
+	if (file_name)
+	{
+		mapped_file = new Mapped_file();
+#if defined (WIN32_SYSTEM)
+		mapped_file->file_handle = CreateFileA(file_name, GENERIC_READ, FILE_SHARE_READ,
+			NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+		if (mapped_file->file_handle != INVALID_HANDLE_VALUE)
+		{
+			LARGE_INTEGER file_size;
+			if (GetFileSizeEx(mapped_file->file_handle, &file_size) && (0 < file_size.QuadPart))
+			{
+				mapped_file->size = (size_t)file_size.QuadPart;
+				/* windows of large files are prefixed by writing to private copies
+				 * of the pages before them */
+				const bool copy = (mapped_file->size > MAPPED_FILE_MAXIMUM_BLOCK_SIZE);
+				mapped_file->mapping_handle = CreateFileMapping(mapped_file->file_handle,
+					NULL, copy ? PAGE_WRITECOPY : PAGE_READONLY, 0, 0, NULL);
+				if (mapped_file->mapping_handle)
+				{
+					mapped_file->data = (const char *)MapViewOfFile(
+						mapped_file->mapping_handle, copy ? FILE_MAP_COPY : FILE_MAP_READ, 0, 0, 0);
+				}
+			}
+		}
+#else /* defined (WIN32_SYSTEM) */
+		int file_descriptor = open(file_name, O_RDONLY);
+		if (0 <= file_descriptor)
+		{
+			struct stat file_status;
+			if ((0 == fstat(file_descriptor, &file_status)) && (0 < file_status.st_size))
+			{
+				mapped_file->size = (size_t)file_status.st_size;
+				/* windows of large files are prefixed by writing to private copies
+				 * of the pages before them; the file itself is never changed */
+				const int protection = (mapped_file->size > MAPPED_FILE_MAXIMUM_BLOCK_SIZE) ?
+					(PROT_READ | PROT_WRITE) : PROT_READ;
+				void *data = mmap(NULL, mapped_file->size, protection, MAP_PRIVATE,
+					file_descriptor, 0);
+				if (data != MAP_FAILED)
+				{
+#if defined (MADV_SEQUENTIAL)
+					madvise(data, mapped_file->size, MADV_SEQUENTIAL);
+#endif /* defined (MADV_SEQUENTIAL) */
+					mapped_file->data = (const char *)data;
+				}
+			}
+			/* mapping stays valid after the descriptor is closed */
+			close(file_descriptor);
+		}
+#endif /* defined (WIN32_SYSTEM) */
+		if (mapped_file->data)
+		{
+			Memory_accounting_add(MEMORY_ACCOUNTING_TAG_MAPPED_FILES, mapped_file->size);
+			Mapped_file_window window;
+			window.start = 0;
+			window.end = mapped_file->size;
+			mapped_file->windows.push_back(window);
+		}
+		else
+		{
+			DESTROY(Mapped_file)(&mapped_file);
+		}
+	}
+	return mapped_file;
+}
+
+int DESTROY(Mapped_file)(struct Mapped_file **mapped_file_address)
+{
+	if (mapped_file_address && (*mapped_file_address))
+	{
+		struct Mapped_file *mapped_file = *mapped_file_address;
+		if (mapped_file->data)
+			Memory_accounting_remove(MEMORY_ACCOUNTING_TAG_MAPPED_FILES, mapped_file->size);
+#if defined (WIN32_SYSTEM)
+		if (mapped_file->data)
+			UnmapViewOfFile((LPCVOID)mapped_file->data);
+		if (mapped_file->mapping_handle)
+			CloseHandle(mapped_file->mapping_handle);
+		if (mapped_file->file_handle != INVALID_HANDLE_VALUE)
+			CloseHandle(mapped_file->file_handle);
+#else /* defined (WIN32_SYSTEM) */
+		if (mapped_file->data)
+			munmap((void *)mapped_file->data, mapped_file->size);
+#endif /* defined (WIN32_SYSTEM) */
+		delete *mapped_file_address;
+		*mapped_file_address = 0;
+		return 1;
+	}
+	return 0;
+}
+
+const char *Mapped_file_get_data(struct Mapped_file *mapped_file)
+{
+	if (mapped_file)
+		return mapped_file->data;
+	return 0;
+}
+
+size_t Mapped_file_get_size(struct Mapped_file *mapped_file)
+{
+	if (mapped_file)
+		return mapped_file->size;
+	return 0;
+}
+
+int Mapped_file_get_number_of_windows(struct Mapped_file *mapped_file)
+{
+	if (mapped_file && (1 < mapped_file->windows.size()))
+		return static_cast<int>(mapped_file->windows.size());
+	return 1;
+}
+
+int IO_stream_open_mapped_window(struct IO_stream_package *io_stream_package,
+	struct IO_stream **stream_address, struct Mapped_file *mapped_file, int window)
+{
+	if (!(io_stream_package && stream_address && mapped_file && (0 <= window) &&
+		(window < static_cast<int>(mapped_file->windows.size()))))
+	{
+		display_message(ERROR_MESSAGE, "IO_stream_open_mapped_window.  Invalid argument(s)");
+		return 0;
+	}
+	if (*stream_address)
+	{
+		IO_stream_close(*stream_address);
+		DESTROY(IO_stream)(stream_address);
+	}
+	if (mapped_file->block_name[0])
+	{
+		IO_stream_package_free_memory_block(io_stream_package, mapped_file->block_name);
+		mapped_file->block_name[0] = '\0';
+	}
+	const Mapped_file_window &mapped_window = mapped_file->windows[window];
+	const size_t prefix_size = mapped_window.prefix.size();
+	char *block = const_cast<char *>(mapped_file->data) + mapped_window.start - prefix_size;
+	if (0 < prefix_size)
+	{
+		/* overwrites the end of the previous window in the private pages */
+		memcpy(block, mapped_window.prefix.data(), prefix_size);
+	}
+	const int block_size = static_cast<int>(prefix_size + mapped_window.end - mapped_window.start);
+	int return_code = 0;
+	char uri[48];
+	sprintf(mapped_file->block_name, "mapped_file_%p", (void *)mapped_file);
+	sprintf(uri, "memory:%s", mapped_file->block_name);
+	if (IO_stream_package_define_memory_block(io_stream_package,
+		mapped_file->block_name, (void *)block, block_size))
+	{
+		*stream_address = CREATE(IO_stream)(io_stream_package);
+		if (*stream_address)
+		{
+			return_code = IO_stream_open_for_read(*stream_address, uri);
+			if (!return_code)
+				DESTROY(IO_stream)(stream_address);
+		}
+		if (!return_code)
+		{
+			IO_stream_package_free_memory_block(io_stream_package,
+				mapped_file->block_name);
+		}
+	}
+	if (!return_code)
+	{
+		mapped_file->block_name[0] = '\0';
+		display_message(ERROR_MESSAGE, "IO_stream_open_mapped_window.  "
+			"Could not open window %d of mapped file", window + 1);
+	}
+	return return_code;
+}
+
+struct IO_stream *IO_stream_open_for_read_mapped(
+	struct IO_stream_package *io_stream_package, const char *file_name,
+	int use_mapping, struct Mapped_file **mapped_file_address)
+{
+	struct IO_stream *stream = 0;
+	if (io_stream_package && file_name && mapped_file_address)
+	{
+		*mapped_file_address = 0;
+		struct Mapped_file *mapped_file = 0;
+		/* compressed files must go through the decompressing stream */
+		if (use_mapping && (!file_name_is_compressed(file_name)))
+		{
+			mapped_file = CREATE(Mapped_file)(file_name);
+			/* memory blocks are limited to int length, so larger files are read
+			 * in windows ending before records */
+			if (mapped_file && (mapped_file->size > MAPPED_FILE_MAXIMUM_BLOCK_SIZE) &&
+				(!Mapped_file_split_windows(mapped_file)))
+			{
+				display_message(WARNING_MESSAGE, "File %s is too large to read from "
+					"a memory mapping and cannot be split into windows. "
+					"Using buffered input.", file_name);
+				DESTROY(Mapped_file)(&mapped_file);
+			}
+		}
+		if (mapped_file)
+		{
+			if (!IO_stream_open_mapped_window(io_stream_package, &stream, mapped_file, 0))
+				DESTROY(Mapped_file)(&mapped_file);
+		}
+		if (!mapped_file)
+		{
+			stream = CREATE(IO_stream)(io_stream_package);
+			if (stream && (!IO_stream_open_for_read(stream, file_name)))
+				DESTROY(IO_stream)(&stream);
+		}
+		if (stream)
+		{
+			*mapped_file_address = mapped_file;
+		}
+		else if (mapped_file)
+		{
+			DESTROY(Mapped_file)(&mapped_file);
+		}
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE, "IO_stream_open_for_read_mapped.  Invalid argument(s)");
+	}
+	return stream;
+}
+
+int IO_stream_close_mapped(struct IO_stream_package *io_stream_package,
+	struct IO_stream **stream_address, struct Mapped_file **mapped_file_address)
+{
+	if (io_stream_package && stream_address && mapped_file_address)
+	{
+		if (*stream_address)
+		{
+			IO_stream_close(*stream_address);
+			DESTROY(IO_stream)(stream_address);
+		}
+		if (*mapped_file_address)
+		{
+			if ((*mapped_file_address)->block_name[0])
+			{
+				IO_stream_package_free_memory_block(io_stream_package,
+					(*mapped_file_address)->block_name);
+			}
+			DESTROY(Mapped_file)(mapped_file_address);
+		}
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,81 @@
+/**
+ * FILE : mapped_file.h
+ *
+ * Read-only memory mapping of whole files, so that large model files can be
+ * parsed straight from the mapped pages without buffered copies.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (GENERAL_MAPPED_FILE_H)
+#define GENERAL_MAPPED_FILE_H
+
+#include <stddef.h>
+#include "general/object.h"
+
+struct IO_stream;
+struct IO_stream_package;
+struct Mapped_file;
+
+/**
+ * @return  1 if the file name has a suffix of a compressed format which
+ * IO_stream decompresses itself (.gz, .bz2), otherwise 0.
+ */
+int file_name_is_compressed(const char *file_name);
+
+/**
+ * Maps the whole of file_name read-only into memory.
+ * @return  New mapped file, or NULL if the file could not be mapped. Does not
+ * report errors so callers can quietly fall back to buffered input.
+ */
+struct Mapped_file *CREATE(Mapped_file)(const char *file_name);
+
+int DESTROY(Mapped_file)(struct Mapped_file **mapped_file_address);
+
+const char *Mapped_file_get_data(struct Mapped_file *mapped_file);
+
+size_t Mapped_file_get_size(struct Mapped_file *mapped_file);
+
+/**
+ * @return  Number of windows the mapped file must be read in, 1 unless it is
+ * larger than an IO_stream memory block.
+ */
+int Mapped_file_get_number_of_windows(struct Mapped_file *mapped_file);
+
+/**
+ * Closes any stream in stream_address and opens a new one on window of the
+ * mapped file. Each window ends before a Node: or Element: record and, after
+ * the first, begins with copies of the Region:, Group name: and field header
+ * lines in effect there, so it parses as a separate EX file. The copies are
+ * written over the end of the previous window, so windows must be read in
+ * order.
+ * @return  1 on success, 0 on failure.
+ */
+int IO_stream_open_mapped_window(struct IO_stream_package *io_stream_package,
+	struct IO_stream **stream_address, struct Mapped_file *mapped_file, int window);
+
+/**
+ * Opens an IO_stream for reading file_name. If use_mapping is set and the file
+ * is uncompressed, the file is memory mapped and the stream reads directly
+ * from the mapped pages; otherwise the file is opened normally. Files larger
+ * than an IO_stream memory block are mapped copy-on-write and the stream is
+ * opened on their first window; see IO_stream_open_mapped_window. EX version 2
+ * files of that size fall back to normal input.
+ * @param mapped_file_address  On success receives the mapping, or NULL if
+ * the file was opened normally. Must be passed to IO_stream_close_mapped.
+ * @return  Open stream, or NULL on failure.
+ */
+struct IO_stream *IO_stream_open_for_read_mapped(
+	struct IO_stream_package *io_stream_package, const char *file_name,
+	int use_mapping, struct Mapped_file **mapped_file_address);
+
+/**
+ * Closes and destroys a stream from IO_stream_open_for_read_mapped, then
+ * releases its mapping if any. Clears both addresses.
+ */
+int IO_stream_close_mapped(struct IO_stream_package *io_stream_package,
+	struct IO_stream **stream_address, struct Mapped_file **mapped_file_address);
+
+#endif /* !defined (GENERAL_MAPPED_FILE_H) */
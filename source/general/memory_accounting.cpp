@@ -0,0 +1,290 @@
+/**
+ * FILE : memory_accounting.cpp
+ *
+ * Tracks the bytes held by large cmgui-owned buffers by kind of buffer.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "configure/cmgui_configure.h"
+#include "general/cmgui_thread.h"
+#include "general/cmgui_time.h"
+#include "general/debug.h"
+#include "general/memory_accounting.h"
+#include "general/message.h"
+#if defined (UNIX)
+#include <sys/resource.h>
+#endif /* defined (UNIX) */
+#if defined (__GLIBC__)
+#include <malloc.h>
+#endif /* defined (__GLIBC__) */
+
+namespace {
+
+const char *memory_accounting_tag_names[MEMORY_ACCOUNTING_NUMBER_OF_TAGS] =
+{
+	"file_buffers",
+	"mapped_files",
+	"images",
+	"mesh_indexes",
+	"cached_images",
+	"image_labels"
+};
+
+struct Memory_accounting_state
+{
+	struct Cmgui_mutex *mutex;
+	double current_bytes[MEMORY_ACCOUNTING_NUMBER_OF_TAGS];
+	double peak_bytes[MEMORY_ACCOUNTING_NUMBER_OF_TAGS];
+	long number_of_allocations[MEMORY_ACCOUNTING_NUMBER_OF_TAGS];
+	double sample_interval_seconds, last_sample_seconds;
+	FILE *sample_file;
+
+	/* created during static initialisation so the mutex exists before any
+	 * thread can record allocations */
+	Memory_accounting_state() :
+		mutex(CREATE(Cmgui_mutex)()),
+		sample_interval_seconds(0.0),
+		last_sample_seconds(0.0),
+		sample_file(0)
+	{
+		for (int i = 0; i < MEMORY_ACCOUNTING_NUMBER_OF_TAGS; ++i)
+		{
+			current_bytes[i] = 0.0;
+			peak_bytes[i] = 0.0;
+			number_of_allocations[i] = 0;
+		}
+	}
+
+	~Memory_accounting_state()
+	{
+		if (sample_file)
+			fclose(sample_file);
+		if (mutex)
+			DESTROY(Cmgui_mutex)(&mutex);
+	}
+
+	void lock()
+	{
+		if (mutex)
+			Cmgui_mutex_lock(mutex);
+	}
+
+	void unlock()
+	{
+		if (mutex)
+			Cmgui_mutex_unlock(mutex);
+	}
+};
+
+Memory_accounting_state memory_accounting_state;
+
+double Memory_accounting_get_seconds(void)
+{
+	struct timeval time_value;
+	cmgui_gettimeofday(&time_value, NULL);
+	return (double)time_value.tv_sec + 1.0E-6*(double)time_value.tv_usec;
+}
+
+/** Writes <line> to <file>, or to the command window if <file> is NULL. */
+void Memory_accounting_write_line(FILE *file, const char *line)
+{
+	if (file)
+	{
+		fputs(line, file);
+		fflush(file);
+	}
+	else
+		display_message(INFORMATION_MESSAGE, "%s", line);
+}
+
+}
+
+const char *Memory_accounting_tag_get_name(enum Memory_accounting_tag tag)
+{
+	if ((0 <= tag) && (tag < MEMORY_ACCOUNTING_NUMBER_OF_TAGS))
+		return memory_accounting_tag_names[tag];
+	return "unknown";
+}
+
+void Memory_accounting_add(enum Memory_accounting_tag tag, size_t bytes)
+{
+	if ((0 <= tag) && (tag < MEMORY_ACCOUNTING_NUMBER_OF_TAGS))
+	{
+		Memory_accounting_state &state = memory_accounting_state;
+		state.lock();
+		state.current_bytes[tag] += (double)bytes;
+		if (state.current_bytes[tag] > state.peak_bytes[tag])
+			state.peak_bytes[tag] = state.current_bytes[tag];
+		++state.number_of_allocations[tag];
+		state.unlock();
+	}
+}
+
+void Memory_accounting_remove(enum Memory_accounting_tag tag, size_t bytes)
+{
+	if ((0 <= tag) && (tag < MEMORY_ACCOUNTING_NUMBER_OF_TAGS))
+	{
+		Memory_accounting_state &state = memory_accounting_state;
+		state.lock();
+		state.current_bytes[tag] -= (double)bytes;
+		--state.number_of_allocations[tag];
+		state.unlock();
+	}
+}
+
+int Memory_accounting_get_tag_bytes(enum Memory_accounting_tag tag,
+	double *current_bytes_address, double *peak_bytes_address,
+	long *number_of_allocations_address)
+{
+	if (!((0 <= tag) && (tag < MEMORY_ACCOUNTING_NUMBER_OF_TAGS)))
+		return 0;
+	Memory_accounting_state &state = memory_accounting_state;
+	state.lock();
+	if (current_bytes_address)
+		*current_bytes_address = state.current_bytes[tag];
+	if (peak_bytes_address)
+		*peak_bytes_address = state.peak_bytes[tag];
+	if (number_of_allocations_address)
+		*number_of_allocations_address = state.number_of_allocations[tag];
+	state.unlock();
+	return 1;
+}
+
+double Memory_accounting_get_heap_bytes(void)
+{
+#if defined (__GLIBC__) && ((__GLIBC__ > 2) || ((__GLIBC__ == 2) && (__GLIBC_MINOR__ >= 33)))
+	struct mallinfo2 info = mallinfo2();
+	return (double)info.uordblks + (double)info.hblkhd;
+#elif defined (__GLIBC__)
+	/* fields wrap beyond 4 GB in the older interface */
+	struct mallinfo info = mallinfo();
+	return (double)(unsigned int)info.uordblks + (double)(unsigned int)info.hblkhd;
+#else
+	return 0.0;
+#endif
+}
+
+int Memory_accounting_heap_bytes_available(void)
+{
+#if defined (__GLIBC__)
+	return 1;
+#else
+	return 0;
+#endif
+}
+
+double Memory_accounting_get_peak_resident_bytes(void)
+{
+#if defined (UNIX)
+	struct rusage usage;
+	if (0 == getrusage(RUSAGE_SELF, &usage))
+	{
+#if defined (__APPLE__)
+		return (double)usage.ru_maxrss;
+#else
+		/* kilobytes on Linux */
+		return 1024.0*(double)usage.ru_maxrss;
+#endif
+	}
+#endif /* defined (UNIX) */
+	return 0.0;
+}
+
+int Memory_accounting_list(void)
+{
+	Memory_accounting_state &state = memory_accounting_state;
+	double current_bytes[MEMORY_ACCOUNTING_NUMBER_OF_TAGS];
+	double peak_bytes[MEMORY_ACCOUNTING_NUMBER_OF_TAGS];
+	long number_of_allocations[MEMORY_ACCOUNTING_NUMBER_OF_TAGS];
+	state.lock();
+	for (int i = 0; i < MEMORY_ACCOUNTING_NUMBER_OF_TAGS; ++i)
+	{
+		current_bytes[i] = state.current_bytes[i];
+		peak_bytes[i] = state.peak_bytes[i];
+		number_of_allocations[i] = state.number_of_allocations[i];
+	}
+	state.unlock();
+	display_message(INFORMATION_MESSAGE, "%-20s %10s %14s %14s\n", "buffer",
+		"count", "current (kB)", "peak (kB)");
+	for (int i = 0; i < MEMORY_ACCOUNTING_NUMBER_OF_TAGS; ++i)
+	{
+		display_message(INFORMATION_MESSAGE, "%-20s %10ld %14.0f %14.0f\n",
+			memory_accounting_tag_names[i], number_of_allocations[i],
+			current_bytes[i]/1024.0, peak_bytes[i]/1024.0);
+	}
+	if (Memory_accounting_heap_bytes_available())
+	{
+		display_message(INFORMATION_MESSAGE, "%-20s %10s %14.0f %14s\n",
+			"process heap", "", Memory_accounting_get_heap_bytes()/1024.0, "");
+	}
+	const double peak_resident_bytes = Memory_accounting_get_peak_resident_bytes();
+	if (0.0 < peak_resident_bytes)
+	{
+		display_message(INFORMATION_MESSAGE, "%-20s %10s %14s %14.0f\n",
+			"process resident", "", "", peak_resident_bytes/1024.0);
+	}
+	return 1;
+}
+
+int Memory_accounting_set_sampling(double interval_seconds, const char *file_name)
+{
+	Memory_accounting_state &state = memory_accounting_state;
+	if (state.sample_file)
+	{
+		fclose(state.sample_file);
+		state.sample_file = 0;
+	}
+	state.sample_interval_seconds = 0.0;
+	if (0.0 < interval_seconds)
+	{
+		if (file_name)
+		{
+			state.sample_file = fopen(file_name, "w");
+			if (!state.sample_file)
+			{
+				display_message(ERROR_MESSAGE,
+					"Could not open file %s for writing", file_name);
+				return 0;
+			}
+		}
+		state.sample_interval_seconds = interval_seconds;
+		/* first sample after the next command */
+		state.last_sample_seconds = 0.0;
+		char line[512];
+		int length = sprintf(line, "time heap_kB peak_resident_kB");
+		for (int i = 0; i < MEMORY_ACCOUNTING_NUMBER_OF_TAGS; ++i)
+			length += sprintf(line + length, " %s_kB", memory_accounting_tag_names[i]);
+		sprintf(line + length, "\n");
+		Memory_accounting_write_line(state.sample_file, line);
+	}
+	return 1;
+}
+
+void Memory_accounting_sample_if_due(void)
+{
+	Memory_accounting_state &state = memory_accounting_state;
+	if (0.0 < state.sample_interval_seconds)
+	{
+		const double seconds = Memory_accounting_get_seconds();
+		if (seconds - state.last_sample_seconds >= state.sample_interval_seconds)
+		{
+			state.last_sample_seconds = seconds;
+			char line[512];
+			int length = sprintf(line, "%.3f %.0f %.0f", seconds,
+				Memory_accounting_get_heap_bytes()/1024.0,
+				Memory_accounting_get_peak_resident_bytes()/1024.0);
+			state.lock();
+			for (int i = 0; i < MEMORY_ACCOUNTING_NUMBER_OF_TAGS; ++i)
+				length += sprintf(line + length, " %.0f", state.current_bytes[i]/1024.0);
+			state.unlock();
+			sprintf(line + length, "\n");
+			Memory_accounting_write_line(state.sample_file, line);
+		}
+	}
+}
@@ -0,0 +1,96 @@
+/**
+ * FILE : memory_accounting.h
+ *
+ * Tracks the bytes held by large cmgui-owned buffers by kind of buffer, with
+ * the process heap size, so memory growth in long sessions can be attributed.
+ * Memory allocated inside Zinc, including textures, graphics and node and
+ * element storage, is only seen in the process figures.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (MEMORY_ACCOUNTING_H)
+#define MEMORY_ACCOUNTING_H
+
+#include <stddef.h>
+
+/** Kinds of large cmgui buffer which allocations are attributed to. */
+enum Memory_accounting_tag
+{
+	/** Output buffers of file writers. */
+	MEMORY_ACCOUNTING_TAG_FILE_BUFFERS,
+	/** Input files mapped into memory. */
+	MEMORY_ACCOUNTING_TAG_MAPPED_FILES,
+	/** Image bands assembled from rendered tiles. */
+	MEMORY_ACCOUNTING_TAG_IMAGES,
+	/** Spatial indexes of mesh elements. */
+	MEMORY_ACCOUNTING_TAG_MESH_INDEXES,
+	/** Textures of image filter results read back from the image cache. */
+	MEMORY_ACCOUNTING_TAG_CACHED_IMAGES,
+	/** Connected component labels kept by the parallel connected threshold. */
+	MEMORY_ACCOUNTING_TAG_IMAGE_LABELS,
+	MEMORY_ACCOUNTING_NUMBER_OF_TAGS
+};
+
+/**
+ * @return  Name of <tag> for listings.
+ */
+const char *Memory_accounting_tag_get_name(enum Memory_accounting_tag tag);
+
+/**
+ * Records <bytes> newly held under <tag>. Safe to call from any thread.
+ */
+void Memory_accounting_add(enum Memory_accounting_tag tag, size_t bytes);
+
+/**
+ * Records <bytes> under <tag> released. Must match earlier additions.
+ */
+void Memory_accounting_remove(enum Memory_accounting_tag tag, size_t bytes);
+
+/**
+ * Gets the bytes currently held under <tag>, the most held at once and the
+ * number of live allocations.
+ */
+int Memory_accounting_get_tag_bytes(enum Memory_accounting_tag tag,
+	double *current_bytes_address, double *peak_bytes_address,
+	long *number_of_allocations_address);
+
+/**
+ * @return  Bytes currently allocated from the process heap, or 0 if not known
+ * on this system.
+ */
+double Memory_accounting_get_heap_bytes(void);
+
+/**
+ * @return  1 if Memory_accounting_get_heap_bytes is supported, otherwise 0.
+ */
+int Memory_accounting_heap_bytes_available(void);
+
+/**
+ * @return  Largest resident size of the process so far in bytes, or 0 if not
+ * known on this system.
+ */
+double Memory_accounting_get_peak_resident_bytes(void);
+
+/**
+ * Writes the current and peak bytes of each tag with the heap and peak
+ * resident sizes to the command window.
+ */
+int Memory_accounting_list(void);
+
+/**
+ * Starts writing a line of heap and per tag bytes at most every
+ * <interval_seconds> while command files are executed, to <file_name> or the
+ * command window if NULL. An interval of 0 stops sampling.
+ */
+int Memory_accounting_set_sampling(double interval_seconds, const char *file_name);
+
+/**
+ * Writes a sample if sampling is on and the interval has passed since the last
+ * one. Called after each command of a command file.
+ */
+void Memory_accounting_sample_if_due(void);
+
+#endif /* !defined (MEMORY_ACCOUNTING_H) */
@@ -0,0 +1,451 @@
+/**
+ * FILE : zip_writer.cpp
+ *
+ * Writes a zip archive entry by entry.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "configure/cmgui_configure.h"
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#if defined (WIN32_SYSTEM)
+//#define WINDOWS_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else /* defined (WIN32_SYSTEM) */
+#include <unistd.h>
+#endif /* defined (WIN32_SYSTEM) */
+#include <zlib.h>
+#include "general/debug.h"
+#include "general/message.h"
+#include "general/zip_writer.h"
+
+namespace {
+
+const unsigned long ZIP_LOCAL_HEADER_SIGNATURE = 0x04034b50UL;
+const unsigned long ZIP_DATA_DESCRIPTOR_SIGNATURE = 0x08074b50UL;
+const unsigned long ZIP_CENTRAL_HEADER_SIGNATURE = 0x02014b50UL;
+const unsigned long ZIP64_END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06064b50UL;
+const unsigned long ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIGNATURE = 0x07064b50UL;
+const unsigned long ZIP_END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06054b50UL;
+/* version 4.5 is needed to extract zip64 entries */
+const unsigned int ZIP_VERSION = 45;
+/* sizes follow the data in a descriptor, so the data can be streamed */
+const unsigned int ZIP_FLAG_DATA_DESCRIPTOR = 0x0008;
+const unsigned int ZIP_METHOD_DEFLATED = 8;
+const unsigned int ZIP64_EXTRA_FIELD_TAG = 0x0001;
+/* larger sizes and offsets are only given in zip64 records */
+const unsigned long long ZIP_MAXIMUM_SIZE = 0xffffffffULL;
+const unsigned long ZIP_MAXIMUM_NUMBER_OF_ENTRIES = 0xffffUL;
+/* bytes compressed between writes to the file */
+const size_t ZIP_BUFFER_SIZE = 65536;
+
+struct Zip_entry
+{
+	std::string name;
+	unsigned long crc;
+	unsigned long long compressed_size, size, local_header_offset;
+};
+
+void zip_put(std::vector<unsigned char> &bytes, unsigned long long value,
+	int number_of_bytes)
+{
+	for (int i = 0; i < number_of_bytes; ++i)
+	{
+		bytes.push_back((unsigned char)(value & 0xff));
+		value >>= 8;
+	}
+}
+
+/** Puts <value> in a 4 byte field, or the zip64 marker if it does not fit. */
+void zip_put_32_or_marker(std::vector<unsigned char> &bytes,
+	unsigned long long value)
+{
+	zip_put(bytes, (value < ZIP_MAXIMUM_SIZE) ? value : ZIP_MAXIMUM_SIZE, 4);
+}
+
+}
+
+struct Zip_writer
+{
+	FILE *file;
+	unsigned long long offset;
+	unsigned int dos_time, dos_date;
+	std::vector<Zip_entry> entries;
+	bool in_entry;
+	Zip_entry current;
+	z_stream stream;
+	std::vector<unsigned char> buffer;
+	int error;
+};
+
+namespace {
+
+int Zip_writer_write_bytes(struct Zip_writer *writer, const void *bytes,
+	size_t length)
+{
+	if ((0 < length) && (length != fwrite(bytes, 1, length, writer->file)))
+	{
+		writer->error = 1;
+		return 0;
+	}
+	writer->offset += length;
+	return 1;
+}
+
+int Zip_writer_write_bytes(struct Zip_writer *writer,
+	const std::vector<unsigned char> &bytes)
+{
+	return Zip_writer_write_bytes(writer, &bytes[0], bytes.size());
+}
+
+/**
+ * Deflates the pending input of the current entry with <flush>, writing
+ * every full output buffer to the file.
+ * @return  1 on success, 0 on failure.
+ */
+int Zip_writer_deflate(struct Zip_writer *writer, int flush)
+{
+	int result;
+	do
+	{
+		writer->stream.next_out = &(writer->buffer[0]);
+		writer->stream.avail_out = (uInt)writer->buffer.size();
+		result = deflate(&(writer->stream), flush);
+		if ((Z_STREAM_ERROR == result) ||
+			!Zip_writer_write_bytes(writer, &(writer->buffer[0]),
+				writer->buffer.size() - writer->stream.avail_out))
+		{
+			writer->error = 1;
+			return 0;
+		}
+		writer->current.compressed_size +=
+			writer->buffer.size() - writer->stream.avail_out;
+	} while ((0 == writer->stream.avail_out) ||
+		((Z_FINISH == flush) && (Z_STREAM_END != result)));
+	return 1;
+}
+
+}
+
+struct Zip_writer *CREATE(Zip_writer)(const char *file_name)
+{
+	struct Zip_writer *writer = 0;
+	if (!file_name)
+	{
+		display_message(ERROR_MESSAGE, "CREATE(Zip_writer).  Invalid argument(s)");
+		return 0;
+	}
+	FILE *file = fopen(file_name, "wb");
+	if (!file)
+	{
+		display_message(ERROR_MESSAGE, "Could not create zip file %s", file_name);
+		return 0;
+	}
+	writer = new Zip_writer();
+	writer->file = file;
+	writer->offset = 0;
+	time_t now = time(0);
+	struct tm *local_time = localtime(&now);
+	if (local_time && (local_time->tm_year >= 80))
+	{
+		writer->dos_time = (unsigned int)((local_time->tm_hour << 11) |
+			(local_time->tm_min << 5) | (local_time->tm_sec/2));
+		writer->dos_date = (unsigned int)(((local_time->tm_year - 80) << 9) |
+			((local_time->tm_mon + 1) << 5) | local_time->tm_mday);
+	}
+	else
+	{
+		/* 1 January 1980 */
+		writer->dos_time = 0;
+		writer->dos_date = (1 << 5) | 1;
+	}
+	writer->in_entry = false;
+	writer->buffer.resize(ZIP_BUFFER_SIZE);
+	writer->error = 0;
+	return writer;
+}
+
+int DESTROY(Zip_writer)(struct Zip_writer **writer_address)
+{
+	if (writer_address && (*writer_address))
+	{
+		if ((*writer_address)->in_entry)
+			deflateEnd(&((*writer_address)->stream));
+		fclose((*writer_address)->file);
+		delete *writer_address;
+		*writer_address = 0;
+		return 1;
+	}
+	return 0;
+}
+
+int Zip_writer_begin_entry(struct Zip_writer *writer, const char *entry_name)
+{
+	if (!(writer && entry_name && (0 < strlen(entry_name)) &&
+		(strlen(entry_name) < 0xffff)))
+	{
+		display_message(ERROR_MESSAGE, "Zip_writer_begin_entry.  Invalid argument(s)");
+		return 0;
+	}
+	if (writer->in_entry && !Zip_writer_end_entry(writer))
+		return 0;
+	if (writer->error)
+		return 0;
+	writer->current.name = entry_name;
+	writer->current.crc = crc32(0L, Z_NULL, 0);
+	writer->current.compressed_size = 0;
+	writer->current.size = 0;
+	writer->current.local_header_offset = writer->offset;
+	/* CRC and sizes are in the data descriptor after the data */
+	std::vector<unsigned char> header;
+	zip_put(header, ZIP_LOCAL_HEADER_SIGNATURE, 4);
+	zip_put(header, ZIP_VERSION, 2);
+	zip_put(header, ZIP_FLAG_DATA_DESCRIPTOR, 2);
+	zip_put(header, ZIP_METHOD_DEFLATED, 2);
+	zip_put(header, writer->dos_time, 2);
+	zip_put(header, writer->dos_date, 2);
+	zip_put(header, /*crc*/0, 4);
+	zip_put(header, /*compressed size*/0, 4);
+	zip_put(header, /*uncompressed size*/0, 4);
+	zip_put(header, (unsigned long long)writer->current.name.size(), 2);
+	zip_put(header, /*extra field length*/0, 2);
+	header.insert(header.end(), writer->current.name.begin(),
+		writer->current.name.end());
+	if (!Zip_writer_write_bytes(writer, header))
+		return 0;
+	memset(&(writer->stream), 0, sizeof(writer->stream));
+	/* negative window bits gives raw deflate data without a zlib header */
+	if (Z_OK != deflateInit2(&(writer->stream), Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+		-MAX_WBITS, /*memLevel*/8, Z_DEFAULT_STRATEGY))
+	{
+		display_message(ERROR_MESSAGE, "Zip_writer_begin_entry.  Could not start compression");
+		writer->error = 1;
+		return 0;
+	}
+	writer->in_entry = true;
+	return 1;
+}
+
+int Zip_writer_write(struct Zip_writer *writer, const void *data,
+	size_t length)
+{
+	if (!(writer && writer->in_entry && (data || (0 == length))))
+	{
+		display_message(ERROR_MESSAGE, "Zip_writer_write.  Invalid argument(s)");
+		return 0;
+	}
+	if (writer->error)
+		return 0;
+	const unsigned char *bytes = static_cast<const unsigned char *>(data);
+	/* zlib lengths are unsigned ints */
+	while (0 < length)
+	{
+		const uInt chunk_length = (length < (size_t)UINT_MAX) ? (uInt)length : UINT_MAX;
+		writer->current.crc = crc32(writer->current.crc, bytes, chunk_length);
+		writer->stream.next_in = const_cast<Bytef *>(bytes);
+		writer->stream.avail_in = chunk_length;
+		if (!Zip_writer_deflate(writer, Z_NO_FLUSH))
+			return 0;
+		writer->current.size += chunk_length;
+		bytes += chunk_length;
+		length -= chunk_length;
+	}
+	return 1;
+}
+
+int Zip_writer_write_file(struct Zip_writer *writer, const char *file_name)
+{
+	if (!(writer && writer->in_entry && file_name))
+	{
+		display_message(ERROR_MESSAGE, "Zip_writer_write_file.  Invalid argument(s)");
+		return 0;
+	}
+	FILE *file = fopen(file_name, "rb");
+	if (!file)
+	{
+		display_message(ERROR_MESSAGE, "Could not open %s to add to zip file", file_name);
+		return 0;
+	}
+	int return_code = 1;
+	std::vector<unsigned char> chunk(ZIP_BUFFER_SIZE);
+	size_t length;
+	while (return_code && (0 < (length = fread(&chunk[0], 1, chunk.size(), file))))
+		return_code = Zip_writer_write(writer, &chunk[0], length);
+	if (ferror(file))
+	{
+		display_message(ERROR_MESSAGE, "Could not read %s to add to zip file", file_name);
+		return_code = 0;
+	}
+	fclose(file);
+	return return_code;
+}
+
+char *Zip_writer_create_temporary_file(void)
+{
+	char *file_name = 0;
+#if defined (WIN32_SYSTEM)
+	char directory[MAX_PATH + 1];
+	const DWORD length = GetTempPathA(MAX_PATH + 1, directory);
+	if ((0 < length) && (length <= MAX_PATH) &&
+		ALLOCATE(file_name, char, MAX_PATH + 1))
+	{
+		/* creates the file so the name is not reused */
+		if (0 == GetTempFileNameA(directory, "cmg", 0, file_name))
+		{
+			DEALLOCATE(file_name);
+		}
+	}
+#else /* defined (WIN32_SYSTEM) */
+	const char *directory = getenv("TMPDIR");
+	if (!(directory && directory[0]))
+		directory = "/tmp";
+	const std::string name_template = std::string(directory) + "/cmgui_zip_XXXXXX";
+	if (ALLOCATE(file_name, char, name_template.size() + 1))
+	{
+		strcpy(file_name, name_template.c_str());
+		const int file_descriptor = mkstemp(file_name);
+		if (0 <= file_descriptor)
+		{
+			close(file_descriptor);
+		}
+		else
+		{
+			DEALLOCATE(file_name);
+		}
+	}
+#endif /* defined (WIN32_SYSTEM) */
+	if (!file_name)
+	{
+		display_message(ERROR_MESSAGE,
+			"Zip_writer_create_temporary_file.  Could not create temporary file");
+	}
+	return file_name;
+}
+
+int Zip_writer_end_entry(struct Zip_writer *writer)
+{
+	if (!(writer && writer->in_entry))
+	{
+		display_message(ERROR_MESSAGE, "Zip_writer_end_entry.  Invalid argument(s)");
+		return 0;
+	}
+	writer->in_entry = false;
+	writer->stream.next_in = Z_NULL;
+	writer->stream.avail_in = 0;
+	if (!writer->error)
+		Zip_writer_deflate(writer, Z_FINISH);
+	deflateEnd(&(writer->stream));
+	if (writer->error)
+		return 0;
+	std::vector<unsigned char> descriptor;
+	zip_put(descriptor, ZIP_DATA_DESCRIPTOR_SIGNATURE, 4);
+	zip_put(descriptor, writer->current.crc, 4);
+	/* sizes are 8 bytes where the central directory needs zip64 for them */
+	const int size_bytes = ((writer->current.compressed_size >= ZIP_MAXIMUM_SIZE) ||
+		(writer->current.size >= ZIP_MAXIMUM_SIZE)) ? 8 : 4;
+	zip_put(descriptor, writer->current.compressed_size, size_bytes);
+	zip_put(descriptor, writer->current.size, size_bytes);
+	if (!Zip_writer_write_bytes(writer, descriptor))
+		return 0;
+	writer->entries.push_back(writer->current);
+	return 1;
+}
+
+int Zip_writer_finish(struct Zip_writer *writer)
+{
+	if (!writer)
+		return 0;
+	if (writer->in_entry)
+		Zip_writer_end_entry(writer);
+	if (writer->error)
+		return 0;
+	const unsigned long long central_directory_offset = writer->offset;
+	std::vector<unsigned char> directory;
+	for (size_t i = 0; i < writer->entries.size(); ++i)
+	{
+		const Zip_entry &entry = writer->entries[i];
+		/* the zip64 extra field has only the values too big for their fields */
+		std::vector<unsigned char> extra;
+		if (entry.size >= ZIP_MAXIMUM_SIZE)
+			zip_put(extra, entry.size, 8);
+		if (entry.compressed_size >= ZIP_MAXIMUM_SIZE)
+			zip_put(extra, entry.compressed_size, 8);
+		if (entry.local_header_offset >= ZIP_MAXIMUM_SIZE)
+			zip_put(extra, entry.local_header_offset, 8);
+		zip_put(directory, ZIP_CENTRAL_HEADER_SIGNATURE, 4);
+		zip_put(directory, ZIP_VERSION, 2);
+		zip_put(directory, ZIP_VERSION, 2);
+		zip_put(directory, ZIP_FLAG_DATA_DESCRIPTOR, 2);
+		zip_put(directory, ZIP_METHOD_DEFLATED, 2);
+		zip_put(directory, writer->dos_time, 2);
+		zip_put(directory, writer->dos_date, 2);
+		zip_put(directory, entry.crc, 4);
+		zip_put_32_or_marker(directory, entry.compressed_size);
+		zip_put_32_or_marker(directory, entry.size);
+		zip_put(directory, (unsigned long long)entry.name.size(), 2);
+		zip_put(directory, extra.empty() ? 0 : (unsigned long long)(extra.size() + 4), 2);
+		zip_put(directory, /*comment length*/0, 2);
+		zip_put(directory, /*disk number*/0, 2);
+		zip_put(directory, /*internal attributes*/0, 2);
+		zip_put(directory, /*external attributes*/0, 4);
+		zip_put_32_or_marker(directory, entry.local_header_offset);
+		directory.insert(directory.end(), entry.name.begin(), entry.name.end());
+		if (!extra.empty())
+		{
+			zip_put(directory, ZIP64_EXTRA_FIELD_TAG, 2);
+			zip_put(directory, (unsigned long long)extra.size(), 2);
+			directory.insert(directory.end(), extra.begin(), extra.end());
+		}
+	}
+	const unsigned long long central_directory_size = directory.size();
+	const unsigned long long number_of_entries = writer->entries.size();
+	if ((number_of_entries >= ZIP_MAXIMUM_NUMBER_OF_ENTRIES) ||
+		(central_directory_size >= ZIP_MAXIMUM_SIZE) ||
+		(central_directory_offset >= ZIP_MAXIMUM_SIZE))
+	{
+		const unsigned long long zip64_end_offset =
+			central_directory_offset + central_directory_size;
+		zip_put(directory, ZIP64_END_OF_CENTRAL_DIRECTORY_SIGNATURE, 4);
+		/* size of the rest of the record */
+		zip_put(directory, 44, 8);
+		zip_put(directory, ZIP_VERSION, 2);
+		zip_put(directory, ZIP_VERSION, 2);
+		zip_put(directory, /*disk number*/0, 4);
+		zip_put(directory, /*disk with central directory*/0, 4);
+		zip_put(directory, number_of_entries, 8);
+		zip_put(directory, number_of_entries, 8);
+		zip_put(directory, central_directory_size, 8);
+		zip_put(directory, central_directory_offset, 8);
+		zip_put(directory, ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIGNATURE, 4);
+		zip_put(directory, /*disk with zip64 end of central directory*/0, 4);
+		zip_put(directory, zip64_end_offset, 8);
+		zip_put(directory, /*number of disks*/1, 4);
+	}
+	zip_put(directory, ZIP_END_OF_CENTRAL_DIRECTORY_SIGNATURE, 4);
+	zip_put(directory, /*disk number*/0, 2);
+	zip_put(directory, /*disk with central directory*/0, 2);
+	zip_put(directory, (number_of_entries < ZIP_MAXIMUM_NUMBER_OF_ENTRIES) ?
+		number_of_entries : ZIP_MAXIMUM_NUMBER_OF_ENTRIES, 2);
+	zip_put(directory, (number_of_entries < ZIP_MAXIMUM_NUMBER_OF_ENTRIES) ?
+		number_of_entries : ZIP_MAXIMUM_NUMBER_OF_ENTRIES, 2);
+	zip_put_32_or_marker(directory, central_directory_size);
+	zip_put_32_or_marker(directory, central_directory_offset);
+	zip_put(directory, /*comment length*/0, 2);
+	if (!Zip_writer_write_bytes(writer, directory) ||
+		(0 != fflush(writer->file)))
+	{
+		writer->error = 1;
+		return 0;
+	}
+	return 1;
+}
@@ -0,0 +1,74 @@
+/**
+ * FILE : zip_writer.h
+ *
+ * Writes a zip archive entry by entry, deflating each entry's data straight
+ * into the archive. Sizes and offsets over 4 GiB and more than 65535 entries
+ * are written with the zip64 extensions.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (ZIP_WRITER_H)
+#define ZIP_WRITER_H
+
+#include <stddef.h>
+#include "general/object.h"
+
+struct Zip_writer;
+
+/**
+ * Creates the zip file <file_name>, replacing any existing file.
+ * @return  New writer, or NULL on failure.
+ */
+struct Zip_writer *CREATE(Zip_writer)(const char *file_name);
+
+/**
+ * Closes the file. If Zip_writer_finish has not succeeded the archive is
+ * left incomplete.
+ */
+int DESTROY(Zip_writer)(struct Zip_writer **writer_address);
+
+/**
+ * Starts a new entry called <entry_name>, ending any current entry.
+ * @return  1 on success, otherwise 0.
+ */
+int Zip_writer_begin_entry(struct Zip_writer *writer, const char *entry_name);
+
+/**
+ * Appends <length> bytes of <data> to the current entry.
+ * @return  1 on success, otherwise 0.
+ */
+int Zip_writer_write(struct Zip_writer *writer, const void *data,
+	size_t length);
+
+/**
+ * Appends the contents of the file <file_name> to the current entry, a block
+ * at a time so the file need not fit in memory.
+ * @return  1 on success, otherwise 0.
+ */
+int Zip_writer_write_file(struct Zip_writer *writer, const char *file_name);
+
+/**
+ * Creates an empty file with a unique name in the system temporary directory,
+ * for entry data which can only be written to a file before being added with
+ * Zip_writer_write_file. On UNIX only the calling user can read the file.
+ * @return  Allocated name of the file, which the caller must remove and
+ * DEALLOCATE, or NULL on failure.
+ */
+char *Zip_writer_create_temporary_file(void);
+
+/**
+ * Ends the current entry, recording its size and checksum.
+ * @return  1 on success, otherwise 0.
+ */
+int Zip_writer_end_entry(struct Zip_writer *writer);
+
+/**
+ * Ends any current entry and writes the central directory.
+ * @return  1 if the whole archive was written, otherwise 0.
+ */
+int Zip_writer_finish(struct Zip_writer *writer);
+
+#endif /* !defined (ZIP_WRITER_H) */
@@ -0,0 +1,406 @@
+/**
+ * FILE : frame_sequence_writer.cpp
+ *
+ * Writes a sequence of rendered frames on a background thread.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "general/cmgui_thread.h"
+#include "general/debug.h"
+#include "general/image_utilities.h"
+#include "general/message.h"
+#include "general/mystring.h"
+#include "graphics/frame_sequence_writer.h"
+
+struct Frame_sequence_writer
+{
+	char *file_pattern;
+	int width, height, number_of_components;
+	struct IO_stream_package *io_stream_package;
+	/* open when writing a .y4m stream, otherwise frames go to separate files */
+	FILE *stream;
+	unsigned char *planes;
+	/* circular queue of frames waiting to be written */
+	unsigned char **queue;
+	int queue_length, queue_start, queue_count;
+	int number_of_frames_added, number_of_frames_written;
+	int finishing, error;
+	struct Cmgui_mutex *mutex;
+	/* signalled whenever the queue or finishing state changes */
+	struct Cmgui_condition *condition;
+	struct Cmgui_thread *thread;
+};
+
+namespace {
+
+int Frame_sequence_writer_file_pattern_is_stream(const char *file_pattern)
+{
+	size_t length = strlen(file_pattern);
+	if (length > 4)
+	{
+		const char *extension = file_pattern + length - 4;
+		return ('.' == extension[0]) &&
+			('y' == tolower((unsigned char)extension[1])) &&
+			('4' == extension[2]) &&
+			('m' == tolower((unsigned char)extension[3]));
+	}
+	return 0;
+}
+
+int greatest_common_divisor(int a, int b)
+{
+	while (b)
+	{
+		int remainder = a % b;
+		a = b;
+		b = remainder;
+	}
+	return a;
+}
+
+/** Writes the YUV4MPEG2 stream header. The frame rate is recorded as a
+ * ratio with a denominator of 1000 reduced to lowest terms. */
+int Frame_sequence_writer_write_stream_header(
+	struct Frame_sequence_writer *writer, double frame_rate)
+{
+	int numerator = (int)floor(frame_rate*1000.0 + 0.5);
+	int denominator = 1000;
+	if (numerator < 1)
+		numerator = 1;
+	int divisor = greatest_common_divisor(numerator, denominator);
+	return (0 < fprintf(writer->stream, "YUV4MPEG2 W%d H%d F%d:%d Ip A1:1 %s\n",
+		writer->width, writer->height, numerator/divisor, denominator/divisor,
+		(writer->number_of_components < 3) ? "Cmono" : "C444"));
+}
+
+/** Converts a frame to studio range BT.601 planes, flipping the rows so the
+ * top of the image comes first, and appends it to the stream. */
+int Frame_sequence_writer_write_stream_frame(
+	struct Frame_sequence_writer *writer, const unsigned char *pixels)
+{
+	const int width = writer->width;
+	const int height = writer->height;
+	const int number_of_components = writer->number_of_components;
+	const size_t plane_size = (size_t)width*(size_t)height;
+	unsigned char *y_plane = writer->planes;
+	unsigned char *u_plane = y_plane + plane_size;
+	unsigned char *v_plane = u_plane + plane_size;
+	int number_of_planes = 1;
+	if (number_of_components < 3)
+	{
+		for (int j = 0; j < height; ++j)
+		{
+			const unsigned char *source =
+				pixels + (size_t)(height - 1 - j)*width*number_of_components;
+			unsigned char *y = y_plane + (size_t)j*width;
+			for (int i = 0; i < width; ++i)
+			{
+				y[i] = (unsigned char)(16 + ((219*(int)source[0] + 127)/255));
+				source += number_of_components;
+			}
+		}
+	}
+	else
+	{
+		number_of_planes = 3;
+		for (int j = 0; j < height; ++j)
+		{
+			const unsigned char *source =
+				pixels + (size_t)(height - 1 - j)*width*number_of_components;
+			const size_t offset = (size_t)j*width;
+			for (int i = 0; i < width; ++i)
+			{
+				const int r = source[0], g = source[1], b = source[2];
+				y_plane[offset + i] = (unsigned char)(((66*r + 129*g + 25*b + 128) >> 8) + 16);
+				u_plane[offset + i] = (unsigned char)(((-38*r - 74*g + 112*b + 128) >> 8) + 128);
+				v_plane[offset + i] = (unsigned char)(((112*r - 94*g - 18*b + 128) >> 8) + 128);
+				source += number_of_components;
+			}
+		}
+	}
+	return (6 == fwrite("FRAME\n", 1, 6, writer->stream)) &&
+		(number_of_planes == (int)fwrite(writer->planes, plane_size, number_of_planes,
+			writer->stream));
+}
+
+int Frame_sequence_writer_write_image_frame(
+	struct Frame_sequence_writer *writer, int frame_number, unsigned char *pixels)
+{
+	int return_code = 0;
+	char *file_name;
+	size_t file_name_length = strlen(writer->file_pattern) + 32;
+	if (ALLOCATE(file_name, char, file_name_length))
+	{
+		sprintf(file_name, writer->file_pattern, frame_number);
+		struct Cmgui_image *cmgui_image = Cmgui_image_constitute(writer->width,
+			writer->height, writer->number_of_components,
+			/*number_of_bytes_per_component*/1,
+			writer->width*writer->number_of_components, pixels);
+		struct Cmgui_image_information *cmgui_image_information =
+			CREATE(Cmgui_image_information)();
+		if (cmgui_image && cmgui_image_information)
+		{
+			Cmgui_image_information_set_image_file_format(cmgui_image_information,
+				UNKNOWN_IMAGE_FILE_FORMAT);
+			Cmgui_image_information_add_file_name(cmgui_image_information,
+				file_name);
+			Cmgui_image_information_set_io_stream_package(cmgui_image_information,
+				writer->io_stream_package);
+			return_code = Cmgui_image_write(cmgui_image, cmgui_image_information);
+		}
+		if (cmgui_image_information)
+			DESTROY(Cmgui_image_information)(&cmgui_image_information);
+		if (cmgui_image)
+			DESTROY(Cmgui_image)(&cmgui_image);
+		DEALLOCATE(file_name);
+	}
+	return return_code;
+}
+
+int Frame_sequence_writer_write_frame(struct Frame_sequence_writer *writer,
+	int frame_number, unsigned char *pixels)
+{
+	if (writer->stream)
+		return Frame_sequence_writer_write_stream_frame(writer, pixels);
+	return Frame_sequence_writer_write_image_frame(writer, frame_number, pixels);
+}
+
+/** Body of the encoding thread: writes queued frames in order until the
+ * queue is empty and the writer is finishing. After an error remaining frames
+ * are discarded. */
+int Frame_sequence_writer_thread_function(int dummy_index, void *writer_void)
+{
+	USE_PARAMETER(dummy_index);
+	struct Frame_sequence_writer *writer =
+		(struct Frame_sequence_writer *)writer_void;
+	Cmgui_mutex_lock(writer->mutex);
+	while (true)
+	{
+		while ((0 == writer->queue_count) && (!writer->finishing))
+			Cmgui_condition_wait(writer->condition, writer->mutex);
+		if (0 == writer->queue_count)
+			break;
+		unsigned char *pixels = writer->queue[writer->queue_start];
+		int frame_number = writer->number_of_frames_written;
+		int error = writer->error;
+		Cmgui_mutex_unlock(writer->mutex);
+		int result = (!error) &&
+			Frame_sequence_writer_write_frame(writer, frame_number, pixels);
+		DEALLOCATE(pixels);
+		Cmgui_mutex_lock(writer->mutex);
+		writer->queue[writer->queue_start] = 0;
+		writer->queue_start = (writer->queue_start + 1) % writer->queue_length;
+		writer->queue_count--;
+		if (result)
+			writer->number_of_frames_written++;
+		else
+			writer->error = 1;
+		Cmgui_condition_broadcast(writer->condition);
+	}
+	Cmgui_mutex_unlock(writer->mutex);
+	return 1;
+}
+
+}
+
+int Frame_sequence_writer_file_pattern_is_valid(const char *file_pattern)
+{
+	if (!file_pattern)
+		return 0;
+	if (Frame_sequence_writer_file_pattern_is_stream(file_pattern))
+		return (0 == strchr(file_pattern, '%'));
+	int number_of_conversions = 0;
+	for (const char *c = file_pattern; *c; ++c)
+	{
+		if ('%' == *c)
+		{
+			++c;
+			if ('%' == *c)
+				continue;
+			/* only zero padding and a single digit field width are allowed, so
+			 * file names fit the space allowed for them */
+			if ('0' == *c)
+				++c;
+			if (isdigit((unsigned char)*c))
+				++c;
+			if ('d' != *c)
+				return 0;
+			++number_of_conversions;
+		}
+	}
+	return (1 == number_of_conversions);
+}
+
+struct Frame_sequence_writer *CREATE(Frame_sequence_writer)(
+	const char *file_pattern, int width, int height, int number_of_components,
+	double frame_rate, int queue_length,
+	struct IO_stream_package *io_stream_package)
+{
+	struct Frame_sequence_writer *writer = 0;
+	if (!(Frame_sequence_writer_file_pattern_is_valid(file_pattern) &&
+		(0 < width) && (0 < height) && (1 <= number_of_components) &&
+		(number_of_components <= 4) && (0.0 < frame_rate) && (0 < queue_length)))
+	{
+		display_message(ERROR_MESSAGE,
+			"CREATE(Frame_sequence_writer).  Invalid argument(s)");
+		return 0;
+	}
+	if (ALLOCATE(writer, struct Frame_sequence_writer, 1))
+	{
+		writer->file_pattern = duplicate_string(file_pattern);
+		writer->width = width;
+		writer->height = height;
+		writer->number_of_components = number_of_components;
+		writer->io_stream_package = io_stream_package;
+		writer->stream = 0;
+		writer->planes = 0;
+		writer->queue = 0;
+		writer->queue_length = queue_length;
+		writer->queue_start = 0;
+		writer->queue_count = 0;
+		writer->number_of_frames_added = 0;
+		writer->number_of_frames_written = 0;
+		writer->finishing = 0;
+		writer->error = 0;
+		writer->mutex = CREATE(Cmgui_mutex)();
+		writer->condition = CREATE(Cmgui_condition)();
+		writer->thread = 0;
+		int return_code = (writer->file_pattern && writer->mutex &&
+			writer->condition && ALLOCATE(writer->queue, unsigned char *, queue_length));
+		if (return_code && Frame_sequence_writer_file_pattern_is_stream(file_pattern))
+		{
+			if (!(ALLOCATE(writer->planes, unsigned char,
+					3*(size_t)width*(size_t)height) &&
+				(writer->stream = fopen(file_pattern, "wb")) &&
+				Frame_sequence_writer_write_stream_header(writer, frame_rate)))
+			{
+				display_message(ERROR_MESSAGE,
+					"CREATE(Frame_sequence_writer).  Could not write %s", file_pattern);
+				return_code = 0;
+			}
+		}
+		if (return_code)
+		{
+			for (int i = 0; i < queue_length; ++i)
+				writer->queue[i] = 0;
+			/* if no thread can be started frames are written as they are added */
+			writer->thread = Cmgui_thread_start(Frame_sequence_writer_thread_function,
+				(void *)writer);
+		}
+		else
+		{
+			DESTROY(Frame_sequence_writer)(&writer);
+		}
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"CREATE(Frame_sequence_writer).  Not enough memory");
+	}
+	return writer;
+}
+
+int DESTROY(Frame_sequence_writer)(
+	struct Frame_sequence_writer **writer_address)
+{
+	struct Frame_sequence_writer *writer;
+	if (writer_address && (writer = *writer_address))
+	{
+		Frame_sequence_writer_finish(writer);
+		if (writer->queue)
+		{
+			for (int i = 0; i < writer->queue_length; ++i)
+			{
+				if (writer->queue[i])
+					DEALLOCATE(writer->queue[i]);
+			}
+			DEALLOCATE(writer->queue);
+		}
+		if (writer->stream)
+			fclose(writer->stream);
+		if (writer->planes)
+			DEALLOCATE(writer->planes);
+		if (writer->condition)
+			DESTROY(Cmgui_condition)(&writer->condition);
+		if (writer->mutex)
+			DESTROY(Cmgui_mutex)(&writer->mutex);
+		if (writer->file_pattern)
+			DEALLOCATE(writer->file_pattern);
+		DEALLOCATE(*writer_address);
+		return 1;
+	}
+	return 0;
+}
+
+int Frame_sequence_writer_add_frame(struct Frame_sequence_writer *writer,
+	unsigned char **pixels_address)
+{
+	if (!(writer && pixels_address && (*pixels_address) && (!writer->finishing)))
+	{
+		display_message(ERROR_MESSAGE,
+			"Frame_sequence_writer_add_frame.  Invalid argument(s)");
+		return 0;
+	}
+	int return_code = 0;
+	if (writer->thread)
+	{
+		Cmgui_mutex_lock(writer->mutex);
+		while ((writer->queue_count == writer->queue_length) && (!writer->error))
+			Cmgui_condition_wait(writer->condition, writer->mutex);
+		if (!writer->error)
+		{
+			writer->queue[(writer->queue_start + writer->queue_count) %
+				writer->queue_length] = *pixels_address;
+			*pixels_address = 0;
+			writer->queue_count++;
+			writer->number_of_frames_added++;
+			Cmgui_condition_broadcast(writer->condition);
+			return_code = 1;
+		}
+		Cmgui_mutex_unlock(writer->mutex);
+	}
+	else if (!writer->error)
+	{
+		writer->number_of_frames_added++;
+		if (Frame_sequence_writer_write_frame(writer,
+			writer->number_of_frames_written, *pixels_address))
+		{
+			writer->number_of_frames_written++;
+			return_code = 1;
+		}
+		else
+		{
+			writer->error = 1;
+		}
+	}
+	if (*pixels_address)
+		DEALLOCATE(*pixels_address);
+	return return_code;
+}
+
+int Frame_sequence_writer_finish(struct Frame_sequence_writer *writer)
+{
+	if (!writer)
+		return 0;
+	if (writer->thread)
+	{
+		Cmgui_mutex_lock(writer->mutex);
+		writer->finishing = 1;
+		Cmgui_condition_broadcast(writer->condition);
+		Cmgui_mutex_unlock(writer->mutex);
+		Cmgui_thread_join(&writer->thread);
+	}
+	writer->finishing = 1;
+	if (writer->stream && (0 != fflush(writer->stream)))
+		writer->error = 1;
+	return (!writer->error) &&
+		(writer->number_of_frames_written == writer->number_of_frames_added);
+}
@@ -0,0 +1,69 @@
+/**
+ * FILE : frame_sequence_writer.h
+ *
+ * Writes a sequence of rendered frames to numbered image files or to a single
+ * YUV4MPEG2 (.y4m) stream. Frames are encoded and written on a background
+ * thread so the next frame can be drawn while the previous ones are saved.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (FRAME_SEQUENCE_WRITER_H)
+#define FRAME_SEQUENCE_WRITER_H
+
+#include "general/object.h"
+
+struct Frame_sequence_writer;
+struct IO_stream_package;
+
+/**
+ * @return  1 if <file_pattern> ends in .y4m and contains no '%', or if it
+ * contains exactly one integer conversion %d, or with a single digit width
+ * such as %04d, and no other conversions. Otherwise 0.
+ */
+int Frame_sequence_writer_file_pattern_is_valid(const char *file_pattern);
+
+/**
+ * Creates a writer and starts its encoding thread. If <file_pattern> ends in
+ * .y4m all frames are written to that file as uncompressed 4:4:4 video, or
+ * monochrome video for luminance frames, with any alpha discarded. Otherwise
+ * each frame is written to an image file named by substituting its frame
+ * number, from 0, into <file_pattern>, with the format taken from the file
+ * extension.
+ * @param number_of_components  1 = luminance, 2 = luminance+alpha, 3 = RGB,
+ * 4 = RGBA, each one byte per pixel.
+ * @param frame_rate  Frames per second recorded in a .y4m stream.
+ * @param queue_length  Maximum number of frames waiting to be written.
+ * @return  New writer, or NULL on failure.
+ */
+struct Frame_sequence_writer *CREATE(Frame_sequence_writer)(
+	const char *file_pattern, int width, int height, int number_of_components,
+	double frame_rate, int queue_length,
+	struct IO_stream_package *io_stream_package);
+
+/**
+ * Finishes writing if Frame_sequence_writer_finish has not been called, then
+ * closes any stream and frees the writer.
+ */
+int DESTROY(Frame_sequence_writer)(
+	struct Frame_sequence_writer **writer_address);
+
+/**
+ * Queues the next frame for writing and takes ownership of its pixels, which
+ * must have been allocated with ALLOCATE. Blocks while the queue is full.
+ * @param pixels_address  Address of width*height pixels with rows from bottom
+ * to top, as read from OpenGL. Cleared on return.
+ * @return  1 on success, 0 if an earlier frame failed to write.
+ */
+int Frame_sequence_writer_add_frame(struct Frame_sequence_writer *writer,
+	unsigned char **pixels_address);
+
+/**
+ * Waits until all queued frames are written and stops the encoding thread.
+ * @return  1 if every frame was written, otherwise 0.
+ */
+int Frame_sequence_writer_finish(struct Frame_sequence_writer *writer);
+
+#endif /* !defined (FRAME_SEQUENCE_WRITER_H) */
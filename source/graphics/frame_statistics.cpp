@@ -0,0 +1,246 @@
+/**
+ * FILE : frame_statistics.cpp
+ *
+ * Rolling record of the time taken by recent frames of a scene viewer, split
+ * into rendering, waiting for OpenGL to finish and swapping buffers.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+#include "general/debug.h"
+#include "general/message.h"
+#include "graphics/frame_statistics.h"
+
+namespace {
+
+/** Mean, 95th percentile and maximum of a set of values. */
+struct Frame_statistics_summary
+{
+	double mean, percentile_95, maximum;
+};
+
+Frame_statistics_summary Frame_statistics_summarise(std::vector<double> &values)
+{
+	Frame_statistics_summary summary = { 0.0, 0.0, 0.0 };
+	if (!values.empty())
+	{
+		double sum = 0.0;
+		for (size_t i = 0; i < values.size(); ++i)
+			sum += values[i];
+		summary.mean = sum/(double)values.size();
+		std::sort(values.begin(), values.end());
+		summary.percentile_95 = values[(95*(values.size() - 1))/100];
+		summary.maximum = values.back();
+	}
+	return summary;
+}
+
+inline double Frame_statistics_frame_total(const Frame_statistics_frame &frame)
+{
+	return frame.render_seconds + frame.finish_seconds + frame.swap_seconds;
+}
+
+}
+
+struct Frame_statistics
+{
+	/* circular buffer of the most recent frames, oldest at next once full */
+	std::vector<Frame_statistics_frame> frames;
+	size_t next;
+	FILE *log_file;
+	int log_pane;
+
+	Frame_statistics() :
+		next(0),
+		log_file(0),
+		log_pane(0)
+	{
+	}
+
+	/** @return  Frame <i> counting from the oldest recorded. */
+	const Frame_statistics_frame &get_frame(size_t i) const
+	{
+		return frames[(frames.size() < FRAME_STATISTICS_WINDOW_SIZE) ? i :
+			((next + i) % FRAME_STATISTICS_WINDOW_SIZE)];
+	}
+
+	/** @return  Frames per second from the start times of recorded frames, or
+	 * 0 if fewer than 2. */
+	double get_frame_rate() const
+	{
+		if (frames.size() < 2)
+			return 0.0;
+		const double elapsed = get_frame(frames.size() - 1).start_seconds -
+			get_frame(0).start_seconds;
+		return (0.0 < elapsed) ? (double)(frames.size() - 1)/elapsed : 0.0;
+	}
+
+	/** @return  Mean primitives per frame, or -1 if not known. */
+	double get_mean_primitives() const
+	{
+		double sum = 0.0;
+		long count = 0;
+		for (size_t i = 0; i < frames.size(); ++i)
+		{
+			if (0 <= frames[i].primitives)
+			{
+				sum += (double)frames[i].primitives;
+				++count;
+			}
+		}
+		return (0 < count) ? sum/(double)count : -1.0;
+	}
+};
+
+struct Frame_statistics *CREATE(Frame_statistics)(void)
+{
+	return new Frame_statistics();
+}
+
+int DESTROY(Frame_statistics)(struct Frame_statistics **statistics_address)
+{
+	if (statistics_address && (*statistics_address))
+	{
+		delete *statistics_address;
+		*statistics_address = 0;
+		return 1;
+	}
+	return 0;
+}
+
+int Frame_statistics_add_frame(struct Frame_statistics *statistics,
+	const struct Frame_statistics_frame *frame)
+{
+	if (!(statistics && frame))
+	{
+		display_message(ERROR_MESSAGE, "Frame_statistics_add_frame.  Invalid argument(s)");
+		return 0;
+	}
+	if (statistics->frames.size() < FRAME_STATISTICS_WINDOW_SIZE)
+		statistics->frames.push_back(*frame);
+	else
+	{
+		statistics->frames[statistics->next] = *frame;
+		statistics->next = (statistics->next + 1) % FRAME_STATISTICS_WINDOW_SIZE;
+	}
+	if (statistics->log_file)
+	{
+		fprintf(statistics->log_file, "%.6f,%d,%.3f,%.3f,%.3f,%.3f,%ld\n",
+			frame->start_seconds, statistics->log_pane,
+			1000.0*Frame_statistics_frame_total(*frame), 1000.0*frame->render_seconds,
+			1000.0*frame->finish_seconds, 1000.0*frame->swap_seconds, frame->primitives);
+	}
+	return 1;
+}
+
+int Frame_statistics_reset(struct Frame_statistics *statistics)
+{
+	if (statistics)
+	{
+		statistics->frames.clear();
+		statistics->next = 0;
+		return 1;
+	}
+	return 0;
+}
+
+int Frame_statistics_set_log_file(struct Frame_statistics *statistics,
+	FILE *log_file, int pane)
+{
+	if (statistics)
+	{
+		statistics->log_file = log_file;
+		statistics->log_pane = pane;
+		return 1;
+	}
+	return 0;
+}
+
+int Frame_statistics_write_log_header(FILE *log_file)
+{
+	if (log_file)
+	{
+		fprintf(log_file, "time,pane,total_ms,render_ms,finish_ms,swap_ms,primitives\n");
+		return 1;
+	}
+	return 0;
+}
+
+int Frame_statistics_list(struct Frame_statistics *statistics)
+{
+	if (!statistics)
+	{
+		display_message(ERROR_MESSAGE, "Frame_statistics_list.  Invalid argument(s)");
+		return 0;
+	}
+	const size_t number_of_frames = statistics->frames.size();
+	if (0 == number_of_frames)
+	{
+		display_message(INFORMATION_MESSAGE, "    No frames recorded\n");
+		return 1;
+	}
+	display_message(INFORMATION_MESSAGE,
+		"    %d frames, %.1f frames per second\n", (int)number_of_frames,
+		statistics->get_frame_rate());
+	display_message(INFORMATION_MESSAGE, "    %-10s %10s %10s %10s\n",
+		"", "mean (ms)", "95% (ms)", "max (ms)");
+	const char *names[4] = { "total", "render", "finish", "swap" };
+	std::vector<double> values(number_of_frames);
+	for (int part = 0; part < 4; ++part)
+	{
+		for (size_t i = 0; i < number_of_frames; ++i)
+		{
+			const Frame_statistics_frame &frame = statistics->frames[i];
+			values[i] = (0 == part) ? Frame_statistics_frame_total(frame) :
+				(1 == part) ? frame.render_seconds :
+				(2 == part) ? frame.finish_seconds : frame.swap_seconds;
+		}
+		const Frame_statistics_summary summary = Frame_statistics_summarise(values);
+		display_message(INFORMATION_MESSAGE, "    %-10s %10.3f %10.3f %10.3f\n",
+			names[part], 1000.0*summary.mean, 1000.0*summary.percentile_95,
+			1000.0*summary.maximum);
+	}
+	const double mean_primitives = statistics->get_mean_primitives();
+	if (0.0 <= mean_primitives)
+	{
+		display_message(INFORMATION_MESSAGE,
+			"    %.0f primitives per frame\n", mean_primitives);
+	}
+	else
+	{
+		display_message(INFORMATION_MESSAGE,
+			"    primitives per frame: not available\n");
+	}
+	return 1;
+}
+
+int Frame_statistics_get_summary(struct Frame_statistics *statistics,
+	char *text, int text_size)
+{
+	if (!(statistics && text && (0 < text_size)))
+		return 0;
+	const size_t number_of_frames = statistics->frames.size();
+	double total = 0.0;
+	for (size_t i = 0; i < number_of_frames; ++i)
+		total += Frame_statistics_frame_total(statistics->frames[i]);
+	const double mean_milliseconds = (0 < number_of_frames) ?
+		1000.0*total/(double)number_of_frames : 0.0;
+	const double mean_primitives = statistics->get_mean_primitives();
+	if (0.0 <= mean_primitives)
+	{
+		snprintf(text, text_size, "%.1f fps  %.2f ms/frame  %.0f primitives",
+			statistics->get_frame_rate(), mean_milliseconds, mean_primitives);
+	}
+	else
+	{
+		snprintf(text, text_size, "%.1f fps  %.2f ms/frame",
+			statistics->get_frame_rate(), mean_milliseconds);
+	}
+	return 1;
+}
@@ -0,0 +1,79 @@
+/**
+ * FILE : frame_statistics.h
+ *
+ * Rolling record of the time taken by recent frames of a scene viewer, split
+ * into rendering, waiting for OpenGL to finish and swapping buffers.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (FRAME_STATISTICS_H)
+#define FRAME_STATISTICS_H
+
+#include <stdio.h>
+#include "general/object.h"
+
+/** Number of recent frames summarised. */
+#define FRAME_STATISTICS_WINDOW_SIZE 120
+
+struct Frame_statistics;
+
+/** Timing of one frame, in seconds. */
+struct Frame_statistics_frame
+{
+	/** Time the frame started, from the epoch. */
+	double start_seconds;
+	/** Building changed graphics and issuing OpenGL calls for the scene. */
+	double render_seconds;
+	/** Waiting for OpenGL to complete the drawing. */
+	double finish_seconds;
+	double swap_seconds;
+	/** Points, lines and triangles drawn, or -1 if not known. */
+	long primitives;
+};
+
+struct Frame_statistics *CREATE(Frame_statistics)(void);
+
+int DESTROY(Frame_statistics)(struct Frame_statistics **statistics_address);
+
+/**
+ * Records <frame>, replacing the oldest once the window is full, and writes it
+ * to the log file if one is set.
+ */
+int Frame_statistics_add_frame(struct Frame_statistics *statistics,
+	const struct Frame_statistics_frame *frame);
+
+/**
+ * Forgets all recorded frames.
+ */
+int Frame_statistics_reset(struct Frame_statistics *statistics);
+
+/**
+ * Sets a CSV file each frame is appended to, labelled with <pane>. The file is
+ * not owned by <statistics> and must stay open until cleared with NULL.
+ */
+int Frame_statistics_set_log_file(struct Frame_statistics *statistics,
+	FILE *log_file, int pane);
+
+/**
+ * Writes the column headings matching lines logged by
+ * Frame_statistics_add_frame to <log_file>.
+ */
+int Frame_statistics_write_log_header(FILE *log_file);
+
+/**
+ * Lists the number of frames recorded, the frame rate and the mean, 95th
+ * percentile and maximum of each part of the frame time to the command window.
+ */
+int Frame_statistics_list(struct Frame_statistics *statistics);
+
+/**
+ * Writes a one line summary of the frame rate, mean frame time and primitives
+ * into <text>, for continuous display.
+ */
+int Frame_statistics_get_summary(struct Frame_statistics *statistics,
+	char *text, int text_size);
+
+#endif /* !defined (FRAME_STATISTICS_H) */
@@ -39,6 +39,7 @@ interest and set scene_viewer values directly.
 #include "general/photogrammetry.h"
 #include "graphics/colour.h"
 #include "graphics/graphics.h"
+#include "graphics/graphics_library.h"
 #include "graphics/graphics_window.h"
 #include "graphics/graphics_window_private.hpp"
 #if defined (WX_USER_INTERFACE)
@@ -105,6 +106,8 @@ interest and set scene_viewer values directly.
 #include "graphics/light_app.h"
 #include "three_d_drawing/graphics_buffer_app.h"
 #include "graphics/scene_viewer_app.h"
+#include "graphics/frame_statistics.h"
+#include "user_interface/event_dispatcher.h"
 #include "region/cmiss_region_chooser_wx.hpp"
 /*
 Module constants
@@ -191,6 +194,12 @@ Contains information for a graphics window.
 	int current_pane;
 	int antialias_mode;
 	int perturb_lines;
+	/* record frame statistics in each pane, optionally logging to a CSV file
+		 and showing a summary in the status bar */
+	int frame_statistics_flag;
+	FILE *frame_statistics_file;
+	int frame_statistics_hud_flag;
+	struct Event_dispatcher_timeout_callback *frame_statistics_hud_timeout;
 	enum Scene_viewer_input_mode input_mode;
 	enum cmzn_sceneviewer_blending_mode blending_mode;
 	double depth_of_field;
@@ -2414,6 +2423,178 @@ Sets if the <graphics_window> perturbs lines or not, using <perturb_lines>
 	return (return_code);
 } /* Graphics_window_set_perturb_lines */
 
+int Graphics_window_set_frame_statistics(struct Graphics_window *graphics_window,
+	int frame_statistics_flag, const char *file_name)
+{
+	if (!(graphics_window && graphics_window->scene_viewer_array))
+	{
+		display_message(ERROR_MESSAGE,
+			"Graphics_window_set_frame_statistics.  Invalid argument(s)");
+		return 0;
+	}
+	int return_code = 1;
+	if (file_name || (!frame_statistics_flag))
+	{
+		/* stop panes logging before the file is closed */
+		for (int pane_no = 0; pane_no < graphics_window->number_of_scene_viewers; pane_no++)
+		{
+			Frame_statistics_set_log_file(Scene_viewer_app_get_frame_statistics(
+				graphics_window->scene_viewer_array[pane_no]), (FILE *)NULL, 0);
+		}
+		if (graphics_window->frame_statistics_file)
+		{
+			fclose(graphics_window->frame_statistics_file);
+			graphics_window->frame_statistics_file = (FILE *)NULL;
+		}
+	}
+	if (file_name && frame_statistics_flag)
+	{
+		graphics_window->frame_statistics_file = fopen(file_name, "w");
+		if (graphics_window->frame_statistics_file)
+		{
+			Frame_statistics_write_log_header(graphics_window->frame_statistics_file);
+		}
+		else
+		{
+			display_message(ERROR_MESSAGE, "Could not open file %s for writing", file_name);
+			return_code = 0;
+		}
+	}
+	graphics_window->frame_statistics_flag = frame_statistics_flag ? 1 : 0;
+	for (int pane_no = 0; pane_no < graphics_window->number_of_scene_viewers; pane_no++)
+	{
+		struct Scene_viewer_app *scene_viewer = graphics_window->scene_viewer_array[pane_no];
+		Scene_viewer_app_set_frame_statistics(scene_viewer, frame_statistics_flag);
+		Frame_statistics_set_log_file(Scene_viewer_app_get_frame_statistics(scene_viewer),
+			graphics_window->frame_statistics_file, pane_no + 1);
+	}
+	return (return_code);
+}
+
+#if defined (WX_USER_INTERFACE)
+static int Graphics_window_frame_statistics_hud_timeout(void *graphics_window_void)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Shows a summary of the frame statistics of each pane in the status bar of the
+graphics window and schedules the next update.
+==============================================================================*/
+{
+	struct Graphics_window *graphics_window =
+		(struct Graphics_window *)graphics_window_void;
+	/* one-shot timeout is destroyed by the event dispatcher after this */
+	graphics_window->frame_statistics_hud_timeout =
+		(struct Event_dispatcher_timeout_callback *)NULL;
+	if (graphics_window->frame_statistics_hud_flag &&
+		graphics_window->GraphicsWindowTitle)
+	{
+		std::string status;
+		char summary[128];
+		for (int pane_no = 0; pane_no < graphics_window->number_of_scene_viewers; pane_no++)
+		{
+			if (Frame_statistics_get_summary(Scene_viewer_app_get_frame_statistics(
+				graphics_window->scene_viewer_array[pane_no]), summary, sizeof(summary)))
+			{
+				if (1 < graphics_window->number_of_scene_viewers)
+				{
+					char pane_text[32];
+					sprintf(pane_text, "%spane %d: ", status.empty() ? "" : "   ", pane_no + 1);
+					status += pane_text;
+				}
+				status += summary;
+			}
+		}
+		graphics_window->GraphicsWindowTitle->SetStatusText(
+			wxString::FromAscii(status.c_str()));
+		/* half a second between updates */
+		graphics_window->frame_statistics_hud_timeout = Event_dispatcher_add_timeout_callback(
+			User_interface_get_event_dispatcher(graphics_window->user_interface),
+			0, 500000000, Graphics_window_frame_statistics_hud_timeout, graphics_window_void);
+	}
+	return 1;
+} /* Graphics_window_frame_statistics_hud_timeout */
+
+static int Graphics_window_set_frame_statistics_hud(
+	struct Graphics_window *graphics_window, int hud_flag)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Shows or hides a status bar along the bottom of the <graphics_window> giving
+the frame rate, mean frame time and primitives drawn in each pane, updated
+twice a second. Showing it turns frame statistics on.
+==============================================================================*/
+{
+	if (!(graphics_window && graphics_window->GraphicsWindowTitle))
+	{
+		display_message(ERROR_MESSAGE,
+			"Graphics_window_set_frame_statistics_hud.  Invalid argument(s)");
+		return 0;
+	}
+	wxFrame *frame = graphics_window->GraphicsWindowTitle;
+	graphics_window->frame_statistics_hud_flag = hud_flag ? 1 : 0;
+	if (hud_flag)
+	{
+		if (!graphics_window->frame_statistics_flag)
+		{
+			Graphics_window_set_frame_statistics(graphics_window, 1, (const char *)NULL);
+		}
+		if (!frame->GetStatusBar())
+		{
+			frame->CreateStatusBar();
+		}
+		if (!graphics_window->frame_statistics_hud_timeout)
+		{
+			Graphics_window_frame_statistics_hud_timeout((void *)graphics_window);
+		}
+	}
+	else
+	{
+		if (graphics_window->frame_statistics_hud_timeout)
+		{
+			Event_dispatcher_remove_timeout_callback(
+				User_interface_get_event_dispatcher(graphics_window->user_interface),
+				graphics_window->frame_statistics_hud_timeout);
+			graphics_window->frame_statistics_hud_timeout =
+				(struct Event_dispatcher_timeout_callback *)NULL;
+		}
+		wxStatusBar *status_bar = frame->GetStatusBar();
+		if (status_bar)
+		{
+			frame->SetStatusBar((wxStatusBar *)NULL);
+			status_bar->Destroy();
+		}
+	}
+	frame->Layout();
+	return 1;
+} /* Graphics_window_set_frame_statistics_hud */
+#endif /* defined (WX_USER_INTERFACE) */
+
+static int Graphics_window_get_on_off_flag(const char *value,
+	const char *option_name, int *flag_address)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Sets <*flag_address> to 1 if <value> is "on" or 0 if it is "off". Otherwise
+reports that <option_name> must be on or off and returns 0.
+==============================================================================*/
+{
+	if (value && fuzzy_string_compare(value, "on"))
+	{
+		*flag_address = 1;
+		return 1;
+	}
+	if (value && fuzzy_string_compare(value, "off"))
+	{
+		*flag_address = 0;
+		return 1;
+	}
+	display_message(ERROR_MESSAGE, "%s must be on or off", option_name);
+	return 0;
+} /* Graphics_window_get_on_off_flag */
+
 int Graphics_window_set_blending_mode(struct Graphics_window *graphics_window,
 	enum cmzn_sceneviewer_blending_mode blending_mode)
 /*******************************************************************************
@@ -2459,12 +2640,13 @@ DESCRIPTION :
 Parser commands for setting simple parameters applicable to the whole <window>.
 ==============================================================================*/
 {
-	char fast_transparency_flag,slow_transparency_flag;
+	char fast_transparency_flag,*hud_string,slow_transparency_flag,
+		*statistics_file_name,*statistics_string;
 	const char *blending_mode_string,**valid_strings;
 	double depth_of_field, focal_depth, std_view_angle;
 	enum cmzn_sceneviewer_blending_mode blending_mode;
 	enum cmzn_sceneviewer_transparency_mode transparency_mode;
-	int antialias_mode,current_pane,i,number_of_tools,
+	int antialias_mode,current_pane,frame_statistics_flag,hud_flag,i,number_of_tools,
 		number_of_valid_strings,order_independent_transparency,pane_no,
 		perturb_lines,redraw,return_code,transparency_layers = 0;
 	struct Graphics_window *graphics_window;
@@ -2499,6 +2681,8 @@ Parser commands for setting simple parameters applicable to the whole <window>.
 					interactive_tool=graphics_window->interactive_tool;
 					antialias_mode=graphics_window->antialias_mode;
 					perturb_lines=graphics_window->perturb_lines;
+					frame_statistics_flag=graphics_window->frame_statistics_flag;
+					hud_flag=graphics_window->frame_statistics_hud_flag;
 					blending_mode=graphics_window->blending_mode;
 				}
 				else
@@ -2510,11 +2694,16 @@ Parser commands for setting simple parameters applicable to the whole <window>.
 					interactive_tool=(struct Interactive_tool *)NULL;
 					antialias_mode=0;
 					perturb_lines=0;
+					frame_statistics_flag=0;
+					hud_flag=0;
 					blending_mode = CMZN_SCENEVIEWER_BLENDING_MODE_NORMAL;
 				}
 				fast_transparency_flag = 0;
 				slow_transparency_flag = 0;
 				order_independent_transparency = 0;
+				hud_string = 0;
+				statistics_file_name = 0;
+				statistics_string = 0;
 #if defined (WX_USER_INTERFACE)
 				hide_time_editor_flag=0;
 				show_time_editor_flag=0;
@@ -2546,6 +2735,11 @@ Parser commands for setting simple parameters applicable to the whole <window>.
 				/* focal_depth */
 				Option_table_add_entry(option_table,"focal_depth",
 					&focal_depth,(void *)NULL,set_double);
+#if defined (WX_USER_INTERFACE)
+				/* hud on|off */
+				Option_table_add_string_entry(option_table,"hud",
+					&hud_string," on|off");
+#endif /* defined (WX_USER_INTERFACE) */
 				/* transform|other tools. tool_names not deallocated until later */
 				const char *tool_name = 0;
 				char **tool_names = interactive_tool_manager_get_tool_names(
@@ -2557,6 +2751,12 @@ Parser commands for setting simple parameters applicable to the whole <window>.
 				/* perturb_lines|normal_lines */
 				Option_table_add_switch(option_table,"perturb_lines","normal_lines",
 					&perturb_lines);
+				/* statistics on|off */
+				Option_table_add_string_entry(option_table,"statistics",
+					&statistics_string," on|off");
+				/* statistics_file */
+				Option_table_add_string_entry(option_table,"statistics_file",
+					&statistics_file_name," FILE_NAME");
 				/* std_view_angle */
 				Option_table_add_entry(option_table,"std_view_angle",
 					&std_view_angle,(void *)NULL,set_double);
@@ -2608,6 +2808,21 @@ Parser commands for setting simple parameters applicable to the whole <window>.
 						STRING_TO_ENUMERATOR(cmzn_sceneviewer_blending_mode)(
 							blending_mode_string, &blending_mode);
 					}
+					if (statistics_string && !Graphics_window_get_on_off_flag(
+						statistics_string, "statistics", &frame_statistics_flag))
+					{
+						return_code = 0;
+					}
+					if (hud_string && !Graphics_window_get_on_off_flag(
+						hud_string, "hud", &hud_flag))
+					{
+						return_code = 0;
+					}
+					if (statistics_file_name && (!statistics_string))
+					{
+						/* naming a log file turns statistics on */
+						frame_statistics_flag = 1;
+					}
 					if (return_code && graphics_window)
 					{
 						redraw=0;
@@ -2683,6 +2898,24 @@ Parser commands for setting simple parameters applicable to the whole <window>.
 							Graphics_window_set_perturb_lines(graphics_window,perturb_lines);
 							redraw=1;
 						}
+						if ((frame_statistics_flag != graphics_window->frame_statistics_flag) ||
+							statistics_file_name)
+						{
+							Graphics_window_set_frame_statistics(graphics_window,
+								frame_statistics_flag, statistics_file_name);
+						}
+#if defined (WX_USER_INTERFACE)
+						if (hud_flag != graphics_window->frame_statistics_hud_flag)
+						{
+							Graphics_window_set_frame_statistics_hud(graphics_window, hud_flag);
+						}
+						else if (graphics_window->frame_statistics_hud_flag &&
+							(!graphics_window->frame_statistics_flag))
+						{
+							/* statistics turned off under the status bar */
+							Graphics_window_set_frame_statistics_hud(graphics_window, 0);
+						}
+#endif /* defined (WX_USER_INTERFACE) */
 #if defined (WX_USER_INTERFACE)
 						if (show_time_editor_flag || hide_time_editor_flag)
 						{
@@ -2755,6 +2988,18 @@ Parser commands for setting simple parameters applicable to the whole <window>.
 					}
 					DEALLOCATE(tool_names);
 				}
+				if (hud_string)
+				{
+					DEALLOCATE(hud_string);
+				}
+				if (statistics_file_name)
+				{
+					DEALLOCATE(statistics_file_name);
+				}
+				if (statistics_string)
+				{
+					DEALLOCATE(statistics_string);
+				}
 				DESTROY(Option_table)(&option_table);
 			}
 			else
@@ -3228,6 +3473,11 @@ it.
 			window->current_pane=0;
 			window->antialias_mode=0;
 			window->perturb_lines=0;
+			window->frame_statistics_flag=0;
+			window->frame_statistics_file=(FILE *)NULL;
+			window->frame_statistics_hud_flag=0;
+			window->frame_statistics_hud_timeout=
+				(struct Event_dispatcher_timeout_callback *)NULL;
 			window->blending_mode = CMZN_SCENEVIEWER_BLENDING_MODE_NORMAL;
 			window->depth_of_field=0.0;
 			window->focal_depth=0.0;
@@ -3929,6 +4179,12 @@ Graphics_window_destroy_CB.
 		{
 			cmzn_scenefiltermodule_destroy(&window->filter_module);
 		}
+		if (window->frame_statistics_hud_timeout)
+		{
+			Event_dispatcher_remove_timeout_callback(
+				User_interface_get_event_dispatcher(window->user_interface),
+				window->frame_statistics_hud_timeout);
+		}
 #if defined (WX_USER_INTERFACE)
 		if (window->interactive_tool_manager)
 		{
@@ -3972,6 +4228,11 @@ Graphics_window_destroy_CB.
 			 window->wx_graphics_window = NULL;
 		}
 #endif /* !defined (WX_USER_INTERFACE) */
+		/* scene viewers logging to it have been destroyed */
+		if (window->frame_statistics_file)
+		{
+			fclose(window->frame_statistics_file);
+		}
 		DEALLOCATE(window->name);
 		DEALLOCATE(*graphics_window_address);
 		return_code=1;
@@ -4496,6 +4757,11 @@ Sets the layout mode in effect on the <window>.
 							perturb_lines = cmzn_sceneviewer_get_perturb_lines_flag(first_sceneviewer);
 							cmzn_sceneviewer_set_perturb_lines_flag(pane_sceneviewer,
 								0 != perturb_lines);
+							Scene_viewer_app_set_frame_statistics(window->scene_viewer_array[pane_no],
+								window->frame_statistics_flag);
+							Frame_statistics_set_log_file(Scene_viewer_app_get_frame_statistics(
+								window->scene_viewer_array[pane_no]), window->frame_statistics_file,
+								pane_no + 1);
 							cmzn_sceneviewer_set_lighting_local_viewer(pane_sceneviewer,
 								cmzn_sceneviewer_is_lighting_local_viewer(first_sceneviewer));
 							cmzn_sceneviewer_set_lighting_two_sided(pane_sceneviewer,
@@ -5382,368 +5648,990 @@ the pixels out of the backbuffer before the frames are swapped.
 	return (return_code);
 } /* Graphics_window_update_now_without_swapbuffers */
 
-int Graphics_window_get_frame_pixels(struct Graphics_window *window,
-	enum Texture_storage_type storage, int *width, int *height,
-	int preferred_antialias, int preferred_transparency_layers,
-	unsigned char **frame_data, int force_onscreen)
+/* OpenGL 2.1 pixel pack buffers let a tile be read back while the next is
+	 drawn; function names need GLEW or the GL prototypes */
+#if defined (OPENGL_API) && defined (GL_PIXEL_PACK_BUFFER) && \
+	(defined (GLEW_VERSION_2_1) || defined (GL_GLEXT_PROTOTYPES))
+#define GRAPHICS_WINDOW_USE_PIXEL_PACK_BUFFERS
+#endif
+
+#define PANE_BORDER (2)
+
+struct Graphics_window_tiling
 /*******************************************************************************
-LAST MODIFIED : 18 September 2002
+LAST MODIFIED : 16 October 2026
 
 DESCRIPTION :
-Returns the contents of the graphics window as pixels.  <width> and <height>
-will be respected if the window is drawn offscreen and they are non zero,
-otherwise they are set in accordance with current size of the graphics window.
-If <preferred_antialias> or <preferred_transparency_layers> are non zero then they
-attempt to override the default values for just this call.
-If <force_onscreen> is non zero then the pixels will always be grabbed from the
-graphics window on screen.
+Layout of the panes and tiles drawn offscreen to make a frame larger than the
+graphics window. Each tile is the size of the window divided between the panes.
 ==============================================================================*/
 {
-	int frame_width, frame_height, number_of_components, return_code, antialias;
-	double bottom = 0.0, fraction_across, fraction_down, left,
-		NDC_left = 0.0, NDC_top = 0.0, NDC_width = 0.0, NDC_height = 0.0,
-		original_NDC_left, original_NDC_top, original_NDC_width, original_NDC_height,
-		original_left, original_right, original_bottom, original_top,
-		original_near_plane, original_far_plane, right, top = 0.0,
-		viewport_left, viewport_top = 0.0, viewport_pixels_per_x = 0.0, viewport_pixels_per_y = 0.0,
-		original_viewport_left, original_viewport_top,
-		original_viewport_pixels_per_x, original_viewport_pixels_per_y,
-		real_left, real_right, real_bottom, real_top,
-		scaled_NDC_width,scaled_NDC_height ;
-	int i, j, number_of_panes = 0, pane = 0,
-		pane_i, pane_j, pane_width = 0, pane_height = 0, panes_across = 0, panes_down = 0,
-		patch_width, patch_height,
-		tile_height, tile_width, tiles_across, tiles_down, panel_width, panel_height;
-#if defined (OPENGL_API) && defined (USE_MSAA) && defined (WX_USER_INTERFACE)
-	int multisample_framebuffer_flag = 0;
-#endif
-	struct Graphics_buffer_app *offscreen_buffer;
-	struct Scene_viewer_app *scene_viewer;
-#if defined (SGI)
-/* The Octane can only handle 1024 */
-#define PBUFFER_MAX (1024)
-#else
-#define PBUFFER_MAX (2048)
-#endif /* defined (SGI) */
+	int frame_width, frame_height, panel_width, panel_height;
+	int number_of_panes, panes_across, panes_down, pane_width, pane_height;
+	int tile_width, tile_height, tiles_across, tiles_down;
+	double fraction_across, fraction_down, frame_split_ration;
+}; /* struct Graphics_window_tiling */
 
-	ENTER(Graphics_window_get_frame_pixels);
-	if (window && width && height)
+struct Graphics_window_tile_reader
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Reads tiles back from the current graphics buffer and passes them to a tile
+function. With pixel pack buffers, reading uses two buffers in turn: each
+tile's transfer is started and flushed, then the previous tile is passed on
+while it runs, and is only mapped after the next tile has been drawn.
+==============================================================================*/
+{
+	enum Texture_storage_type storage;
+	int number_of_components;
+	Graphics_window_frame_tile_function *tile_function;
+	void *user_data;
+	/* tile sized buffer for synchronous reads */
+	unsigned char *pixels;
+#if defined (OPENGL_API)
+	/* pixel store state of the caller, restored at the end */
+	GLint pack_alignment, pack_row_length, pack_skip_rows, pack_skip_pixels;
+#endif /* defined (OPENGL_API) */
+#if defined (GRAPHICS_WINDOW_USE_PIXEL_PACK_BUFFERS)
+	GLint pack_buffer_binding;
+	int use_pixel_pack_buffers;
+	GLenum format;
+	GLuint pixel_pack_buffers[2];
+	int next_buffer;
+	/* position of tile still in the other buffer, if pending */
+	int pending, pending_left, pending_bottom, pending_width, pending_height;
+#endif /* defined (GRAPHICS_WINDOW_USE_PIXEL_PACK_BUFFERS) */
+}; /* struct Graphics_window_tile_reader */
+
+#if defined (GRAPHICS_WINDOW_USE_PIXEL_PACK_BUFFERS)
+static int Graphics_window_pixel_pack_buffers_available(void)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Returns true if the current OpenGL context is at least version 2.1.
+==============================================================================*/
+{
+	int return_code;
+
+	return_code = 0;
+#if defined (GLEW_VERSION_2_1)
+	if (GLEW_VERSION_2_1)
 	{
-		// force complete build of all graphics in scene for image output, otherwise may get only incremental output
-		cmzn_scenefilter_id filter = cmzn_sceneviewer_get_scenefilter((window->scene_viewer_array[0]->core_scene_viewer));
-		build_Scene(window->scene, filter);
-		cmzn_scenefilter_destroy(&filter);
+		return_code = 1;
+	}
+#else /* defined (GLEW_VERSION_2_1) */
+	const char *version = (const char *)glGetString(GL_VERSION);
+	int major_version, minor_version;
+	if (version && (2 == sscanf(version, "%d.%d", &major_version, &minor_version)))
+	{
+		return_code = (major_version > 2) ||
+			((2 == major_version) && (minor_version >= 1));
+	}
+#endif /* defined (GLEW_VERSION_2_1) */
+
+	return (return_code);
+} /* Graphics_window_pixel_pack_buffers_available */
+#endif /* defined (GRAPHICS_WINDOW_USE_PIXEL_PACK_BUFFERS) */
+
+static int Graphics_window_tile_reader_begin(
+	struct Graphics_window_tile_reader *reader, enum Texture_storage_type storage,
+	int tile_width, int tile_height,
+	Graphics_window_frame_tile_function *tile_function, void *user_data)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
 
-		double frame_split_ration = 1.0;
-		Graphics_window_get_viewing_area_size(window, &panel_width,
-			&panel_height);
-		antialias = preferred_antialias;
-		if (antialias == -1)
+DESCRIPTION :
+Prepares <reader> to read tiles of up to <tile_width> by <tile_height> pixels
+from the current graphics buffer. Pixel pack buffers are used if the OpenGL
+version supports them and <storage> is read directly by glReadPixels. Saves the
+pixel pack state for Graphics_window_tile_reader_end to restore.
+==============================================================================*/
+{
+	int return_code;
+	size_t tile_size;
+
+	ENTER(Graphics_window_tile_reader_begin);
+	reader->storage = storage;
+	reader->number_of_components =
+		Texture_storage_type_get_number_of_components(storage);
+	reader->tile_function = tile_function;
+	reader->user_data = user_data;
+	reader->pixels = (unsigned char *)NULL;
+	tile_size = (size_t)tile_width*(size_t)tile_height*
+		(size_t)reader->number_of_components;
+	return_code = 1;
+#if defined (OPENGL_API)
+	glGetIntegerv(GL_PACK_ALIGNMENT, &reader->pack_alignment);
+	glGetIntegerv(GL_PACK_ROW_LENGTH, &reader->pack_row_length);
+	glGetIntegerv(GL_PACK_SKIP_ROWS, &reader->pack_skip_rows);
+	glGetIntegerv(GL_PACK_SKIP_PIXELS, &reader->pack_skip_pixels);
+#endif /* defined (OPENGL_API) */
+#if defined (GRAPHICS_WINDOW_USE_PIXEL_PACK_BUFFERS)
+	reader->pack_buffer_binding = 0;
+	reader->use_pixel_pack_buffers = 0;
+	reader->next_buffer = 0;
+	reader->pending = 0;
+	reader->format = GL_RGBA;
+	switch (storage)
+	{
+		case TEXTURE_LUMINANCE:
+		{
+			reader->format = GL_LUMINANCE;
+			reader->use_pixel_pack_buffers = 1;
+		} break;
+		case TEXTURE_LUMINANCE_ALPHA:
 		{
-			antialias = window->antialias_mode;
-		}
-		if ((*width) && (*height))
+			reader->format = GL_LUMINANCE_ALPHA;
+			reader->use_pixel_pack_buffers = 1;
+		} break;
+		case TEXTURE_RGB:
+		{
+			reader->format = GL_RGB;
+			reader->use_pixel_pack_buffers = 1;
+		} break;
+		case TEXTURE_RGBA:
+		{
+			reader->format = GL_RGBA;
+			reader->use_pixel_pack_buffers = 1;
+		} break;
+		default:
+		{
+			/* other storage types are converted by Graphics_library_read_pixels */
+		} break;
+	}
+	if (reader->use_pixel_pack_buffers &&
+		Graphics_window_pixel_pack_buffers_available())
+	{
+		glGetIntegerv(GL_PIXEL_PACK_BUFFER_BINDING, &reader->pack_buffer_binding);
+		glPixelStorei(GL_PACK_ALIGNMENT, 1);
+		glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+		glPixelStorei(GL_PACK_SKIP_ROWS, 0);
+		glPixelStorei(GL_PACK_SKIP_PIXELS, 0);
+		glGenBuffers(2, reader->pixel_pack_buffers);
+		for (int i = 0; i < 2; i++)
 		{
-			frame_width = *width;
-			frame_height = *height;
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, reader->pixel_pack_buffers[i]);
+			glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)tile_size, NULL,
+				GL_STREAM_READ);
 		}
-		else
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		if (GL_NO_ERROR != glGetError())
 		{
-			/* Only use the window size if either dimension is zero */
-			frame_width = panel_width;
-			frame_height = panel_height;
-			*width = frame_width;
-			*height = frame_height;
+			glDeleteBuffers(2, reader->pixel_pack_buffers);
+			reader->use_pixel_pack_buffers = 0;
 		}
-		/* If working offscreen try and allocate as large an area as possible */
-		if (!force_onscreen)
+	}
+	else
+	{
+		reader->use_pixel_pack_buffers = 0;
+	}
+	if (!reader->use_pixel_pack_buffers)
+#endif /* defined (GRAPHICS_WINDOW_USE_PIXEL_PACK_BUFFERS) */
+	{
+		if (!ALLOCATE(reader->pixels, unsigned char, tile_size))
 		{
-			offscreen_buffer = (struct Graphics_buffer_app *)NULL;
-#define PANE_BORDER (2)
-			switch (window->layout_mode)
-			{
-				case GRAPHICS_WINDOW_LAYOUT_SIMPLE:
-				case GRAPHICS_WINDOW_LAYOUT_2D:
-				{
-					number_of_panes = 1;
-					panes_across = 1;
-					panes_down = 1;
-					pane_width = frame_width;
-					pane_height = frame_height;
-				} break;
-				case GRAPHICS_WINDOW_LAYOUT_ORTHOGRAPHIC:
-				case GRAPHICS_WINDOW_LAYOUT_FREE_ORTHO:
-				{
-					number_of_panes = 4;
-					panes_across = 2;
-					panes_down = 2;
-					/* Reduce the pane_width by one pixel to leave a border */
-					pane_width = (frame_width - PANE_BORDER) / 2;
-					pane_height = (frame_height - PANE_BORDER) / 2;
-				} break;
-				case GRAPHICS_WINDOW_LAYOUT_FRONT_BACK:
-				case GRAPHICS_WINDOW_LAYOUT_FRONT_SIDE:
-				case GRAPHICS_WINDOW_LAYOUT_PSEUDO_3D:
-				case GRAPHICS_WINDOW_LAYOUT_TWO_FREE:
-				{
-					number_of_panes = 2;
-					panes_across = 2;
-					panes_down = 1;
-					/* Reduce the pane_width by one pixel to leave a border */
-					pane_width = (frame_width - PANE_BORDER) / 2;
-					pane_height = frame_height;
-					frame_split_ration = 2.0;
-				} break;
-				default:
-				{
-					display_message(ERROR_MESSAGE,
-						"Graphics_window_get_frame_pixels.  Unknown layout_mode");
-					return_code=0;
-				} break;
-			}
+			display_message(ERROR_MESSAGE,
+				"Graphics_window_tile_reader_begin.  Unable to allocate pixels");
+			return_code = 0;
+		}
+	}
+	LEAVE;
 
-			if (pane_width <= panel_width)
-			{
-				tile_width = pane_width/panes_across;
-				fraction_across = 1.0;
-				tiles_across = 1;
-			}
-			else
-			{
-				tile_width = panel_width/panes_across;
-				fraction_across = (double)pane_width / (double)tile_width;
-				tiles_across = (int)ceil(fraction_across);
-			}
-			if (pane_height <= panel_height)
-			{
-				tile_height = pane_height/panes_down;
-				fraction_down = 1.0;
-				tiles_down = 1;
-			}
-			else
-			{
-				tile_height = panel_height/panes_down;
-				fraction_down = (double)pane_height / (double)tile_height;
-				tiles_down = (int)ceil(fraction_down);
-			}
+	return (return_code);
+} /* Graphics_window_tile_reader_begin */
 
-			if (!(offscreen_buffer = create_Graphics_buffer_offscreen_from_buffer(
-				  tile_width, tile_height, /*buffer_to_match*/Scene_viewer_app_get_graphics_buffer(
-				  Graphics_window_get_Scene_viewer(window, 0)))))
-			{
-				force_onscreen = 1;
-			}
+#if defined (GRAPHICS_WINDOW_USE_PIXEL_PACK_BUFFERS)
+static int Graphics_window_tile_reader_pass_pending(
+	struct Graphics_window_tile_reader *reader)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Maps the pixel pack buffer holding the pending tile, the one not next to be
+read into, and passes it to the tile function. Its transfer was started before
+the tile last drawn, so it has normally finished and mapping does not wait.
+==============================================================================*/
+{
+	int return_code;
+	unsigned char *pixels;
+
+	ENTER(Graphics_window_tile_reader_pass_pending);
+	return_code = 1;
+	if (reader->pending)
+	{
+		reader->pending = 0;
+		glBindBuffer(GL_PIXEL_PACK_BUFFER,
+			reader->pixel_pack_buffers[1 - reader->next_buffer]);
+		pixels = (unsigned char *)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+		if (pixels)
+		{
+			return_code = (reader->tile_function)(reader->pending_left,
+				reader->pending_bottom, reader->pending_width, reader->pending_height,
+				pixels, reader->user_data);
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
 		}
-		if (!force_onscreen)
+		else
 		{
-			if (GRAPHICS_BUFFER_GL_EXT_FRAMEBUFFER_TYPE ==
-				Graphics_buffer_get_type(Graphics_buffer_app_get_core_buffer(offscreen_buffer)))
-			{
-				for (pane = 0 ; pane < number_of_panes ; pane++)
-				{
-					Scene_viewer_app_redraw_now(
-						Graphics_window_get_Scene_viewer(window,pane));
-				}
-			}
-			number_of_components =
-				Texture_storage_type_get_number_of_components(storage);
-			if (ALLOCATE(*frame_data, unsigned char,
-				number_of_components * (frame_width) * (frame_height)))
-			{
-				return_code = 1;
-				for (pane = 0 ; pane < number_of_panes ; pane++)
-				{
-					struct Graphics_buffer_app *current_buffer;
-					if (pane == 0)
-					{
-						current_buffer = offscreen_buffer;
-					}
-					else
-					{
-						current_buffer = create_Graphics_buffer_offscreen_from_buffer(
-							tile_width, tile_height, /*buffer_to_match*/Scene_viewer_app_get_graphics_buffer(
-							 Graphics_window_get_Scene_viewer(window, pane)));
-					}
-					if (current_buffer)
-					{
-						Graphics_buffer_app_make_current(current_buffer);
-						if (Graphics_buffer_get_type(Graphics_buffer_app_get_core_buffer(current_buffer)) ==
-							GRAPHICS_BUFFER_GL_EXT_FRAMEBUFFER_TYPE)
-						{
-							if (antialias > 1)
-							{
-		#if !defined (USE_MSAA)
-								display_message(WARNING_MESSAGE,
-									"Graphics_window_get_frame_pixels. Cmgui-wx does not write"
-									"image with anti-aliasing under offscreen mode at the moment.");
-		#else
-		#if defined (OPENGL_API) && defined (USE_MSAA)
-								multisample_framebuffer_flag =
-									Graphics_buffer_set_multisample_framebuffer(Graphics_buffer_app_get_core_buffer(current_buffer), antialias);
-		#endif
-		#endif
-							}
-						}
+			display_message(ERROR_MESSAGE,
+				"Graphics_window_tile_reader_pass_pending.  Could not map pixel buffer");
+			return_code = 0;
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	}
+	LEAVE;
 
-		#if defined (OPENGL_API)
-						if (number_of_panes > 1)
-						{
-							/* Clear the buffer as we are going to leave a border between panes */
-							glClearColor(0.0,0.0,0.0,0.);
-							glClear(GL_COLOR_BUFFER_BIT);
-						}
-		#endif /* defined (OPENGL_API) */
-						if ((tiles_across > 1) || (panes_across > 1))
-						{
-							glPixelStorei(GL_PACK_ROW_LENGTH, frame_width);
-						}
-						pane_i = pane % panes_across;
-						pane_j = pane / panes_across;
-						scene_viewer = Graphics_window_get_Scene_viewer(window,pane);
-						if ((tiles_across > 1) || (tiles_down > 1))
-						{
-							Scene_viewer_get_viewing_volume(scene_viewer->core_scene_viewer,
-								&original_left, &original_right, &original_bottom, &original_top,
-								&original_near_plane, &original_far_plane);
-							Scene_viewer_get_NDC_info(scene_viewer->core_scene_viewer,
-								&original_NDC_left, &original_NDC_top, &original_NDC_width, &original_NDC_height);
-							Scene_viewer_get_viewport_info(scene_viewer->core_scene_viewer,
-								&original_viewport_left, &original_viewport_top,
-								&original_viewport_pixels_per_x, &original_viewport_pixels_per_y);
-							Scene_viewer_get_viewing_volume_and_NDC_info_for_specified_size(scene_viewer->core_scene_viewer,
-									frame_width/frame_split_ration, frame_height, panel_width, panel_height, &real_left,
-								&real_right, &real_bottom, &real_top, &scaled_NDC_width, &scaled_NDC_height);
-							NDC_width = scaled_NDC_width / fraction_across;
-							NDC_height = scaled_NDC_height / fraction_down ;
-							viewport_pixels_per_x = original_viewport_pixels_per_x;
-							viewport_pixels_per_y = original_viewport_pixels_per_y;
-						}
-						for (j = 0 ; return_code && (j < tiles_down) ; j++)
-						{
-							if ((tiles_across > 1) || (tiles_down > 1))
-							{
-								bottom = real_bottom + (double)j * (real_top - real_bottom) / fraction_down;
-								top = real_bottom
-									+ (double)(j + 1) * (real_top - real_bottom) / fraction_down;
-								NDC_top = original_NDC_top + (double)j * original_NDC_height / fraction_down;
-								viewport_top = ((j + 1) * tile_height - pane_height) / viewport_pixels_per_y;
-							}
-							for (i = 0 ; return_code && (i < tiles_across) ; i++)
-							{
-								if ((tiles_across > 1) || (tiles_down > 1))
-								{
-									left = real_left + (double)i * (real_right - real_left) / fraction_across;
-									right = real_left +
-										(double)(i + 1) * (real_right - real_left) / fraction_across;
-									NDC_left = original_NDC_left + (double)i *
-										 original_NDC_width / fraction_across;
-									viewport_left = i * tile_width / viewport_pixels_per_x;
-									Scene_viewer_set_viewing_volume(scene_viewer->core_scene_viewer,
-										left, right, bottom, top,
-										original_near_plane, original_far_plane);
-									Scene_viewer_set_NDC_info(scene_viewer->core_scene_viewer,
-											NDC_left, NDC_top, NDC_width, NDC_height);
-									Scene_viewer_set_viewport_info(scene_viewer->core_scene_viewer,
-										viewport_left, viewport_top,
-										viewport_pixels_per_x, viewport_pixels_per_y);
-								}
-								if (Graphics_buffer_get_type(Graphics_buffer_app_get_core_buffer(current_buffer)) ==
-									GRAPHICS_BUFFER_GL_EXT_FRAMEBUFFER_TYPE )
-								{
-	#if !defined (USE_MSAA)
-									Scene_viewer_render_scene_in_viewport_with_overrides(scene_viewer->core_scene_viewer,
-										/*left*/0, /*bottom*/0, /*right*/tile_width, /*top*/tile_height,
-										/*preferred_antialias*/0, preferred_transparency_layers,
-										/*drawing_offscreen*/1);
-	#else
-									Scene_viewer_render_scene_in_viewport_with_overrides(scene_viewer->core_scene_viewer,
-										/*left*/0, /*bottom*/0, /*right*/tile_width, /*top*/tile_height,
-										antialias, preferred_transparency_layers,
-										/*drawing_offscreen*/1);
-	#endif
-								}
-								else
-								{
-									Scene_viewer_render_scene_in_viewport_with_overrides(scene_viewer->core_scene_viewer,
-										/*left*/0, /*bottom*/0, /*right*/tile_width, /*top*/tile_height,
-										antialias, preferred_transparency_layers,
-										/*drawing_offscreen*/1);
-								}
-								if (return_code)
-								{
-									if (i < tiles_across - 1)
-									{
-										patch_width = tile_width;
-									}
-									else
-									{
-										patch_width = pane_width - tile_width * (tiles_across - 1);
-									}
-									if (j < tiles_down - 1)
-									{
-										patch_height = tile_height;
-									}
-									else
-									{
-										patch_height = pane_height - tile_height * (tiles_down - 1);
-									}
+	return (return_code);
+} /* Graphics_window_tile_reader_pass_pending */
+#endif /* defined (GRAPHICS_WINDOW_USE_PIXEL_PACK_BUFFERS) */
 
-									if (Graphics_buffer_get_type(Graphics_buffer_app_get_core_buffer(current_buffer)) ==
-										GRAPHICS_BUFFER_GL_EXT_FRAMEBUFFER_TYPE)
-									{
-	#if defined (OPENGL_API) && defined (USE_MSAA) && defined (WX_USER_INTERFACE)
-										if (multisample_framebuffer_flag)
-										{
-											Graphics_buffer_blit_framebuffer(Graphics_buffer_app_get_core_buffer(current_buffer));
-										}
-	#endif
-									}
-									return_code=Graphics_library_read_pixels(*frame_data +
-										(i * tile_width + pane_i * (pane_width + PANE_BORDER) +
-											(j * tile_height + (panes_down - 1 - pane_j) * (pane_height + PANE_BORDER))
-											* frame_width) * number_of_components,
-										patch_width, patch_height, storage, /*front_buffer*/0);
-									if (Graphics_buffer_get_type(Graphics_buffer_app_get_core_buffer(current_buffer)) ==
-										GRAPHICS_BUFFER_GL_EXT_FRAMEBUFFER_TYPE)
-									{
-	#if defined (OPENGL_API) && defined (USE_MSAA) && defined (WX_USER_INTERFACE)
-										if (multisample_framebuffer_flag)
-										{
-											Graphics_buffer_reset_multisample_framebuffer(Graphics_buffer_app_get_core_buffer(current_buffer));
-										}
-	#endif
-									}
-								}
-							}
-						}
-						if (tiles_across > 1)
-						{
-							glPixelStorei(GL_PACK_ROW_LENGTH, 0);
-						}
-						if ((tiles_across > 1) || (tiles_down > 1))
-						{
-							Scene_viewer_set_viewing_volume(scene_viewer->core_scene_viewer,
-								original_left, original_right, original_bottom, original_top,
-								original_near_plane, original_far_plane);
-							Scene_viewer_set_NDC_info(scene_viewer->core_scene_viewer,
-								original_NDC_left, original_NDC_top, original_NDC_width, original_NDC_height);
-							Scene_viewer_set_viewport_info(scene_viewer->core_scene_viewer,
-								original_viewport_left, original_viewport_top,
-								original_viewport_pixels_per_x, original_viewport_pixels_per_y);
-						}
-						DESTROY(Graphics_buffer_app)(&current_buffer);
+static int Graphics_window_tile_reader_read(
+	struct Graphics_window_tile_reader *reader, int left, int bottom,
+	int width, int height)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Reads the bottom left <width> by <height> pixels of the current graphics buffer
+as the tile at <left>, <bottom> in the frame. With pixel pack buffers the read
+is only started and flushed to the GPU, and the previously read tile is passed
+to the tile function. The new tile is passed on in the next call, after the
+following tile has been drawn, so each transfer overlaps both passing on the
+previous tile and drawing the next one.
+==============================================================================*/
+{
+	int return_code;
+
+	ENTER(Graphics_window_tile_reader_read);
+#if defined (GRAPHICS_WINDOW_USE_PIXEL_PACK_BUFFERS)
+	if (reader->use_pixel_pack_buffers)
+	{
+		glBindBuffer(GL_PIXEL_PACK_BUFFER,
+			reader->pixel_pack_buffers[reader->next_buffer]);
+		glReadPixels(0, 0, width, height, reader->format, GL_UNSIGNED_BYTE,
+			/*offset*/(GLvoid *)0);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		/* submit the transfer now rather than with the next tile's drawing */
+		glFlush();
+		/* pass on the previous tile from the other buffer while this one is
+			 transferred */
+		return_code = Graphics_window_tile_reader_pass_pending(reader);
+		reader->next_buffer = 1 - reader->next_buffer;
+		reader->pending = 1;
+		reader->pending_left = left;
+		reader->pending_bottom = bottom;
+		reader->pending_width = width;
+		reader->pending_height = height;
+	}
+	else
+#endif /* defined (GRAPHICS_WINDOW_USE_PIXEL_PACK_BUFFERS) */
+	{
+		return_code = Graphics_library_read_pixels(reader->pixels, width, height,
+			reader->storage, /*front_buffer*/0);
+		if (return_code)
+		{
+			return_code = (reader->tile_function)(left, bottom, width, height,
+				reader->pixels, reader->user_data);
+		}
+	}
+	LEAVE;
+
+	return (return_code);
+} /* Graphics_window_tile_reader_read */
+
+static int Graphics_window_tile_reader_end(
+	struct Graphics_window_tile_reader *reader)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Passes on any tile still being read, frees the buffers of <reader> and restores
+the pixel pack state saved by Graphics_window_tile_reader_begin.
+==============================================================================*/
+{
+	int return_code;
+
+	ENTER(Graphics_window_tile_reader_end);
+	return_code = 1;
+#if defined (GRAPHICS_WINDOW_USE_PIXEL_PACK_BUFFERS)
+	if (reader->use_pixel_pack_buffers)
+	{
+		return_code = Graphics_window_tile_reader_pass_pending(reader);
+		glDeleteBuffers(2, reader->pixel_pack_buffers);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, (GLuint)reader->pack_buffer_binding);
+		reader->use_pixel_pack_buffers = 0;
+	}
+#endif /* defined (GRAPHICS_WINDOW_USE_PIXEL_PACK_BUFFERS) */
+#if defined (OPENGL_API)
+	glPixelStorei(GL_PACK_ALIGNMENT, reader->pack_alignment);
+	glPixelStorei(GL_PACK_ROW_LENGTH, reader->pack_row_length);
+	glPixelStorei(GL_PACK_SKIP_ROWS, reader->pack_skip_rows);
+	glPixelStorei(GL_PACK_SKIP_PIXELS, reader->pack_skip_pixels);
+#endif /* defined (OPENGL_API) */
+	if (reader->pixels)
+	{
+		DEALLOCATE(reader->pixels);
+	}
+	LEAVE;
+
+	return (return_code);
+} /* Graphics_window_tile_reader_end */
+
+static int Graphics_window_get_tiling(struct Graphics_window *window,
+	int frame_width, int frame_height, struct Graphics_window_tiling *tiling)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Works out how the panes of <window> are split into tiles the size of the window
+to draw a frame of <frame_width> by <frame_height> pixels offscreen.
+==============================================================================*/
+{
+	int return_code;
+
+	ENTER(Graphics_window_get_tiling);
+	return_code = 1;
+	tiling->frame_width = frame_width;
+	tiling->frame_height = frame_height;
+	Graphics_window_get_viewing_area_size(window, &tiling->panel_width,
+		&tiling->panel_height);
+	tiling->frame_split_ration = 1.0;
+	switch (window->layout_mode)
+	{
+		case GRAPHICS_WINDOW_LAYOUT_SIMPLE:
+		case GRAPHICS_WINDOW_LAYOUT_2D:
+		{
+			tiling->number_of_panes = 1;
+			tiling->panes_across = 1;
+			tiling->panes_down = 1;
+			tiling->pane_width = frame_width;
+			tiling->pane_height = frame_height;
+		} break;
+		case GRAPHICS_WINDOW_LAYOUT_ORTHOGRAPHIC:
+		case GRAPHICS_WINDOW_LAYOUT_FREE_ORTHO:
+		{
+			tiling->number_of_panes = 4;
+			tiling->panes_across = 2;
+			tiling->panes_down = 2;
+			/* Reduce the pane_width by one pixel to leave a border */
+			tiling->pane_width = (frame_width - PANE_BORDER) / 2;
+			tiling->pane_height = (frame_height - PANE_BORDER) / 2;
+		} break;
+		case GRAPHICS_WINDOW_LAYOUT_FRONT_BACK:
+		case GRAPHICS_WINDOW_LAYOUT_FRONT_SIDE:
+		case GRAPHICS_WINDOW_LAYOUT_PSEUDO_3D:
+		case GRAPHICS_WINDOW_LAYOUT_TWO_FREE:
+		{
+			tiling->number_of_panes = 2;
+			tiling->panes_across = 2;
+			tiling->panes_down = 1;
+			/* Reduce the pane_width by one pixel to leave a border */
+			tiling->pane_width = (frame_width - PANE_BORDER) / 2;
+			tiling->pane_height = frame_height;
+			tiling->frame_split_ration = 2.0;
+		} break;
+		default:
+		{
+			display_message(ERROR_MESSAGE,
+				"Graphics_window_get_tiling.  Unknown layout_mode");
+			return_code=0;
+		} break;
+	}
+	if (return_code)
+	{
+		if (tiling->pane_width <= tiling->panel_width)
+		{
+			tiling->tile_width = tiling->pane_width/tiling->panes_across;
+			tiling->fraction_across = 1.0;
+			tiling->tiles_across = 1;
+		}
+		else
+		{
+			tiling->tile_width = tiling->panel_width/tiling->panes_across;
+			tiling->fraction_across =
+				(double)tiling->pane_width / (double)tiling->tile_width;
+			tiling->tiles_across = (int)ceil(tiling->fraction_across);
+		}
+		if (tiling->pane_height <= tiling->panel_height)
+		{
+			tiling->tile_height = tiling->pane_height/tiling->panes_down;
+			tiling->fraction_down = 1.0;
+			tiling->tiles_down = 1;
+		}
+		else
+		{
+			tiling->tile_height = tiling->panel_height/tiling->panes_down;
+			tiling->fraction_down =
+				(double)tiling->pane_height / (double)tiling->tile_height;
+			tiling->tiles_down = (int)ceil(tiling->fraction_down);
+		}
+	}
+	LEAVE;
+
+	return (return_code);
+} /* Graphics_window_get_tiling */
+
+static int Graphics_window_render_tiles(struct Graphics_window *window,
+	struct Graphics_window_tiling *tiling,
+	struct Graphics_buffer_app **pane_buffers, enum Texture_storage_type storage,
+	int antialias, int preferred_transparency_layers,
+	Graphics_window_frame_tile_function *tile_function, void *user_data)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Draws each pane of <window> offscreen tile by tile as laid out in <tiling>,
+passing each tile to <tile_function>. Within a pane, tile rows are drawn from
+the top of the frame down and tiles from left to right. <pane_buffers> are the
+offscreen buffers for each pane, which are kept for reuse.
+==============================================================================*/
+{
+	double bottom = 0.0, left, NDC_left = 0.0, NDC_top = 0.0, NDC_width = 0.0,
+		NDC_height = 0.0, original_NDC_left = 0.0, original_NDC_top = 0.0,
+		original_NDC_width = 0.0, original_NDC_height = 0.0, original_left = 0.0,
+		original_right = 0.0, original_bottom = 0.0, original_top = 0.0,
+		original_near_plane = 0.0, original_far_plane = 0.0, right, top = 0.0,
+		viewport_left, viewport_top = 0.0, viewport_pixels_per_x = 0.0,
+		viewport_pixels_per_y = 0.0, original_viewport_left = 0.0,
+		original_viewport_top = 0.0, original_viewport_pixels_per_x = 0.0,
+		original_viewport_pixels_per_y = 0.0, real_left = 0.0, real_right = 0.0,
+		real_bottom = 0.0, real_top = 0.0, scaled_NDC_width, scaled_NDC_height;
+	int i, j, pane, pane_i, pane_j, patch_width, patch_height, return_code, tiled;
+#if defined (OPENGL_API) && defined (USE_MSAA) && defined (WX_USER_INTERFACE)
+	int multisample_framebuffer_flag = 0;
+#endif
+	struct Graphics_buffer_app *current_buffer;
+	struct Graphics_window_tile_reader reader;
+	struct Scene_viewer_app *scene_viewer;
+
+	ENTER(Graphics_window_render_tiles);
+	return_code = 1;
+	tiled = (tiling->tiles_across > 1) || (tiling->tiles_down > 1);
+	if (GRAPHICS_BUFFER_GL_EXT_FRAMEBUFFER_TYPE ==
+		Graphics_buffer_get_type(Graphics_buffer_app_get_core_buffer(pane_buffers[0])))
+	{
+		for (pane = 0 ; pane < tiling->number_of_panes ; pane++)
+		{
+			Scene_viewer_app_redraw_now(
+				Graphics_window_get_Scene_viewer(window,pane));
+		}
+	}
+	for (pane = 0 ; return_code && (pane < tiling->number_of_panes) ; pane++)
+	{
+		if (NULL != (current_buffer = pane_buffers[pane]))
+		{
+			Graphics_buffer_app_make_current(current_buffer);
+			if (Graphics_buffer_get_type(Graphics_buffer_app_get_core_buffer(current_buffer)) ==
+				GRAPHICS_BUFFER_GL_EXT_FRAMEBUFFER_TYPE)
+			{
+				if (antialias > 1)
+				{
+#if !defined (USE_MSAA)
+					display_message(WARNING_MESSAGE,
+						"Graphics_window_get_frame_pixels. Cmgui-wx does not write"
+						"image with anti-aliasing under offscreen mode at the moment.");
+#else
+#if defined (OPENGL_API) && defined (USE_MSAA)
+					multisample_framebuffer_flag =
+						Graphics_buffer_set_multisample_framebuffer(Graphics_buffer_app_get_core_buffer(current_buffer), antialias);
+#endif
+#endif
+				}
+			}
+#if defined (OPENGL_API)
+			if (tiling->number_of_panes > 1)
+			{
+				/* Clear the buffer as we are going to leave a border between panes */
+				glClearColor(0.0,0.0,0.0,0.);
+				glClear(GL_COLOR_BUFFER_BIT);
+			}
+#endif /* defined (OPENGL_API) */
+			pane_i = pane % tiling->panes_across;
+			pane_j = pane / tiling->panes_across;
+			scene_viewer = Graphics_window_get_Scene_viewer(window,pane);
+			if (tiled)
+			{
+				Scene_viewer_get_viewing_volume(scene_viewer->core_scene_viewer,
+					&original_left, &original_right, &original_bottom, &original_top,
+					&original_near_plane, &original_far_plane);
+				Scene_viewer_get_NDC_info(scene_viewer->core_scene_viewer,
+					&original_NDC_left, &original_NDC_top, &original_NDC_width, &original_NDC_height);
+				Scene_viewer_get_viewport_info(scene_viewer->core_scene_viewer,
+					&original_viewport_left, &original_viewport_top,
+					&original_viewport_pixels_per_x, &original_viewport_pixels_per_y);
+				Scene_viewer_get_viewing_volume_and_NDC_info_for_specified_size(scene_viewer->core_scene_viewer,
+					tiling->frame_width/tiling->frame_split_ration, tiling->frame_height,
+					tiling->panel_width, tiling->panel_height, &real_left,
+					&real_right, &real_bottom, &real_top, &scaled_NDC_width, &scaled_NDC_height);
+				NDC_width = scaled_NDC_width / tiling->fraction_across;
+				NDC_height = scaled_NDC_height / tiling->fraction_down ;
+				viewport_pixels_per_x = original_viewport_pixels_per_x;
+				viewport_pixels_per_y = original_viewport_pixels_per_y;
+			}
+			return_code = Graphics_window_tile_reader_begin(&reader, storage,
+				tiling->tile_width, tiling->tile_height, tile_function, user_data);
+			/* top row first so tiles can be written straight to file */
+			for (j = tiling->tiles_down - 1 ; return_code && (j >= 0) ; j--)
+			{
+				if (tiled)
+				{
+					bottom = real_bottom + (double)j * (real_top - real_bottom) / tiling->fraction_down;
+					top = real_bottom
+						+ (double)(j + 1) * (real_top - real_bottom) / tiling->fraction_down;
+					NDC_top = original_NDC_top + (double)j * original_NDC_height / tiling->fraction_down;
+					viewport_top = ((j + 1) * tiling->tile_height - tiling->pane_height) / viewport_pixels_per_y;
+				}
+				for (i = 0 ; return_code && (i < tiling->tiles_across) ; i++)
+				{
+					if (tiled)
+					{
+						left = real_left + (double)i * (real_right - real_left) / tiling->fraction_across;
+						right = real_left +
+							(double)(i + 1) * (real_right - real_left) / tiling->fraction_across;
+						NDC_left = original_NDC_left + (double)i *
+							 original_NDC_width / tiling->fraction_across;
+						viewport_left = i * tiling->tile_width / viewport_pixels_per_x;
+						Scene_viewer_set_viewing_volume(scene_viewer->core_scene_viewer,
+							left, right, bottom, top,
+							original_near_plane, original_far_plane);
+						Scene_viewer_set_NDC_info(scene_viewer->core_scene_viewer,
+								NDC_left, NDC_top, NDC_width, NDC_height);
+						Scene_viewer_set_viewport_info(scene_viewer->core_scene_viewer,
+							viewport_left, viewport_top,
+							viewport_pixels_per_x, viewport_pixels_per_y);
+					}
+					if (Graphics_buffer_get_type(Graphics_buffer_app_get_core_buffer(current_buffer)) ==
+						GRAPHICS_BUFFER_GL_EXT_FRAMEBUFFER_TYPE )
+					{
+#if !defined (USE_MSAA)
+						Scene_viewer_render_scene_in_viewport_with_overrides(scene_viewer->core_scene_viewer,
+							/*left*/0, /*bottom*/0, /*right*/tiling->tile_width, /*top*/tiling->tile_height,
+							/*preferred_antialias*/0, preferred_transparency_layers,
+							/*drawing_offscreen*/1);
+#else
+						Scene_viewer_render_scene_in_viewport_with_overrides(scene_viewer->core_scene_viewer,
+							/*left*/0, /*bottom*/0, /*right*/tiling->tile_width, /*top*/tiling->tile_height,
+							antialias, preferred_transparency_layers,
+							/*drawing_offscreen*/1);
+#endif
+					}
+					else
+					{
+						Scene_viewer_render_scene_in_viewport_with_overrides(scene_viewer->core_scene_viewer,
+							/*left*/0, /*bottom*/0, /*right*/tiling->tile_width, /*top*/tiling->tile_height,
+							antialias, preferred_transparency_layers,
+							/*drawing_offscreen*/1);
+					}
+					if (i < tiling->tiles_across - 1)
+					{
+						patch_width = tiling->tile_width;
+					}
+					else
+					{
+						patch_width = tiling->pane_width - tiling->tile_width * (tiling->tiles_across - 1);
+					}
+					if (j < tiling->tiles_down - 1)
+					{
+						patch_height = tiling->tile_height;
+					}
+					else
+					{
+						patch_height = tiling->pane_height - tiling->tile_height * (tiling->tiles_down - 1);
+					}
+#if defined (OPENGL_API) && defined (USE_MSAA) && defined (WX_USER_INTERFACE)
+					if ((Graphics_buffer_get_type(Graphics_buffer_app_get_core_buffer(current_buffer)) ==
+						GRAPHICS_BUFFER_GL_EXT_FRAMEBUFFER_TYPE) && multisample_framebuffer_flag)
+					{
+						Graphics_buffer_blit_framebuffer(Graphics_buffer_app_get_core_buffer(current_buffer));
+					}
+#endif
+					return_code = Graphics_window_tile_reader_read(&reader,
+						i * tiling->tile_width + pane_i * (tiling->pane_width + PANE_BORDER),
+						j * tiling->tile_height +
+							(tiling->panes_down - 1 - pane_j) * (tiling->pane_height + PANE_BORDER),
+						patch_width, patch_height);
+#if defined (OPENGL_API) && defined (USE_MSAA) && defined (WX_USER_INTERFACE)
+					if ((Graphics_buffer_get_type(Graphics_buffer_app_get_core_buffer(current_buffer)) ==
+						GRAPHICS_BUFFER_GL_EXT_FRAMEBUFFER_TYPE) && multisample_framebuffer_flag)
+					{
+						Graphics_buffer_reset_multisample_framebuffer(Graphics_buffer_app_get_core_buffer(current_buffer));
+					}
+#endif
+				}
+			}
+			if (!Graphics_window_tile_reader_end(&reader))
+			{
+				return_code = 0;
+			}
+			if (tiled)
+			{
+				Scene_viewer_set_viewing_volume(scene_viewer->core_scene_viewer,
+					original_left, original_right, original_bottom, original_top,
+					original_near_plane, original_far_plane);
+				Scene_viewer_set_NDC_info(scene_viewer->core_scene_viewer,
+					original_NDC_left, original_NDC_top, original_NDC_width, original_NDC_height);
+				Scene_viewer_set_viewport_info(scene_viewer->core_scene_viewer,
+					original_viewport_left, original_viewport_top,
+					original_viewport_pixels_per_x, original_viewport_pixels_per_y);
+			}
+		}
+	}
+	LEAVE;
+
+	return (return_code);
+} /* Graphics_window_render_tiles */
+
+struct Graphics_window_frame_composite_data
+{
+	unsigned char *frame_data;
+	int frame_width, number_of_components;
+};
+
+static int Graphics_window_frame_composite_tile(int left, int bottom,
+	int width, int height, unsigned char *pixels, void *composite_data_void)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Graphics_window_frame_tile_function copying a tile into the whole frame.
+==============================================================================*/
+{
+	int row;
+	size_t frame_row_size, tile_row_size;
+	struct Graphics_window_frame_composite_data *composite_data;
+
+	composite_data =
+		(struct Graphics_window_frame_composite_data *)composite_data_void;
+	frame_row_size = (size_t)composite_data->frame_width*
+		(size_t)composite_data->number_of_components;
+	tile_row_size = (size_t)width*(size_t)composite_data->number_of_components;
+	for (row = 0; row < height; row++)
+	{
+		memcpy(composite_data->frame_data + frame_row_size*(size_t)(bottom + row) +
+			(size_t)left*(size_t)composite_data->number_of_components,
+			pixels + tile_row_size*(size_t)row, tile_row_size);
+	}
+
+	return (1);
+} /* Graphics_window_frame_composite_tile */
+
+struct Graphics_window_frame_renderer
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Offscreen buffers and tiling kept for drawing a series of frames of the same
+size from a graphics window.
+==============================================================================*/
+{
+	struct Graphics_window *window;
+	enum Texture_storage_type storage;
+	int antialias, transparency_layers;
+	struct Graphics_window_tiling tiling;
+	struct Graphics_buffer_app **pane_buffers;
+}; /* struct Graphics_window_frame_renderer */
+
+struct Graphics_window_frame_renderer *CREATE(Graphics_window_frame_renderer)(
+	struct Graphics_window *window, enum Texture_storage_type storage,
+	int *width, int *height, int preferred_antialias,
+	int preferred_transparency_layers)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Creates the offscreen buffers for drawing frames from <window>. Returns NULL
+without an error message if they cannot be created.
+==============================================================================*/
+{
+	int pane, panel_width, panel_height, return_code;
+	struct Graphics_window_frame_renderer *renderer;
+
+	ENTER(CREATE(Graphics_window_frame_renderer));
+	renderer = (struct Graphics_window_frame_renderer *)NULL;
+	if (window && width && height)
+	{
+		if (!((*width) && (*height)))
+		{
+			/* Only use the window size if either dimension is zero */
+			Graphics_window_get_viewing_area_size(window, &panel_width,
+				&panel_height);
+			*width = panel_width;
+			*height = panel_height;
+		}
+		if (ALLOCATE(renderer, struct Graphics_window_frame_renderer, 1))
+		{
+			renderer->window = window;
+			renderer->storage = storage;
+			renderer->antialias = preferred_antialias;
+			if (renderer->antialias == -1)
+			{
+				renderer->antialias = window->antialias_mode;
+			}
+			renderer->transparency_layers = preferred_transparency_layers;
+			renderer->pane_buffers = (struct Graphics_buffer_app **)NULL;
+			return_code = Graphics_window_get_tiling(window, *width, *height,
+				&renderer->tiling);
+			if (return_code && ALLOCATE(renderer->pane_buffers,
+				struct Graphics_buffer_app *, renderer->tiling.number_of_panes))
+			{
+				for (pane = 0; pane < renderer->tiling.number_of_panes; pane++)
+				{
+					renderer->pane_buffers[pane] = (struct Graphics_buffer_app *)NULL;
+				}
+				for (pane = 0; return_code && (pane < renderer->tiling.number_of_panes); pane++)
+				{
+					renderer->pane_buffers[pane] =
+						create_Graphics_buffer_offscreen_from_buffer(
+						renderer->tiling.tile_width, renderer->tiling.tile_height,
+						/*buffer_to_match*/Scene_viewer_app_get_graphics_buffer(
+						Graphics_window_get_Scene_viewer(window, pane)));
+					/* other panes are left blank if their buffers cannot be created */
+					if ((pane == 0) && (!renderer->pane_buffers[pane]))
+					{
+						return_code = 0;
 					}
 				}
 			}
 			else
 			{
-				display_message(ERROR_MESSAGE,
-					"Graphics_window_get_frame_pixels.  Unable to allocate pixels");
-				return_code=0;
+				return_code = 0;
+			}
+			if (!return_code)
+			{
+				DESTROY(Graphics_window_frame_renderer)(&renderer);
+			}
+		}
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"CREATE(Graphics_window_frame_renderer).  Invalid argument(s)");
+	}
+	LEAVE;
+
+	return (renderer);
+} /* CREATE(Graphics_window_frame_renderer) */
+
+int DESTROY(Graphics_window_frame_renderer)(
+	struct Graphics_window_frame_renderer **renderer_address)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Destroys the renderer and its offscreen buffers.
+==============================================================================*/
+{
+	int pane, return_code;
+	struct Graphics_window_frame_renderer *renderer;
+
+	ENTER(DESTROY(Graphics_window_frame_renderer));
+	if (renderer_address && (renderer = *renderer_address))
+	{
+		if (renderer->pane_buffers)
+		{
+			for (pane = 0; pane < renderer->tiling.number_of_panes; pane++)
+			{
+				if (renderer->pane_buffers[pane])
+				{
+					DESTROY(Graphics_buffer_app)(&(renderer->pane_buffers[pane]));
+				}
+			}
+			DEALLOCATE(renderer->pane_buffers);
+		}
+		DEALLOCATE(*renderer_address);
+		return_code = 1;
+	}
+	else
+	{
+		return_code = 0;
+	}
+	LEAVE;
+
+	return (return_code);
+} /* DESTROY(Graphics_window_frame_renderer) */
+
+int Graphics_window_frame_renderer_render(
+	struct Graphics_window_frame_renderer *renderer,
+	Graphics_window_frame_tile_function *tile_function, void *user_data)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Brings the graphics up to date and draws a frame, passing each tile to
+<tile_function>.
+==============================================================================*/
+{
+	int return_code;
+
+	ENTER(Graphics_window_frame_renderer_render);
+	if (renderer && tile_function)
+	{
+		// force complete build of all graphics in scene for image output, otherwise may get only incremental output
+		cmzn_scenefilter_id filter = cmzn_sceneviewer_get_scenefilter(
+			(renderer->window->scene_viewer_array[0]->core_scene_viewer));
+		build_Scene(renderer->window->scene, filter);
+		cmzn_scenefilter_destroy(&filter);
+		return_code = Graphics_window_render_tiles(renderer->window,
+			&renderer->tiling, renderer->pane_buffers, renderer->storage,
+			renderer->antialias, renderer->transparency_layers, tile_function,
+			user_data);
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"Graphics_window_frame_renderer_render.  Invalid argument(s)");
+		return_code = 0;
+	}
+	LEAVE;
+
+	return (return_code);
+} /* Graphics_window_frame_renderer_render */
+
+int Graphics_window_frame_renderer_get_frame_pixels(
+	struct Graphics_window_frame_renderer *renderer, unsigned char **frame_data)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Draws a frame into newly allocated <frame_data>, which the caller must
+DEALLOCATE.
+==============================================================================*/
+{
+	int return_code;
+	size_t frame_size;
+	struct Graphics_window_frame_composite_data composite_data;
+
+	ENTER(Graphics_window_frame_renderer_get_frame_pixels);
+	return_code = 0;
+	if (renderer && frame_data)
+	{
+		composite_data.frame_width = renderer->tiling.frame_width;
+		composite_data.number_of_components =
+			Texture_storage_type_get_number_of_components(renderer->storage);
+		frame_size = (size_t)composite_data.number_of_components*
+			(size_t)renderer->tiling.frame_width*(size_t)renderer->tiling.frame_height;
+		if (ALLOCATE(*frame_data, unsigned char, frame_size))
+		{
+			if (renderer->tiling.number_of_panes > 1)
+			{
+				/* black border between panes */
+				memset(*frame_data, 0, frame_size);
+			}
+			composite_data.frame_data = *frame_data;
+			return_code = Graphics_window_frame_renderer_render(renderer,
+				Graphics_window_frame_composite_tile, (void *)&composite_data);
+		}
+		else
+		{
+			display_message(ERROR_MESSAGE,
+				"Graphics_window_frame_renderer_get_frame_pixels.  "
+				"Unable to allocate pixels");
+		}
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"Graphics_window_frame_renderer_get_frame_pixels.  Invalid argument(s)");
+	}
+	LEAVE;
+
+	return (return_code);
+} /* Graphics_window_frame_renderer_get_frame_pixels */
+
+int Graphics_window_render_frame_tiles(struct Graphics_window *window,
+	enum Texture_storage_type storage, int *width, int *height,
+	int preferred_antialias, int preferred_transparency_layers,
+	Graphics_window_frame_tile_function *tile_function, void *user_data)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Draws the graphics window offscreen in tiles no larger than the window and
+passes each tile to <tile_function> as it is read back, so the whole frame is
+never held in memory. See header for tile order.
+==============================================================================*/
+{
+	int return_code;
+	struct Graphics_window_frame_renderer *renderer;
+
+	ENTER(Graphics_window_render_frame_tiles);
+	return_code = 0;
+	if (window && width && height && tile_function)
+	{
+		if (NULL != (renderer = CREATE(Graphics_window_frame_renderer)(window,
+			storage, width, height, preferred_antialias, preferred_transparency_layers)))
+		{
+			return_code = Graphics_window_frame_renderer_render(renderer,
+				tile_function, user_data);
+			DESTROY(Graphics_window_frame_renderer)(&renderer);
+		}
+		else
+		{
+			display_message(ERROR_MESSAGE,
+				"Graphics_window_render_frame_tiles.  Could not draw offscreen");
+		}
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"Graphics_window_render_frame_tiles.  Invalid argument(s)");
+	}
+	LEAVE;
+
+	return (return_code);
+} /* Graphics_window_render_frame_tiles */
+
+int Graphics_window_get_frame_pixels(struct Graphics_window *window,
+	enum Texture_storage_type storage, int *width, int *height,
+	int preferred_antialias, int preferred_transparency_layers,
+	unsigned char **frame_data, int force_onscreen)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Returns the contents of the graphics window as pixels.  <width> and <height>
+will be respected if the window is drawn offscreen and they are non zero,
+otherwise they are set in accordance with current size of the graphics window.
+If <preferred_antialias> or <preferred_transparency_layers> are non zero then they
+attempt to override the default values for just this call.
+If <force_onscreen> is non zero then the pixels will always be grabbed from the
+graphics window on screen.
+==============================================================================*/
+{
+	int antialias, frame_width, frame_height, number_of_components, return_code;
+	struct Graphics_window_frame_renderer *renderer;
+
+	ENTER(Graphics_window_get_frame_pixels);
+	if (window && width && height)
+	{
+		/* If working offscreen try and allocate as large an area as possible */
+		renderer = (struct Graphics_window_frame_renderer *)NULL;
+		if (!force_onscreen)
+		{
+			if (!(renderer = CREATE(Graphics_window_frame_renderer)(window, storage,
+				width, height, preferred_antialias, preferred_transparency_layers)))
+			{
+				force_onscreen = 1;
 			}
 		}
+		if (renderer)
+		{
+			return_code = Graphics_window_frame_renderer_get_frame_pixels(renderer,
+				frame_data);
+			DESTROY(Graphics_window_frame_renderer)(&renderer);
+		}
 		else
 		{
+			// force complete build of all graphics in scene for image output, otherwise may get only incremental output
+			cmzn_scenefilter_id filter = cmzn_sceneviewer_get_scenefilter((window->scene_viewer_array[0]->core_scene_viewer));
+			build_Scene(window->scene, filter);
+			cmzn_scenefilter_destroy(&filter);
+			antialias = preferred_antialias;
+			if (antialias == -1)
+			{
+				antialias = window->antialias_mode;
+			}
 			/* Always use the window size if grabbing from screen */
 			Graphics_window_get_viewing_area_size(window, &frame_width,
 				&frame_height);
@@ -6610,6 +7498,8 @@ Writes the properties of the <window> to the command window.
 		{
 			display_message(INFORMATION_MESSAGE,"  perturbed lines: off\n");
 		}
+		display_message(INFORMATION_MESSAGE,"  frame statistics: %s\n",
+			window->frame_statistics_flag ? "on" : "off");
 		int antialias = cmzn_sceneviewer_get_antialias_sampling(first_sceneviewer);
 		if (antialias)
 		{
@@ -6882,6 +7772,12 @@ and establishing the views in it to the command window to a com file.
 		{
 			process_message->process_command(INFORMATION_MESSAGE," normal_lines");
 		}
+		process_message->process_command(INFORMATION_MESSAGE,
+			" statistics %s", window->frame_statistics_flag ? "on" : "off");
+#if defined (WX_USER_INTERFACE)
+		process_message->process_command(INFORMATION_MESSAGE,
+			" hud %s", window->frame_statistics_hud_flag ? "on" : "off");
+#endif /* defined (WX_USER_INTERFACE) */
 		int antialias = cmzn_sceneviewer_get_antialias_sampling(window->scene_viewer_array[0]->core_scene_viewer);
 		if (antialias)
 		{
@@ -6930,6 +7826,34 @@ and establishing the views in it to the command window to a com file.
 	return (return_code);
 } /* process_list_or_write_Graphics_window_commands */
 
+int list_Graphics_window_statistics(struct Graphics_window *window,
+	void *dummy_void)
+{
+	USE_PARAMETER(dummy_void);
+	if (!window)
+	{
+		display_message(ERROR_MESSAGE,
+			"list_Graphics_window_statistics.  Invalid argument(s)");
+		return 0;
+	}
+	display_message(INFORMATION_MESSAGE,
+		"Graphics window %s frame statistics:\n", window->name);
+	if (!window->frame_statistics_flag)
+	{
+		display_message(INFORMATION_MESSAGE,
+			"  Not recorded. Use: gfx modify window %s set statistics on\n",
+			window->name);
+		return 1;
+	}
+	for (int pane_no = 0; pane_no < window->number_of_scene_viewers; pane_no++)
+	{
+		display_message(INFORMATION_MESSAGE, "  pane %d:\n", pane_no + 1);
+		Frame_statistics_list(Scene_viewer_app_get_frame_statistics(
+			window->scene_viewer_array[pane_no]));
+	}
+	return 1;
+}
+
 int list_Graphics_window_commands(struct Graphics_window *window,
 	 void *dummy_void)
 /*******************************************************************************
@@ -92,6 +92,8 @@ without knowing which order the types are in.
 	GRAPHICS_WINDOW_LAYOUT_MODE_AFTER_LAST
 };
 
+class Process_list_or_write_command_class;
+
 struct Graphics_window;
 /*******************************************************************************
 LAST MODIFIED : 10 December 1997
@@ -424,6 +426,74 @@ in the backbuffer so that utility functions such as the movie extensions can get
 the pixels out of the backbuffer before the frames are swapped.
 ==============================================================================*/
 
+typedef int Graphics_window_frame_tile_function(int left, int bottom,
+	int width, int height, unsigned char *pixels, void *user_data);
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Receives a tile of <width> by <height> pixels drawn at <left>, <bottom> in the
+frame, measured from its bottom left. <pixels> are tightly packed with rows
+from bottom to top and are only valid during the call.
+==============================================================================*/
+
+int Graphics_window_render_frame_tiles(struct Graphics_window *window,
+	enum Texture_storage_type storage, int *width, int *height,
+	int preferred_antialias, int preferred_transparency_layers,
+	Graphics_window_frame_tile_function *tile_function, void *user_data);
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Draws the graphics window offscreen in tiles no larger than the window and
+passes each tile to <tile_function> as soon as it is read back, so the whole
+frame is never held in memory. Where OpenGL 2.1 is available, each tile is read
+back asynchronously while the next is drawn. For each pane, tile rows are
+passed from the top of the frame down and tiles left to right within a row.
+<width> and <height> are set to the window size if either is zero.
+==============================================================================*/
+
+struct Graphics_window_frame_renderer;
+
+struct Graphics_window_frame_renderer *CREATE(Graphics_window_frame_renderer)(
+	struct Graphics_window *window, enum Texture_storage_type storage,
+	int *width, int *height, int preferred_antialias,
+	int preferred_transparency_layers);
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Creates offscreen buffers for drawing a series of frames of the same size from
+<window>, e.g. for a movie, so they are not recreated for every frame.
+<width> and <height> are set to the window size if either is zero. Returns NULL
+if offscreen drawing is not available. The window layout must not change while
+the renderer exists.
+==============================================================================*/
+
+int DESTROY(Graphics_window_frame_renderer)(
+	struct Graphics_window_frame_renderer **renderer_address);
+
+int Graphics_window_frame_renderer_render(
+	struct Graphics_window_frame_renderer *renderer,
+	Graphics_window_frame_tile_function *tile_function, void *user_data);
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Builds any graphics changed since the last frame and draws the window, passing
+each tile to <tile_function> as for Graphics_window_render_frame_tiles.
+==============================================================================*/
+
+int Graphics_window_frame_renderer_get_frame_pixels(
+	struct Graphics_window_frame_renderer *renderer, unsigned char **frame_data);
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Draws a frame into newly allocated <frame_data> with rows from bottom to top.
+The caller must DEALLOCATE it.
+==============================================================================*/
+
 int Graphics_window_get_frame_pixels(struct Graphics_window *window,
 	enum Texture_storage_type storage, int *width, int *height,
 	int preferred_antialias, int preferred_transparency_layers,
@@ -485,6 +555,13 @@ DESCRIPTION :
 Writes the properties of the <window> to the command window.
 ==============================================================================*/
 
+/**
+ * Writes the frame rate and the time taken by recent frames in each pane of
+ * <window> to the command window, if frame statistics are on.
+ */
+int list_Graphics_window_statistics(struct Graphics_window *window,
+	void *dummy_void);
+
 int list_Graphics_window_commands(struct Graphics_window *window,
 	void *dummy_void);
 /*******************************************************************************
@@ -495,6 +572,16 @@ Writes the commands for creating the <window> and establishing the views in it
 to the command window.
 ==============================================================================*/
 
+int process_list_or_write_Graphics_window_commands(struct Graphics_window *window,
+	class Process_list_or_write_command_class *process_message);
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Passes the commands for creating the <window> and establishing the views in it
+to <process_message>.
+==============================================================================*/
+
 int write_Graphics_window_commands_to_comfile(struct Graphics_window *window,
 	 void *dummy_void);
 /*******************************************************************************
@@ -535,6 +622,14 @@ Sets if the <graphics_window> perturbs lines or not, using <perturb_lines>
 (1==TRUE,0==FALSE)
 ==============================================================================*/
 
+/**
+ * Starts or stops recording frame statistics in each pane of <graphics_window>.
+ * If <file_name> is given while starting, each frame is also written to it as
+ * a line of CSV, replacing any previous file; stopping closes the file.
+ */
+int Graphics_window_set_frame_statistics(struct Graphics_window *graphics_window,
+	int frame_statistics_flag, const char *file_name);
+
 int set_Graphics_window(struct Parse_state *state,void *window_address_void,
 	void *graphics_window_manager_void);
 /*******************************************************************************
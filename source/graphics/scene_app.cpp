@@ -4,6 +4,8 @@
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <string>
+#include <vector>
 #include "opencmiss/zinc/glyph.h"
 #include "opencmiss/zinc/material.h"
 #include "opencmiss/zinc/status.h"
@@ -23,6 +25,7 @@
 #include "computed_field/computed_field_set_app.h"
 #include "graphics/tessellation.hpp"
 #include "graphics/tessellation_app.hpp"
+#include "graphics/threejs_resource_writer.h"
 #include "user_interface/process_list_or_write_command.hpp"
 #include "finite_element/finite_element_region_app.h"
 #include "graphics/font.h"
@@ -864,11 +867,11 @@ int cmzn_scene_change_element_selection_conditional(cmzn_scene_id scene,
 int scene_app_export_threejs(cmzn_scene_id scene, cmzn_scenefilter_id scenefilter,
 	char *file_prefix, int number_of_time_steps, double begin_time, double end_time,
 	cmzn_streaminformation_scene_io_data_type data_type,
-	int morphVertices, int morphColours, int morphNormals)
+	int morphVertices, int morphColours, int morphNormals, int binary)
 {
-	if (scene)
+	if (scene && file_prefix)
 	{
-		int return_code = 0;
+		int return_code = 1;
 		cmzn_streaminformation_id streaminformation = cmzn_scene_create_streaminformation_scene(scene);
 		cmzn_streaminformation_scene_id streaminformation_scene = cmzn_streaminformation_cast_scene(
 			streaminformation);
@@ -892,26 +895,44 @@ int scene_app_export_threejs(cmzn_scene_id scene, cmzn_scenefilter_id scenefilte
 
 		int number_of_resources_required =
 			cmzn_streaminformation_scene_get_number_of_resources_required(streaminformation_scene);
-		cmzn_streamresource_id *streamresources = new cmzn_streamresource_id[number_of_resources_required];
 		if (number_of_resources_required > 0)
 		{
-			char temp[200];
+			/* Zinc streams each resource to its file, so only the graphics being
+			 * written is held in memory */
+			std::vector<cmzn_streamresource_id> streamresources(
+				number_of_resources_required, (cmzn_streamresource_id)0);
 			for (int i = 0; i < number_of_resources_required; i++)
 			{
-				sprintf(temp, "%s_%d.json", file_prefix, i+1);
-				streamresources[i] =
-					cmzn_streaminformation_create_streamresource_file(streaminformation,temp);
+				char number_string[32];
+				sprintf(number_string, "_%d.json", i + 1);
+				const std::string file_name = std::string(file_prefix) + number_string;
+				streamresources[i] = cmzn_streaminformation_create_streamresource_file(
+					streaminformation, file_name.c_str());
+			}
+			if (CMZN_OK == cmzn_scene_write(scene, streaminformation_scene))
+			{
+				/* conversion only needs the files so it is done in parallel after
+				 * Zinc has closed them */
+				if (binary)
+				{
+					return_code = threejs_convert_resources_to_binary(file_prefix,
+						number_of_resources_required, /*number_of_threads*/0);
+				}
+			}
+			else
+			{
+				display_message(ERROR_MESSAGE,
+					"gfx export threejs.  Could not export scene");
+				return_code = 0;
+			}
+			for (int i = 0; i < number_of_resources_required; i++)
+			{
+				cmzn_streamresource_destroy(&(streamresources[i]));
 			}
-			return_code = cmzn_scene_write(scene, streaminformation_scene);
-		}
-		for (int i = 0; i < number_of_resources_required; i++)
-		{
-			cmzn_streamresource_destroy(&(streamresources[i]));
 		}
-		delete[] streamresources;
 		cmzn_streaminformation_scene_destroy(&streaminformation_scene);
 		cmzn_streaminformation_destroy(&streaminformation);
-		return 1;
+		return return_code;
 	}
 
 	return 0;
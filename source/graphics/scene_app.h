@@ -91,10 +91,17 @@ Modifier function to set the scene from a command.
 int define_Scene(struct Parse_state *state, void *scene_void,
 	void *define_scene_data_void);
 
+/**
+ * Exports the scene to ThreeJS JSON files <file_prefix>_1.json (metadata),
+ * <file_prefix>_2.json etc.
+ * @param binary  If set, once each file is written its large numeric arrays
+ * are moved to a .bin file per graphics and referenced from its JSON by
+ * glTF-style accessors. Files are converted in parallel.
+ */
 int scene_app_export_threejs(cmzn_scene_id scene, cmzn_scenefilter_id scenefilter,
 	char *file_prefix, int number_of_time_steps, double begin_time, double end_time,
 	cmzn_streaminformation_scene_io_data_type data_type,
-	int morphVertices, int morphColours, int morphNormals);
+	int morphVertices, int morphColours, int morphNormals, int binary);
 
 struct Define_scene_data
 {
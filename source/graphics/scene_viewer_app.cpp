@@ -4,8 +4,10 @@
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <stdio.h>
 #include "general/debug.h"
 #include "general/message.h"
+#include "graphics/frame_statistics.h"
 #include "graphics/graphics_module.h"
 #include "graphics/scene_viewer.h"
 #include "graphics/scene_viewer_app.h"
@@ -180,6 +182,7 @@ struct Scene_viewer_app *CREATE(Scene_viewer_app)(struct Graphics_buffer_app *gr
 				scene_viewer->core_scene_viewer);
 			cmzn_sceneviewernotifier_set_callback(scene_viewer->notifier,
 				My_cmzn_sceneviewer_callback, (void *)scene_viewer);
+			scene_viewer->frame_statistics = 0;
 			Graphics_buffer_app_add_initialise_callback(graphics_buffer,
 				Scene_viewer_app_initialise_callback, scene_viewer);
 			Graphics_buffer_app_add_resize_callback(graphics_buffer,
@@ -230,6 +233,7 @@ struct Scene_viewer_app *Scene_viewer_app_for_spectrum_create(struct Graphics_bu
 				scene_viewer->core_scene_viewer);
 			cmzn_sceneviewernotifier_set_callback(scene_viewer->notifier,
 				My_cmzn_sceneviewer_callback, (void *)scene_viewer);
+			scene_viewer->frame_statistics = 0;
 			Graphics_buffer_app_add_initialise_callback(graphics_buffer,
 				Scene_viewer_app_initialise_callback, scene_viewer);
 			Graphics_buffer_app_add_resize_callback(graphics_buffer,
@@ -261,6 +265,10 @@ int DESTROY(Scene_viewer_app)(struct Scene_viewer_app **scene_viewer_app_address
 		{
 			cmzn_sceneviewernotifier_destroy(&scene_viewer->notifier);
 		}
+		if (scene_viewer->frame_statistics)
+		{
+			DESTROY(Frame_statistics)(&scene_viewer->frame_statistics);
+		}
 		if (scene_viewer->core_scene_viewer)
 			cmzn_sceneviewer_destroy(&(scene_viewer->core_scene_viewer));
 		if (scene_viewer->sync_callback_list)
@@ -820,6 +828,117 @@ int Scene_viewer_app_default_input_callback(struct Scene_viewer_app *scene_viewe
 	return return_code;
 }
 
+/* OpenGL 3.0 counts the primitives drawn with a query; function names need
+	 GLEW or the GL prototypes */
+#if defined (OPENGL_API) && defined (GL_PRIMITIVES_GENERATED) && \
+	(defined (GLEW_VERSION_3_0) || defined (GL_GLEXT_PROTOTYPES))
+#define SCENE_VIEWER_APP_USE_PRIMITIVES_QUERY
+#endif
+
+namespace {
+
+#if defined (SCENE_VIEWER_APP_USE_PRIMITIVES_QUERY)
+/** @return  1 if the current OpenGL context is at least version 3.0. */
+int Scene_viewer_app_primitives_query_available(void)
+{
+#if defined (GLEW_VERSION_3_0)
+	return GLEW_VERSION_3_0 ? 1 : 0;
+#else /* defined (GLEW_VERSION_3_0) */
+	const char *version = (const char *)glGetString(GL_VERSION);
+	int major_version, minor_version;
+	return (version && (2 == sscanf(version, "%d.%d", &major_version, &minor_version)) &&
+		(3 <= major_version)) ? 1 : 0;
+#endif /* defined (GLEW_VERSION_3_0) */
+}
+#endif /* defined (SCENE_VIEWER_APP_USE_PRIMITIVES_QUERY) */
+
+/**
+ * Renders the scene of <scene_viewer> and swaps buffers if it is double
+ * buffered. While frame statistics are recorded each part of the frame is
+ * timed, waiting for OpenGL to finish drawing so the swap time excludes it.
+ */
+int Scene_viewer_app_render_and_swap(struct Scene_viewer_app *scene_viewer)
+{
+	if (!scene_viewer->frame_statistics)
+	{
+		const int return_code = cmzn_sceneviewer_render_scene(scene_viewer->core_scene_viewer);
+		if (scene_viewer->core_scene_viewer->swap_buffers)
+		{
+			Graphics_buffer_app_swap_buffers(scene_viewer->graphics_buffer);
+		}
+		return return_code;
+	}
+	struct Frame_statistics_frame frame;
+	frame.primitives = -1;
+	frame.start_seconds = Scene_viewer_app_get_seconds();
+#if defined (SCENE_VIEWER_APP_USE_PRIMITIVES_QUERY)
+	GLuint query = 0;
+	if (Scene_viewer_app_primitives_query_available())
+	{
+		glGenQueries(1, &query);
+		glBeginQuery(GL_PRIMITIVES_GENERATED, query);
+	}
+#endif /* defined (SCENE_VIEWER_APP_USE_PRIMITIVES_QUERY) */
+	const int return_code = cmzn_sceneviewer_render_scene(scene_viewer->core_scene_viewer);
+#if defined (SCENE_VIEWER_APP_USE_PRIMITIVES_QUERY)
+	if (query)
+	{
+		glEndQuery(GL_PRIMITIVES_GENERATED);
+	}
+#endif /* defined (SCENE_VIEWER_APP_USE_PRIMITIVES_QUERY) */
+	const double rendered_seconds = Scene_viewer_app_get_seconds();
+	glFinish();
+	const double finished_seconds = Scene_viewer_app_get_seconds();
+	if (scene_viewer->core_scene_viewer->swap_buffers)
+	{
+		Graphics_buffer_app_swap_buffers(scene_viewer->graphics_buffer);
+	}
+	frame.render_seconds = rendered_seconds - frame.start_seconds;
+	frame.finish_seconds = finished_seconds - rendered_seconds;
+	frame.swap_seconds = Scene_viewer_app_get_seconds() - finished_seconds;
+#if defined (SCENE_VIEWER_APP_USE_PRIMITIVES_QUERY)
+	if (query)
+	{
+		GLuint primitives = 0;
+		glGetQueryObjectuiv(query, GL_QUERY_RESULT, &primitives);
+		glDeleteQueries(1, &query);
+		frame.primitives = (long)primitives;
+	}
+#endif /* defined (SCENE_VIEWER_APP_USE_PRIMITIVES_QUERY) */
+	Frame_statistics_add_frame(scene_viewer->frame_statistics, &frame);
+	return return_code;
+}
+
+}
+
+int Scene_viewer_app_set_frame_statistics(struct Scene_viewer_app *scene_viewer,
+	int frame_statistics_flag)
+{
+	if (scene_viewer)
+	{
+		if (frame_statistics_flag && (!scene_viewer->frame_statistics))
+		{
+			scene_viewer->frame_statistics = CREATE(Frame_statistics)();
+		}
+		else if ((!frame_statistics_flag) && scene_viewer->frame_statistics)
+		{
+			DESTROY(Frame_statistics)(&scene_viewer->frame_statistics);
+		}
+		return 1;
+	}
+	display_message(ERROR_MESSAGE,
+		"Scene_viewer_app_set_frame_statistics.  Invalid argument(s)");
+	return 0;
+}
+
+struct Frame_statistics *Scene_viewer_app_get_frame_statistics(
+	struct Scene_viewer_app *scene_viewer)
+{
+	if (scene_viewer)
+		return scene_viewer->frame_statistics;
+	return 0;
+}
+
 int Scene_viewer_app_redraw(struct Scene_viewer_app *scene_viewer)
 /*******************************************************************************
 LAST MODIFIED : 14 July 2000
@@ -881,11 +1000,7 @@ Requests a full redraw immediately.
 			}
 		}
 		Graphics_buffer_app_make_current(scene_viewer->graphics_buffer);
-		return_code = cmzn_sceneviewer_render_scene(scene_viewer->core_scene_viewer);
-		if (scene_viewer->core_scene_viewer->swap_buffers)
-		{
-			Graphics_buffer_app_swap_buffers(scene_viewer->graphics_buffer);
-		}
+		return_code = Scene_viewer_app_render_and_swap(scene_viewer);
 	}
 	else
 	{
@@ -1016,11 +1131,7 @@ Updates the scene_viewer.
 			scene_viewer->core_scene_viewer->tumble_angle = 0.0;
 		}
 		Graphics_buffer_app_make_current(scene_viewer->graphics_buffer);
-		cmzn_sceneviewer_render_scene(scene_viewer->core_scene_viewer);
-		if (scene_viewer->core_scene_viewer->swap_buffers)
-		{
-			Graphics_buffer_app_swap_buffers(scene_viewer->graphics_buffer);
-		}
+		Scene_viewer_app_render_and_swap(scene_viewer);
 		/* We don't want the idle callback to repeat so we return 0 */
 		repeat_idle = 0;
 	}
@@ -62,6 +62,8 @@ struct Scene_viewer_app
 	/* list of callbacks requested by other objects when view changes */
 	struct LIST(CMZN_CALLBACK_ITEM(Scene_viewer_app_callback)) *sync_callback_list;
 	cmzn_sceneviewernotifier_id notifier;
+	/* timings of recent frames, if being recorded */
+	struct Frame_statistics *frame_statistics;
 };
 
 DECLARE_LIST_TYPES(Scene_viewer_app);
@@ -155,6 +157,20 @@ struct Scene_viewer_app *Scene_viewer_app_for_spectrum_create(struct Graphics_bu
 
 int DESTROY(Scene_viewer_app)(struct Scene_viewer_app **scene_viewer_app_address);
 
+/**
+ * Starts or stops recording the time taken by each frame drawn by
+ * <scene_viewer>. Stopping discards the frames recorded.
+ */
+int Scene_viewer_app_set_frame_statistics(struct Scene_viewer_app *scene_viewer,
+	int frame_statistics_flag);
+
+/**
+ * @return  Recent frame timings of <scene_viewer>, or NULL if not recording.
+ * Owned by <scene_viewer>.
+ */
+struct Frame_statistics *Scene_viewer_app_get_frame_statistics(
+	struct Scene_viewer_app *scene_viewer);
+
 int Scene_viewer_app_add_input_callback(struct Scene_viewer_app *scene_viewer,
 	CMZN_CALLBACK_FUNCTION(Scene_viewer_app_input_callback) *function,
 	void *user_data, int add_first);
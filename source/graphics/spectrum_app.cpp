@@ -397,6 +397,7 @@ to the comfile.
 				list_data.component_string_detail=SPECTRUM_COMPONENT_STRING_COMPLETE;
 				list_data.line_prefix=line_prefix;
 				list_data.line_suffix=command_suffix;
+				list_data.process_message=process_message;
 				return_code = process_message->write_enabled();
 				if (return_code == 0)
 				{
@@ -584,6 +585,7 @@ Writes the properties of the <spectrum> to the command window.
 		list_data.component_string_detail=SPECTRUM_COMPONENT_STRING_COMPLETE_PLUS;
 		list_data.line_prefix="  ";
 		list_data.line_suffix="";
+		list_data.process_message=(class Process_list_or_write_command_class *)NULL;
 		return_code=FOR_EACH_OBJECT_IN_LIST(cmzn_spectrumcomponent)(
 			cmzn_spectrumcomponent_list_contents,(void *)&list_data,
 			spectrum->list_of_components);
@@ -8,6 +8,8 @@
 #endif /* defined (BUILD_WITH_CMAKE) */
 #include "command/parser.h"
 
+class Process_list_or_write_command_class;
+
 int set_Spectrum(struct Parse_state *state,void *spectrum_address_void,
 	void *spectrum_manager_void);
 /*******************************************************************************
@@ -66,6 +68,17 @@ Writes the properties of the <spectrum> to the command window in a
 form that can be directly pasted into a com file.
 ==============================================================================*/
 
+int process_list_or_write_Spectrum_commands(struct cmzn_spectrum *spectrum,
+	 const char *command_prefix,char *command_suffix,
+	 class Process_list_or_write_command_class *process_message);
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+List the properties of the <spectrum> to the command window or write
+to the comfile, or wherever <process_message> sends them.
+==============================================================================*/
+
 int for_each_spectrum_list_or_write_commands(
 	struct cmzn_spectrum *spectrum,void *write_enabled_void);
 /*******************************************************************************
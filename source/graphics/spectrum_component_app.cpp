@@ -21,6 +21,7 @@
 #include "graphics/spectrum.h"
 #include "graphics/spectrum_component.h"
 #include "graphics/spectrum_component_app.h"
+#include "user_interface/process_list_or_write_command.hpp"
 #include "computed_field/computed_field_set.h"
 #include "computed_field/computed_field_set_app.h"
 #include "general/enumerator_private_app.h"
@@ -669,6 +670,26 @@ Writes out the <component> as a text string in the command window with the
 	return (return_code);
 } /* cmzn_spectrumcomponent_list_contents */
 
+static void cmzn_spectrumcomponent_write_string(
+	struct cmzn_spectrumcomponent_list_data *list_data, const char *string)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Writes <string> to the <list_data> process_message if any, otherwise to the
+comfile.
+==============================================================================*/
+{
+	if (list_data->process_message)
+	{
+		list_data->process_message->process_command(INFORMATION_MESSAGE,"%s",string);
+	}
+	else
+	{
+		write_message_to_file(INFORMATION_MESSAGE,string);
+	}
+}
+
 int cmzn_spectrumcomponent_write_contents(struct cmzn_spectrumcomponent *component,
 	void *list_data_void)
 /*******************************************************************************
@@ -694,21 +715,21 @@ Writes out the <component> as a text string in the command window with the
 		{
 			if (list_data->line_prefix)
 			{
-				write_message_to_file(INFORMATION_MESSAGE,list_data->line_prefix);
+				cmzn_spectrumcomponent_write_string(list_data,list_data->line_prefix);
 			}
-			write_message_to_file(INFORMATION_MESSAGE,component_string);
+			cmzn_spectrumcomponent_write_string(list_data,component_string);
 			if (list_data->line_suffix)
 			{
-				 write_message_to_file(INFORMATION_MESSAGE,list_data->line_suffix);
+				 cmzn_spectrumcomponent_write_string(list_data,list_data->line_suffix);
 			}
 			/*???RC temp */
 			if ((SPECTRUM_COMPONENT_STRING_COMPLETE_PLUS==list_data->component_string_detail)&&
 				(component->access_count != 1))
 			{
 				sprintf(line," (access count = %i)",component->access_count);
-				write_message_to_file(INFORMATION_MESSAGE,line);
+				cmzn_spectrumcomponent_write_string(list_data,line);
 			}
-			write_message_to_file(INFORMATION_MESSAGE,";\n");
+			cmzn_spectrumcomponent_write_string(list_data,";\n");
 			DEALLOCATE(component_string);
 			return_code=1;
 		}
@@ -74,16 +74,21 @@ COMPONENT_STRING_COMPLETE_PLUS = as above, but with * added if component_changed
 }; /* enum cmzn_spectrumcomponent_string_details */
 
 
+class Process_list_or_write_command_class;
+
 struct cmzn_spectrumcomponent_list_data
 /*******************************************************************************
-LAST MODIFIED : 5 August 1998
+LAST MODIFIED : 16 October 2026
 
 DESCRIPTION :
 Data for formating output with Spectrum_list_app_contents function.
+<process_message>, if set, receives the output of
+cmzn_spectrumcomponent_write_contents instead of the comfile.
 ==============================================================================*/
 {
 	const char *line_prefix,*line_suffix;
 	enum cmzn_spectrumcomponent_string_details component_string_detail;
+	class Process_list_or_write_command_class *process_message;
 }; /* cmzn_spectrumcomponent_list_data */
 
 
@@ -0,0 +1,465 @@
+/**
+ * FILE : texture_field_sampler.cpp
+ *
+ * Fills a texture image with the colours of a field on several threads.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string.h>
+#include <vector>
+#include "opencmiss/zinc/element.h"
+#include "opencmiss/zinc/field.h"
+#include "opencmiss/zinc/fieldcache.h"
+#include "opencmiss/zinc/fieldmodule.h"
+#include "opencmiss/zinc/status.h"
+#include "finite_element/mesh_location_index.h"
+#include "general/cmgui_thread.h"
+#include "general/debug.h"
+#include "general/message.h"
+#include "graphics/material.h"
+#include "graphics/spectrum.h"
+#include "graphics/texture_field_sampler.h"
+#include "image_processing/image_filter_stream.h"
+
+namespace {
+
+/** Layout of the texels written to a texture. */
+struct Texture_pixel_format
+{
+	enum Texture_storage_type storage;
+	int number_of_bytes_per_component, bytes_per_pixel;
+};
+
+/**
+ * Field values evaluated on the calling thread, converted to pixels one row
+ * at a time on worker threads. Rows are <row_length> texels of consecutive
+ * values, found flags and pixels.
+ */
+struct Texture_pixel_conversion_data
+{
+	struct Texture_pixel_format format;
+	cmzn_spectrum_id spectrum;
+	ZnReal fail_rgba[4];
+	int field_number_of_components, row_length;
+	double *values;
+	/* non-zero for texels whose values were evaluated */
+	const unsigned char *found;
+	unsigned char *pixels;
+};
+
+inline void Texture_sampler_set_component(unsigned char *pixel,
+	int number_of_bytes_per_component, int component, ZnReal value)
+{
+	if (value < 0.0)
+		value = 0.0;
+	else if (value > 1.0)
+		value = 1.0;
+	if (2 == number_of_bytes_per_component)
+	{
+		unsigned short short_value = (unsigned short)(value*65535.0 + 0.5);
+		memcpy(pixel + 2*component, &short_value, 2);
+	}
+	else
+	{
+		pixel[component] = (unsigned char)(value*255.0 + 0.5);
+	}
+}
+
+void Texture_sampler_set_pixel(const struct Texture_pixel_format &format,
+	const ZnReal *rgba, unsigned char *pixel)
+{
+	const int bytes = format.number_of_bytes_per_component;
+	switch (format.storage)
+	{
+		case TEXTURE_LUMINANCE:
+		{
+			Texture_sampler_set_component(pixel, bytes, 0, (rgba[0] + rgba[1] + rgba[2])/3.0);
+		} break;
+		case TEXTURE_LUMINANCE_ALPHA:
+		{
+			Texture_sampler_set_component(pixel, bytes, 0, (rgba[0] + rgba[1] + rgba[2])/3.0);
+			Texture_sampler_set_component(pixel, bytes, 1, rgba[3]);
+		} break;
+		case TEXTURE_RGB:
+		{
+			for (int c = 0; c < 3; ++c)
+				Texture_sampler_set_component(pixel, bytes, c, rgba[c]);
+		} break;
+		case TEXTURE_BGR:
+		{
+			for (int c = 0; c < 3; ++c)
+				Texture_sampler_set_component(pixel, bytes, c, rgba[2 - c]);
+		} break;
+		case TEXTURE_RGBA:
+		{
+			for (int c = 0; c < 4; ++c)
+				Texture_sampler_set_component(pixel, bytes, c, rgba[c]);
+		} break;
+		case TEXTURE_ABGR:
+		{
+			for (int c = 0; c < 4; ++c)
+				Texture_sampler_set_component(pixel, bytes, c, rgba[3 - c]);
+		} break;
+		default:
+		{
+			memset(pixel, 0, format.bytes_per_pixel);
+		} break;
+	}
+}
+
+/** Gets the diffuse colour and alpha of <fail_material>, or zeros if NULL. */
+void Texture_sampler_get_fail_rgba(cmzn_material_id fail_material,
+	ZnReal *fail_rgba)
+{
+	for (int c = 0; c < 4; ++c)
+		fail_rgba[c] = 0.0;
+	if (fail_material)
+	{
+		struct Colour fail_colour;
+		MATERIAL_PRECISION fail_alpha;
+		if (Graphical_material_get_diffuse(fail_material, &fail_colour) &&
+			Graphical_material_get_alpha(fail_material, &fail_alpha))
+		{
+			fail_rgba[0] = fail_colour.red;
+			fail_rgba[1] = fail_colour.green;
+			fail_rgba[2] = fail_colour.blue;
+			fail_rgba[3] = fail_alpha;
+		}
+	}
+}
+
+/**
+ * Converts the values of <row> to pixels through the spectrum, or to the fail
+ * colour where not found. Evaluates no fields and only reads the spectrum, so
+ * rows may be converted on any thread. Displays no messages.
+ */
+int Texture_convert_pixel_row(int row, void *data_void)
+{
+	const struct Texture_pixel_conversion_data *data =
+		static_cast<const struct Texture_pixel_conversion_data *>(data_void);
+	const size_t start = (size_t)row*data->row_length;
+	double *values = data->values + start*data->field_number_of_components;
+	unsigned char *pixel = data->pixels + start*data->format.bytes_per_pixel;
+	ZnReal rgba[4];
+	for (int i = 0; i < data->row_length; ++i)
+	{
+		if (data->found[start + i] && Spectrum_value_to_rgba(data->spectrum,
+			data->field_number_of_components, values, rgba))
+		{
+			Texture_sampler_set_pixel(data->format, rgba, pixel);
+		}
+		else
+		{
+			Texture_sampler_set_pixel(data->format, data->fail_rgba, pixel);
+		}
+		values += data->field_number_of_components;
+		pixel += data->format.bytes_per_pixel;
+	}
+	return 1;
+}
+
+/** A tile of a streamed image, whose filters read its texels plus halo. */
+struct Texture_stream_tile
+{
+	int minimum[3], maximum[3], halo_minimum[3], halo_maximum[3];
+};
+
+/**
+ * @return  Texture coordinate of the centre of texel <i> in direction <d> of
+ * the tile field, which spans only the tile plus halo over <texture_size>.
+ */
+inline double Texture_stream_tile_get_coordinate(const double *texture_size,
+	const struct Texture_stream_tile &tile, int d, int i)
+{
+	return (i - tile.halo_minimum[d] + 0.5)*texture_size[d]/
+		(double)(tile.halo_maximum[d] - tile.halo_minimum[d]);
+}
+
+}
+
+int Texture_evaluate_field_image(struct Texture *texture, cmzn_field_id field,
+	cmzn_field_id texture_coordinate_field, int propagate_field,
+	int use_pixel_location, cmzn_spectrum_id spectrum,
+	cmzn_material_id fail_material, int image_width, int image_height,
+	int image_depth, enum Texture_storage_type storage,
+	int number_of_bytes_per_component, double texture_width,
+	double texture_height, double texture_depth, cmzn_mesh_id search_mesh,
+	int number_of_threads, Texture_field_values_function values_function,
+	void *values_user_data)
+{
+	const int number_of_components =
+		Texture_storage_type_get_number_of_components(storage);
+	if (!(texture && field && texture_coordinate_field && spectrum &&
+		(0 < image_width) && (0 < image_height) && (0 < image_depth) &&
+		(0 < number_of_components) && (4 >= number_of_components) &&
+		((1 == number_of_bytes_per_component) || (2 == number_of_bytes_per_component))))
+	{
+		display_message(ERROR_MESSAGE,
+			"Texture_evaluate_field_image.  Invalid argument(s)");
+		return 0;
+	}
+	const int field_number_of_components = cmzn_field_get_number_of_components(field);
+	const int texture_number_of_components =
+		cmzn_field_get_number_of_components(texture_coordinate_field);
+	if ((field_number_of_components < 1) ||
+		(texture_number_of_components < 1) || (texture_number_of_components > 3))
+	{
+		display_message(ERROR_MESSAGE,
+			"Texture_evaluate_field_image.  Invalid field or texture coordinates");
+		return 0;
+	}
+	const bool evaluate_direct = (propagate_field || use_pixel_location);
+	const double texel_size[3] = { texture_width/image_width,
+		texture_height/image_height, texture_depth/image_depth };
+	struct Texture_pixel_conversion_data conversion;
+	conversion.format.storage = storage;
+	conversion.format.number_of_bytes_per_component = number_of_bytes_per_component;
+	conversion.format.bytes_per_pixel = number_of_components*number_of_bytes_per_component;
+	conversion.spectrum = spectrum;
+	Texture_sampler_get_fail_rgba(fail_material, conversion.fail_rgba);
+	conversion.field_number_of_components = field_number_of_components;
+	conversion.row_length = image_width;
+	struct Mesh_location_index *index = 0;
+	/* texture coordinates matching mesh dimension are needed to find locations */
+	if (search_mesh && (!use_pixel_location) &&
+		(texture_number_of_components >= cmzn_mesh_get_dimension(search_mesh)))
+	{
+		index = CREATE(Mesh_location_index)(search_mesh, texture_coordinate_field);
+	}
+	const int dimension = index ? Mesh_location_index_get_dimension(index) : 0;
+	const size_t plane_number_of_texels = (size_t)image_width*image_height;
+	const size_t plane_number_of_values =
+		plane_number_of_texels*field_number_of_components;
+	std::vector<double> values(plane_number_of_values);
+	std::vector<unsigned char> found(plane_number_of_texels),
+		pixels(plane_number_of_texels*conversion.format.bytes_per_pixel);
+	conversion.values = &(values[0]);
+	conversion.found = &(found[0]);
+	conversion.pixels = &(pixels[0]);
+	bool values_complete = (0 != values_function);
+	/* fields are only evaluated here, with one cache, as Zinc field evaluation
+	 * is not thread safe */
+	cmzn_fieldmodule_id field_module = cmzn_field_get_fieldmodule(field);
+	cmzn_fieldcache_id field_cache = cmzn_fieldmodule_create_fieldcache(field_module);
+	/* element found for the previous texel, for a warm start */
+	int element_number = -1;
+	double texture_values[3] = { 0.0, 0.0, 0.0 }, xi[3];
+	int return_code = (0 != field_cache);
+	for (int k = 0; return_code && (k < image_depth); ++k)
+	{
+		texture_values[2] = (k + 0.5)*texel_size[2];
+		double *value = &(values[0]);
+		unsigned char *texel_found = &(found[0]);
+		for (int j = 0; j < image_height; ++j)
+		{
+			texture_values[1] = (j + 0.5)*texel_size[1];
+			for (int i = 0; i < image_width; ++i)
+			{
+				texture_values[0] = (i + 0.5)*texel_size[0];
+				bool direct = false;
+				if (evaluate_direct &&
+					(CMZN_OK == cmzn_fieldcache_set_field_real(field_cache,
+						texture_coordinate_field, texture_number_of_components,
+						texture_values)) &&
+					(CMZN_OK == cmzn_field_evaluate_real(field, field_cache,
+						field_number_of_components, value)))
+				{
+					*texel_found = direct = true;
+				}
+				else
+				{
+					*texel_found = index && Mesh_location_index_find(index,
+						field_cache, texture_values, &element_number, xi) &&
+						(CMZN_OK == cmzn_fieldcache_set_mesh_location(field_cache,
+							Mesh_location_index_get_element(index, element_number),
+							dimension, xi)) &&
+						(CMZN_OK == cmzn_field_evaluate_real(field, field_cache,
+							field_number_of_components, value));
+				}
+				if (!direct)
+					values_complete = false;
+				value += field_number_of_components;
+				++texel_found;
+			}
+		}
+		if (values_complete &&
+			!(values_function)(&(values[0]), plane_number_of_values, values_user_data))
+		{
+			values_complete = false;
+		}
+		if (!cmgui_parallel_for(number_of_threads, image_height,
+			Texture_convert_pixel_row, static_cast<void *>(&conversion)))
+		{
+			return_code = 0;
+		}
+		if (return_code)
+		{
+			return_code = Texture_set_image_block(texture, /*left*/0, /*bottom*/0,
+				image_width, image_height, /*depth_plane*/k,
+				image_width*conversion.format.bytes_per_pixel, &(pixels[0]));
+		}
+	}
+	if (!return_code)
+	{
+		display_message(ERROR_MESSAGE,
+			"Texture_evaluate_field_image.  Could not set texture image");
+	}
+	cmzn_fieldcache_destroy(&field_cache);
+	cmzn_fieldmodule_destroy(&field_module);
+	if (index)
+		DESTROY(Mesh_location_index)(&index);
+	return return_code;
+}
+
+int Texture_evaluate_field_image_streamed(struct Texture *texture,
+	cmzn_field_id field, cmzn_spectrum_id spectrum,
+	cmzn_material_id fail_material, int image_width, int image_height,
+	int image_depth, enum Texture_storage_type storage,
+	int number_of_bytes_per_component, double texture_width,
+	double texture_height, double texture_depth, const int *tile_sizes,
+	int number_of_threads)
+{
+	const int number_of_components =
+		Texture_storage_type_get_number_of_components(storage);
+	if (!(texture && field && spectrum && tile_sizes &&
+		(0 < image_width) && (0 < image_height) && (0 < image_depth) &&
+		(0 < number_of_components) && (4 >= number_of_components) &&
+		((1 == number_of_bytes_per_component) || (2 == number_of_bytes_per_component))))
+	{
+		display_message(ERROR_MESSAGE,
+			"Texture_evaluate_field_image_streamed.  Invalid argument(s)");
+		return 0;
+	}
+	struct Image_filter_stream *stream = CREATE(Image_filter_stream)(field);
+	if (!stream)
+		return 0;
+	int sizes[3], halo[3];
+	Image_filter_stream_get_sizes(stream, sizes);
+	Image_filter_stream_get_halo(stream, halo);
+	if ((sizes[0] != image_width) || (sizes[1] != image_height) ||
+		(sizes[2] != image_depth))
+	{
+		display_message(ERROR_MESSAGE, "Image filter streaming needs the texture "
+			"to have the native resolution of the field, %d x %d x %d",
+			sizes[0], sizes[1], sizes[2]);
+		DESTROY(Image_filter_stream)(&stream);
+		return 0;
+	}
+	cmzn_field_id texture_coordinate_field =
+		Image_filter_stream_get_texture_coordinate_field(stream);
+	const int field_number_of_components = cmzn_field_get_number_of_components(field);
+	const int texture_number_of_components =
+		cmzn_field_get_number_of_components(texture_coordinate_field);
+	const double texture_size[3] = { texture_width, texture_height, texture_depth };
+	struct Texture_pixel_conversion_data conversion;
+	conversion.format.storage = storage;
+	conversion.format.number_of_bytes_per_component = number_of_bytes_per_component;
+	conversion.format.bytes_per_pixel = number_of_components*number_of_bytes_per_component;
+	conversion.spectrum = spectrum;
+	Texture_sampler_get_fail_rgba(fail_material, conversion.fail_rgba);
+	conversion.field_number_of_components = field_number_of_components;
+	/* tile sizes of 0 or beyond the image take the whole image in that direction */
+	int steps[3], number_of_tiles_in[3];
+	for (int d = 0; d < 3; ++d)
+	{
+		steps[d] = ((0 < tile_sizes[d]) && (tile_sizes[d] < sizes[d])) ?
+			tile_sizes[d] : sizes[d];
+		number_of_tiles_in[d] = (sizes[d] + steps[d] - 1)/steps[d];
+	}
+	const int number_of_tiles =
+		number_of_tiles_in[0]*number_of_tiles_in[1]*number_of_tiles_in[2];
+	/* only one tile is filtered and held at once, bounding memory use */
+	const size_t tile_number_of_texels = (size_t)steps[0]*steps[1]*steps[2];
+	std::vector<double> values(tile_number_of_texels*
+		((0 < field_number_of_components) ? field_number_of_components : 1));
+	std::vector<unsigned char> found(tile_number_of_texels),
+		pixels(tile_number_of_texels*conversion.format.bytes_per_pixel);
+	conversion.values = &(values[0]);
+	conversion.found = &(found[0]);
+	conversion.pixels = &(pixels[0]);
+	/* tile filters and fields are only evaluated here, with one cache, as Zinc
+	 * field evaluation is not thread safe; ITK uses its own threads within
+	 * each filter */
+	cmzn_fieldmodule_id field_module = cmzn_field_get_fieldmodule(field);
+	cmzn_fieldcache_id field_cache = cmzn_fieldmodule_create_fieldcache(field_module);
+	int return_code = (0 != field_cache);
+	double texture_values[3] = { 0.0, 0.0, 0.0 };
+	for (int tile_number = 0; return_code && (tile_number < number_of_tiles);
+		++tile_number)
+	{
+		struct Texture_stream_tile tile;
+		const int tile_index[3] = { tile_number % number_of_tiles_in[0],
+			(tile_number/number_of_tiles_in[0]) % number_of_tiles_in[1],
+			tile_number/(number_of_tiles_in[0]*number_of_tiles_in[1]) };
+		for (int d = 0; d < 3; ++d)
+		{
+			tile.minimum[d] = tile_index[d]*steps[d];
+			tile.maximum[d] = (tile.minimum[d] + steps[d] < sizes[d]) ?
+				(tile.minimum[d] + steps[d]) : sizes[d];
+			tile.halo_minimum[d] = (tile.minimum[d] > halo[d]) ?
+				(tile.minimum[d] - halo[d]) : 0;
+			tile.halo_maximum[d] = (tile.maximum[d] + halo[d] < sizes[d]) ?
+				(tile.maximum[d] + halo[d]) : sizes[d];
+		}
+		cmzn_field_id tile_field = Image_filter_stream_create_tile_field(stream,
+			tile.halo_minimum, tile.halo_maximum);
+		if (!tile_field)
+		{
+			return_code = 0;
+			break;
+		}
+		double *value = &(values[0]);
+		unsigned char *texel_found = &(found[0]);
+		for (int k = tile.minimum[2]; k < tile.maximum[2]; ++k)
+		{
+			texture_values[2] = Texture_stream_tile_get_coordinate(texture_size, tile, 2, k);
+			for (int j = tile.minimum[1]; j < tile.maximum[1]; ++j)
+			{
+				texture_values[1] = Texture_stream_tile_get_coordinate(texture_size, tile, 1, j);
+				for (int i = tile.minimum[0]; i < tile.maximum[0]; ++i)
+				{
+					texture_values[0] = Texture_stream_tile_get_coordinate(texture_size, tile, 0, i);
+					*texel_found =
+						(CMZN_OK == cmzn_fieldcache_set_field_real(field_cache,
+							texture_coordinate_field, texture_number_of_components,
+							texture_values)) &&
+						(CMZN_OK == cmzn_field_evaluate_real(tile_field, field_cache,
+							field_number_of_components, value));
+					value += field_number_of_components;
+					++texel_found;
+				}
+			}
+		}
+		cmzn_field_destroy(&tile_field);
+		const int width = tile.maximum[0] - tile.minimum[0];
+		const int height = tile.maximum[1] - tile.minimum[1];
+		conversion.row_length = width;
+		if (!cmgui_parallel_for(number_of_threads,
+			height*(tile.maximum[2] - tile.minimum[2]),
+			Texture_convert_pixel_row, static_cast<void *>(&conversion)))
+		{
+			return_code = 0;
+		}
+		const size_t plane_size = (size_t)width*height*conversion.format.bytes_per_pixel;
+		for (int k = tile.minimum[2]; return_code && (k < tile.maximum[2]); ++k)
+		{
+			if (!Texture_set_image_block(texture, tile.minimum[0], tile.minimum[1],
+				width, height, /*depth_plane*/k, width*conversion.format.bytes_per_pixel,
+				&(pixels[0]) + (k - tile.minimum[2])*plane_size))
+			{
+				display_message(ERROR_MESSAGE,
+					"Texture_evaluate_field_image_streamed.  Could not set texture image");
+				return_code = 0;
+			}
+		}
+	}
+	cmzn_fieldcache_destroy(&field_cache);
+	cmzn_fieldmodule_destroy(&field_module);
+	cmzn_field_destroy(&texture_coordinate_field);
+	DESTROY(Image_filter_stream)(&stream);
+	return return_code;
+}
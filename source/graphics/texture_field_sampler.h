@@ -0,0 +1,87 @@
+/**
+ * FILE : texture_field_sampler.h
+ *
+ * Fills a texture image with the colours of a field, sampled at the
+ * locations where a texture coordinate field matches each texel, converting
+ * the values to pixels on several threads.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (TEXTURE_FIELD_SAMPLER_H)
+#define TEXTURE_FIELD_SAMPLER_H
+
+#include <stddef.h>
+#include "opencmiss/zinc/types/elementid.h"
+#include "opencmiss/zinc/types/fieldid.h"
+#include "opencmiss/zinc/types/materialid.h"
+#include "opencmiss/zinc/types/spectrumid.h"
+#include "graphics/texture.h"
+
+/**
+ * Receives the field values of each plane evaluated by
+ * Texture_evaluate_field_image, components fastest, then x and y.
+ * @return  1 to continue, 0 if no more values are wanted.
+ */
+typedef int (*Texture_field_values_function)(const double *values,
+	size_t number_of_values, void *user_data);
+
+/**
+ * Sets every texel of the image already allocated in <texture> to the colour
+ * of <field> through <spectrum>, at the texel centre's texture coordinates.
+ * If <propagate_field> or <use_pixel_location> is set, the field is first
+ * evaluated with the texture coordinates assigned directly. Otherwise, or if
+ * that fails, the location is found in <search_mesh> with a
+ * Mesh_location_index, starting from the element found for the previous
+ * texel. Texels with no location get the diffuse colour and alpha of
+ * <fail_material>, or are cleared if it is NULL.
+ * Each plane is evaluated on the calling thread with one field cache, as Zinc
+ * field evaluation is not thread safe. Its rows are then converted to pixels
+ * through <spectrum> on up to <number_of_threads> threads and the plane is
+ * written to the texture.
+ * @param number_of_threads  Maximum number of threads converting pixels, or 0
+ * for the number of processors.
+ * @param values_function  Optional function receiving the field values of
+ * each plane while every texel so far was evaluated directly. Not called
+ * again once a texel fails or it returns 0.
+ * @return  1 on success, 0 on failure.
+ */
+int Texture_evaluate_field_image(struct Texture *texture, cmzn_field_id field,
+	cmzn_field_id texture_coordinate_field, int propagate_field,
+	int use_pixel_location, cmzn_spectrum_id spectrum,
+	cmzn_material_id fail_material, int image_width, int image_height,
+	int image_depth, enum Texture_storage_type storage,
+	int number_of_bytes_per_component, double texture_width,
+	double texture_height, double texture_depth, cmzn_mesh_id search_mesh,
+	int number_of_threads, Texture_field_values_function values_function,
+	void *values_user_data);
+
+/**
+ * Sets every texel of the image already allocated in <texture> from a chain
+ * of image filter fields ending at <field>, filtering one tile of
+ * <tile_sizes> texels at a time so no filter holds a buffer for the whole
+ * image. Each tile's filters read the tile plus the halo the chain needs, so
+ * the result matches filtering the whole image. Chains including filters
+ * which depend on the whole image, curvature anisotropic diffusion and canny
+ * edge detection, are rejected. One tile at a time is filtered and evaluated
+ * on the calling thread, then converted to pixels on worker threads and
+ * written to the texture, so memory use is bounded by one tile. The image
+ * must have the field's native resolution.
+ * @param tile_sizes  Array of 3 tile sizes. 0 takes the whole image in that
+ * direction.
+ * @param number_of_threads  Maximum number of threads converting pixels, or 0
+ * for the number of processors.
+ * @return  1 on success, 0 on failure including chains of filters which
+ * cannot be streamed.
+ */
+int Texture_evaluate_field_image_streamed(struct Texture *texture,
+	cmzn_field_id field, cmzn_spectrum_id spectrum,
+	cmzn_material_id fail_material, int image_width, int image_height,
+	int image_depth, enum Texture_storage_type storage,
+	int number_of_bytes_per_component, double texture_width,
+	double texture_height, double texture_depth, const int *tile_sizes,
+	int number_of_threads);
+
+#endif /* !defined (TEXTURE_FIELD_SAMPLER_H) */
@@ -0,0 +1,196 @@
+/**
+ * FILE : texture_volume_loader.cpp
+ *
+ * Reads a numbered series of image files into the depth planes of a texture.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string.h>
+#include "general/cmgui_thread.h"
+#include "general/debug.h"
+#include "general/message.h"
+#include "graphics/texture.h"
+#include "graphics/texture_volume_loader.h"
+
+namespace {
+
+/** At most this many progress reports are made for one series. */
+const int TEXTURE_VOLUME_PROGRESS_REPORTS = 10;
+
+struct Texture_volume_read_data
+{
+	const struct Texture_volume_series *series;
+	/* number of the first slice of the current batch in the series */
+	int first_slice;
+	/* image decoded for each slice of the current batch, or NULL on failure */
+	struct Cmgui_image **slices;
+};
+
+/** Decodes one slice of the current batch. Displays no messages as it is
+ * called from worker threads. */
+int Texture_volume_read_slice(int index, void *read_data_void)
+{
+	struct Texture_volume_read_data *read_data =
+		static_cast<struct Texture_volume_read_data *>(read_data_void);
+	const struct Texture_volume_series *series = read_data->series;
+	read_data->slices[index] = 0;
+	struct Cmgui_image_information *information = CREATE(Cmgui_image_information)();
+	if (!information)
+		return 1;
+	const int file_number = series->start +
+		(read_data->first_slice + index)*series->increment;
+	Cmgui_image_information_set_file_name_series(information,
+		series->file_name_template, series->file_number_pattern,
+		/*start*/file_number, /*end*/file_number, /*increment*/1);
+	if (series->width)
+		Cmgui_image_information_set_width(information, series->width);
+	if (series->height)
+		Cmgui_image_information_set_height(information, series->height);
+	Cmgui_image_information_set_io_stream_package(information,
+		series->io_stream_package);
+	Cmgui_image_information_set_raw_image_storage(information,
+		series->raw_image_storage);
+	if (series->number_of_components)
+	{
+		Cmgui_image_information_set_number_of_components(information,
+			series->number_of_components);
+	}
+	if (series->number_of_bytes_per_component)
+	{
+		Cmgui_image_information_set_number_of_bytes_per_component(information,
+			series->number_of_bytes_per_component);
+	}
+	read_data->slices[index] = Cmgui_image_read(information);
+	DESTROY(Cmgui_image_information)(&information);
+	/* keep going so the whole batch finishes; failures are found by the caller */
+	return 1;
+}
+
+}
+
+int Texture_volume_series_read(struct Texture *texture,
+	const struct Texture_volume_series *series, int crop_left, int crop_bottom,
+	int crop_width, int crop_height, int number_of_threads)
+{
+	if (!(texture && series && series->file_name_template &&
+		series->file_number_pattern && (0 < series->number_of_slices) &&
+		(0 <= crop_left) && (0 <= crop_bottom) && (0 <= crop_width) &&
+		(0 <= crop_height)))
+	{
+		display_message(ERROR_MESSAGE,
+			"Texture_volume_series_read.  Invalid argument(s)");
+		return 0;
+	}
+	if (!strstr(series->file_name_template, series->file_number_pattern))
+	{
+		display_message(ERROR_MESSAGE, "Texture_volume_series_read.  "
+			"File number pattern \"%s\" not found in file name \"%s\"",
+			series->file_number_pattern, series->file_name_template);
+		return 0;
+	}
+	const int number_of_slices = series->number_of_slices;
+	if (number_of_threads <= 0)
+		number_of_threads = cmgui_get_number_of_processors();
+	/* limit decoded slices waiting to be added to a few per thread, but
+	 * use larger batches for long series to limit progress reports */
+	int batch_size = 4*number_of_threads;
+	const int progress_batch_size = (number_of_slices +
+		TEXTURE_VOLUME_PROGRESS_REPORTS - 1)/TEXTURE_VOLUME_PROGRESS_REPORTS;
+	if (batch_size < progress_batch_size)
+		batch_size = progress_batch_size;
+	struct Texture_volume_read_data read_data;
+	read_data.series = series;
+	read_data.slices = 0;
+	if (!ALLOCATE(read_data.slices, struct Cmgui_image *, batch_size))
+	{
+		display_message(ERROR_MESSAGE,
+			"Texture_volume_series_read.  Not enough memory");
+		return 0;
+	}
+	int return_code = 1;
+	for (int batch_start = 0; return_code && (batch_start < number_of_slices);
+		batch_start += batch_size)
+	{
+		const int batch_end = (batch_start + batch_size < number_of_slices) ?
+			(batch_start + batch_size) : number_of_slices;
+		read_data.first_slice = batch_start;
+		if (1 == number_of_threads)
+		{
+			for (int i = 0; i < batch_end - batch_start; ++i)
+				Texture_volume_read_slice(i, static_cast<void *>(&read_data));
+		}
+		else
+		{
+			cmgui_parallel_for(number_of_threads, batch_end - batch_start,
+				Texture_volume_read_slice, static_cast<void *>(&read_data));
+		}
+		for (int i = 0; i < batch_end - batch_start; ++i)
+		{
+			struct Cmgui_image *slice = read_data.slices[i];
+			const int slice_number = batch_start + i;
+			if (!slice)
+			{
+				if (return_code)
+				{
+					display_message(ERROR_MESSAGE, "Texture_volume_series_read.  "
+						"Could not read slice %d of %s", series->start +
+						slice_number*series->increment, series->file_name_template);
+					return_code = 0;
+				}
+				continue;
+			}
+			if (return_code)
+			{
+				if (0 == slice_number)
+				{
+					/* records the number series and crop with the texture */
+					return_code = Texture_set_image(texture, slice,
+						series->file_name_template, series->file_number_pattern,
+						series->start, series->stop, series->increment,
+						crop_left, crop_bottom, crop_width, crop_height);
+					if (return_code)
+					{
+						char *property, *value;
+
+						/* properties of the series are those of its first slice */
+						Texture_clear_all_properties(texture);
+						Cmgui_image_get_property(slice, "exif:*");
+						Cmgui_image_reset_property_iterator(slice);
+						while ((property = Cmgui_image_get_next_property(slice)) &&
+							(value = Cmgui_image_get_property(slice, property)))
+						{
+							Texture_set_property(texture, property, value);
+							DEALLOCATE(property);
+							DEALLOCATE(value);
+						}
+					}
+				}
+				else
+				{
+					return_code = Texture_add_image(texture, slice,
+						crop_left, crop_bottom, crop_width, crop_height);
+				}
+				if (!return_code)
+				{
+					display_message(ERROR_MESSAGE, "Texture_volume_series_read.  "
+						"Could not add slice %d of %s to the texture",
+						series->start + slice_number*series->increment,
+						series->file_name_template);
+				}
+			}
+			DESTROY(Cmgui_image)(&slice);
+		}
+		if (return_code && (batch_size < number_of_slices))
+		{
+			display_message(INFORMATION_MESSAGE,
+				"Read %d of %d slices of %s\n", batch_end, number_of_slices,
+				series->file_name_template);
+		}
+	}
+	DEALLOCATE(read_data.slices);
+	return return_code;
+}
@@ -0,0 +1,56 @@
+/**
+ * FILE : texture_volume_loader.h
+ *
+ * Reads a numbered series of image files into the depth planes of a texture,
+ * optionally decoding several slices at a time.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (TEXTURE_VOLUME_LOADER_H)
+#define TEXTURE_VOLUME_LOADER_H
+
+#include "general/image_utilities.h"
+
+struct IO_stream_package;
+struct Texture;
+
+/**
+ * Describes the files of a volume series and how each slice is read. The
+ * width, height, raw_image_storage, number_of_components and
+ * number_of_bytes_per_component are passed on to each slice's
+ * Cmgui_image_information as for a single file; 0 leaves them unset.
+ */
+struct Texture_volume_series
+{
+	const char *file_name_template, *file_number_pattern;
+	int start, stop, increment, number_of_slices;
+	int width, height, number_of_components, number_of_bytes_per_component;
+	enum Raw_image_storage raw_image_storage;
+	struct IO_stream_package *io_stream_package;
+};
+
+/**
+ * Reads every slice of <series> into <texture>. The first slice is set with
+ * Texture_set_image, which records the number series and crop, and gives the
+ * texture its properties; later slices are added in order with
+ * Texture_add_image as soon as their batch is decoded. Only one batch of
+ * decoded slices is held at a time and progress is reported after each batch
+ * of a series needing several.
+ * @param crop_left, crop_bottom, crop_width, crop_height  Part of each slice
+ * copied to the texture. A crop width or height of 0 uses the rest of the
+ * slice in that direction.
+ * @param number_of_threads  Maximum number of threads decoding slices, or 0
+ * for the number of processors. Cmgui_image_read is not safe on worker
+ * threads with every image library, so pass 1, which decodes on the calling
+ * thread, unless the reader is known to be thread safe.
+ * @return  1 on success, or 0 if any slice could not be read or differs in
+ * size or type from the first slice.
+ */
+int Texture_volume_series_read(struct Texture *texture,
+	const struct Texture_volume_series *series, int crop_left, int crop_bottom,
+	int crop_width, int crop_height, int number_of_threads);
+
+#endif /* !defined (TEXTURE_VOLUME_LOADER_H) */
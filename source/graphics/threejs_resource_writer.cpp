@@ -0,0 +1,309 @@
+/**
+ * FILE : threejs_resource_writer.cpp
+ *
+ * Converts the files of a ThreeJS scene export to JSON with binary buffers.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "general/cmgui_thread.h"
+#include "general/debug.h"
+#include "general/message.h"
+#include "graphics/threejs_resource_writer.h"
+
+namespace {
+
+/** Numeric arrays shorter than this are left in the JSON. */
+const int THREEJS_BINARY_MINIMUM_COUNT = 16;
+/** glTF accessor component types */
+const int THREEJS_COMPONENT_TYPE_UNSIGNED_INT = 5125;
+const int THREEJS_COMPONENT_TYPE_FLOAT = 5126;
+
+struct Threejs_resource_convert_data
+{
+	const char *file_prefix;
+	/* file prefix without any directory, for references between files */
+	const char *file_name_prefix;
+	/* set for each resource which could not be converted */
+	char *failed;
+};
+
+std::string threejs_resource_file_name(const char *file_prefix, int number,
+	const char *extension)
+{
+	char number_string[32];
+	sprintf(number_string, "_%d", number);
+	return std::string(file_prefix) + number_string + extension;
+}
+
+/** Reads the whole of file <file_name> into <data> with a single read.
+ * @return  1 on success, 0 if it could not be read, or -1 if it could not be
+ * opened. */
+int threejs_read_file(const std::string &file_name, std::string &data)
+{
+	FILE *file = fopen(file_name.c_str(), "rb");
+	if (!file)
+		return -1;
+	int return_code = 0;
+	long size;
+	if ((0 == fseek(file, 0, SEEK_END)) && (0 <= (size = ftell(file))) &&
+		(0 == fseek(file, 0, SEEK_SET)))
+	{
+		data.resize((size_t)size);
+		return_code = ((0 == size) ||
+			((size_t)size == fread(&data[0], 1, (size_t)size, file))) ? 1 : 0;
+	}
+	fclose(file);
+	return return_code;
+}
+
+int threejs_write_file(const std::string &file_name, const char *data,
+	size_t length)
+{
+	FILE *file = fopen(file_name.c_str(), "wb");
+	if (!file)
+		return 0;
+	int return_code = (length == fwrite(data, 1, length, file));
+	if (0 != fclose(file))
+		return_code = 0;
+	return return_code;
+}
+
+void threejs_append_little_endian(std::vector<unsigned char> &binary,
+	unsigned int value)
+{
+	for (int i = 0; i < 4; ++i)
+	{
+		binary.push_back((unsigned char)(value & 0xff));
+		value >>= 8;
+	}
+}
+
+inline bool threejs_is_number_character(char c)
+{
+	return isdigit((unsigned char)c) || ('-' == c) || ('+' == c) || ('.' == c) ||
+		('e' == c) || ('E' == c);
+}
+
+/**
+ * If the array starting at json[start] == '[' contains only numbers, returns
+ * the index of its closing ']' and the number of values, otherwise 0.
+ */
+size_t threejs_numeric_array_end(const char *json, size_t length, size_t start,
+	int *count_address, bool *integer_address)
+{
+	int count = 0;
+	bool integer = true, in_number = false;
+	for (size_t i = start + 1; i < length; ++i)
+	{
+		const char c = json[i];
+		if (threejs_is_number_character(c))
+		{
+			if (!in_number)
+			{
+				++count;
+				in_number = true;
+				if ('-' == c)
+					integer = false;
+			}
+			if (('.' == c) || ('e' == c) || ('E' == c))
+				integer = false;
+		}
+		else if ((',' == c) || isspace((unsigned char)c))
+		{
+			in_number = false;
+		}
+		else if (']' == c)
+		{
+			*count_address = count;
+			*integer_address = integer;
+			return i;
+		}
+		else
+		{
+			return 0;
+		}
+	}
+	return 0;
+}
+
+/**
+ * Copies <json> to <json_out>, moving numeric arrays into <binary> and
+ * replacing them with accessor objects referring to <binary_uri>.
+ */
+int threejs_json_to_binary(const char *json, size_t length,
+	const std::string &binary_uri, std::string &json_out,
+	std::vector<unsigned char> &binary)
+{
+	json_out.reserve(length/4);
+	size_t i = 0;
+	while (i < length)
+	{
+		const char c = json[i];
+		if ('"' == c)
+		{
+			/* copy strings verbatim so brackets in them are not misread */
+			size_t end = i + 1;
+			while ((end < length) && ('"' != json[end]))
+			{
+				if ('\\' == json[end])
+					++end;
+				++end;
+			}
+			if (end >= length)
+				return 0;
+			json_out.append(json + i, end + 1 - i);
+			i = end + 1;
+			continue;
+		}
+		if ('[' == c)
+		{
+			int count;
+			bool integer;
+			size_t end = threejs_numeric_array_end(json, length, i, &count, &integer);
+			if (end && (count >= THREEJS_BINARY_MINIMUM_COUNT))
+			{
+				const size_t byte_offset = binary.size();
+				binary.reserve(byte_offset + 4*(size_t)count);
+				const char *position = json + i + 1;
+				for (int v = 0; v < count; ++v)
+				{
+					while (!threejs_is_number_character(*position))
+						++position;
+					char *number_end;
+					if (integer)
+					{
+						/* strtod is exact for integers this size, unlike strtoul
+						 * with 32-bit long */
+						double value = strtod(position, &number_end);
+						if (value > 4294967295.0)
+						{
+							/* too large for unsigned int: start again as floats */
+							binary.resize(byte_offset);
+							integer = false;
+							position = json + i + 1;
+							v = -1;
+							continue;
+						}
+						threejs_append_little_endian(binary, (unsigned int)value);
+					}
+					else
+					{
+						float value = (float)strtod(position, &number_end);
+						unsigned int bits;
+						memcpy(&bits, &value, 4);
+						threejs_append_little_endian(binary, bits);
+					}
+					if (number_end == position)
+						return 0;
+					position = number_end;
+				}
+				char accessor[256];
+				sprintf(accessor, "\",\"byteOffset\":%lu,\"count\":%d,"
+					"\"componentType\":%d,\"type\":\"SCALAR\"}",
+					(unsigned long)byte_offset, count, integer ?
+					THREEJS_COMPONENT_TYPE_UNSIGNED_INT : THREEJS_COMPONENT_TYPE_FLOAT);
+				json_out += "{\"uri\":\"";
+				json_out += binary_uri;
+				json_out += accessor;
+				i = end + 1;
+				continue;
+			}
+		}
+		json_out += c;
+		++i;
+	}
+	return 1;
+}
+
+int threejs_convert_resource(int index, void *convert_data_void)
+{
+	struct Threejs_resource_convert_data *convert_data =
+		static_cast<struct Threejs_resource_convert_data *>(convert_data_void);
+	/* resource 1 is the metadata, which is left as Zinc wrote it */
+	const int number = index + 2;
+	const std::string json_file_name =
+		threejs_resource_file_name(convert_data->file_prefix, number, ".json");
+	std::string json_in;
+	int return_code = threejs_read_file(json_file_name, json_in);
+	/* resources Zinc did not use have no file and are skipped */
+	if (-1 == return_code)
+		return 1;
+	if (return_code && (0 < json_in.size()))
+	{
+		std::string json;
+		std::vector<unsigned char> binary;
+		return_code = threejs_json_to_binary(json_in.data(), json_in.size(),
+			threejs_resource_file_name(convert_data->file_name_prefix, number, ".bin"),
+			json, binary);
+		if (return_code && (0 < binary.size()))
+		{
+			return_code = threejs_write_file(threejs_resource_file_name(
+				convert_data->file_prefix, number, ".bin"),
+				reinterpret_cast<const char *>(&binary[0]), binary.size()) &&
+				threejs_write_file(json_file_name, json.data(), json.size());
+		}
+	}
+	if (!return_code)
+		convert_data->failed[index] = 1;
+	/* keep going so one failure does not stop the other files */
+	return 1;
+}
+
+}
+
+int threejs_convert_resources_to_binary(const char *file_prefix,
+	int number_of_resources, int number_of_threads)
+{
+	if (!(file_prefix && (0 <= number_of_resources)))
+	{
+		display_message(ERROR_MESSAGE,
+			"threejs_convert_resources_to_binary.  Invalid argument(s)");
+		return 0;
+	}
+	/* all but the metadata are converted */
+	const int number_to_convert = (0 < number_of_resources) ? number_of_resources - 1 : 0;
+	struct Threejs_resource_convert_data convert_data;
+	convert_data.file_prefix = file_prefix;
+	convert_data.file_name_prefix = file_prefix;
+	for (const char *c = file_prefix; *c; ++c)
+	{
+		if (('/' == *c) || ('\\' == *c))
+			convert_data.file_name_prefix = c + 1;
+	}
+	convert_data.failed = 0;
+	if ((0 < number_to_convert) &&
+		!ALLOCATE(convert_data.failed, char, number_to_convert))
+	{
+		display_message(ERROR_MESSAGE,
+			"threejs_convert_resources_to_binary.  Not enough memory");
+		return 0;
+	}
+	for (int i = 0; i < number_to_convert; ++i)
+		convert_data.failed[i] = 0;
+	int return_code = cmgui_parallel_for(number_of_threads, number_to_convert,
+		threejs_convert_resource, static_cast<void *>(&convert_data));
+	/* messages are only displayed from the calling thread */
+	for (int i = 0; i < number_to_convert; ++i)
+	{
+		if (convert_data.failed[i])
+		{
+			display_message(ERROR_MESSAGE,
+				"Could not convert ThreeJS resource %s to binary",
+				threejs_resource_file_name(file_prefix, i + 2, ".json").c_str());
+			return_code = 0;
+		}
+	}
+	if (convert_data.failed)
+		DEALLOCATE(convert_data.failed);
+	return return_code;
+}
@@ -0,0 +1,33 @@
+/**
+ * FILE : threejs_resource_writer.h
+ *
+ * Converts the files of a ThreeJS scene export, several at a time, moving
+ * large numeric arrays into binary buffers.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (THREEJS_RESOURCE_WRITER_H)
+#define THREEJS_RESOURCE_WRITER_H
+
+/**
+ * Converts the files <file_prefix>_2.json to <file_prefix>_<number_of_resources>.json
+ * written by a ThreeJS scene export so each numeric array of at least 16
+ * values is moved to <file_prefix>_<n>.bin as 32-bit little endian unsigned
+ * integers or floats, and replaced in the JSON by a glTF-style accessor object
+ * giving the uri, byteOffset, count and componentType (5125 or 5126) of the
+ * values. Non-integer values are narrowed to float32, keeping about 7
+ * significant digits. Each file is read back once after Zinc writes it, and
+ * its JSON is rewritten in place. The metadata file <file_prefix>_1.json and files which were not
+ * written are left alone. No Zinc objects are used so the files are converted
+ * on up to <number_of_threads> threads, one file at a time on each.
+ * @param number_of_threads  Maximum number of threads, or 0 for the number of
+ * processors.
+ * @return  1 if all files were converted, otherwise 0.
+ */
+int threejs_convert_resources_to_binary(const char *file_prefix,
+	int number_of_resources, int number_of_threads);
+
+#endif /* !defined (THREEJS_RESOURCE_WRITER_H) */
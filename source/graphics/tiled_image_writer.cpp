@@ -0,0 +1,393 @@
+/**
+ * FILE : tiled_image_writer.cpp
+ *
+ * Writes an image to file from tiles of rendered pixels.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include "general/debug.h"
+#include "general/memory_accounting.h"
+#include "general/message.h"
+#include "graphics/tiled_image_writer.h"
+
+namespace {
+
+enum Tiled_image_writer_format
+{
+	TILED_IMAGE_WRITER_FORMAT_INVALID,
+	TILED_IMAGE_WRITER_FORMAT_PNM,
+	TILED_IMAGE_WRITER_FORMAT_TIFF
+};
+
+/** Offset of the first image data in a TIFF file, after its 8 byte header. */
+const long TIFF_DATA_OFFSET = 8;
+
+enum Tiled_image_writer_format Tiled_image_writer_format_from_file_name(
+	const char *file_name)
+{
+	const char *extension = file_name ? strrchr(file_name, '.') : 0;
+	if (extension)
+	{
+		char lower_extension[8];
+		int i;
+		for (i = 0; extension[i] && (i < 7); ++i)
+			lower_extension[i] = (char)tolower((unsigned char)extension[i]);
+		lower_extension[i] = '\0';
+		if ((0 == strcmp(lower_extension, ".tif")) ||
+			(0 == strcmp(lower_extension, ".tiff")))
+			return TILED_IMAGE_WRITER_FORMAT_TIFF;
+		if ((0 == strcmp(lower_extension, ".pgm")) ||
+			(0 == strcmp(lower_extension, ".ppm")) ||
+			(0 == strcmp(lower_extension, ".pnm")) ||
+			(0 == strcmp(lower_extension, ".pam")))
+			return TILED_IMAGE_WRITER_FORMAT_PNM;
+	}
+	return TILED_IMAGE_WRITER_FORMAT_INVALID;
+}
+
+void write_little_endian(FILE *file, unsigned long value, int number_of_bytes)
+{
+	for (int i = 0; i < number_of_bytes; ++i)
+	{
+		fputc((int)(value & 0xff), file);
+		value >>= 8;
+	}
+}
+
+/** Writes a 12 byte TIFF directory entry. Values of up to 4 bytes are stored
+ * in the entry itself, otherwise <value> is the offset of the values. */
+void write_tiff_entry(FILE *file, int tag, int type, unsigned long count,
+	unsigned long value)
+{
+	write_little_endian(file, (unsigned long)tag, 2);
+	write_little_endian(file, (unsigned long)type, 2);
+	write_little_endian(file, count, 4);
+	if ((3 == type) && (1 == count))
+	{
+		/* single SHORT is left justified */
+		write_little_endian(file, value, 2);
+		write_little_endian(file, 0, 2);
+	}
+	else
+	{
+		write_little_endian(file, value, 4);
+	}
+}
+
+}
+
+struct Tiled_image_writer
+{
+	FILE *file;
+	enum Tiled_image_writer_format format;
+	int width, height, number_of_components;
+	size_t row_size;
+	/* rows of the band of tiles being assembled, bottom row first */
+	unsigned char *band;
+	int band_bottom, band_height, band_allocated_height;
+	/* next pixel column expected in the current band */
+	int band_next_left;
+	/* rows from the top of the image already written */
+	int rows_written;
+	int failed;
+};
+
+int Tiled_image_writer_file_name_is_supported(const char *file_name)
+{
+	return (TILED_IMAGE_WRITER_FORMAT_INVALID !=
+		Tiled_image_writer_format_from_file_name(file_name));
+}
+
+struct Tiled_image_writer *CREATE(Tiled_image_writer)(const char *file_name,
+	int width, int height, int number_of_components)
+{
+	struct Tiled_image_writer *writer = 0;
+	enum Tiled_image_writer_format format =
+		Tiled_image_writer_format_from_file_name(file_name);
+	if ((TILED_IMAGE_WRITER_FORMAT_INVALID == format) || (width <= 0) ||
+		(height <= 0) || (number_of_components < 1) || (number_of_components > 4))
+	{
+		display_message(ERROR_MESSAGE,
+			"CREATE(Tiled_image_writer).  Invalid argument(s)");
+		return 0;
+	}
+	if ((TILED_IMAGE_WRITER_FORMAT_TIFF == format) &&
+		((double)width*(double)height*(double)number_of_components +
+			16.0*(double)height + 1024.0 > 4294967295.0))
+	{
+		display_message(ERROR_MESSAGE, "Image %s of %d x %d pixels is too large "
+			"for a TIFF file", file_name, width, height);
+		return 0;
+	}
+	if (ALLOCATE(writer, struct Tiled_image_writer, 1))
+	{
+		writer->format = format;
+		writer->width = width;
+		writer->height = height;
+		writer->number_of_components = number_of_components;
+		writer->row_size = (size_t)width*(size_t)number_of_components;
+		writer->band = 0;
+		writer->band_bottom = height;
+		writer->band_height = 0;
+		writer->band_allocated_height = 0;
+		writer->band_next_left = 0;
+		writer->rows_written = 0;
+		writer->failed = 0;
+		writer->file = fopen(file_name, "wb");
+		if (writer->file)
+		{
+			if (TILED_IMAGE_WRITER_FORMAT_TIFF == format)
+			{
+				/* little endian header; directory offset is filled in by finish */
+				fputs("II", writer->file);
+				write_little_endian(writer->file, 42, 2);
+				write_little_endian(writer->file, 0, 4);
+			}
+			else if (3 == number_of_components)
+			{
+				fprintf(writer->file, "P6\n%d %d\n255\n", width, height);
+			}
+			else if (1 == number_of_components)
+			{
+				fprintf(writer->file, "P5\n%d %d\n255\n", width, height);
+			}
+			else
+			{
+				fprintf(writer->file, "P7\nWIDTH %d\nHEIGHT %d\nDEPTH %d\nMAXVAL 255\n"
+					"TUPLTYPE %s\nENDHDR\n", width, height, number_of_components,
+					(2 == number_of_components) ? "GRAYSCALE_ALPHA" : "RGB_ALPHA");
+			}
+			if (ferror(writer->file))
+			{
+				display_message(ERROR_MESSAGE, "Could not write to file %s", file_name);
+				DESTROY(Tiled_image_writer)(&writer);
+			}
+		}
+		else
+		{
+			display_message(ERROR_MESSAGE, "Could not open file %s for writing",
+				file_name);
+			DEALLOCATE(writer);
+		}
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"CREATE(Tiled_image_writer).  Not enough memory");
+	}
+	return writer;
+}
+
+int DESTROY(Tiled_image_writer)(struct Tiled_image_writer **writer_address)
+{
+	if (writer_address && (*writer_address))
+	{
+		struct Tiled_image_writer *writer = *writer_address;
+		if (writer->file)
+			fclose(writer->file);
+		if (writer->band)
+		{
+			Memory_accounting_remove(MEMORY_ACCOUNTING_TAG_IMAGES,
+				writer->row_size*(size_t)writer->band_allocated_height);
+			DEALLOCATE(writer->band);
+		}
+		DEALLOCATE(*writer_address);
+		return 1;
+	}
+	return 0;
+}
+
+int Tiled_image_writer_add_tile(struct Tiled_image_writer *writer,
+	int left, int bottom, int width, int height, const unsigned char *pixels)
+{
+	if (!(writer && pixels && (width > 0) && (height > 0)))
+	{
+		display_message(ERROR_MESSAGE,
+			"Tiled_image_writer_add_tile.  Invalid argument(s)");
+		return 0;
+	}
+	if (writer->failed)
+		return 0;
+	if (0 == writer->band_next_left)
+	{
+		/* first tile in a new band, which must be directly below the last */
+		if ((0 != left) || (bottom + height != writer->height - writer->rows_written) ||
+			(bottom < 0))
+		{
+			display_message(ERROR_MESSAGE,
+				"Tiled_image_writer_add_tile.  Tile does not start the next band");
+			writer->failed = 1;
+			return 0;
+		}
+		if (height > writer->band_allocated_height)
+		{
+			unsigned char *band;
+			if (REALLOCATE(band, writer->band, unsigned char,
+				writer->row_size*(size_t)height))
+			{
+				if (writer->band)
+				{
+					Memory_accounting_remove(MEMORY_ACCOUNTING_TAG_IMAGES,
+						writer->row_size*(size_t)writer->band_allocated_height);
+				}
+				Memory_accounting_add(MEMORY_ACCOUNTING_TAG_IMAGES,
+					writer->row_size*(size_t)height);
+				writer->band = band;
+				writer->band_allocated_height = height;
+			}
+			else
+			{
+				display_message(ERROR_MESSAGE,
+					"Tiled_image_writer_add_tile.  Not enough memory for band of %d rows",
+					height);
+				writer->failed = 1;
+				return 0;
+			}
+		}
+		writer->band_bottom = bottom;
+		writer->band_height = height;
+	}
+	else if ((left != writer->band_next_left) || (bottom != writer->band_bottom) ||
+		(height != writer->band_height))
+	{
+		display_message(ERROR_MESSAGE,
+			"Tiled_image_writer_add_tile.  Tile is not next in band");
+		writer->failed = 1;
+		return 0;
+	}
+	if (left + width > writer->width)
+	{
+		display_message(ERROR_MESSAGE,
+			"Tiled_image_writer_add_tile.  Tile extends beyond image");
+		writer->failed = 1;
+		return 0;
+	}
+	const size_t tile_row_size = (size_t)width*(size_t)writer->number_of_components;
+	for (int row = 0; row < height; ++row)
+	{
+		memcpy(writer->band + writer->row_size*(size_t)row +
+			(size_t)left*(size_t)writer->number_of_components,
+			pixels + tile_row_size*(size_t)row, tile_row_size);
+	}
+	writer->band_next_left = left + width;
+	if (writer->band_next_left == writer->width)
+	{
+		/* band complete: write it top row first */
+		for (int row = height - 1; row >= 0; --row)
+		{
+			if (1 != fwrite(writer->band + writer->row_size*(size_t)row,
+				writer->row_size, 1, writer->file))
+			{
+				display_message(ERROR_MESSAGE,
+					"Tiled_image_writer_add_tile.  Error writing file");
+				writer->failed = 1;
+				return 0;
+			}
+		}
+		writer->rows_written += height;
+		writer->band_next_left = 0;
+	}
+	return 1;
+}
+
+int Tiled_image_writer_finish(struct Tiled_image_writer *writer)
+{
+	if (!writer)
+	{
+		display_message(ERROR_MESSAGE,
+			"Tiled_image_writer_finish.  Invalid argument(s)");
+		return 0;
+	}
+	if (writer->failed || (writer->rows_written != writer->height))
+	{
+		display_message(ERROR_MESSAGE,
+			"Tiled_image_writer_finish.  Only %d of %d rows were written",
+			writer->rows_written, writer->height);
+		return 0;
+	}
+	if (TILED_IMAGE_WRITER_FORMAT_TIFF == writer->format)
+	{
+		/* one row per strip so strips need not match the tile height; rows are
+		 * contiguous after the header so offsets are computed, not recorded */
+		FILE *file = writer->file;
+		const int samples = writer->number_of_components;
+		const int has_alpha = (2 == samples) || (4 == samples);
+		const int number_of_entries = 10 + has_alpha;
+		const unsigned long row_size = (unsigned long)writer->row_size;
+		const unsigned long height = (unsigned long)writer->height;
+		unsigned long offset = (unsigned long)TIFF_DATA_OFFSET + row_size*height;
+		/* directory must start on a word boundary */
+		if (offset & 1)
+		{
+			fputc(0, file);
+			++offset;
+		}
+		const unsigned long directory_offset = offset;
+		const unsigned long bits_offset = directory_offset + 2 +
+			12*(unsigned long)number_of_entries + 4;
+		const unsigned long strip_offsets_offset = bits_offset + 2*(unsigned long)samples;
+		const unsigned long strip_byte_counts_offset = strip_offsets_offset + 4*height;
+		write_little_endian(file, (unsigned long)number_of_entries, 2);
+		write_tiff_entry(file, 256, 4, 1, (unsigned long)writer->width);
+		write_tiff_entry(file, 257, 4, 1, height);
+		if (samples <= 2)
+		{
+			write_tiff_entry(file, 258, 3, (unsigned long)samples,
+				(2 == samples) ? (8UL | (8UL << 16)) : 8UL);
+		}
+		else
+		{
+			write_tiff_entry(file, 258, 3, (unsigned long)samples, bits_offset);
+		}
+		/* compression none */
+		write_tiff_entry(file, 259, 3, 1, 1);
+		/* photometric interpretation: black is zero or RGB */
+		write_tiff_entry(file, 262, 3, 1, (samples <= 2) ? 1 : 2);
+		write_tiff_entry(file, 273, 4, height,
+			(1 == height) ? (unsigned long)TIFF_DATA_OFFSET : strip_offsets_offset);
+		write_tiff_entry(file, 277, 3, 1, (unsigned long)samples);
+		write_tiff_entry(file, 278, 4, 1, 1);
+		write_tiff_entry(file, 279, 4, height,
+			(1 == height) ? row_size : strip_byte_counts_offset);
+		/* planar configuration contiguous */
+		write_tiff_entry(file, 284, 3, 1, 1);
+		if (has_alpha)
+		{
+			/* extra sample is unassociated alpha */
+			write_tiff_entry(file, 338, 3, 1, 2);
+		}
+		/* no further directories */
+		write_little_endian(file, 0, 4);
+		for (int i = 0; i < samples; ++i)
+			write_little_endian(file, 8, 2);
+		if (1 < height)
+		{
+			for (unsigned long row = 0; row < height; ++row)
+				write_little_endian(file, (unsigned long)TIFF_DATA_OFFSET + row*row_size, 4);
+			for (unsigned long row = 0; row < height; ++row)
+				write_little_endian(file, row_size, 4);
+		}
+		if (0 == fseek(file, 4, SEEK_SET))
+		{
+			write_little_endian(file, directory_offset, 4);
+		}
+		else
+		{
+			writer->failed = 1;
+		}
+	}
+	if (writer->failed || (0 != fflush(writer->file)) || ferror(writer->file))
+	{
+		display_message(ERROR_MESSAGE, "Tiled_image_writer_finish.  Error writing file");
+		writer->failed = 1;
+		return 0;
+	}
+	return 1;
+}
@@ -0,0 +1,61 @@
+/**
+ * FILE : tiled_image_writer.h
+ *
+ * Writes an image to file from tiles of rendered pixels, keeping only one band
+ * of tiles in memory so images larger than available memory can be printed.
+ * Supports uncompressed TIFF and binary PNM (PGM, PPM or PAM) files.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (TILED_IMAGE_WRITER_H)
+#define TILED_IMAGE_WRITER_H
+
+#include "general/object.h"
+
+struct Tiled_image_writer;
+
+/**
+ * @return  1 if file_name ends in an extension the tiled image writer can
+ * write: .tif, .tiff, .pgm, .ppm, .pnm or .pam. Otherwise 0.
+ */
+int Tiled_image_writer_file_name_is_supported(const char *file_name);
+
+/**
+ * Creates the file and writes its header. The file format is chosen from the
+ * file name extension; PNM files are written as PGM, PPM or PAM to suit the
+ * number of components.
+ * @param number_of_components  1 = luminance, 2 = luminance+alpha, 3 = RGB,
+ * 4 = RGBA, each one byte per pixel.
+ * @return  New writer, or NULL on failure.
+ */
+struct Tiled_image_writer *CREATE(Tiled_image_writer)(const char *file_name,
+	int width, int height, int number_of_components);
+
+/**
+ * Closes the file. If Tiled_image_writer_finish has not succeeded the file is
+ * left incomplete.
+ */
+int DESTROY(Tiled_image_writer)(struct Tiled_image_writer **writer_address);
+
+/**
+ * Adds a tile of pixels. Tiles must arrive in bands from the top of the image
+ * down and from left to right within each band, and each band must span the
+ * image width. A band is written to file as soon as its last tile arrives.
+ * @param left, bottom  Position of the tile in the image, from bottom left.
+ * @param pixels  width*height pixels with rows from bottom to top, as read
+ * from OpenGL.
+ * @return  1 on success, 0 if out of order or the write failed.
+ */
+int Tiled_image_writer_add_tile(struct Tiled_image_writer *writer,
+	int left, int bottom, int width, int height, const unsigned char *pixels);
+
+/**
+ * Checks all rows have been written and completes the file.
+ * @return  1 on success, otherwise 0.
+ */
+int Tiled_image_writer_finish(struct Tiled_image_writer *writer);
+
+#endif /* !defined (TILED_IMAGE_WRITER_H) */
@@ -13,6 +13,7 @@
 #include "computed_field/computed_field_set.h"
 #include "computed_field/computed_field_set_app.h"
 #include "image_processing/computed_field_connected_threshold_image_filter.h"
+#include "image_processing/connected_threshold_parallel.h"
 
 const char computed_field_connected_threshold_image_filter_type_string[] = "connected_threshold_filter";
 
@@ -23,17 +24,19 @@ int cmzn_field_get_type_connected_threshold_image_filter(struct Computed_field *
 int define_Computed_field_type_connected_threshold_image_filter(struct Parse_state *state,
 	void *field_modify_void, void *computed_field_simple_package_void)
 /*******************************************************************************
-LAST MODIFIED : 30 August 2006
+LAST MODIFIED : 16 October 2026
 
 DESCRIPTION :
 Converts <field> into type COMPUTED_FIELD_CONNECTED_THRESHOLD_IMAGE_FILTER (if it is not
-already) and allows its contents to be modified.
+already) and allows its contents to be modified. With engine parallel, <field>
+becomes an image field with the same values computed on all processors.
 ==============================================================================*/
 {
 	double lower_threshold, upper_threshold, replace_value;
 	int num_seed_points;
 	int seed_dimension;
   double *seed_points;
+	char *engine_name;
 	int return_code;
 	int seed_points_length;
 	int previous_state_index, expected_parameters;
@@ -56,6 +59,7 @@ already) and allows its contents to be modified.
 		num_seed_points = 0;
 		seed_dimension  = 2;
 		seed_points = (double *)NULL;
+		engine_name = (char *)NULL;
 
 		// should probably default to having 1 seed point
 		//		seed_points[0] = 0.5;  // pjb: is this ok?
@@ -87,8 +91,11 @@ already) and allows its contents to be modified.
 				/* Handle help separately */
 				option_table = CREATE(Option_table)();
 			Option_table_add_help(option_table,
-				"The connected_threshold_filter field uses the itk::ConnectedThresholdImageFilter code to segment a field. The <field> it operates on is usually a sample_texture field, based on a texture that has been created from image file(s).  The segmentation is based on a region growing algorithm which requires at least one seed point.  To specify the seed points first set the <num_seed_points> and the <dimension> of the image.  The <seed_points> are a list of the coordinates for the first and any subsequent seed points.  Starting from the seed points any neighbouring pixels with an intensity between <lower_threshold> and the <upper_threshold> are added to the region.  Pixels within the region have their pixel intensity set to <replace_value> while the remaining pixels are set to 0. See a/testing/image_processing_2D for an example of using this field.  For more information see the itk software guide.");
+				"The connected_threshold_filter field uses the itk::ConnectedThresholdImageFilter code to segment a field. The <field> it operates on is usually a sample_texture field, based on a texture that has been created from image file(s).  The segmentation is based on a region growing algorithm which requires at least one seed point.  To specify the seed points first set the <num_seed_points> and the <dimension> of the image.  The <seed_points> are a list of the coordinates for the first and any subsequent seed points.  Starting from the seed points any neighbouring pixels with an intensity between <lower_threshold> and the <upper_threshold> are added to the region.  Pixels within the region have their pixel intensity set to <replace_value> while the remaining pixels are set to 0. See a/testing/image_processing_2D for an example of using this field.  For more information see the itk software guide.  With <engine parallel> the region is found on all processors by labelling the connected components of the pixels within the thresholds, giving the same values; the field becomes an image field, which is found again when the source field changes, and the labels are kept while only the seed points change.");
 
+				/* engine */
+				Option_table_add_string_entry(option_table, "engine", &engine_name,
+					" itk|parallel");
 				/* field */
 				set_source_field_data.computed_field_manager =
 					field_modify->get_field_manager();
@@ -151,6 +158,9 @@ already) and allows its contents to be modified.
 				// pjb: should I populate array with dummy values?
 
 				option_table = CREATE(Option_table)();
+				/* engine */
+				Option_table_add_string_entry(option_table, "engine", &engine_name,
+					" itk|parallel");
 				/* field */
 				set_source_field_data.computed_field_manager =
 					field_modify->get_field_manager();
@@ -189,14 +199,33 @@ already) and allows its contents to be modified.
 						"Missing source field");
 					return_code = 0;
 				}
+				else if (engine_name && strcmp(engine_name, "itk") &&
+					strcmp(engine_name, "parallel"))
+				{
+					display_message(ERROR_MESSAGE,
+						"define_Computed_field_type_connected_threshold_image_filter.  "
+						"Unknown engine '%s'", engine_name);
+					return_code = 0;
+				}
 			}
 			if (return_code)
 			{
-				return_code = field_modify->update_field_and_deaccess(
-					cmzn_fieldmodule_create_field_imagefilter_connected_threshold(
-						field_modify->get_field_module(),
-						source_field, lower_threshold, upper_threshold, replace_value,
-						num_seed_points, seed_dimension, seed_points));
+				if (engine_name && (0 == strcmp(engine_name, "parallel")))
+				{
+					return_code = field_modify->update_field_and_deaccess(
+						Connected_threshold_parallel_create_field(
+							field_modify->get_field_module(),
+							source_field, lower_threshold, upper_threshold, replace_value,
+							num_seed_points, seed_dimension, seed_points));
+				}
+				else
+				{
+					return_code = field_modify->update_field_and_deaccess(
+						cmzn_fieldmodule_create_field_imagefilter_connected_threshold(
+							field_modify->get_field_module(),
+							source_field, lower_threshold, upper_threshold, replace_value,
+							num_seed_points, seed_dimension, seed_points));
+				}
 			}
 
 			if (!return_code)
@@ -219,6 +248,10 @@ already) and allows its contents to be modified.
 			if (seed_points) {
 				DEALLOCATE(seed_points);
 			}
+			if (engine_name)
+			{
+				DEALLOCATE(engine_name);
+			}
 		}
 	}
 	else
@@ -0,0 +1,769 @@
+/**
+ * FILE : connected_threshold_parallel.cpp
+ *
+ * Multithreaded alternative to the ITK connected threshold filter, labelling
+ * the connected components of the thresholded image with a union-find over
+ * slabs so later changes to the seed points reuse the labels.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <algorithm>
+#include <vector>
+#include "opencmiss/zinc/core.h"
+#include "opencmiss/zinc/field.h"
+#include "opencmiss/zinc/fieldcache.h"
+#include "opencmiss/zinc/fieldimage.h"
+#include "opencmiss/zinc/fieldmodule.h"
+#include "opencmiss/zinc/region.h"
+#include "opencmiss/zinc/status.h"
+#include "computed_field/computed_field.h"
+#include "computed_field/computed_field_image.h"
+#include "general/cmgui_thread.h"
+#include "general/debug.h"
+#include "general/memory_accounting.h"
+#include "general/message.h"
+#include "graphics/texture.h"
+#include "image_processing/connected_threshold_parallel.h"
+
+int cmzn_field_image_set_output_range(cmzn_field_image_id image_field, double minimum, double maximum);
+
+namespace {
+
+/** Label of pixels outside the thresholds. */
+const unsigned int CONNECTED_THRESHOLD_OUTSIDE = 0xFFFFFFFFu;
+
+/** Labels of the most recent image, reused while only the seeds change. */
+struct Connected_threshold_labels
+{
+	/* not accessed; cleared when the source field changes or is removed */
+	cmzn_field_id source_field;
+	float lower_threshold, upper_threshold;
+	int sizes[3];
+	/* index of the first pixel of the component containing each pixel, or
+	 * CONNECTED_THRESHOLD_OUTSIDE */
+	std::vector<unsigned int> labels;
+};
+
+Connected_threshold_labels previous_labels;
+
+/**
+ * Gets the texture coordinate sizes of the first image field found among
+ * <field> and its sources, which its native resolution spans.
+ */
+bool Connected_threshold_get_texture_coordinate_sizes(cmzn_field_id field,
+	double *texture_coordinate_sizes)
+{
+	cmzn_field_image_id image = cmzn_field_cast_image(field);
+	if (image)
+	{
+		texture_coordinate_sizes[0] = cmzn_field_image_get_texture_coordinate_width(image);
+		texture_coordinate_sizes[1] = cmzn_field_image_get_texture_coordinate_height(image);
+		texture_coordinate_sizes[2] = cmzn_field_image_get_texture_coordinate_depth(image);
+		cmzn_field_image_destroy(&image);
+		return true;
+	}
+	const int number_of_source_fields = cmzn_field_get_number_of_source_fields(field);
+	for (int i = 1; i <= number_of_source_fields; ++i)
+	{
+		cmzn_field_id source_field = cmzn_field_get_source_field(field, i);
+		const bool found = (0 != source_field) &&
+			Connected_threshold_get_texture_coordinate_sizes(source_field, texture_coordinate_sizes);
+		cmzn_field_destroy(&source_field);
+		if (found)
+			return true;
+	}
+	return false;
+}
+
+/**
+ * Finds the root of the component of pixel <i>, halving the path. Unions
+ * always point the larger root at the smaller, so parent[i] <= i throughout.
+ */
+inline unsigned int Connected_threshold_find_root(unsigned int *parent,
+	unsigned int i)
+{
+	while (parent[i] != i)
+	{
+		parent[i] = parent[parent[i]];
+		i = parent[i];
+	}
+	return i;
+}
+
+inline void Connected_threshold_unite(unsigned int *parent, unsigned int a,
+	unsigned int b)
+{
+	const unsigned int root_a = Connected_threshold_find_root(parent, a);
+	const unsigned int root_b = Connected_threshold_find_root(parent, b);
+	if (root_a < root_b)
+		parent[root_b] = root_a;
+	else if (root_b < root_a)
+		parent[root_a] = root_b;
+}
+
+struct Connected_threshold_job
+{
+	cmzn_field_id source_field, texture_coordinate_field;
+	int texture_number_of_components;
+	int sizes[3];
+	double texel_size[3];
+	float lower_threshold, upper_threshold;
+	/* slabs are ranges of layers along the last direction with more than one
+	 * pixel, each labelled by one worker */
+	int slab_axis, number_of_slabs;
+	unsigned int *parent;
+	/* final pass */
+	const std::vector<unsigned int> *seed_roots;
+	unsigned char inside_value, outside_value;
+	unsigned char *pixels;
+};
+
+inline int Connected_threshold_get_number_of_layers(const Connected_threshold_job *job)
+{
+	return job->sizes[job->slab_axis];
+}
+
+/** @return  First layer of slab <slab>, or the number of layers for the end
+ * of the last slab. */
+inline int Connected_threshold_get_slab_start(const Connected_threshold_job *job,
+	int slab)
+{
+	return (int)(((long long)slab*Connected_threshold_get_number_of_layers(job))/
+		job->number_of_slabs);
+}
+
+/** @return  Number of pixels in each layer of the slab axis. */
+inline unsigned int Connected_threshold_get_layer_size(const Connected_threshold_job *job)
+{
+	unsigned int layer_size = 1;
+	for (int d = 0; d < job->slab_axis; ++d)
+		layer_size *= (unsigned int)job->sizes[d];
+	return layer_size;
+}
+
+/**
+ * Evaluates the source at each pixel centre, making each pixel within the
+ * thresholds its own component. Evaluates on this thread only as field
+ * evaluation is not thread safe. Pixels which cannot be evaluated are outside.
+ */
+int Connected_threshold_threshold(Connected_threshold_job *job,
+	cmzn_fieldmodule_id field_module)
+{
+	cmzn_fieldcache_id field_cache = cmzn_fieldmodule_create_fieldcache(field_module);
+	if (!field_cache)
+		return 0;
+	double texture_values[3] = { 0.0, 0.0, 0.0 };
+	double value;
+	unsigned int index = 0;
+	for (int k = 0; k < job->sizes[2]; ++k)
+	{
+		texture_values[2] = (k + 0.5)*job->texel_size[2];
+		for (int j = 0; j < job->sizes[1]; ++j)
+		{
+			texture_values[1] = (j + 0.5)*job->texel_size[1];
+			for (int i = 0; i < job->sizes[0]; ++i, ++index)
+			{
+				texture_values[0] = (i + 0.5)*job->texel_size[0];
+				bool inside = false;
+				if ((CMZN_OK == cmzn_fieldcache_set_field_real(field_cache,
+						job->texture_coordinate_field, job->texture_number_of_components,
+						texture_values)) &&
+					(CMZN_OK == cmzn_field_evaluate_real(job->source_field, field_cache,
+						1, &value)))
+				{
+					/* the ITK filter compares its 4 byte real pixels */
+					const float pixel_value = (float)value;
+					inside = (job->lower_threshold <= pixel_value) &&
+						(pixel_value <= job->upper_threshold);
+				}
+				job->parent[index] = inside ? index : CONNECTED_THRESHOLD_OUTSIDE;
+			}
+		}
+	}
+	cmzn_fieldcache_destroy(&field_cache);
+	return 1;
+}
+
+/**
+ * Unites face neighbours within slab <slab>. Components only refer to pixels
+ * in the slab so slabs can be labelled at the same time.
+ */
+int Connected_threshold_label_slab(int slab, void *job_void)
+{
+	Connected_threshold_job *job = static_cast<Connected_threshold_job *>(job_void);
+	const int slab_start = Connected_threshold_get_slab_start(job, slab);
+	const int slab_end = Connected_threshold_get_slab_start(job, slab + 1);
+	const unsigned int layer_size = Connected_threshold_get_layer_size(job);
+	const unsigned int steps[3] = { 1u, (unsigned int)job->sizes[0],
+		(unsigned int)(job->sizes[0]*job->sizes[1]) };
+	unsigned int *parent = job->parent;
+	const unsigned int end = (unsigned int)slab_end*layer_size;
+	int position[3];
+	for (unsigned int index = (unsigned int)slab_start*layer_size; index < end; ++index)
+	{
+		if (CONNECTED_THRESHOLD_OUTSIDE == parent[index])
+			continue;
+		position[0] = (int)(index % steps[1]);
+		position[1] = (int)((index/steps[1]) % (unsigned int)job->sizes[1]);
+		position[2] = (int)(index/steps[2]);
+		for (int d = 0; d < 3; ++d)
+		{
+			if ((0 < position[d]) && ((d != job->slab_axis) || (slab_start < position[d])) &&
+				(CONNECTED_THRESHOLD_OUTSIDE != parent[index - steps[d]]))
+			{
+				Connected_threshold_unite(parent, index, index - steps[d]);
+			}
+		}
+	}
+	return 1;
+}
+
+/** Writes the output value of each pixel of slab <slab>. */
+int Connected_threshold_output_slab(int slab, void *job_void)
+{
+	Connected_threshold_job *job = static_cast<Connected_threshold_job *>(job_void);
+	const unsigned int layer_size = Connected_threshold_get_layer_size(job);
+	const unsigned int end =
+		(unsigned int)Connected_threshold_get_slab_start(job, slab + 1)*layer_size;
+	const unsigned int *labels = job->parent;
+	const std::vector<unsigned int> &seed_roots = *(job->seed_roots);
+	for (unsigned int index =
+		(unsigned int)Connected_threshold_get_slab_start(job, slab)*layer_size;
+		index < end; ++index)
+	{
+		job->pixels[index] = ((CONNECTED_THRESHOLD_OUTSIDE != labels[index]) &&
+			std::binary_search(seed_roots.begin(), seed_roots.end(), labels[index])) ?
+			job->inside_value : job->outside_value;
+	}
+	return 1;
+}
+
+/**
+ * Labels the components of pixels of the source within the thresholds into
+ * <job->parent>: thresholds the source on this thread, labels each slab on
+ * its own worker, unites pixels across slab borders, then points every pixel
+ * at its root.
+ */
+int Connected_threshold_label(Connected_threshold_job *job,
+	cmzn_fieldmodule_id field_module, int number_of_threads)
+{
+	if (!Connected_threshold_threshold(job, field_module))
+		return 0;
+	if (!cmgui_parallel_for(number_of_threads, job->number_of_slabs,
+		Connected_threshold_label_slab, static_cast<void *>(job)))
+	{
+		return 0;
+	}
+	const unsigned int layer_size = Connected_threshold_get_layer_size(job);
+	unsigned int *parent = job->parent;
+	for (int slab = 1; slab < job->number_of_slabs; ++slab)
+	{
+		const unsigned int start =
+			(unsigned int)Connected_threshold_get_slab_start(job, slab)*layer_size;
+		for (unsigned int index = start; index < start + layer_size; ++index)
+		{
+			if ((CONNECTED_THRESHOLD_OUTSIDE != parent[index]) &&
+				(CONNECTED_THRESHOLD_OUTSIDE != parent[index - layer_size]))
+			{
+				Connected_threshold_unite(parent, index, index - layer_size);
+			}
+		}
+	}
+	/* parents precede their children, so one pass in order reaches the roots */
+	const unsigned int number_of_pixels =
+		layer_size*(unsigned int)Connected_threshold_get_number_of_layers(job);
+	for (unsigned int index = 0; index < number_of_pixels; ++index)
+	{
+		if (CONNECTED_THRESHOLD_OUTSIDE != parent[index])
+			parent[index] = parent[parent[index]];
+	}
+	return 1;
+}
+
+
+void Connected_threshold_free_labels()
+{
+	if (!previous_labels.labels.empty())
+	{
+		Memory_accounting_remove(MEMORY_ACCOUNTING_TAG_IMAGE_LABELS,
+			previous_labels.labels.size()*sizeof(unsigned int));
+	}
+	std::vector<unsigned int>().swap(previous_labels.labels);
+	previous_labels.source_field = 0;
+}
+
+/** Image of the components of a source containing the seed points. */
+struct Connected_threshold_image
+{
+	cmzn_field_id texture_coordinate_field;
+	double texture_coordinate_sizes[3];
+	int sizes[3];
+	/* range the 8 bit pixels are scaled to */
+	double minimum, maximum;
+	std::vector<unsigned char> pixels;
+};
+
+/**
+ * Finds the pixels of <source_field> connected to the seed points within the
+ * thresholds. Labels the source again unless the labels of the previous call
+ * were for the same source and thresholds, and the source has not changed
+ * since.
+ * @return  1 on success, 0 with an error message on failure.
+ */
+int Connected_threshold_get_image(cmzn_fieldmodule_id field_module,
+	cmzn_field_id source_field, double lower_threshold, double upper_threshold,
+	double replace_value, int number_of_seed_points, int seed_dimension,
+	const double *seed_points, struct Connected_threshold_image &image)
+{
+	int dimension = 0, *native_sizes = 0;
+	struct Computed_field *texture_coordinate_field = 0;
+	if (!(Computed_field_get_native_resolution(source_field, &dimension,
+			&native_sizes, &texture_coordinate_field) && (0 < dimension) &&
+		(dimension <= 3) && texture_coordinate_field &&
+		(cmzn_field_get_number_of_components(texture_coordinate_field) <= 3) &&
+		Connected_threshold_get_texture_coordinate_sizes(source_field,
+			image.texture_coordinate_sizes)))
+	{
+		display_message(ERROR_MESSAGE, "connected_threshold_filter engine parallel:  "
+			"Source field is not based on an image");
+		if (native_sizes)
+			DEALLOCATE(native_sizes);
+		return 0;
+	}
+	if ((0 < number_of_seed_points) && (seed_dimension != dimension))
+	{
+		display_message(ERROR_MESSAGE, "connected_threshold_filter engine parallel:  "
+			"Seed dimension %d does not match image dimension %d", seed_dimension, dimension);
+		DEALLOCATE(native_sizes);
+		return 0;
+	}
+	image.texture_coordinate_field = texture_coordinate_field;
+	Connected_threshold_job job;
+	job.source_field = source_field;
+	job.texture_coordinate_field = texture_coordinate_field;
+	job.texture_number_of_components =
+		cmzn_field_get_number_of_components(texture_coordinate_field);
+	job.lower_threshold = (float)lower_threshold;
+	job.upper_threshold = (float)upper_threshold;
+	double number_of_pixels_real = 1.0;
+	job.slab_axis = 0;
+	for (int d = 0; d < 3; ++d)
+	{
+		job.sizes[d] = (d < dimension) ? native_sizes[d] : 1;
+		image.sizes[d] = job.sizes[d];
+		job.texel_size[d] = image.texture_coordinate_sizes[d]/job.sizes[d];
+		number_of_pixels_real *= (double)job.sizes[d];
+		if (1 < job.sizes[d])
+			job.slab_axis = d;
+	}
+	DEALLOCATE(native_sizes);
+	if (number_of_pixels_real >= (double)CONNECTED_THRESHOLD_OUTSIDE)
+	{
+		display_message(ERROR_MESSAGE, "connected_threshold_filter engine parallel:  "
+			"Image has too many pixels");
+		return 0;
+	}
+	const unsigned int number_of_pixels = (unsigned int)number_of_pixels_real;
+	const int number_of_threads = cmgui_get_number_of_processors();
+	job.number_of_slabs = std::min(number_of_threads,
+		Connected_threshold_get_number_of_layers(&job));
+
+	bool reuse = (previous_labels.source_field == source_field) &&
+		(previous_labels.lower_threshold == job.lower_threshold) &&
+		(previous_labels.upper_threshold == job.upper_threshold) &&
+		(previous_labels.labels.size() == number_of_pixels);
+	for (int d = 0; reuse && (d < 3); ++d)
+		reuse = (previous_labels.sizes[d] == job.sizes[d]);
+	if (!reuse)
+	{
+		Connected_threshold_free_labels();
+		std::vector<unsigned int> labels(number_of_pixels);
+		job.parent = &(labels[0]);
+		if (!Connected_threshold_label(&job, field_module, number_of_threads))
+		{
+			display_message(ERROR_MESSAGE, "connected_threshold_filter engine parallel:  "
+				"Failed to label image");
+			return 0;
+		}
+		previous_labels.source_field = source_field;
+		previous_labels.lower_threshold = job.lower_threshold;
+		previous_labels.upper_threshold = job.upper_threshold;
+		for (int d = 0; d < 3; ++d)
+			previous_labels.sizes[d] = job.sizes[d];
+		previous_labels.labels.swap(labels);
+		Memory_accounting_add(MEMORY_ACCOUNTING_TAG_IMAGE_LABELS,
+			previous_labels.labels.size()*sizeof(unsigned int));
+	}
+	job.parent = &(previous_labels.labels[0]);
+
+	/* like ITK, ignore seeds outside the image */
+	std::vector<unsigned int> seed_roots;
+	for (int s = 0; s < number_of_seed_points; ++s)
+	{
+		unsigned int index = 0, step = 1;
+		bool inside = true;
+		for (int d = 0; d < dimension; ++d)
+		{
+			const double position = seed_points[s*seed_dimension + d]*job.sizes[d];
+			if (!((0.0 <= position) && (position < (double)job.sizes[d])))
+			{
+				inside = false;
+				break;
+			}
+			index += (unsigned int)position*step;
+			step *= (unsigned int)job.sizes[d];
+		}
+		if (inside && (CONNECTED_THRESHOLD_OUTSIDE != job.parent[index]))
+			seed_roots.push_back(job.parent[index]);
+	}
+	std::sort(seed_roots.begin(), seed_roots.end());
+	job.seed_roots = &seed_roots;
+
+	/* the ITK filter writes 4 byte reals; 8 bit pixels scaled to a range with
+	 * the replace value at one end restore it exactly */
+	const float output_value = (float)replace_value;
+	image.minimum = 0.0;
+	image.maximum = 1.0;
+	job.inside_value = 0;
+	job.outside_value = 0;
+	if (0.0f < output_value)
+	{
+		image.maximum = output_value;
+		job.inside_value = 255;
+	}
+	else if (output_value < 0.0f)
+	{
+		image.minimum = output_value;
+		image.maximum = 0.0;
+		job.outside_value = 255;
+	}
+	image.pixels.resize(number_of_pixels);
+	job.pixels = &(image.pixels[0]);
+	cmgui_parallel_for(number_of_threads, job.number_of_slabs,
+		Connected_threshold_output_slab, static_cast<void *>(&job));
+	return 1;
+}
+
+/** Allocates the image of <texture> and sets it to the pixels of <image>. */
+int Connected_threshold_set_texture(struct Texture *texture,
+	const struct Connected_threshold_image &image)
+{
+	const char *texture_name = "connected_threshold";
+	int return_code = Texture_allocate_image(texture,
+		image.sizes[0], image.sizes[1], image.sizes[2], TEXTURE_LUMINANCE,
+		/*number_of_bytes_per_component*/1, texture_name);
+	const size_t plane_size = (size_t)image.sizes[0]*image.sizes[1];
+	for (int k = 0; return_code && (k < image.sizes[2]); ++k)
+	{
+		return_code = Texture_set_image_block(texture, /*left*/0, /*bottom*/0,
+			image.sizes[0], image.sizes[1], /*depth_plane*/k, image.sizes[0],
+			const_cast<unsigned char *>(&(image.pixels[k*plane_size])));
+	}
+	if (return_code)
+	{
+		Texture_set_filter_mode(texture, TEXTURE_NEAREST_FILTER);
+		Texture_set_physical_size(texture, image.texture_coordinate_sizes[0],
+			image.texture_coordinate_sizes[1], image.texture_coordinate_sizes[2]);
+	}
+	return return_code;
+}
+
+/** Parameters of an image field created by the engine, to find its image
+ * again when its source changes. */
+struct Connected_threshold_output
+{
+	/* not accessed; cleared when the source field is removed */
+	cmzn_field_id source_field;
+	double lower_threshold, upper_threshold, replace_value;
+	int number_of_seed_points, seed_dimension;
+	std::vector<double> seed_points;
+	/* accessed; identifies the image fields showing the output */
+	struct Texture *texture;
+	bool source_changed;
+};
+
+/** Fields created by the engine in a region, with the notifier of changes to
+ * their sources and removal of the fields. */
+struct Connected_threshold_region
+{
+	cmzn_fieldmodule_id field_module;
+	cmzn_fieldmodulenotifier_id notifier;
+	std::vector<Connected_threshold_output> outputs;
+};
+
+std::vector<Connected_threshold_region *> output_regions;
+
+/** @return  Texture of <field> if it is an image field, otherwise NULL. */
+struct Texture *Connected_threshold_get_field_texture(cmzn_field_id field)
+{
+	struct Texture *texture = 0;
+	cmzn_field_image_id image = cmzn_field_cast_image(field);
+	if (image)
+	{
+		texture = cmzn_field_image_get_texture(image);
+		cmzn_field_image_destroy(&image);
+	}
+	return texture;
+}
+
+/**
+ * Forgets outputs whose texture is no longer used by any field in the region,
+ * then frees the labels if no output remains with their source.
+ */
+void Connected_threshold_prune_outputs(Connected_threshold_region *output_region)
+{
+	std::vector<struct Texture *> textures;
+	cmzn_fielditerator_id iterator =
+		cmzn_fieldmodule_create_fielditerator(output_region->field_module);
+	cmzn_field_id field;
+	while (0 != (field = cmzn_fielditerator_next(iterator)))
+	{
+		struct Texture *texture = Connected_threshold_get_field_texture(field);
+		if (texture)
+			textures.push_back(texture);
+		cmzn_field_destroy(&field);
+	}
+	cmzn_fielditerator_destroy(&iterator);
+	std::vector<Connected_threshold_output> &outputs = output_region->outputs;
+	for (size_t i = outputs.size(); 0 < i--; )
+	{
+		if (std::find(textures.begin(), textures.end(), outputs[i].texture) == textures.end())
+		{
+			DEACCESS(Texture)(&(outputs[i].texture));
+			outputs.erase(outputs.begin() + i);
+		}
+	}
+	if (previous_labels.source_field)
+	{
+		for (size_t r = 0; r < output_regions.size(); ++r)
+		{
+			const std::vector<Connected_threshold_output> &region_outputs = output_regions[r]->outputs;
+			for (size_t i = 0; i < region_outputs.size(); ++i)
+			{
+				if (region_outputs[i].source_field == previous_labels.source_field)
+					return;
+			}
+		}
+		Connected_threshold_free_labels();
+	}
+}
+
+/** Finds the image of each output whose source changed again, and tells the
+ * image fields showing it. */
+void Connected_threshold_update_outputs(Connected_threshold_region *output_region)
+{
+	cmzn_fieldmodule_begin_change(output_region->field_module);
+	std::vector<Connected_threshold_output> &outputs = output_region->outputs;
+	for (size_t i = 0; i < outputs.size(); ++i)
+	{
+		Connected_threshold_output &output = outputs[i];
+		if (!(output.source_changed && output.source_field))
+			continue;
+		output.source_changed = false;
+		struct Connected_threshold_image image;
+		if (!(Connected_threshold_get_image(output_region->field_module,
+				output.source_field, output.lower_threshold, output.upper_threshold,
+				output.replace_value, output.number_of_seed_points, output.seed_dimension,
+				output.seed_points.empty() ? 0 : &(output.seed_points[0]), image) &&
+			Connected_threshold_set_texture(output.texture, image)))
+		{
+			display_message(WARNING_MESSAGE, "connected_threshold_filter engine parallel:  "
+				"Could not update field after its source changed");
+			continue;
+		}
+		cmzn_fielditerator_id iterator =
+			cmzn_fieldmodule_create_fielditerator(output_region->field_module);
+		cmzn_field_id field;
+		while (0 != (field = cmzn_fielditerator_next(iterator)))
+		{
+			if (Connected_threshold_get_field_texture(field) == output.texture)
+			{
+				cmzn_field_image_id image_field = cmzn_field_cast_image(field);
+				cmzn_field_image_set_texture_coordinate_width(image_field,
+					image.texture_coordinate_sizes[0]);
+				cmzn_field_image_set_texture_coordinate_height(image_field,
+					image.texture_coordinate_sizes[1]);
+				cmzn_field_image_set_texture_coordinate_depth(image_field,
+					image.texture_coordinate_sizes[2]);
+				/* setting the same texture marks the field changed */
+				cmzn_field_image_set_texture(image_field, output.texture);
+				cmzn_field_image_destroy(&image_field);
+			}
+			cmzn_field_destroy(&field);
+		}
+		cmzn_fielditerator_destroy(&iterator);
+	}
+	cmzn_fieldmodule_end_change(output_region->field_module);
+}
+
+/**
+ * Frees the labels if their source changed or was removed, updates outputs
+ * whose source changed and forgets outputs whose fields were removed.
+ */
+void Connected_threshold_fieldmoduleevent(cmzn_fieldmoduleevent_id event,
+	void *output_region_void)
+{
+	Connected_threshold_region *output_region =
+		static_cast<Connected_threshold_region *>(output_region_void);
+	if (!(event && output_region))
+		return;
+	const cmzn_field_change_flags source_change_flags =
+		CMZN_FIELD_CHANGE_FLAG_RESULT | CMZN_FIELD_CHANGE_FLAG_REMOVE;
+	if (previous_labels.source_field && (0 != (source_change_flags &
+		cmzn_fieldmoduleevent_get_field_change_flags(event, previous_labels.source_field))))
+	{
+		Connected_threshold_free_labels();
+	}
+	bool source_changed = false;
+	std::vector<Connected_threshold_output> &outputs = output_region->outputs;
+	for (size_t i = 0; i < outputs.size(); ++i)
+	{
+		if (!outputs[i].source_field)
+			continue;
+		const cmzn_field_change_flags change_flags =
+			cmzn_fieldmoduleevent_get_field_change_flags(event, outputs[i].source_field);
+		if (change_flags & CMZN_FIELD_CHANGE_FLAG_REMOVE)
+			outputs[i].source_field = 0;
+		else if (change_flags & CMZN_FIELD_CHANGE_FLAG_RESULT)
+			outputs[i].source_changed = source_changed = true;
+	}
+	Connected_threshold_prune_outputs(output_region);
+	if (source_changed)
+		Connected_threshold_update_outputs(output_region);
+}
+
+/**
+ * Gets the outputs of the region of <field_module>, adding a notifier for it
+ * if needed. Destroys the notifiers of regions with no outputs left, which
+ * cannot be done from their own callback.
+ */
+Connected_threshold_region *Connected_threshold_get_region(
+	cmzn_fieldmodule_id field_module)
+{
+	cmzn_region_id region = cmzn_fieldmodule_get_region(field_module);
+	Connected_threshold_region *output_region = 0;
+	for (size_t r = output_regions.size(); 0 < r--; )
+	{
+		cmzn_region_id output_region_region =
+			cmzn_fieldmodule_get_region(output_regions[r]->field_module);
+		if (output_region_region == region)
+		{
+			output_region = output_regions[r];
+		}
+		else if (output_regions[r]->outputs.empty())
+		{
+			cmzn_fieldmodulenotifier_destroy(&(output_regions[r]->notifier));
+			cmzn_fieldmodule_destroy(&(output_regions[r]->field_module));
+			delete output_regions[r];
+			output_regions.erase(output_regions.begin() + r);
+		}
+		cmzn_region_destroy(&output_region_region);
+	}
+	cmzn_region_destroy(&region);
+	if (!output_region)
+	{
+		output_region = new Connected_threshold_region();
+		output_region->field_module = cmzn_fieldmodule_access(field_module);
+		output_region->notifier = cmzn_fieldmodule_create_fieldmodulenotifier(field_module);
+		cmzn_fieldmodulenotifier_set_callback(output_region->notifier,
+			Connected_threshold_fieldmoduleevent, static_cast<void *>(output_region));
+		output_regions.push_back(output_region);
+	}
+	return output_region;
+}
+
+}
+
+cmzn_field_id Connected_threshold_parallel_create_field(
+	cmzn_fieldmodule_id field_module, cmzn_field_id source_field,
+	double lower_threshold, double upper_threshold, double replace_value,
+	int number_of_seed_points, int seed_dimension, const double *seed_points)
+{
+	if (!(field_module && source_field &&
+		(1 == cmzn_field_get_number_of_components(source_field)) &&
+		(0 <= number_of_seed_points) && ((0 == number_of_seed_points) || seed_points)))
+	{
+		display_message(ERROR_MESSAGE,
+			"Connected_threshold_parallel_create_field.  Invalid argument(s)");
+		return 0;
+	}
+	/* the notifier must exist before labels are kept for the source */
+	Connected_threshold_region *output_region = Connected_threshold_get_region(field_module);
+	struct Connected_threshold_image image;
+	if (!Connected_threshold_get_image(field_module, source_field, lower_threshold,
+		upper_threshold, replace_value, number_of_seed_points, seed_dimension,
+		seed_points, image))
+	{
+		return 0;
+	}
+	struct Texture *texture = ACCESS(Texture)(CREATE(Texture)("connected_threshold"));
+	int return_code = (0 != texture) && Connected_threshold_set_texture(texture, image);
+	cmzn_field_id field = 0;
+	if (return_code)
+	{
+		field = cmzn_fieldmodule_create_field_image(field_module);
+		cmzn_field_image_id image_field = cmzn_field_cast_image(field);
+		return_code = (0 != image_field) &&
+			(CMZN_OK == cmzn_field_image_set_texture(image_field, texture));
+		if (return_code)
+		{
+			cmzn_field_image_set_domain_field(image_field, image.texture_coordinate_field);
+			cmzn_field_image_set_texture_coordinate_width(image_field,
+				image.texture_coordinate_sizes[0]);
+			cmzn_field_image_set_texture_coordinate_height(image_field,
+				image.texture_coordinate_sizes[1]);
+			cmzn_field_image_set_texture_coordinate_depth(image_field,
+				image.texture_coordinate_sizes[2]);
+			cmzn_field_image_set_output_range(image_field, image.minimum, image.maximum);
+		}
+		cmzn_field_image_destroy(&image_field);
+		if (!return_code)
+			cmzn_field_destroy(&field);
+	}
+	if (field)
+	{
+		Connected_threshold_output output;
+		output.source_field = source_field;
+		output.lower_threshold = lower_threshold;
+		output.upper_threshold = upper_threshold;
+		output.replace_value = replace_value;
+		output.number_of_seed_points = number_of_seed_points;
+		output.seed_dimension = seed_dimension;
+		if (0 < number_of_seed_points)
+		{
+			output.seed_points.assign(seed_points,
+				seed_points + number_of_seed_points*seed_dimension);
+		}
+		output.texture = texture;
+		output.source_changed = false;
+		output_region->outputs.push_back(output);
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE, "connected_threshold_filter engine parallel:  "
+			"Could not create image field");
+		if (texture)
+			DEACCESS(Texture)(&texture);
+	}
+	return field;
+}
+
+int Connected_threshold_parallel_clear(void)
+{
+	for (size_t r = 0; r < output_regions.size(); ++r)
+	{
+		std::vector<Connected_threshold_output> &outputs = output_regions[r]->outputs;
+		for (size_t i = 0; i < outputs.size(); ++i)
+			DEACCESS(Texture)(&(outputs[i].texture));
+		cmzn_fieldmodulenotifier_destroy(&(output_regions[r]->notifier));
+		cmzn_fieldmodule_destroy(&(output_regions[r]->field_module));
+		delete output_regions[r];
+	}
+	output_regions.clear();
+	Connected_threshold_free_labels();
+	return 1;
+}
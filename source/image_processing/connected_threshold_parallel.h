@@ -0,0 +1,46 @@
+/**
+ * FILE : connected_threshold_parallel.h
+ *
+ * Multithreaded alternative to the ITK connected threshold filter, labelling
+ * the connected components of the thresholded image with a union-find over
+ * slabs so later changes to the seed points reuse the labels.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (CONNECTED_THRESHOLD_PARALLEL_H)
+#define CONNECTED_THRESHOLD_PARALLEL_H
+
+#include "opencmiss/zinc/types/fieldid.h"
+#include "opencmiss/zinc/types/fieldmoduleid.h"
+
+/**
+ * Creates an image field with the same values as a connected_threshold_filter
+ * of <source_field>: <replace_value> at pixels of its native resolution
+ * connected through face neighbours to a seed by pixels with values from
+ * <lower_threshold> to <upper_threshold>, and 0 elsewhere. Thresholds and
+ * values are compared as 4 byte reals like the ITK filter, and seed points are
+ * texture coordinates over [0,1] in each direction locating the pixel they
+ * are in. The source is evaluated on this thread and labelled on all
+ * processors.
+ * The labels of the last call are kept, and reused for the same source field
+ * and thresholds so moving seeds only repeats the final pass. They are freed
+ * when the source changes or is removed, or no field created from it is left.
+ * When the source changes, the images of fields created from it are found
+ * again.
+ * @return  New field, not managed, or NULL with an error message on failure.
+ */
+cmzn_field_id Connected_threshold_parallel_create_field(
+	cmzn_fieldmodule_id field_module, cmzn_field_id source_field,
+	double lower_threshold, double upper_threshold, double replace_value,
+	int number_of_seed_points, int seed_dimension, const double *seed_points);
+
+/**
+ * Stops updating fields created by Connected_threshold_parallel_create_field
+ * and frees the labels. Call before regions are destroyed.
+ */
+int Connected_threshold_parallel_clear(void);
+
+#endif /* !defined (CONNECTED_THRESHOLD_PARALLEL_H) */
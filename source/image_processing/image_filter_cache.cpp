@@ -0,0 +1,1209 @@
+/**
+ * FILE : image_filter_cache.cpp
+ *
+ * Directory of image filter field results kept between sessions.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include "opencmiss/zinc/core.h"
+#include "opencmiss/zinc/field.h"
+#include "opencmiss/zinc/fieldarithmeticoperators.h"
+#include "opencmiss/zinc/fieldcache.h"
+#include "opencmiss/zinc/fieldimage.h"
+#include "opencmiss/zinc/fieldimageprocessing.h"
+#include "opencmiss/zinc/fieldmodule.h"
+#include "opencmiss/zinc/region.h"
+#include "opencmiss/zinc/status.h"
+#include "computed_field/computed_field.h"
+#include "computed_field/computed_field_image.h"
+#include "computed_field/computed_field_private.hpp"
+#include "computed_field/field_module.hpp"
+#include "general/debug.h"
+#include "general/memory_accounting.h"
+#include "general/message.h"
+#include "graphics/texture.h"
+#include "image_processing/image_filter_cache.h"
+
+/* implemented with the filter fields; declared here as in their _app files */
+int cmzn_field_get_type_mean_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, int **radius_sizes);
+int cmzn_field_get_type_discrete_gaussian_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, double *variance, int *maxKernelWidth);
+int cmzn_field_get_type_curvature_anisotropic_diffusion_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, double *timeStep, double *conductance, int *numIterations);
+int cmzn_field_get_type_canny_edge_detection_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, double *variance, double *maximumError,
+	double *upperThreshold, double *lowerThreshold);
+int cmzn_field_get_type_derivative_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, int *order, int *direction);
+int cmzn_field_get_type_binary_dilate_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, int *radius, double *dilate_value);
+int cmzn_field_get_type_binary_erode_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, int *radius, double *erode_value);
+int cmzn_field_get_type_sigmoid_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, double *min, double *max, double *alpha, double *beta);
+int cmzn_field_get_type_threshold_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field,
+	enum cmzn_field_imagefilter_threshold_condition *condition,
+	double *outsideValue, double *lowerValue, double *upperValue);
+int cmzn_field_get_type_binary_threshold_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, double *lower_threshold,
+	double *upper_threshold);
+int cmzn_field_get_type_rescale_intensity_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, double *outputMin, double *outputMax);
+int cmzn_field_get_type_gradient_magnitude_recursive_gaussian_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, double *sigma);
+int cmzn_field_get_type_connected_threshold_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, double *lower_threshold, double *upper_threshold,
+	double *replace_value, int *num_seed_points, int *seed_dimension, double **seed_points);
+int cmzn_field_get_type_fast_marching_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, double *stopping_value,
+	int *num_seed_points, int *dimension, double **seed_points,
+	double **seed_values, int **output_size);
+int cmzn_field_get_type_image_resample(struct Computed_field *field,
+	struct Computed_field **source_field, int *dimension, int **sizes);
+
+int cmzn_field_image_set_output_range(cmzn_field_image_id image_field, double minimum, double maximum);
+
+namespace {
+
+const unsigned long long FNV_OFFSET_BASIS = 14695981039346656037ULL;
+const unsigned long long FNV_PRIME = 1099511628211ULL;
+
+inline unsigned long long fnv1a_hash(unsigned long long hash,
+	const void *data, size_t size)
+{
+	const unsigned char *bytes = static_cast<const unsigned char *>(data);
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash ^= bytes[i];
+		hash *= FNV_PRIME;
+	}
+	return hash;
+}
+
+const char IMAGE_FILTER_CACHE_INDEX_HEADER[] = "cmgui_image_filter_cache 2";
+
+const char IMAGE_FILTER_CACHE_MAGIC[8] = { 'c', 'm', 'g', 'u', 'i', 'i', 'f', '2' };
+
+/** Start of each result file, followed by the values as 4 byte reals with
+ * components fastest, then x, y and z. */
+struct Image_filter_cache_file_header
+{
+	char magic[8];
+	int dimension, sizes[3], number_of_components;
+	/* range of all values */
+	double minimum, maximum;
+};
+
+struct Image_filter_cache_entry
+{
+	long long size;
+	/* value of the cache use counter when last stored or read */
+	unsigned long last_use;
+};
+
+typedef std::map<unsigned long long, Image_filter_cache_entry> Image_filter_cache_entry_map;
+
+template <typename Value> void Image_filter_cache_append(
+	std::vector<double> &parameters, int count, const Value *values)
+{
+	parameters.push_back((double)count);
+	for (int i = 0; i < count; ++i)
+		parameters.push_back((double)values[i]);
+}
+
+/** @return  Dimension of the native resolution of <field>, or 0 if none. */
+int Image_filter_cache_get_dimension(struct Computed_field *field)
+{
+	int dimension = 0, *sizes = 0;
+	struct Computed_field *texture_coordinate_field = 0;
+	if (!Computed_field_get_native_resolution(field, &dimension, &sizes,
+		&texture_coordinate_field))
+	{
+		dimension = 0;
+	}
+	if (sizes)
+		DEALLOCATE(sizes);
+	return dimension;
+}
+
+/**
+ * If <field> is an image filter or image_resample field, appends its
+ * parameters to <parameters> and returns its accessed source field, otherwise
+ * returns NULL. Sets <store> if its result is worth keeping.
+ */
+cmzn_field_id Image_filter_cache_get_filter(cmzn_field_id field,
+	const char *type_string, std::vector<double> &parameters, bool &store)
+{
+	struct Computed_field *source_field = 0;
+	double values[4] = { 0.0, 0.0, 0.0, 0.0 };
+	int int_values[2] = { 0, 0 };
+	int return_code = 0;
+	store = true;
+	if (0 == strcmp(type_string, "mean_filter"))
+	{
+		int *radius_sizes = 0;
+		return_code = cmzn_field_get_type_mean_image_filter(field, &source_field,
+			&radius_sizes) && radius_sizes;
+		if (return_code)
+		{
+			Image_filter_cache_append(parameters,
+				Image_filter_cache_get_dimension(source_field), radius_sizes);
+		}
+		if (radius_sizes)
+			DEALLOCATE(radius_sizes);
+	}
+	else if (0 == strcmp(type_string, "discrete_gaussian_filter"))
+	{
+		return_code = cmzn_field_get_type_discrete_gaussian_image_filter(field,
+			&source_field, &values[0], &int_values[0]);
+		Image_filter_cache_append(parameters, 1, values);
+		Image_filter_cache_append(parameters, 1, int_values);
+	}
+	else if (0 == strcmp(type_string, "curvature_anisotropic_diffusion_filter"))
+	{
+		return_code = cmzn_field_get_type_curvature_anisotropic_diffusion_image_filter(
+			field, &source_field, &values[0], &values[1], &int_values[0]);
+		Image_filter_cache_append(parameters, 2, values);
+		Image_filter_cache_append(parameters, 1, int_values);
+	}
+	else if (0 == strcmp(type_string, "canny_edge_detection_filter"))
+	{
+		return_code = cmzn_field_get_type_canny_edge_detection_image_filter(field,
+			&source_field, &values[0], &values[1], &values[2], &values[3]);
+		Image_filter_cache_append(parameters, 4, values);
+	}
+	else if (0 == strcmp(type_string, "derivative_filter"))
+	{
+		return_code = cmzn_field_get_type_derivative_image_filter(field,
+			&source_field, &int_values[0], &int_values[1]);
+		Image_filter_cache_append(parameters, 2, int_values);
+	}
+	else if (0 == strcmp(type_string, "binary_dilate_filter"))
+	{
+		return_code = cmzn_field_get_type_binary_dilate_image_filter(field,
+			&source_field, &int_values[0], &values[0]);
+		Image_filter_cache_append(parameters, 1, int_values);
+		Image_filter_cache_append(parameters, 1, values);
+	}
+	else if (0 == strcmp(type_string, "binary_erode_filter"))
+	{
+		return_code = cmzn_field_get_type_binary_erode_image_filter(field,
+			&source_field, &int_values[0], &values[0]);
+		Image_filter_cache_append(parameters, 1, int_values);
+		Image_filter_cache_append(parameters, 1, values);
+	}
+	else if (0 == strcmp(type_string, "sigmoid_filter"))
+	{
+		return_code = cmzn_field_get_type_sigmoid_image_filter(field,
+			&source_field, &values[0], &values[1], &values[2], &values[3]);
+		Image_filter_cache_append(parameters, 4, values);
+	}
+	else if (0 == strcmp(type_string, "threshold_filter"))
+	{
+		enum cmzn_field_imagefilter_threshold_condition condition;
+		return_code = cmzn_field_get_type_threshold_image_filter(field,
+			&source_field, &condition, &values[0], &values[1], &values[2]);
+		int_values[0] = (int)condition;
+		Image_filter_cache_append(parameters, 1, int_values);
+		Image_filter_cache_append(parameters, 3, values);
+	}
+	else if (0 == strcmp(type_string, "binary_threshold_filter"))
+	{
+		return_code = cmzn_field_get_type_binary_threshold_image_filter(field,
+			&source_field, &values[0], &values[1]);
+		Image_filter_cache_append(parameters, 2, values);
+	}
+	else if (0 == strcmp(type_string, "rescale_intensity_filter"))
+	{
+		return_code = cmzn_field_get_type_rescale_intensity_image_filter(field,
+			&source_field, &values[0], &values[1]);
+		Image_filter_cache_append(parameters, 2, values);
+	}
+	else if (0 == strcmp(type_string, "gradient_magnitude_recursive_gaussian_filter"))
+	{
+		return_code = cmzn_field_get_type_gradient_magnitude_recursive_gaussian_image_filter(
+			field, &source_field, &values[0]);
+		Image_filter_cache_append(parameters, 1, values);
+	}
+	else if (0 == strcmp(type_string, "connected_threshold_filter"))
+	{
+		int number_of_seed_points = 0, seed_dimension = 0;
+		double *seed_points = 0;
+		return_code = cmzn_field_get_type_connected_threshold_image_filter(field,
+			&source_field, &values[0], &values[1], &values[2],
+			&number_of_seed_points, &seed_dimension, &seed_points);
+		Image_filter_cache_append(parameters, 3, values);
+		Image_filter_cache_append(parameters, 1, &seed_dimension);
+		if (seed_points)
+		{
+			Image_filter_cache_append(parameters,
+				number_of_seed_points*seed_dimension, seed_points);
+			DEALLOCATE(seed_points);
+		}
+	}
+	else if (0 == strcmp(type_string, "fast_marching_filter"))
+	{
+		int number_of_seed_points = 0, dimension = 0, *output_size = 0;
+		double *seed_points = 0, *seed_values = 0;
+		return_code = cmzn_field_get_type_fast_marching_image_filter(field,
+			&source_field, &values[0], &number_of_seed_points, &dimension,
+			&seed_points, &seed_values, &output_size) &&
+			seed_points && seed_values && output_size;
+		if (return_code)
+		{
+			Image_filter_cache_append(parameters, 1, values);
+			Image_filter_cache_append(parameters,
+				number_of_seed_points*dimension, seed_points);
+			Image_filter_cache_append(parameters, number_of_seed_points, seed_values);
+			Image_filter_cache_append(parameters, dimension, output_size);
+		}
+		if (seed_points)
+			DEALLOCATE(seed_points);
+		if (seed_values)
+			DEALLOCATE(seed_values);
+		if (output_size)
+			DEALLOCATE(output_size);
+	}
+	else if (0 == strcmp(type_string, "image_resample"))
+	{
+		/* cheap to evaluate, but its parameters are part of later keys */
+		store = false;
+		int dimension = 0, *sizes = 0;
+		return_code = cmzn_field_get_type_image_resample(field, &source_field,
+			&dimension, &sizes) && sizes;
+		if (return_code)
+		{
+			Image_filter_cache_append(parameters, dimension, sizes);
+			std::vector<double> coordinates(4*dimension);
+			cmzn_field_image_resample_id image_resample = cmzn_field_cast_image_resample(field);
+			cmzn_field_image_resample_get_input_coordinates_minimum(image_resample,
+				dimension, &coordinates[0]);
+			cmzn_field_image_resample_get_input_coordinates_maximum(image_resample,
+				dimension, &coordinates[dimension]);
+			cmzn_field_image_resample_get_lookup_coordinates_minimum(image_resample,
+				dimension, &coordinates[2*dimension]);
+			cmzn_field_image_resample_get_lookup_coordinates_maximum(image_resample,
+				dimension, &coordinates[3*dimension]);
+			cmzn_field_image_resample_destroy(&image_resample);
+			Image_filter_cache_append(parameters, 4*dimension, &coordinates[0]);
+		}
+		if (sizes)
+			DEALLOCATE(sizes);
+	}
+	if (!(return_code && source_field))
+		return 0;
+	return cmzn_field_access(source_field);
+}
+
+/**
+ * Gets the texture coordinate sizes of the first image field found among
+ * <field> and its sources, which the native resolution of image filters spans.
+ */
+bool Image_filter_cache_get_texture_coordinate_sizes(cmzn_field_id field,
+	double *texture_coordinate_sizes)
+{
+	cmzn_field_image_id image = cmzn_field_cast_image(field);
+	if (image)
+	{
+		texture_coordinate_sizes[0] = cmzn_field_image_get_texture_coordinate_width(image);
+		texture_coordinate_sizes[1] = cmzn_field_image_get_texture_coordinate_height(image);
+		texture_coordinate_sizes[2] = cmzn_field_image_get_texture_coordinate_depth(image);
+		cmzn_field_image_destroy(&image);
+		return true;
+	}
+	const int number_of_source_fields = cmzn_field_get_number_of_source_fields(field);
+	for (int i = 1; i <= number_of_source_fields; ++i)
+	{
+		cmzn_field_id source_field = cmzn_field_get_source_field(field, i);
+		const bool found = (0 != source_field) &&
+			Image_filter_cache_get_texture_coordinate_sizes(source_field, texture_coordinate_sizes);
+		cmzn_field_destroy(&source_field);
+		if (found)
+			return true;
+	}
+	return false;
+}
+
+/** @return  Path of the region of <field> and its name, identifying it while
+ * it is not redefined. */
+std::string Image_filter_cache_get_field_path(cmzn_field_id field)
+{
+	std::string path;
+	char *name = cmzn_field_get_name(field);
+	if (name)
+	{
+		path = name;
+		cmzn_deallocate(name);
+	}
+	cmzn_fieldmodule_id field_module = cmzn_field_get_fieldmodule(field);
+	cmzn_region_id region = cmzn_fieldmodule_get_region(field_module);
+	while (region)
+	{
+		char *region_name = cmzn_region_get_name(region);
+		path = std::string(region_name ? region_name : "") + "/" + path;
+		if (region_name)
+			cmzn_deallocate(region_name);
+		cmzn_region_id parent = cmzn_region_get_parent(region);
+		cmzn_region_destroy(&region);
+		region = parent;
+	}
+	cmzn_fieldmodule_destroy(&field_module);
+	return path;
+}
+
+/**
+ * Native resolution of a field padded to 3 sizes, the texture coordinate
+ * field it is evaluated with and the texture coordinate sizes it spans.
+ */
+struct Image_filter_cache_resolution
+{
+	int dimension, sizes[3];
+	cmzn_field_id texture_coordinate_field;
+	int texture_number_of_components;
+	double texture_coordinate_sizes[3];
+};
+
+/** @return  true if <field> has a native resolution of 1 to 3 dimensions. */
+bool Image_filter_cache_get_resolution(cmzn_field_id field,
+	struct Image_filter_cache_resolution &resolution)
+{
+	int *native_sizes = 0;
+	struct Computed_field *texture_coordinate_field = 0;
+	resolution.dimension = 0;
+	if (!(Computed_field_get_native_resolution(field, &resolution.dimension,
+			&native_sizes, &texture_coordinate_field) &&
+		(0 < resolution.dimension) && (resolution.dimension <= 3) &&
+		texture_coordinate_field &&
+		(cmzn_field_get_number_of_components(texture_coordinate_field) <= 3) &&
+		Image_filter_cache_get_texture_coordinate_sizes(field,
+			resolution.texture_coordinate_sizes)))
+	{
+		if (native_sizes)
+			DEALLOCATE(native_sizes);
+		return false;
+	}
+	for (int d = 0; d < 3; ++d)
+		resolution.sizes[d] = (d < resolution.dimension) ? native_sizes[d] : 1;
+	DEALLOCATE(native_sizes);
+	resolution.texture_coordinate_field = texture_coordinate_field;
+	resolution.texture_number_of_components =
+		cmzn_field_get_number_of_components(texture_coordinate_field);
+	return true;
+}
+
+typedef int (*Image_filter_cache_plane_function)(const double *values,
+	size_t number_of_values, void *user_data);
+
+/**
+ * Evaluates <field> at the centre of each pixel of <resolution>, passing the
+ * values of each plane in order to <plane_function>. Evaluates on this thread
+ * only as field evaluation is not thread safe.
+ * @return  1 on success, 0 if any pixel could not be evaluated or
+ * <plane_function> failed.
+ */
+int Image_filter_cache_sample(cmzn_field_id field,
+	const struct Image_filter_cache_resolution &resolution,
+	Image_filter_cache_plane_function plane_function, void *user_data)
+{
+	const int number_of_components = cmzn_field_get_number_of_components(field);
+	if (number_of_components < 1)
+		return 0;
+	const size_t plane_size =
+		(size_t)resolution.sizes[0]*resolution.sizes[1]*number_of_components;
+	std::vector<double> values(plane_size);
+	double texel_size[3], texture_values[3] = { 0.0, 0.0, 0.0 };
+	for (int d = 0; d < 3; ++d)
+		texel_size[d] = resolution.texture_coordinate_sizes[d]/resolution.sizes[d];
+	cmzn_fieldmodule_id field_module = cmzn_field_get_fieldmodule(field);
+	cmzn_fieldcache_id field_cache = cmzn_fieldmodule_create_fieldcache(field_module);
+	int return_code = (0 != field_cache);
+	for (int k = 0; return_code && (k < resolution.sizes[2]); ++k)
+	{
+		texture_values[2] = (k + 0.5)*texel_size[2];
+		double *value = &(values[0]);
+		for (int j = 0; return_code && (j < resolution.sizes[1]); ++j)
+		{
+			texture_values[1] = (j + 0.5)*texel_size[1];
+			for (int i = 0; return_code && (i < resolution.sizes[0]); ++i)
+			{
+				texture_values[0] = (i + 0.5)*texel_size[0];
+				return_code =
+					(CMZN_OK == cmzn_fieldcache_set_field_real(field_cache,
+						resolution.texture_coordinate_field,
+						resolution.texture_number_of_components, texture_values)) &&
+					(CMZN_OK == cmzn_field_evaluate_real(field, field_cache,
+						number_of_components, value));
+				value += number_of_components;
+			}
+		}
+		if (return_code)
+			return_code = (plane_function)(&(values[0]), plane_size, user_data);
+	}
+	cmzn_fieldcache_destroy(&field_cache);
+	cmzn_fieldmodule_destroy(&field_module);
+	return return_code;
+}
+
+int Image_filter_cache_hash_plane(const double *values, size_t number_of_values,
+	void *hash_void)
+{
+	unsigned long long *hash = static_cast<unsigned long long *>(hash_void);
+	*hash = fnv1a_hash(*hash, values, number_of_values*sizeof(double));
+	return 1;
+}
+
+/** @return  Range of <minimum> to <maximum> 2 byte texture values are scaled
+ * to, or 1 if they are the same. */
+inline double Image_filter_cache_get_range(double minimum, double maximum)
+{
+	return (maximum > minimum) ? (maximum - minimum) : 1.0;
+}
+
+/**
+ * Gets the 2 byte texture value nearest <value> scaled from <minimum> to
+ * <minimum> + <range>.
+ * @return  The value the texture value is scaled back to.
+ */
+inline double Image_filter_cache_get_pixel(double value, double minimum,
+	double range, unsigned short &pixel)
+{
+	double scaled = (value - minimum)/range*65535.0 + 0.5;
+	if (!(0.0 <= scaled))
+		scaled = 0.0;
+	else if (!(scaled < 65535.0))
+		scaled = 65535.0;
+	pixel = (unsigned short)scaled;
+	return minimum + range*(pixel/65535.0);
+}
+
+/** @return  Texture of <field> if it is an image field, otherwise NULL. */
+struct Texture *Image_filter_cache_get_field_texture(cmzn_field_id field)
+{
+	struct Texture *texture = 0;
+	cmzn_field_image_id image = cmzn_field_cast_image(field);
+	if (image)
+	{
+		texture = cmzn_field_image_get_texture(image);
+		cmzn_field_image_destroy(&image);
+	}
+	return texture;
+}
+
+/** @return  Texture of the coarse image field of <field> if it is the sum
+ * of the images a result is read into, or of <field> if it is an image field,
+ * otherwise NULL. */
+struct Texture *Image_filter_cache_get_result_texture(cmzn_field_id field)
+{
+	const char *type_string = Computed_field_get_type_string(field);
+	if (!(type_string && (0 == strcmp(type_string, "add"))))
+		return Image_filter_cache_get_field_texture(field);
+	cmzn_field_id source_field = cmzn_field_get_source_field(field, 1);
+	struct Texture *texture = source_field ?
+		Image_filter_cache_get_field_texture(source_field) : 0;
+	cmzn_field_destroy(&source_field);
+	return texture;
+}
+
+/** Sets image field <field> to show <texture> over <resolution>, scaled from
+ * <minimum> to <minimum> + <range>. */
+bool Image_filter_cache_set_image(cmzn_field_id field, struct Texture *texture,
+	const struct Image_filter_cache_resolution &resolution, double minimum,
+	double range)
+{
+	cmzn_field_image_id image = cmzn_field_cast_image(field);
+	const bool result = (0 != image) &&
+		(CMZN_OK == cmzn_field_image_set_texture(image, texture));
+	if (result)
+	{
+		cmzn_field_image_set_domain_field(image, resolution.texture_coordinate_field);
+		cmzn_field_image_set_texture_coordinate_width(image,
+			resolution.texture_coordinate_sizes[0]);
+		cmzn_field_image_set_texture_coordinate_height(image,
+			resolution.texture_coordinate_sizes[1]);
+		cmzn_field_image_set_texture_coordinate_depth(image,
+			resolution.texture_coordinate_sizes[2]);
+		cmzn_field_image_set_output_range(image, minimum, minimum + range);
+	}
+	cmzn_field_image_destroy(&image);
+	return result;
+}
+
+/**
+ * Creates an unnamed image field showing <pixels>, planes of <header> sizes,
+ * in a new 2 byte texture named <name> scaled from <minimum> to
+ * <minimum> + <range>.
+ * @return  The image field, or NULL on failure.
+ */
+cmzn_field_id Image_filter_cache_create_image(cmzn_fieldmodule_id field_module,
+	const char *name, const struct Image_filter_cache_file_header &header,
+	const struct Image_filter_cache_resolution &resolution,
+	std::vector<unsigned short> &pixels, double minimum, double range)
+{
+	static const enum Texture_storage_type storage_types[4] =
+		{ TEXTURE_LUMINANCE, TEXTURE_LUMINANCE_ALPHA, TEXTURE_RGB, TEXTURE_RGBA };
+	struct Texture *texture = CREATE(Texture)(name);
+	bool result = (0 != texture) && Texture_allocate_image(texture, header.sizes[0],
+		header.sizes[1], header.sizes[2],
+		storage_types[header.number_of_components - 1],
+		/*number_of_bytes_per_component*/2, name);
+	if (result)
+	{
+		/* pixel centres then evaluate to the stored values */
+		Texture_set_filter_mode(texture, TEXTURE_NEAREST_FILTER);
+		Texture_set_physical_size(texture, resolution.texture_coordinate_sizes[0],
+			resolution.texture_coordinate_sizes[1], resolution.texture_coordinate_sizes[2]);
+		const size_t plane_size =
+			(size_t)header.sizes[0]*header.sizes[1]*header.number_of_components;
+		for (int k = 0; result && (k < header.sizes[2]); ++k)
+		{
+			result = Texture_set_image_block(texture, /*left*/0, /*bottom*/0,
+				header.sizes[0], header.sizes[1], /*depth_plane*/k,
+				2*header.sizes[0]*header.number_of_components,
+				reinterpret_cast<unsigned char *>(&pixels[k*plane_size]));
+		}
+	}
+	cmzn_field_id image_field = 0;
+	if (result)
+	{
+		image_field = cmzn_fieldmodule_create_field_image(field_module);
+		if (!Image_filter_cache_set_image(image_field, texture, resolution, minimum, range))
+			cmzn_field_destroy(&image_field);
+	}
+	/* otherwise the image field has the texture */
+	if ((!image_field) && texture)
+		DESTROY(Texture)(&texture);
+	return image_field;
+}
+
+/** Field redefined as an image field with a result read from the cache. */
+struct Image_filter_cache_image
+{
+	cmzn_region_id region;
+	std::string name;
+	struct Texture *texture;
+	unsigned long long key;
+	size_t size;
+};
+
+typedef std::map<std::string, Image_filter_cache_image> Image_filter_cache_image_map;
+
+}
+
+struct Image_filter_cache_store
+{
+	std::string path, file_name;
+	unsigned long long key;
+	FILE *file;
+	struct Image_filter_cache_file_header header;
+	size_t number_of_values, number_of_values_stored;
+	/* set if a value could not be written or was not finite */
+	bool failed;
+	std::vector<float> buffer;
+};
+
+struct Image_filter_cache
+{
+	/* empty while the cache is disabled */
+	std::string directory;
+	long long maximum_size, total_size;
+	Image_filter_cache_entry_map entries;
+	unsigned long use_counter;
+	int number_of_hits, number_of_misses, number_of_evictions;
+	/* paths of filter fields with no result, stored when first evaluated */
+	std::set<std::string> pending_paths;
+	/* fields redefined with results read from the cache, by field path */
+	Image_filter_cache_image_map images;
+
+	Image_filter_cache() :
+		maximum_size(1024LL*1024*1024),
+		total_size(0),
+		use_counter(0),
+		number_of_hits(0),
+		number_of_misses(0),
+		number_of_evictions(0)
+	{
+	}
+
+	~Image_filter_cache()
+	{
+		while (!images.empty())
+			forget_image(images.begin());
+	}
+
+	std::string get_index_file_name() const
+	{
+		return directory + "/index.txt";
+	}
+
+	std::string get_entry_file_name(unsigned long long key) const
+	{
+		char name[32];
+		snprintf(name, sizeof(name), "/%016llx.ifc", key);
+		return directory + name;
+	}
+
+	/** Reads the index of the directory, dropping entries whose file is gone. */
+	void read_index()
+	{
+		entries.clear();
+		total_size = 0;
+		use_counter = 0;
+		FILE *file = fopen(get_index_file_name().c_str(), "r");
+		if (!file)
+			return;
+		char line[256];
+		if (fgets(line, sizeof(line), file) &&
+			(0 == strncmp(line, IMAGE_FILTER_CACHE_INDEX_HEADER,
+				strlen(IMAGE_FILTER_CACHE_INDEX_HEADER))))
+		{
+			unsigned long long key;
+			Image_filter_cache_entry entry;
+			while (3 == fscanf(file, "%llx %lld %lu", &key, &entry.size, &entry.last_use))
+			{
+				FILE *entry_file = fopen(get_entry_file_name(key).c_str(), "rb");
+				if (entry_file)
+				{
+					fclose(entry_file);
+					entries[key] = entry;
+					total_size += entry.size;
+					if (entry.last_use > use_counter)
+						use_counter = entry.last_use;
+				}
+			}
+		}
+		fclose(file);
+	}
+
+	bool write_index() const
+	{
+		FILE *file = fopen(get_index_file_name().c_str(), "w");
+		if (!file)
+			return false;
+		fprintf(file, "%s\n", IMAGE_FILTER_CACHE_INDEX_HEADER);
+		for (Image_filter_cache_entry_map::const_iterator iter = entries.begin();
+			iter != entries.end(); ++iter)
+		{
+			fprintf(file, "%016llx %lld %lu\n", iter->first, iter->second.size,
+				iter->second.last_use);
+		}
+		return (0 == fclose(file));
+	}
+
+	void remove_entry(Image_filter_cache_entry_map::iterator iter)
+	{
+		remove(get_entry_file_name(iter->first).c_str());
+		total_size -= iter->second.size;
+		entries.erase(iter);
+	}
+
+	/** Removes least recently used results until within the maximum size. */
+	void evict()
+	{
+		while ((maximum_size < total_size) && (!entries.empty()))
+		{
+			Image_filter_cache_entry_map::iterator oldest = entries.begin();
+			for (Image_filter_cache_entry_map::iterator iter = entries.begin();
+				iter != entries.end(); ++iter)
+			{
+				if (iter->second.last_use < oldest->second.last_use)
+					oldest = iter;
+			}
+			remove_entry(oldest);
+			++number_of_evictions;
+		}
+	}
+
+	void forget_image(Image_filter_cache_image_map::iterator iter)
+	{
+		Memory_accounting_remove(MEMORY_ACCOUNTING_TAG_CACHED_IMAGES, iter->second.size);
+		cmzn_region_destroy(&(iter->second.region));
+		images.erase(iter);
+	}
+
+	/** Forgets fields read from the cache which have since been destroyed or
+	 * had their texture changed. */
+	void prune_images()
+	{
+		Image_filter_cache_image_map::iterator iter = images.begin();
+		while (iter != images.end())
+		{
+			Image_filter_cache_image_map::iterator next = iter;
+			++next;
+			cmzn_fieldmodule_id field_module = cmzn_region_get_fieldmodule(iter->second.region);
+			cmzn_field_id field = cmzn_fieldmodule_find_field_by_name(field_module,
+				iter->second.name.c_str());
+			if (!(field && cmzn_field_is_managed(field) &&
+				(Image_filter_cache_get_result_texture(field) == iter->second.texture)))
+			{
+				forget_image(iter);
+			}
+			cmzn_field_destroy(&field);
+			cmzn_fieldmodule_destroy(&field_module);
+			iter = next;
+		}
+	}
+
+	/**
+	 * Gets the key of <field>: for filters the hash of their type, parameters
+	 * and the key of their source, for fields read from the cache the key of
+	 * their result, and for other image fields the hash of their values at
+	 * their native resolution.
+	 * @return  true on success, false if <field> is not based on an image field.
+	 */
+	bool get_field_key(cmzn_field_id field, unsigned long long &key)
+	{
+		Image_filter_cache_image_map::iterator image_iter =
+			images.find(Image_filter_cache_get_field_path(field));
+		if ((image_iter != images.end()) &&
+			(Image_filter_cache_get_result_texture(field) == image_iter->second.texture))
+		{
+			key = image_iter->second.key;
+			return true;
+		}
+		const char *type_string = Computed_field_get_type_string(field);
+		std::vector<double> parameters;
+		bool store;
+		cmzn_field_id source_field = type_string ?
+			Image_filter_cache_get_filter(field, type_string, parameters, store) : 0;
+		if (source_field)
+		{
+			unsigned long long source_key;
+			const bool found = get_field_key(source_field, source_key);
+			cmzn_field_destroy(&source_field);
+			if (!found)
+				return false;
+			key = fnv1a_hash(FNV_OFFSET_BASIS, type_string, strlen(type_string) + 1);
+			if (!parameters.empty())
+				key = fnv1a_hash(key, &parameters[0], parameters.size()*sizeof(double));
+			key = fnv1a_hash(key, &source_key, sizeof(source_key));
+			return true;
+		}
+		/* other sources could only be hashed by evaluating filters now */
+		struct Image_filter_cache_resolution resolution;
+		if (!(Image_filter_cache_get_field_texture(field) &&
+			Image_filter_cache_get_resolution(field, resolution)))
+		{
+			return false;
+		}
+		key = FNV_OFFSET_BASIS;
+		if (!Image_filter_cache_sample(field, resolution, Image_filter_cache_hash_plane,
+			static_cast<void *>(&key)))
+		{
+			return false;
+		}
+		const int number_of_components = cmzn_field_get_number_of_components(field);
+		key = fnv1a_hash(key, resolution.sizes, sizeof(resolution.sizes));
+		key = fnv1a_hash(key, &number_of_components, sizeof(int));
+		return true;
+	}
+
+	/**
+	 * Redefines <field> as the sum of two image fields with the result stored
+	 * for <key>: a 2 byte texture scaled to the range of the result, and a 2
+	 * byte texture of what it misses scaled to their smaller range. Together
+	 * they restore each 4 byte real to within 1/2^32 of the range of the
+	 * result, finer than 4 byte reals resolve near its largest magnitude.
+	 * @return  true on success, false if the result could not be read or does
+	 * not match the native resolution of <field>.
+	 */
+	bool read_entry(cmzn_field_id field, unsigned long long key)
+	{
+		struct Image_filter_cache_resolution resolution;
+		if (!Image_filter_cache_get_resolution(field, resolution))
+			return false;
+		FILE *file = fopen(get_entry_file_name(key).c_str(), "rb");
+		struct Image_filter_cache_file_header header;
+		bool result = (0 != file) && (1 == fread(&header, sizeof(header), 1, file)) &&
+			(0 == memcmp(header.magic, IMAGE_FILTER_CACHE_MAGIC, sizeof(header.magic))) &&
+			(header.dimension == resolution.dimension) &&
+			(header.number_of_components == cmzn_field_get_number_of_components(field)) &&
+			(0 < header.number_of_components) && (header.number_of_components <= 4);
+		for (int d = 0; result && (d < 3); ++d)
+			result = (header.sizes[d] == resolution.sizes[d]);
+		const size_t number_of_values = result ? ((size_t)header.sizes[0]*
+			header.sizes[1]*header.sizes[2]*header.number_of_components) : 0;
+		std::vector<float> values(number_of_values);
+		if (result)
+		{
+			result = (number_of_values == fread(&values[0], sizeof(float),
+				number_of_values, file));
+		}
+		if (file)
+			fclose(file);
+		const double range = Image_filter_cache_get_range(header.minimum, header.maximum);
+		std::vector<unsigned short> pixels(number_of_values), residual_pixels(number_of_values);
+		std::vector<double> residuals(number_of_values);
+		double residual_minimum = 0.0, residual_maximum = 0.0;
+		for (size_t i = 0; result && (i < number_of_values); ++i)
+		{
+			residuals[i] = values[i] - Image_filter_cache_get_pixel(values[i],
+				header.minimum, range, pixels[i]);
+			if ((0 == i) || (residuals[i] < residual_minimum))
+				residual_minimum = residuals[i];
+			if ((0 == i) || (residuals[i] > residual_maximum))
+				residual_maximum = residuals[i];
+		}
+		const double residual_range =
+			Image_filter_cache_get_range(residual_minimum, residual_maximum);
+		for (size_t i = 0; result && (i < number_of_values); ++i)
+		{
+			Image_filter_cache_get_pixel(residuals[i], residual_minimum, residual_range,
+				residual_pixels[i]);
+		}
+		char *name = cmzn_field_get_name(field);
+		cmzn_fieldmodule_id field_module = cmzn_field_get_fieldmodule(field);
+		cmzn_field_id image_field = 0, residual_image_field = 0;
+		struct Texture *texture = 0;
+		if (result)
+		{
+			image_field = Image_filter_cache_create_image(field_module, name, header,
+				resolution, pixels, header.minimum, range);
+			residual_image_field = image_field ? Image_filter_cache_create_image(
+				field_module, name, header, resolution, residual_pixels,
+				residual_minimum, residual_range) : 0;
+			result = (0 != residual_image_field);
+			texture = Image_filter_cache_get_field_texture(image_field);
+		}
+		if (result)
+		{
+			cmzn_fieldmodule_begin_change(field_module);
+			cmzn_fieldmodule_set_field_name(field_module, name);
+			cmzn_fieldmodule_set_replace_field(field_module, field);
+			Computed_field_modify_data field_modify(field_module);
+			cmzn_field_id sum_field = cmzn_fieldmodule_create_field_add(field_module,
+				image_field, residual_image_field);
+			result = (0 != sum_field) &&
+				(0 != field_modify.update_field_and_deaccess(sum_field));
+			cmzn_fieldmodule_end_change(field_module);
+		}
+		if (result)
+		{
+			const std::string path = Image_filter_cache_get_field_path(field);
+			Image_filter_cache_image_map::iterator iter = images.find(path);
+			if (iter != images.end())
+				forget_image(iter);
+			Image_filter_cache_image &image = images[path];
+			image.region = cmzn_fieldmodule_get_region(field_module);
+			image.name = name;
+			image.texture = texture;
+			image.key = key;
+			image.size = 2*2*number_of_values;
+			Memory_accounting_add(MEMORY_ACCOUNTING_TAG_CACHED_IMAGES, image.size);
+		}
+		/* the sum field keeps both image fields and their textures */
+		cmzn_field_destroy(&image_field);
+		cmzn_field_destroy(&residual_image_field);
+		cmzn_fieldmodule_destroy(&field_module);
+		if (name)
+			cmzn_deallocate(name);
+		return result;
+	}
+};
+
+struct Image_filter_cache *CREATE(Image_filter_cache)(void)
+{
+	return new Image_filter_cache();
+}
+
+int DESTROY(Image_filter_cache)(struct Image_filter_cache **cache_address)
+{
+	if (cache_address && (*cache_address))
+	{
+		delete *cache_address;
+		*cache_address = 0;
+		return 1;
+	}
+	return 0;
+}
+
+int Image_filter_cache_set_directory(struct Image_filter_cache *cache,
+	const char *directory)
+{
+	if (!cache)
+	{
+		display_message(ERROR_MESSAGE,
+			"Image_filter_cache_set_directory.  Invalid argument(s)");
+		return 0;
+	}
+	cache->pending_paths.clear();
+	if (!directory)
+	{
+		cache->directory.clear();
+		cache->entries.clear();
+		cache->total_size = 0;
+		return 1;
+	}
+	cache->directory = directory;
+	cache->read_index();
+	cache->evict();
+	if (!cache->write_index())
+	{
+		display_message(ERROR_MESSAGE,
+			"Could not write image filter cache index in directory %s", directory);
+		cache->directory.clear();
+		cache->entries.clear();
+		cache->total_size = 0;
+		return 0;
+	}
+	return 1;
+}
+
+int Image_filter_cache_set_maximum_size(struct Image_filter_cache *cache,
+	double maximum_megabytes)
+{
+	if (!(cache && (0.0 <= maximum_megabytes)))
+	{
+		display_message(ERROR_MESSAGE,
+			"Image_filter_cache_set_maximum_size.  Invalid argument(s)");
+		return 0;
+	}
+	cache->maximum_size = (long long)(maximum_megabytes*1024.0*1024.0);
+	if (!cache->directory.empty())
+	{
+		cache->evict();
+		cache->write_index();
+	}
+	return 1;
+}
+
+int Image_filter_cache_define_field(struct Image_filter_cache *cache,
+	cmzn_field_id field)
+{
+	if (!(cache && field))
+	{
+		display_message(ERROR_MESSAGE,
+			"Image_filter_cache_define_field.  Invalid argument(s)");
+		return 0;
+	}
+	cache->prune_images();
+	const std::string path = Image_filter_cache_get_field_path(field);
+	cache->pending_paths.erase(path);
+	Image_filter_cache_image_map::iterator image_iter = cache->images.find(path);
+	if (image_iter != cache->images.end())
+		cache->forget_image(image_iter);
+	if (cache->directory.empty())
+		return 1;
+	const char *type_string = Computed_field_get_type_string(field);
+	std::vector<double> parameters;
+	bool store = false;
+	cmzn_field_id source_field = type_string ?
+		Image_filter_cache_get_filter(field, type_string, parameters, store) : 0;
+	if (!source_field)
+		return 1;
+	cmzn_field_destroy(&source_field);
+	unsigned long long key;
+	if (!(store && cache->get_field_key(field, key)))
+		return 1;
+	Image_filter_cache_entry_map::iterator iter = cache->entries.find(key);
+	if (iter != cache->entries.end())
+	{
+		if (cache->read_entry(field, key))
+		{
+			++(cache->number_of_hits);
+			iter->second.last_use = ++(cache->use_counter);
+			cache->write_index();
+			return 1;
+		}
+		/* unreadable or from an older format */
+		cache->remove_entry(iter);
+		cache->write_index();
+	}
+	++(cache->number_of_misses);
+	cache->pending_paths.insert(path);
+	return 1;
+}
+
+struct Image_filter_cache_store *Image_filter_cache_begin_store(
+	struct Image_filter_cache *cache, cmzn_field_id field,
+	cmzn_field_id texture_coordinate_field, int image_width, int image_height,
+	int image_depth)
+{
+	if (!(cache && field))
+	{
+		display_message(ERROR_MESSAGE,
+			"Image_filter_cache_begin_store.  Invalid argument(s)");
+		return 0;
+	}
+	if (cache->directory.empty())
+		return 0;
+	const std::string path = Image_filter_cache_get_field_path(field);
+	if (cache->pending_paths.find(path) == cache->pending_paths.end())
+		return 0;
+	struct Image_filter_cache_resolution resolution;
+	const int image_sizes[3] = { image_width, image_height, image_depth };
+	const int number_of_components = cmzn_field_get_number_of_components(field);
+	if (!(Image_filter_cache_get_resolution(field, resolution) &&
+		((!texture_coordinate_field) ||
+			(texture_coordinate_field == resolution.texture_coordinate_field)) &&
+		(0 < number_of_components) && (number_of_components <= 4)))
+	{
+		return 0;
+	}
+	for (int d = 0; d < 3; ++d)
+	{
+		if ((0 != image_sizes[d]) && (image_sizes[d] != resolution.sizes[d]))
+			return 0;
+	}
+	/* the source may have changed since the field was defined */
+	unsigned long long key;
+	if (!cache->get_field_key(field, key) ||
+		(cache->entries.find(key) != cache->entries.end()))
+	{
+		cache->pending_paths.erase(path);
+		return 0;
+	}
+	struct Image_filter_cache_store *store = new Image_filter_cache_store();
+	store->path = path;
+	store->file_name = cache->get_entry_file_name(key);
+	store->key = key;
+	store->file = fopen((store->file_name + ".tmp").c_str(), "wb");
+	memset(&store->header, 0, sizeof(store->header));
+	memcpy(store->header.magic, IMAGE_FILTER_CACHE_MAGIC, sizeof(store->header.magic));
+	store->header.dimension = resolution.dimension;
+	for (int d = 0; d < 3; ++d)
+		store->header.sizes[d] = resolution.sizes[d];
+	store->header.number_of_components = number_of_components;
+	store->number_of_values = (size_t)resolution.sizes[0]*resolution.sizes[1]*
+		resolution.sizes[2]*number_of_components;
+	store->number_of_values_stored = 0;
+	/* written again with the range once all values are known */
+	store->failed = !(store->file &&
+		(1 == fwrite(&store->header, sizeof(store->header), 1, store->file)));
+	return store;
+}
+
+int Image_filter_cache_store_values(const double *values,
+	size_t number_of_values, void *store_void)
+{
+	struct Image_filter_cache_store *store =
+		static_cast<struct Image_filter_cache_store *>(store_void);
+	if (!(store && values) || store->failed)
+		return 0;
+	store->buffer.resize(number_of_values);
+	for (size_t i = 0; i < number_of_values; ++i)
+	{
+		const float value = (float)values[i];
+		/* also fails for NaN */
+		if (!(fabs(value) <= FLT_MAX))
+		{
+			store->failed = true;
+			return 0;
+		}
+		if (0 == store->number_of_values_stored + i)
+		{
+			store->header.minimum = value;
+			store->header.maximum = value;
+		}
+		else if (value < store->header.minimum)
+			store->header.minimum = value;
+		else if (value > store->header.maximum)
+			store->header.maximum = value;
+		store->buffer[i] = value;
+	}
+	if ((number_of_values > store->number_of_values - store->number_of_values_stored) ||
+		(number_of_values != fwrite(&(store->buffer[0]), sizeof(float),
+			number_of_values, store->file)))
+	{
+		store->failed = true;
+		return 0;
+	}
+	store->number_of_values_stored += number_of_values;
+	return 1;
+}
+
+int Image_filter_cache_end_store(struct Image_filter_cache *cache,
+	struct Image_filter_cache_store **store_address)
+{
+	if (!(cache && store_address && (*store_address)))
+	{
+		display_message(ERROR_MESSAGE,
+			"Image_filter_cache_end_store.  Invalid argument(s)");
+		return 0;
+	}
+	struct Image_filter_cache_store *store = *store_address;
+	const std::string temporary_file_name = store->file_name + ".tmp";
+	/* incomplete if the evaluation failed, so tried again next time */
+	const bool complete = store->failed ||
+		(store->number_of_values_stored == store->number_of_values);
+	bool result = (!store->failed) &&
+		(store->number_of_values_stored == store->number_of_values) &&
+		(0 == fseek(store->file, 0, SEEK_SET)) &&
+		(1 == fwrite(&store->header, sizeof(store->header), 1, store->file));
+	if (store->file && (0 != fclose(store->file)))
+		result = false;
+	if (result)
+	{
+		remove(store->file_name.c_str());
+		result = (0 == rename(temporary_file_name.c_str(), store->file_name.c_str()));
+	}
+	if (result)
+	{
+		Image_filter_cache_entry entry;
+		entry.size = (long long)sizeof(store->header) +
+			(long long)(sizeof(float)*store->number_of_values);
+		entry.last_use = ++(cache->use_counter);
+		cache->entries[store->key] = entry;
+		cache->total_size += entry.size;
+		cache->evict();
+		cache->write_index();
+	}
+	else
+	{
+		remove(temporary_file_name.c_str());
+	}
+	if (complete)
+		cache->pending_paths.erase(store->path);
+	delete store;
+	*store_address = 0;
+	return 1;
+}
+
+int Image_filter_cache_clear(struct Image_filter_cache *cache)
+{
+	if (!cache)
+		return 0;
+	while (!cache->entries.empty())
+		cache->remove_entry(cache->entries.begin());
+	if (!cache->directory.empty())
+		cache->write_index();
+	return 1;
+}
+
+int Image_filter_cache_list(struct Image_filter_cache *cache)
+{
+	if (!cache)
+		return 0;
+	cache->prune_images();
+	if (cache->directory.empty())
+	{
+		display_message(INFORMATION_MESSAGE, "Image filter cache: off\n");
+	}
+	else
+	{
+		display_message(INFORMATION_MESSAGE, "Image filter cache: %s\n",
+			cache->directory.c_str());
+	}
+	display_message(INFORMATION_MESSAGE,
+		"  %d results, %.1f of %.1f MB, %d hits, %d misses, %d evictions\n",
+		(int)cache->entries.size(), (double)cache->total_size/(1024.0*1024.0),
+		(double)cache->maximum_size/(1024.0*1024.0), cache->number_of_hits,
+		cache->number_of_misses, cache->number_of_evictions);
+	display_message(INFORMATION_MESSAGE,
+		"  %d fields read from results, %d waiting to store their first evaluation\n",
+		(int)cache->images.size(), (int)cache->pending_paths.size());
+	return 1;
+}
@@ -0,0 +1,100 @@
+/**
+ * FILE : image_filter_cache.h
+ *
+ * Directory of image filter field results kept between sessions, keyed by a
+ * hash of the source image and the type and parameters of each filter in the
+ * chain, so redefining the same pipeline reads its results back instead of
+ * running the filters again.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (IMAGE_FILTER_CACHE_H)
+#define IMAGE_FILTER_CACHE_H
+
+#include <stddef.h>
+#include "opencmiss/zinc/types/fieldid.h"
+#include "general/object.h"
+
+struct Image_filter_cache;
+
+struct Image_filter_cache_store;
+
+/**
+ * Creates a cache which is disabled until a directory is set.
+ */
+struct Image_filter_cache *CREATE(Image_filter_cache)(void);
+
+int DESTROY(Image_filter_cache)(struct Image_filter_cache **cache_address);
+
+/**
+ * Sets the existing directory results are kept in and reads its index, or
+ * disables the cache if <directory> is NULL.
+ * @return  1 on success, 0 if the directory index could not be written.
+ */
+int Image_filter_cache_set_directory(struct Image_filter_cache *cache,
+	const char *directory);
+
+/**
+ * Sets the total size of results kept, evicting the least recently used
+ * results beyond it.
+ */
+int Image_filter_cache_set_maximum_size(struct Image_filter_cache *cache,
+	double maximum_megabytes);
+
+/**
+ * Called after gfx define field has defined <field>. If it is an image filter
+ * on an image field whose result is in the cache, it is redefined as the sum
+ * of two image fields restoring the stored 4 byte reals: one scaled to the
+ * range of the result and one to the part of each value it misses.
+ * Otherwise the filter is left to be evaluated as usual, and its result is
+ * stored the first time it is evaluated by Image_filter_cache_begin_store.
+ * @return  1 if the field was handled or not cacheable, 0 on error.
+ */
+int Image_filter_cache_define_field(struct Image_filter_cache *cache,
+	cmzn_field_id field);
+
+/**
+ * Starts storing the result of <field> if gfx define field found none for
+ * it, when it is about to be evaluated with <texture_coordinate_field> into
+ * an image of the given sizes, where 0 is the size of its native resolution.
+ * @return  Store to pass with Image_filter_cache_store_values to the
+ * evaluation, or NULL if the result is not needed or the evaluation is not at
+ * the native resolution of the field.
+ */
+struct Image_filter_cache_store *Image_filter_cache_begin_store(
+	struct Image_filter_cache *cache, cmzn_field_id field,
+	cmzn_field_id texture_coordinate_field, int image_width, int image_height,
+	int image_depth);
+
+/**
+ * Appends the next <number_of_values> field values evaluated, components
+ * fastest, then x, y and z, to <store_void>.
+ * @return  1 on success, 0 if the result cannot be stored so no more values
+ * are needed.
+ */
+int Image_filter_cache_store_values(const double *values,
+	size_t number_of_values, void *store_void);
+
+/**
+ * Keeps the result of <*store_address> if all values were stored and can be
+ * restored exactly, then destroys the store. If the evaluation failed the
+ * result is stored the next time the field is evaluated.
+ */
+int Image_filter_cache_end_store(struct Image_filter_cache *cache,
+	struct Image_filter_cache_store **store_address);
+
+/**
+ * Deletes all results from the cache directory.
+ */
+int Image_filter_cache_clear(struct Image_filter_cache *cache);
+
+/**
+ * Writes the directory, size, number of results, hits, misses, evictions and
+ * fields read from or waiting to store results to the command window.
+ */
+int Image_filter_cache_list(struct Image_filter_cache *cache);
+
+#endif /* !defined (IMAGE_FILTER_CACHE_H) */
@@ -0,0 +1,447 @@
+/**
+ * FILE : image_filter_stream.cpp
+ *
+ * Evaluates a chain of ITK image filter fields one tile of the source image at
+ * a time, so the filters never hold buffers for the whole image.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <string.h>
+#include <vector>
+#include "opencmiss/zinc/field.h"
+#include "opencmiss/zinc/fieldimageprocessing.h"
+#include "opencmiss/zinc/fieldmodule.h"
+#include "general/debug.h"
+#include "general/message.h"
+#include "computed_field/computed_field.h"
+#include "image_processing/image_filter_stream.h"
+
+/* implemented with the filter fields; declared here as in their _app files */
+int cmzn_field_get_type_mean_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, int **radius_sizes);
+int cmzn_field_get_type_discrete_gaussian_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, double *variance, int *maxKernelWidth);
+int cmzn_field_get_type_derivative_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, int *order, int *direction);
+int cmzn_field_get_type_binary_dilate_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, int *radius, double *dilate_value);
+int cmzn_field_get_type_binary_erode_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, int *radius, double *erode_value);
+int cmzn_field_get_type_sigmoid_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, double *min, double *max, double *alpha, double *beta);
+int cmzn_field_get_type_threshold_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field,
+	enum cmzn_field_imagefilter_threshold_condition *condition,
+	double *outsideValue, double *lowerValue, double *upperValue);
+int cmzn_field_get_type_binary_threshold_image_filter(struct Computed_field *field,
+	struct Computed_field **source_field, double *lower_threshold,
+	double *upper_threshold);
+
+namespace {
+
+enum Image_filter_stream_stage_type
+{
+	IMAGE_FILTER_STREAM_MEAN,
+	IMAGE_FILTER_STREAM_DISCRETE_GAUSSIAN,
+	IMAGE_FILTER_STREAM_DERIVATIVE,
+	IMAGE_FILTER_STREAM_BINARY_DILATE,
+	IMAGE_FILTER_STREAM_BINARY_ERODE,
+	IMAGE_FILTER_STREAM_SIGMOID,
+	IMAGE_FILTER_STREAM_THRESHOLD,
+	IMAGE_FILTER_STREAM_BINARY_THRESHOLD
+};
+
+/** Type and parameters of one filter in the chain. */
+struct Image_filter_stream_stage
+{
+	enum Image_filter_stream_stage_type type;
+	double values[4];
+	int int_values[2];
+	std::vector<int> radius_sizes;
+	enum cmzn_field_imagefilter_threshold_condition condition;
+};
+
+/**
+ * @return  True if <field> is a filter whose output at a pixel can depend on
+ * pixels anywhere in the image, so tiles cannot match filtering it whole.
+ * Curvature anisotropic diffusion scales its conductance by the mean gradient
+ * over the image, and canny hysteresis follows edges of any length.
+ */
+bool Image_filter_stream_is_global_filter(struct Computed_field *field)
+{
+	const char *type_string = Computed_field_get_type_string(field);
+	return type_string &&
+		((0 == strcmp(type_string, "curvature_anisotropic_diffusion_filter")) ||
+		(0 == strcmp(type_string, "canny_edge_detection_filter")));
+}
+
+/**
+ * Records the filter <field> in <stage> and returns its source field, or
+ * returns NULL if <field> is not a filter which can be streamed.
+ */
+struct Computed_field *Image_filter_stream_get_stage(struct Computed_field *field,
+	Image_filter_stream_stage &stage)
+{
+	const char *type_string = Computed_field_get_type_string(field);
+	struct Computed_field *source_field = 0;
+	if (!type_string)
+		return 0;
+	if (0 == strcmp(type_string, "mean_filter"))
+	{
+		int *radius_sizes = 0;
+		stage.type = IMAGE_FILTER_STREAM_MEAN;
+		int dimension = 0, *sizes = 0;
+		struct Computed_field *texture_coordinate_field = 0;
+		if (cmzn_field_get_type_mean_image_filter(field, &source_field, &radius_sizes) &&
+			radius_sizes && Computed_field_get_native_resolution(source_field,
+				&dimension, &sizes, &texture_coordinate_field))
+		{
+			stage.radius_sizes.assign(radius_sizes, radius_sizes + dimension);
+		}
+		else
+			source_field = 0;
+		if (sizes)
+			DEALLOCATE(sizes);
+		if (radius_sizes)
+			DEALLOCATE(radius_sizes);
+	}
+	else if (0 == strcmp(type_string, "discrete_gaussian_filter"))
+	{
+		stage.type = IMAGE_FILTER_STREAM_DISCRETE_GAUSSIAN;
+		cmzn_field_get_type_discrete_gaussian_image_filter(field, &source_field,
+			&stage.values[0], &stage.int_values[0]);
+	}
+	else if (0 == strcmp(type_string, "derivative_filter"))
+	{
+		stage.type = IMAGE_FILTER_STREAM_DERIVATIVE;
+		cmzn_field_get_type_derivative_image_filter(field, &source_field,
+			&stage.int_values[0], &stage.int_values[1]);
+	}
+	else if (0 == strcmp(type_string, "binary_dilate_filter"))
+	{
+		stage.type = IMAGE_FILTER_STREAM_BINARY_DILATE;
+		cmzn_field_get_type_binary_dilate_image_filter(field, &source_field,
+			&stage.int_values[0], &stage.values[0]);
+	}
+	else if (0 == strcmp(type_string, "binary_erode_filter"))
+	{
+		stage.type = IMAGE_FILTER_STREAM_BINARY_ERODE;
+		cmzn_field_get_type_binary_erode_image_filter(field, &source_field,
+			&stage.int_values[0], &stage.values[0]);
+	}
+	else if (0 == strcmp(type_string, "sigmoid_filter"))
+	{
+		stage.type = IMAGE_FILTER_STREAM_SIGMOID;
+		cmzn_field_get_type_sigmoid_image_filter(field, &source_field,
+			&stage.values[0], &stage.values[1], &stage.values[2], &stage.values[3]);
+	}
+	else if (0 == strcmp(type_string, "threshold_filter"))
+	{
+		stage.type = IMAGE_FILTER_STREAM_THRESHOLD;
+		cmzn_field_get_type_threshold_image_filter(field, &source_field,
+			&stage.condition, &stage.values[0], &stage.values[1], &stage.values[2]);
+	}
+	else if (0 == strcmp(type_string, "binary_threshold_filter"))
+	{
+		stage.type = IMAGE_FILTER_STREAM_BINARY_THRESHOLD;
+		cmzn_field_get_type_binary_threshold_image_filter(field, &source_field,
+			&stage.values[0], &stage.values[1]);
+	}
+	return source_field;
+}
+
+/**
+ * @return  Pixels either side of the output pixel in direction <d> which the
+ * filter of <stage> reads.
+ */
+int Image_filter_stream_stage_get_halo(const Image_filter_stream_stage &stage, int d)
+{
+	switch (stage.type)
+	{
+		case IMAGE_FILTER_STREAM_MEAN:
+			return (d < (int)stage.radius_sizes.size()) ? stage.radius_sizes[d] : 0;
+		case IMAGE_FILTER_STREAM_DISCRETE_GAUSSIAN:
+			/* the kernel is truncated to the maximum width */
+			return stage.int_values[0]/2;
+		case IMAGE_FILTER_STREAM_DERIVATIVE:
+			return (d == stage.int_values[1]) ? stage.int_values[0] : 0;
+		case IMAGE_FILTER_STREAM_BINARY_DILATE:
+		case IMAGE_FILTER_STREAM_BINARY_ERODE:
+			return stage.int_values[0];
+		case IMAGE_FILTER_STREAM_SIGMOID:
+		case IMAGE_FILTER_STREAM_THRESHOLD:
+		case IMAGE_FILTER_STREAM_BINARY_THRESHOLD:
+			return 0;
+	}
+	return 0;
+}
+
+/** @return  New accessed filter field applying <stage> to <source_field>. */
+cmzn_field_id Image_filter_stream_stage_create_field(
+	const Image_filter_stream_stage &stage, cmzn_fieldmodule_id field_module,
+	cmzn_field_id source_field, int dimension)
+{
+	cmzn_field_id field = 0;
+	switch (stage.type)
+	{
+		case IMAGE_FILTER_STREAM_MEAN:
+		{
+			std::vector<int> radius_sizes(stage.radius_sizes);
+			field = cmzn_fieldmodule_create_field_imagefilter_mean(field_module,
+				source_field, dimension, &radius_sizes[0]);
+		} break;
+		case IMAGE_FILTER_STREAM_DISCRETE_GAUSSIAN:
+		{
+			field = cmzn_fieldmodule_create_field_imagefilter_discrete_gaussian(
+				field_module, source_field);
+			cmzn_field_imagefilter_discrete_gaussian_id imagefilter =
+				cmzn_field_cast_imagefilter_discrete_gaussian(field);
+			cmzn_field_imagefilter_discrete_gaussian_set_variance(imagefilter,
+				stage.values[0]);
+			cmzn_field_imagefilter_discrete_gaussian_set_max_kernel_width(imagefilter,
+				stage.int_values[0]);
+			cmzn_field_imagefilter_discrete_gaussian_destroy(&imagefilter);
+		} break;
+		case IMAGE_FILTER_STREAM_DERIVATIVE:
+		{
+			field = cmzn_fieldmodule_create_field_imagefilter_derivative(field_module,
+				source_field, stage.int_values[0], stage.int_values[1]);
+		} break;
+		case IMAGE_FILTER_STREAM_BINARY_DILATE:
+		{
+			field = cmzn_fieldmodule_create_field_imagefilter_binary_dilate(field_module,
+				source_field, stage.int_values[0], stage.values[0]);
+		} break;
+		case IMAGE_FILTER_STREAM_BINARY_ERODE:
+		{
+			field = cmzn_fieldmodule_create_field_imagefilter_binary_erode(field_module,
+				source_field, stage.int_values[0], stage.values[0]);
+		} break;
+		case IMAGE_FILTER_STREAM_SIGMOID:
+		{
+			field = cmzn_fieldmodule_create_field_imagefilter_sigmoid(field_module,
+				source_field, stage.values[0], stage.values[1], stage.values[2],
+				stage.values[3]);
+		} break;
+		case IMAGE_FILTER_STREAM_THRESHOLD:
+		{
+			field = cmzn_fieldmodule_create_field_imagefilter_threshold(
+				field_module, source_field);
+			cmzn_field_imagefilter_threshold_id imagefilter =
+				cmzn_field_cast_imagefilter_threshold(field);
+			cmzn_field_imagefilter_threshold_set_condition(imagefilter, stage.condition);
+			cmzn_field_imagefilter_threshold_set_outside_value(imagefilter, stage.values[0]);
+			cmzn_field_imagefilter_threshold_set_lower_threshold(imagefilter, stage.values[1]);
+			cmzn_field_imagefilter_threshold_set_upper_threshold(imagefilter, stage.values[2]);
+			cmzn_field_imagefilter_threshold_destroy(&imagefilter);
+		} break;
+		case IMAGE_FILTER_STREAM_BINARY_THRESHOLD:
+		{
+			field = cmzn_fieldmodule_create_field_imagefilter_binary_threshold(
+				field_module, source_field);
+			cmzn_field_imagefilter_binary_threshold_id imagefilter =
+				cmzn_field_cast_imagefilter_binary_threshold(field);
+			cmzn_field_imagefilter_binary_threshold_set_lower_threshold(imagefilter,
+				stage.values[0]);
+			cmzn_field_imagefilter_binary_threshold_set_upper_threshold(imagefilter,
+				stage.values[1]);
+			cmzn_field_imagefilter_binary_threshold_destroy(&imagefilter);
+		} break;
+	}
+	return field;
+}
+
+}
+
+struct Image_filter_stream
+{
+	/* filters from the output field down to the one applied to the source */
+	std::vector<Image_filter_stream_stage> stages;
+	cmzn_field_id source_field, texture_coordinate_field;
+	int dimension, sizes[3], halo[3];
+
+	Image_filter_stream() :
+		source_field(0),
+		texture_coordinate_field(0),
+		dimension(0)
+	{
+		for (int d = 0; d < 3; ++d)
+		{
+			sizes[d] = 1;
+			halo[d] = 0;
+		}
+	}
+
+	~Image_filter_stream()
+	{
+		cmzn_field_destroy(&source_field);
+		cmzn_field_destroy(&texture_coordinate_field);
+	}
+};
+
+struct Image_filter_stream *CREATE(Image_filter_stream)(cmzn_field_id field)
+{
+	if (!field)
+	{
+		display_message(ERROR_MESSAGE, "CREATE(Image_filter_stream).  Invalid argument(s)");
+		return 0;
+	}
+	struct Image_filter_stream *stream = new Image_filter_stream();
+	struct Computed_field *current_field = field;
+	while (true)
+	{
+		Image_filter_stream_stage stage;
+		struct Computed_field *source_field =
+			Image_filter_stream_get_stage(current_field, stage);
+		if (!source_field)
+			break;
+		stream->stages.push_back(stage);
+		current_field = source_field;
+	}
+	if (Image_filter_stream_is_global_filter(current_field))
+	{
+		display_message(ERROR_MESSAGE,
+			"Image filter streaming is not possible for %s fields, which depend on "
+			"the whole image. Evaluate without streaming_tile_size",
+			Computed_field_get_type_string(current_field));
+		delete stream;
+		return 0;
+	}
+	if (0 == stream->stages.size())
+	{
+		const char *type_string = Computed_field_get_type_string(field);
+		display_message(ERROR_MESSAGE,
+			"Image filter streaming is not possible for %s fields",
+			type_string ? type_string : "unknown");
+		delete stream;
+		return 0;
+	}
+	stream->source_field = cmzn_field_access(current_field);
+	int *sizes = 0;
+	struct Computed_field *texture_coordinate_field = 0;
+	if (!(Computed_field_get_native_resolution(stream->source_field,
+		&stream->dimension, &sizes, &texture_coordinate_field) &&
+		(0 < stream->dimension) && (stream->dimension <= 3) && texture_coordinate_field))
+	{
+		display_message(ERROR_MESSAGE,
+			"Image filter streaming needs a 1 to 3 dimensional image source");
+		if (sizes)
+			DEALLOCATE(sizes);
+		delete stream;
+		return 0;
+	}
+	stream->texture_coordinate_field = cmzn_field_access(texture_coordinate_field);
+	for (int d = 0; d < stream->dimension; ++d)
+	{
+		stream->sizes[d] = sizes[d];
+		for (size_t s = 0; s < stream->stages.size(); ++s)
+			stream->halo[d] += Image_filter_stream_stage_get_halo(stream->stages[s], d);
+	}
+	DEALLOCATE(sizes);
+	return stream;
+}
+
+int DESTROY(Image_filter_stream)(struct Image_filter_stream **stream_address)
+{
+	if (stream_address && (*stream_address))
+	{
+		delete *stream_address;
+		*stream_address = 0;
+		return 1;
+	}
+	return 0;
+}
+
+int Image_filter_stream_get_sizes(struct Image_filter_stream *stream,
+	int *sizes)
+{
+	if (!(stream && sizes))
+		return 0;
+	for (int d = 0; d < 3; ++d)
+		sizes[d] = stream->sizes[d];
+	return stream->dimension;
+}
+
+int Image_filter_stream_get_halo(struct Image_filter_stream *stream,
+	int *halo)
+{
+	if (!(stream && halo))
+		return 0;
+	for (int d = 0; d < 3; ++d)
+		halo[d] = stream->halo[d];
+	return 1;
+}
+
+cmzn_field_id Image_filter_stream_get_texture_coordinate_field(
+	struct Image_filter_stream *stream)
+{
+	if (stream)
+		return cmzn_field_access(stream->texture_coordinate_field);
+	return 0;
+}
+
+cmzn_field_id Image_filter_stream_create_tile_field(
+	struct Image_filter_stream *stream, const int *minimum, const int *maximum)
+{
+	if (!(stream && minimum && maximum))
+	{
+		display_message(ERROR_MESSAGE,
+			"Image_filter_stream_create_tile_field.  Invalid argument(s)");
+		return 0;
+	}
+	const int dimension = stream->dimension;
+	int tile_sizes[3];
+	double input_minimum[3], input_maximum[3], lookup_minimum[3], lookup_maximum[3];
+	for (int d = 0; d < dimension; ++d)
+	{
+		if (!((0 <= minimum[d]) && (minimum[d] < maximum[d]) &&
+			(maximum[d] <= stream->sizes[d])))
+		{
+			display_message(ERROR_MESSAGE,
+				"Image_filter_stream_create_tile_field.  Invalid tile range");
+			return 0;
+		}
+		tile_sizes[d] = maximum[d] - minimum[d];
+		/* image_resample coordinates are normalised to the source image */
+		input_minimum[d] = 0.0;
+		input_maximum[d] = 1.0;
+		lookup_minimum[d] = (double)minimum[d]/(double)stream->sizes[d];
+		lookup_maximum[d] = (double)maximum[d]/(double)stream->sizes[d];
+	}
+	cmzn_fieldmodule_id field_module = cmzn_field_get_fieldmodule(stream->source_field);
+	cmzn_fieldmodule_begin_change(field_module);
+	cmzn_field_id field = cmzn_fieldmodule_create_field_image_resample(field_module,
+		stream->source_field, dimension, tile_sizes);
+	if (field)
+	{
+		cmzn_field_image_resample_id image_resample = cmzn_field_cast_image_resample(field);
+		cmzn_field_image_resample_set_input_coordinates_minimum(image_resample,
+			dimension, input_minimum);
+		cmzn_field_image_resample_set_input_coordinates_maximum(image_resample,
+			dimension, input_maximum);
+		cmzn_field_image_resample_set_lookup_coordinates_minimum(image_resample,
+			dimension, lookup_minimum);
+		cmzn_field_image_resample_set_lookup_coordinates_maximum(image_resample,
+			dimension, lookup_maximum);
+		cmzn_field_image_resample_destroy(&image_resample);
+	}
+	for (size_t s = stream->stages.size(); field && (0 < s); --s)
+	{
+		cmzn_field_id filter_field = Image_filter_stream_stage_create_field(
+			stream->stages[s - 1], field_module, field, dimension);
+		cmzn_field_destroy(&field);
+		field = filter_field;
+	}
+	cmzn_fieldmodule_end_change(field_module);
+	cmzn_fieldmodule_destroy(&field_module);
+	if (!field)
+	{
+		display_message(ERROR_MESSAGE,
+			"Image_filter_stream_create_tile_field.  Could not create filters for tile");
+	}
+	return field;
+}
@@ -0,0 +1,73 @@
+/**
+ * FILE : image_filter_stream.h
+ *
+ * Evaluates a chain of ITK image filter fields one tile of the source image at
+ * a time, so the filters never hold buffers for the whole image.
+ */
+/* OpenCMISS-Cmgui Application
+*
+* This Source Code Form is subject to the terms of the Mozilla Public
+* License, v. 2.0. If a copy of the MPL was not distributed with this
+* file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+#if !defined (IMAGE_FILTER_STREAM_H)
+#define IMAGE_FILTER_STREAM_H
+
+#include "opencmiss/zinc/types/fieldid.h"
+#include "general/object.h"
+
+struct Image_filter_stream;
+
+/**
+ * Records the chain of image filters ending at <field> down to the first
+ * field which is not a filter, the image source. Only filters whose output
+ * at a pixel depends on a bounded neighbourhood of their input can be
+ * streamed: mean, discrete_gaussian, derivative, binary_dilate, binary_erode,
+ * sigmoid, threshold and binary_threshold. Curvature anisotropic diffusion
+ * and canny edge detection depend on the whole image and are rejected.
+ * @return  New stream, or NULL with an error message if <field> is not such a
+ * filter, the chain includes a filter depending on the whole image or the
+ * source has no native resolution.
+ */
+struct Image_filter_stream *CREATE(Image_filter_stream)(cmzn_field_id field);
+
+int DESTROY(Image_filter_stream)(struct Image_filter_stream **stream_address);
+
+/**
+ * Gets the native resolution of the source image, which the filters keep.
+ * @param sizes  Array of 3 receiving the number of pixels in each direction,
+ * 1 beyond the dimension.
+ * @return  Dimension of the image, or 0 if invalid.
+ */
+int Image_filter_stream_get_sizes(struct Image_filter_stream *stream,
+	int *sizes);
+
+/**
+ * Gets the number of extra pixels each side of a tile the chain needs to give
+ * the same result as filtering the whole image, the sum of the neighbourhood
+ * radii of the filters.
+ * @param halo  Array of 3 receiving the halo in each direction.
+ */
+int Image_filter_stream_get_halo(struct Image_filter_stream *stream,
+	int *halo);
+
+/**
+ * @return  Accessed texture coordinate field locating pixels of the source
+ * image and of tile fields, or NULL if invalid.
+ */
+cmzn_field_id Image_filter_stream_get_texture_coordinate_field(
+	struct Image_filter_stream *stream);
+
+/**
+ * Creates a copy of the filter chain applied to the pixels of the source from
+ * <minimum> up to but excluding <maximum>, cropped out with an image_resample
+ * field. The tile field has a native resolution of maximum - minimum pixels,
+ * spread over the full range of the texture coordinates, and is released with
+ * all its filter buffers when destroyed.
+ * Not thread safe: call from the main thread.
+ * @param minimum, maximum  Pixel ranges in each direction, including halo.
+ * @return  Accessed tile field, or NULL on failure.
+ */
+cmzn_field_id Image_filter_stream_create_tile_field(
+	struct Image_filter_stream *stream, const int *minimum, const int *maximum);
+
+#endif /* !defined (IMAGE_FILTER_STREAM_H) */
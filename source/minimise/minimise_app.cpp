@@ -4,12 +4,18 @@
 * License, v. 2.0. If a copy of the MPL was not distributed with this
 * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
 #include "opencmiss/zinc/field.h"
+#include "opencmiss/zinc/fieldcache.h"
 #include "opencmiss/zinc/fieldmodule.h"
 #include "opencmiss/zinc/fieldgroup.h"
 #include "opencmiss/zinc/optimisation.h"
 #include "opencmiss/zinc/region.h"
 #include "opencmiss/zinc/status.h"
+#include "general/cmgui_time.h"
 #include "general/debug.h"
 #include "general/message.h"
 #include "command/parser.h"
@@ -18,6 +24,192 @@
 #include "region/cmiss_region_app.h"
 #include "minimise/minimise.h"
 
+namespace {
+
+double minimise_get_seconds(void)
+{
+	struct timeval time_value;
+	cmgui_gettimeofday(&time_value, NULL);
+	return (double)time_value.tv_sec + 1.0E-6*(double)time_value.tv_usec;
+}
+
+/**
+ * @return  Sum of all components of the <objective_fields>, the value being
+ * minimised, or 0 if any cannot be evaluated with <valid> set to false.
+ */
+double minimise_evaluate_objective(cmzn_fieldmodule_id field_module,
+	const std::vector<cmzn_field_id> &objective_fields, bool &valid)
+{
+	double objective = 0.0;
+	valid = true;
+	cmzn_fieldcache_id field_cache = cmzn_fieldmodule_create_fieldcache(field_module);
+	std::vector<double> values;
+	for (size_t i = 0; i < objective_fields.size(); ++i)
+	{
+		const int number_of_components = cmzn_field_get_number_of_components(objective_fields[i]);
+		values.resize(number_of_components);
+		if ((0 < number_of_components) && (CMZN_OK == cmzn_field_evaluate_real(
+			objective_fields[i], field_cache, number_of_components, &(values[0]))))
+		{
+			for (int j = 0; j < number_of_components; ++j)
+				objective += values[j];
+		}
+		else
+		{
+			valid = false;
+		}
+	}
+	cmzn_fieldcache_destroy(&field_cache);
+	return valid ? objective : 0.0;
+}
+
+/**
+ * Writes the nodal parameters of the independent fields to <file_name>, via a
+ * temporary file so an interrupted write leaves the previous checkpoint.
+ */
+int minimise_write_checkpoint(cmzn_region_id region, const char *file_name,
+	Multiple_strings &independent_field_names)
+{
+	std::string temporary_file_name = std::string(file_name) + ".tmp";
+	int return_code = export_region_file_of_name(temporary_file_name.c_str(),
+		region, /*group_name*/0, region, /*write_elements*/0, /*write_nodes*/1,
+		/*write_data*/0, independent_field_names.number_of_strings,
+		independent_field_names.strings, /*time*/0.0,
+		CMZN_STREAMINFORMATION_REGION_RECURSION_MODE_OFF, /*isFieldML*/0);
+	if (return_code)
+	{
+		remove(file_name);
+		if (0 != rename(temporary_file_name.c_str(), file_name))
+		{
+			display_message(ERROR_MESSAGE,
+				"gfx minimise:  Could not rename checkpoint to %s", file_name);
+			return_code = 0;
+		}
+	}
+	return return_code;
+}
+
+/**
+ * @return  Number of iterations taken by the last optimise call, read from the
+ * "No. iterations taken" line of its solution report, or -1 if not found.
+ * Zinc's optimisation attributes are all settings, so the report is the only
+ * place the count is given.
+ */
+int minimise_get_iterations_taken(cmzn_optimisation_id optimisation)
+{
+	int iterations_taken = -1;
+	char *report = cmzn_optimisation_get_solution_report(optimisation);
+	if (report)
+	{
+		const char *text = strstr(report, "iterations taken");
+		if (text)
+		{
+			text += strlen("iterations taken");
+			while ((' ' == *text) || ('=' == *text) || (':' == *text))
+				++text;
+			if ((1 != sscanf(text, "%d", &iterations_taken)) || (iterations_taken < 0))
+				iterations_taken = -1;
+		}
+		DEALLOCATE(report);
+	}
+	return iterations_taken;
+}
+
+/**
+ * Optimises up to <maximum_iterations> in steps of the smaller of
+ * <report_every> and <checkpoint_every> iterations, writing the objective and
+ * times every <report_every> and a checkpoint every <checkpoint_every>
+ * iterations, where these are non-zero. Stops early once the optimiser
+ * takes fewer iterations than a step allows or leaves the objective unchanged.
+ * Iterations are counted from the solution report of each step; if it does
+ * not give them, the step's limit is counted and reported as an upper bound.
+ */
+int minimise_optimise_in_steps(cmzn_optimisation_id optimisation,
+	cmzn_fieldmodule_id field_module, cmzn_region_id region,
+	const std::vector<cmzn_field_id> &objective_fields, int maximum_iterations,
+	int report_every, int checkpoint_every, const char *checkpoint_file_name,
+	Multiple_strings &independent_field_names)
+{
+	int step_iterations = report_every;
+	if ((0 < checkpoint_every) && ((0 == step_iterations) || (checkpoint_every < step_iterations)))
+		step_iterations = checkpoint_every;
+	const double start_seconds = minimise_get_seconds();
+	bool valid;
+	double objective = minimise_evaluate_objective(field_module, objective_fields, valid);
+	if (report_every)
+	{
+		display_message(INFORMATION_MESSAGE,
+			"gfx minimise:  %10s %24s %12s %12s\n", "iterations", "objective", "step (s)", "total (s)");
+		if (valid)
+			display_message(INFORMATION_MESSAGE,
+				"gfx minimise:  %10d %24.16e\n", 0, objective);
+	}
+	int return_code = 1;
+	int iterations = 0, next_report = report_every, next_checkpoint = checkpoint_every;
+	/* set once any step's iterations are not in its solution report */
+	bool iterations_upper_bound = false;
+	while (return_code && (iterations < maximum_iterations))
+	{
+		int iterations_this_step = maximum_iterations - iterations;
+		if (iterations_this_step > step_iterations)
+			iterations_this_step = step_iterations;
+		const double step_start_seconds = minimise_get_seconds();
+		if ((CMZN_OK != cmzn_optimisation_set_attribute_integer(optimisation,
+				CMZN_OPTIMISATION_ATTRIBUTE_MAXIMUM_ITERATIONS, iterations_this_step)) ||
+			(!cmzn_optimisation_optimise(optimisation)))
+		{
+			return_code = 0;
+			break;
+		}
+		const double end_seconds = minimise_get_seconds();
+		const int iterations_taken = minimise_get_iterations_taken(optimisation);
+		bool stopped_early = false;
+		if ((0 <= iterations_taken) && (iterations_taken <= iterations_this_step))
+		{
+			iterations += iterations_taken;
+			stopped_early = (iterations_taken < iterations_this_step);
+		}
+		else
+		{
+			iterations += iterations_this_step;
+			iterations_upper_bound = true;
+		}
+		const double last_objective = objective;
+		objective = minimise_evaluate_objective(field_module, objective_fields, valid);
+		const bool converged = stopped_early || (valid && (objective == last_objective));
+		const bool finished = converged || (iterations >= maximum_iterations);
+		if (report_every && ((iterations >= next_report) || finished))
+		{
+			char iterations_string[32];
+			sprintf(iterations_string, "%s%d", iterations_upper_bound ? "<=" : "", iterations);
+			if (valid)
+			{
+				display_message(INFORMATION_MESSAGE,
+					"gfx minimise:  %10s %24.16e %12.3f %12.3f\n", iterations_string, objective,
+					end_seconds - step_start_seconds, end_seconds - start_seconds);
+			}
+			else
+			{
+				display_message(INFORMATION_MESSAGE,
+					"gfx minimise:  %10s %24s %12.3f %12.3f\n", iterations_string, "-",
+					end_seconds - step_start_seconds, end_seconds - start_seconds);
+			}
+			next_report = iterations + report_every;
+		}
+		if (checkpoint_every && ((iterations >= next_checkpoint) || finished))
+		{
+			if (!minimise_write_checkpoint(region, checkpoint_file_name, independent_field_names))
+				return_code = 0;
+			next_checkpoint = iterations + checkpoint_every;
+		}
+		if (converged)
+			break;
+	}
+	return return_code;
+}
+
+}
+
 int gfx_minimise(struct Parse_state *state, void *dummy_to_be_modified,
 	void *root_region_void)
 {
@@ -28,6 +220,10 @@ int gfx_minimise(struct Parse_state *state, void *dummy_to_be_modified,
 	{
 		enum cmzn_optimisation_method optimisation_method = CMZN_OPTIMISATION_METHOD_QUASI_NEWTON;
 		int maxIters = 100; // default value
+		int checkpointEvery = 0;
+		int reportEvery = 0;
+		char *checkpointFileName = 0;
+		char restartSteps = 0;
 		int showReport = 1; // output solution report by default
 		const char *optimisation_method_string = 0;
 		Multiple_strings conditionalFieldNames;
@@ -48,10 +244,31 @@ int gfx_minimise(struct Parse_state *state, void *dummy_to_be_modified,
 			"Field types 'nodeset_sum_squares' and 'mesh_integral_squares' have "
 			"special behaviour with the LEAST_SQUARES_QUASI_NEWTON solution method, "
 			"supplying individual terms for the least squares solution, useful for "
-			"least squares fitting problems.");
+			"least squares fitting problems. "
+			"With report_every N, the objective value and times are written after "
+			"every N iterations. With checkpoint_every N, the independent fields' "
+			"nodal parameters are written to the EX <file> after every N iterations, "
+			"so a long fit can be resumed by reading the file and minimising again. "
+			"Either option runs the optimiser for the smaller number of iterations at "
+			"a time, restarting it from the current parameters; iterating stops early "
+			"once the optimiser takes fewer iterations than allowed or the objective "
+			"no longer changes. Restarting changes the solution: QUASI_NEWTON "
+			"discards its Hessian approximation at every restart, so it converges "
+			"more slowly and may reach a different minimum, and it needs the "
+			"restart_steps flag to agree to this. LEAST_SQUARES_QUASI_NEWTON rebuilds "
+			"its Hessian from the terms at each iteration but resets its trust region "
+			"size, so its path may also differ slightly from an unbroken run. "
+			"There is no threads option: Zinc's optimiser evaluates the objective "
+			"and its derivatives on the calling thread.");
+		/* checkpoint_every */
+		Option_table_add_int_non_negative_entry(option_table, "checkpoint_every",
+			&checkpointEvery);
 		/* conditional_fields */
 		Option_table_add_multiple_strings_entry(option_table, "conditional_fields",
 			&conditionalFieldNames, "FIELD_NAME|none [& FIELD_NAME|none [& ...]]");
+		/* file */
+		Option_table_add_entry(option_table, "file", &checkpointFileName,
+			(void *)1, set_name);
 		/* independent field(s) */
 		Option_table_add_multiple_strings_entry(option_table, "independent_fields",
 			&independentFieldNames, "FIELD_NAME [& FIELD_NAME [& ...]]");
@@ -76,11 +293,37 @@ int gfx_minimise(struct Parse_state *state, void *dummy_to_be_modified,
 			&objectiveFieldNames, "FIELD_NAME [& FIELD_NAME [& ...]]");
 		/* region */
 		Option_table_add_set_cmzn_region(option_table, "region", root_region, &region);
+		/* report_every */
+		Option_table_add_int_non_negative_entry(option_table, "report_every",
+			&reportEvery);
+		/* restart_steps */
+		Option_table_add_char_flag_entry(option_table, "restart_steps",
+			&restartSteps);
 		/* flag whether to show or hide the optimisation output */
 		Option_table_add_switch(option_table, "show_output", "hide_output", &showReport);
 		return_code = Option_table_multi_parse(option_table, state);
+		if (return_code && ((0 < checkpointEvery) != (0 != checkpointFileName)))
+		{
+			display_message(ERROR_MESSAGE,
+				"gfx minimise:  checkpoint_every and file must be given together");
+			return_code = 0;
+		}
+		if (return_code && ((0 < reportEvery) || (0 < checkpointEvery)) && (!restartSteps))
+		{
+			STRING_TO_ENUMERATOR(cmzn_optimisation_method)(
+				optimisation_method_string, &optimisation_method);
+			if (CMZN_OPTIMISATION_METHOD_QUASI_NEWTON == optimisation_method)
+			{
+				display_message(ERROR_MESSAGE, "gfx minimise:  report_every and "
+					"checkpoint_every restart the optimiser, which discards the Hessian "
+					"approximation of method %s and changes the solution. Add "
+					"restart_steps to accept this", optimisation_method_string);
+				return_code = 0;
+			}
+		}
 		if (return_code)
 		{
+			std::vector<cmzn_field_id> objectiveFields;
 			cmzn_fieldmodule_id fieldModule = cmzn_region_get_fieldmodule(region);
 			cmzn_optimisation_id optimisation = cmzn_fieldmodule_create_optimisation(fieldModule);
 			STRING_TO_ENUMERATOR(cmzn_optimisation_method)(
@@ -130,13 +373,17 @@ int gfx_minimise(struct Parse_state *state, void *dummy_to_be_modified,
 			{
 				cmzn_field_id objectiveField = cmzn_fieldmodule_find_field_by_name(
 					fieldModule, objectiveFieldNames.strings[i]);
-				if (CMZN_OK != cmzn_optimisation_add_objective_field(optimisation, objectiveField))
+				if (CMZN_OK == cmzn_optimisation_add_objective_field(optimisation, objectiveField))
+				{
+					objectiveFields.push_back(objectiveField);
+				}
+				else
 				{
 					display_message(ERROR_MESSAGE, "gfx minimise:  Invalid or unrecognised objective field '%s'",
 						objectiveFieldNames.strings[i]);
 					return_code = 0;
+					cmzn_field_destroy(&objectiveField);
 				}
-				cmzn_field_destroy(&objectiveField);
 			}
 			if (CMZN_OK != cmzn_optimisation_set_attribute_integer(optimisation,
 				CMZN_OPTIMISATION_ATTRIBUTE_MAXIMUM_ITERATIONS, maxIters))
@@ -146,7 +393,16 @@ int gfx_minimise(struct Parse_state *state, void *dummy_to_be_modified,
 			}
 			if (return_code)
 			{
-				return_code = cmzn_optimisation_optimise(optimisation);
+				if ((0 < reportEvery) || (0 < checkpointEvery))
+				{
+					return_code = minimise_optimise_in_steps(optimisation, fieldModule,
+						region, objectiveFields, maxIters, reportEvery, checkpointEvery,
+						checkpointFileName, independentFieldNames);
+				}
+				else
+				{
+					return_code = cmzn_optimisation_optimise(optimisation);
+				}
 				if (showReport)
 				{
 					char *report = cmzn_optimisation_get_solution_report(optimisation);
@@ -161,10 +417,14 @@ int gfx_minimise(struct Parse_state *state, void *dummy_to_be_modified,
 					display_message(ERROR_MESSAGE, "gfx minimise.  Optimisation failed.");
 				}
 			}
+			for (size_t i = 0; i < objectiveFields.size(); ++i)
+				cmzn_field_destroy(&(objectiveFields[i]));
 			cmzn_optimisation_destroy(&optimisation);
 			cmzn_fieldmodule_destroy(&fieldModule);
 		}
 		DESTROY(Option_table)(&option_table);
+		if (checkpointFileName)
+			DEALLOCATE(checkpointFileName);
 		cmzn_region_destroy(&region);
 	}
 	else
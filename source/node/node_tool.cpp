@@ -36,6 +36,7 @@ Scene input.
 #include "computed_field/computed_field_set.h"
 #include "computed_field/computed_field_wrappers.h"
 #include "opencmiss/zinc/fieldsubobjectgroup.h"
+#include "general/cmgui_time.h"
 #include "general/debug.h"
 #include "general/matrix_vector.h"
 #include "general/mystring.h"
@@ -62,6 +63,7 @@ Scene input.
 #include "general/message.h"
 #include "command/parser.h"
 #include "region/cmiss_region_app.h"
+#include "user_interface/event_dispatcher.h"
 
 #if defined (WX_USER_INTERFACE)
 #include "wx/wx.h"
@@ -95,6 +97,12 @@ class wxNodeTool;
 static int Node_tool_set_region(struct Node_tool *node_tool,
 	struct cmzn_region *region, cmzn_field_group_id group);
 
+static void Node_tool_interactive_event_handler(void *device_id,
+	struct Interactive_event *event,void *node_tool_void,
+	cmzn_sceneviewer *scene_viewer);
+
+struct Node_tool_drag_session;
+
 struct Node_tool
 /*******************************************************************************
 LAST MODIFIED : 17 May 2003
@@ -145,6 +153,9 @@ changes in node position and derivatives etc.
 	struct cmzn_scene *scene;
 	struct cmzn_graphics *graphics;
 	struct Interaction_volume *last_interaction_volume;
+	/* nodes being moved while dragging with edit enabled, created on the first
+		 edit and destroyed on reset */
+	struct Node_tool_drag_session *drag_session;
 	struct GT_object *rubber_band;
 
 	bool createElementEnabled;
@@ -663,6 +674,276 @@ static int FE_node_edit_position(struct FE_node *node,
 	return (return_code);
 } /* FE_node_edit_position */
 
+/** Minimum time between node edits while dragging, matching a 60Hz display. */
+const long NODE_TOOL_DRAG_FRAME_INTERVAL_US = 16667;
+
+/**
+ * Nodes moved with the last picked node while dragging. Their handles and
+ * coordinates at the start of the drag are cached so each update is a single
+ * pass adding the accumulated delta and assigning the result, with no
+ * selection iteration or field evaluation. Motion events arriving within a
+ * frame of the last update are held and the latest is applied from a timeout.
+ */
+struct Node_tool_drag_session
+{
+	struct Node_tool *node_tool;
+	cmzn_fieldcache_id field_cache;
+	cmzn_field_id coordinate_field;
+	FE_value time;
+	int number_of_nodes;
+	cmzn_node_id *nodes;
+	/* 3 coordinates per node at the start of the drag, then the values to set */
+	double *start_coordinates, *coordinates;
+	double total_delta[3];
+	struct timeval last_update;
+	/* latest deferred motion event with the device and viewer it came from */
+	struct Interactive_event *pending_event;
+	void *pending_device_id;
+	cmzn_sceneviewer_id pending_scene_viewer;
+	struct Event_dispatcher_timeout_callback *timeout;
+	/* set while the pending event is handled so it is not deferred again */
+	int flushing;
+}; /* struct Node_tool_drag_session */
+
+static int DESTROY(Node_tool_drag_session)(
+	struct Node_tool_drag_session **session_address);
+
+/**
+ * Caches the nodes in <nodeset_group> other than <picked_node> at which
+ * <coordinate_field> is defined, with their current coordinates.
+ * @return  New drag session, or NULL on failure.
+ */
+static struct Node_tool_drag_session *CREATE(Node_tool_drag_session)(
+	struct Node_tool *node_tool, cmzn_nodeset_group_id nodeset_group,
+	cmzn_field_id coordinate_field, struct FE_node *picked_node, FE_value time)
+{
+	cmzn_nodeset_id nodeset = cmzn_nodeset_group_base_cast(nodeset_group);
+	const int size = cmzn_nodeset_get_size(nodeset);
+	struct Node_tool_drag_session *session = 0;
+	if (ALLOCATE(session, struct Node_tool_drag_session, 1))
+	{
+		cmzn_fieldmodule_id field_module = cmzn_field_get_fieldmodule(coordinate_field);
+		session->node_tool = node_tool;
+		session->field_cache = cmzn_fieldmodule_create_fieldcache(field_module);
+		cmzn_fieldmodule_destroy(&field_module);
+		session->coordinate_field = cmzn_field_access(coordinate_field);
+		session->time = time;
+		session->number_of_nodes = 0;
+		session->nodes = 0;
+		session->start_coordinates = 0;
+		session->coordinates = 0;
+		session->total_delta[0] = 0.0;
+		session->total_delta[1] = 0.0;
+		session->total_delta[2] = 0.0;
+		cmgui_gettimeofday(&session->last_update, NULL);
+		session->pending_event = 0;
+		session->pending_device_id = 0;
+		session->pending_scene_viewer = 0;
+		session->timeout = 0;
+		session->flushing = 0;
+		if (session->field_cache && (0 <= size) &&
+			ALLOCATE(session->nodes, cmzn_node_id, size + 1) &&
+			ALLOCATE(session->start_coordinates, double, 3*size + 1) &&
+			ALLOCATE(session->coordinates, double, 3*size + 1))
+		{
+			cmzn_fieldcache_set_time(session->field_cache, time);
+			cmzn_nodeiterator_id iterator = cmzn_nodeset_create_nodeiterator(nodeset);
+			cmzn_node_id node = 0;
+			while ((0 != (node = cmzn_nodeiterator_next_non_access(iterator))) &&
+				(session->number_of_nodes < size))
+			{
+				if (node == picked_node)
+					continue;
+				double *node_coordinates = session->start_coordinates + 3*session->number_of_nodes;
+				/* clear coordinates in case less than 3 dimensions */
+				node_coordinates[0] = 0.0;
+				node_coordinates[1] = 0.0;
+				node_coordinates[2] = 0.0;
+				cmzn_fieldcache_set_node(session->field_cache, node);
+				/* nodes the field isn't defined at are not moved */
+				if (CMZN_OK == cmzn_field_evaluate_real(coordinate_field,
+					session->field_cache, 3, node_coordinates))
+				{
+					session->nodes[session->number_of_nodes] = cmzn_node_access(node);
+					++(session->number_of_nodes);
+				}
+			}
+			cmzn_nodeiterator_destroy(&iterator);
+		}
+		else
+		{
+			display_message(ERROR_MESSAGE,
+				"CREATE(Node_tool_drag_session).  Not enough memory");
+			DESTROY(Node_tool_drag_session)(&session);
+		}
+	}
+	else
+	{
+		display_message(ERROR_MESSAGE,
+			"CREATE(Node_tool_drag_session).  Not enough memory");
+	}
+	return session;
+}
+
+static int DESTROY(Node_tool_drag_session)(
+	struct Node_tool_drag_session **session_address)
+{
+	struct Node_tool_drag_session *session;
+	if (session_address && (session = *session_address))
+	{
+		if (session->timeout)
+		{
+			Event_dispatcher_remove_timeout_callback(
+				User_interface_get_event_dispatcher(session->node_tool->user_interface),
+				session->timeout);
+		}
+		if (session->pending_event)
+			DEACCESS(Interactive_event)(&session->pending_event);
+		if (session->pending_scene_viewer)
+			cmzn_sceneviewer_destroy(&session->pending_scene_viewer);
+		for (int i = 0; i < session->number_of_nodes; ++i)
+			cmzn_node_destroy(&session->nodes[i]);
+		DEALLOCATE(session->nodes);
+		DEALLOCATE(session->start_coordinates);
+		DEALLOCATE(session->coordinates);
+		cmzn_field_destroy(&session->coordinate_field);
+		cmzn_fieldcache_destroy(&session->field_cache);
+		DEALLOCATE(*session_address);
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * Adds <delta> to the total change in <coordinate_field> for the drag and sets
+ * it at all nodes of the session. Call within a field module change.
+ */
+static int Node_tool_drag_session_move(struct Node_tool_drag_session *session,
+	const double *delta)
+{
+	session->total_delta[0] += delta[0];
+	session->total_delta[1] += delta[1];
+	session->total_delta[2] += delta[2];
+	const double delta1 = session->total_delta[0];
+	const double delta2 = session->total_delta[1];
+	const double delta3 = session->total_delta[2];
+	const double *start_coordinates = session->start_coordinates;
+	double *coordinates = session->coordinates;
+	const int number_of_values = 3*session->number_of_nodes;
+	for (int i = 0; i < number_of_values; i += 3)
+	{
+		coordinates[i] = start_coordinates[i] + delta1;
+		coordinates[i + 1] = start_coordinates[i + 1] + delta2;
+		coordinates[i + 2] = start_coordinates[i + 2] + delta3;
+	}
+	int number_of_failures = 0;
+	for (int i = 0; i < session->number_of_nodes; ++i)
+	{
+		cmzn_fieldcache_set_node(session->field_cache, session->nodes[i]);
+		if (CMZN_OK != cmzn_field_assign_real(session->coordinate_field,
+			session->field_cache, 3, coordinates + 3*i))
+			++number_of_failures;
+	}
+	cmgui_gettimeofday(&session->last_update, NULL);
+	if (number_of_failures)
+	{
+		display_message(ERROR_MESSAGE, "Node_tool_drag_session_move.  "
+			"Failed to move %d nodes", number_of_failures);
+		return 0;
+	}
+	return 1;
+}
+
+/**
+ * Handles the motion event deferred by the drag session of <node_tool>, if any.
+ */
+static int Node_tool_drag_session_flush(void *node_tool_void)
+{
+	struct Node_tool *node_tool = static_cast<struct Node_tool *>(node_tool_void);
+	struct Node_tool_drag_session *session = node_tool->drag_session;
+	if (session)
+	{
+		if (session->timeout)
+		{
+			Event_dispatcher_remove_timeout_callback(
+				User_interface_get_event_dispatcher(node_tool->user_interface),
+				session->timeout);
+		}
+		session->timeout = 0;
+		struct Interactive_event *event = session->pending_event;
+		cmzn_sceneviewer_id scene_viewer = session->pending_scene_viewer;
+		session->pending_event = 0;
+		session->pending_scene_viewer = 0;
+		if (event)
+		{
+			session->flushing = 1;
+			Node_tool_interactive_event_handler(session->pending_device_id, event,
+				(void *)node_tool, scene_viewer);
+			/* the handler may have replaced the session */
+			if (node_tool->drag_session)
+				node_tool->drag_session->flushing = 0;
+			DEACCESS(Interactive_event)(&event);
+			cmzn_sceneviewer_destroy(&scene_viewer);
+		}
+	}
+	return 1;
+}
+
+/** Timeout callback applying the latest motion event held while dragging. */
+static int Node_tool_drag_session_timeout(void *node_tool_void)
+{
+	struct Node_tool *node_tool = static_cast<struct Node_tool *>(node_tool_void);
+	if (node_tool->drag_session)
+	{
+		/* one-shot timeout is destroyed by the event dispatcher after this */
+		node_tool->drag_session->timeout = 0;
+		Node_tool_drag_session_flush(node_tool_void);
+	}
+	return 1;
+}
+
+/**
+ * Holds motion <event> while dragging if the nodes were moved less than a frame
+ * ago, replacing any event already held and making sure a timeout will apply
+ * it at the start of the next frame.
+ * @return  1 if the event was deferred, 0 if it should be handled now.
+ */
+static int Node_tool_drag_session_defer_motion(
+	struct Node_tool_drag_session *session, void *device_id,
+	struct Interactive_event *event, cmzn_sceneviewer_id scene_viewer)
+{
+	if (session->flushing)
+		return 0;
+	struct timeval now;
+	cmgui_gettimeofday(&now, NULL);
+	const long elapsed_us = (now.tv_sec - session->last_update.tv_sec)*1000000L +
+		(now.tv_usec - session->last_update.tv_usec);
+	if ((elapsed_us < 0) || (NODE_TOOL_DRAG_FRAME_INTERVAL_US <= elapsed_us))
+		return 0;
+	REACCESS(Interactive_event)(&session->pending_event, event);
+	if (session->pending_scene_viewer != scene_viewer)
+	{
+		cmzn_sceneviewer_destroy(&session->pending_scene_viewer);
+		session->pending_scene_viewer = cmzn_sceneviewer_access(scene_viewer);
+	}
+	session->pending_device_id = device_id;
+	if (!session->timeout)
+	{
+		session->timeout = Event_dispatcher_add_timeout_callback(
+			User_interface_get_event_dispatcher(session->node_tool->user_interface),
+			0, /*ns*/(unsigned long)(NODE_TOOL_DRAG_FRAME_INTERVAL_US - elapsed_us)*1000,
+			Node_tool_drag_session_timeout, (void *)session->node_tool);
+		if (!session->timeout)
+		{
+			/* cannot wait; handle the event now */
+			DEACCESS(Interactive_event)(&session->pending_event);
+			cmzn_sceneviewer_destroy(&session->pending_scene_viewer);
+			return 0;
+		}
+	}
+	return 1;
+}
+
 static int FE_node_calculate_delta_vector(struct FE_node *node,
 	void *edit_info_void)
 /*******************************************************************************
@@ -1262,6 +1543,8 @@ Resets current edit. Called on button release or when tool deactivated.
 			(struct cmzn_scene *)NULL);
 		REACCESS(cmzn_graphics)(&(node_tool->graphics),
 			(struct cmzn_graphics *)NULL);
+		if (node_tool->drag_session)
+			DESTROY(Node_tool_drag_session)(&(node_tool->drag_session));
 	}
 	else
 	{
@@ -1338,6 +1621,25 @@ release.
 	if (device_id&&event&&(node_tool=
 		(struct Node_tool *)node_tool_void) && scene_viewer)
 	{
+		if (node_tool->drag_session)
+		{
+			/* coalesce drag motion to the display frame rate, and apply any held
+				 motion before other events */
+			if (INTERACTIVE_EVENT_MOTION_NOTIFY == Interactive_event_get_type(event))
+			{
+				if (Node_tool_drag_session_defer_motion(node_tool->drag_session,
+					device_id, event, scene_viewer))
+				{
+					return;
+				}
+			}
+			else
+			{
+				Node_tool_drag_session_flush((void *)node_tool);
+			}
+		}
+		/* set when only node coordinates change so selection needn't be flushed */
+		int drag_update = 0;
 		graphics_buffer = scene_viewer->graphics_buffer;
 		cmzn_region_begin_hierarchical_change(node_tool->root_region);
 		interaction_volume=Interactive_event_get_interaction_volume(event);
@@ -1754,14 +2056,39 @@ release.
 													/* edit position */
 													if (FE_node_calculate_delta_position(node_tool->last_picked_node, &edit_info))
 													{
-														cmzn_nodeiterator_id iterator =
-															cmzn_nodeset_create_nodeiterator(cmzn_nodeset_group_base_cast(nodeset_group));
-														cmzn_node_id edit_node = 0;
-														while (0 != (edit_node = cmzn_nodeiterator_next_non_access(iterator)))
+														/* the selection is fixed while dragging so reuse the
+															 nodes cached by the drag session */
+														if (node_tool->drag_session &&
+															((node_tool->drag_session->coordinate_field != coordinate_field) ||
+																(node_tool->drag_session->time != edit_info.time)))
+														{
+															DESTROY(Node_tool_drag_session)(&(node_tool->drag_session));
+														}
+														if (!node_tool->drag_session)
+														{
+															node_tool->drag_session = CREATE(Node_tool_drag_session)(
+																node_tool, nodeset_group, coordinate_field,
+																node_tool->last_picked_node, edit_info.time);
+														}
+														if (node_tool->drag_session)
+														{
+															const double delta[3] =
+																{ edit_info.delta1, edit_info.delta2, edit_info.delta3 };
+															return_code = Node_tool_drag_session_move(
+																node_tool->drag_session, delta);
+															drag_update = (INTERACTIVE_EVENT_MOTION_NOTIFY == event_type);
+														}
+														else
 														{
-															FE_node_edit_position(edit_node, &edit_info);
+															cmzn_nodeiterator_id iterator =
+																cmzn_nodeset_create_nodeiterator(cmzn_nodeset_group_base_cast(nodeset_group));
+															cmzn_node_id edit_node = 0;
+															while (0 != (edit_node = cmzn_nodeiterator_next_non_access(iterator)))
+															{
+																FE_node_edit_position(edit_node, &edit_info);
+															}
+															cmzn_nodeiterator_destroy(&iterator);
 														}
-														cmzn_nodeiterator_destroy(&iterator);
 													}
 												}
 												else
@@ -1942,7 +2269,7 @@ release.
 			cmzn_scenefiltermodule_end_change(filtermodule);
 			cmzn_scenefiltermodule_destroy(&filtermodule);
 		}
-		if (node_tool->root_region)
+		if (node_tool->root_region && !drag_update)
 		{
 			cmzn_scene *root_scene = cmzn_region_get_scene(
 				node_tool->root_region);
@@ -3021,6 +3348,7 @@ struct Node_tool *CREATE(Node_tool)(
 			node_tool->graphics=(struct cmzn_graphics *)NULL;
 
 			node_tool->last_interaction_volume=(struct Interaction_volume *)NULL;
+			node_tool->drag_session=(struct Node_tool_drag_session *)NULL;
 			node_tool->rubber_band=(struct GT_object *)NULL;
 			node_tool->rubber_band_glyph = 0;
 			node_tool->rubber_band_graphics = 0;
@@ -41,8 +41,34 @@ This provides an object which interfaces between a event_dispatcher and Cmgui
 #include "carbon/carbon.h"
 #elif defined (USE_GTK_MAIN_STEP) /* switch (USER_INTERFACE) */
 #include <gtk/gtk.h>
+#elif defined (USE_GENERIC_EVENT_DISPATCHER) /* switch (USER_INTERFACE) */
+#if defined (__linux__)
+/* Fdio descriptors are watched with epoll so the number and value of
+	descriptors is not limited by select */
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#define USE_EPOLL_EVENT_DISPATCHER
+#endif /* defined (__linux__) */
 #endif /* switch (USER_INTERFACE) */
 
+/*
+Module constants
+----------------
+*/
+
+#if defined (USE_GENERIC_EVENT_DISPATCHER)
+#define EVENT_DISPATCHER_NUMBER_OF_IDLE_PRIORITIES \
+	(EVENT_DISPATCHER_TUMBLE_SCENE_VIEWER_PRIORITY + 1)
+#endif /* defined (USE_GENERIC_EVENT_DISPATCHER) */
+#if defined (USE_EPOLL_EVENT_DISPATCHER)
+/* maximum number of ready descriptors collected by one epoll_wait */
+#define EVENT_DISPATCHER_MAX_EPOLL_EVENTS 64
+#endif /* defined (USE_EPOLL_EVENT_DISPATCHER) */
+
 /*
 Module types
 ------------
@@ -104,6 +130,10 @@ Contains all information necessary for a file descriptor callback.
 #if defined (WX_USER_INTERFACE)
 	wxEventTimer *wx_timer;
 #endif /* defined (WX_USER_INTERFACE) */
+#if defined (USE_GENERIC_EVENT_DISPATCHER)
+	/* position in the event_dispatcher timeout_heap, -1 if not in it */
+	int heap_index;
+#endif /* defined (USE_GENERIC_EVENT_DISPATCHER) */
 }; /* struct Event_dispatcher_timeout_callback */
 
 PROTOTYPE_OBJECT_FUNCTIONS(Event_dispatcher_timeout_callback);
@@ -137,6 +167,11 @@ Contains all information necessary for a file descriptor callback.
 #if defined (CARBON_USER_INTERFACE)
 	EventLoopTimerRef carbon_timer_ref;
 #endif /* defined (CARBON_USER_INTERFACE) */
+#if defined (USE_GENERIC_EVENT_DISPATCHER)
+	/* links in the event_dispatcher idle queue for this priority */
+	struct Event_dispatcher_idle_callback *previous_in_queue, *next_in_queue;
+	int in_queue;
+#endif /* defined (USE_GENERIC_EVENT_DISPATCHER) */
 }; /* struct Event_dispatcher_idle_callback */
 
 PROTOTYPE_OBJECT_FUNCTIONS(Event_dispatcher_idle_callback);
@@ -156,8 +191,30 @@ DESCRIPTION :
 #else
 	struct LIST(Event_dispatcher_descriptor_callback) *descriptor_list;
 #endif
+#if defined (USE_GENERIC_EVENT_DISPATCHER)
+	/* Timeouts are kept in a binary heap with the earliest at the top, so adding,
+		removing and finding the next timeout are all O(log n) or better */
+	struct Event_dispatcher_timeout_callback **timeout_heap;
+	int number_of_timeouts, timeout_heap_size;
+	/* Idle callbacks are kept in one FIFO queue per priority. A callback which
+		has not finished is moved to the back of its queue so callbacks of the
+		same priority take turns */
+	struct Event_dispatcher_idle_callback
+		*idle_queue_head[EVENT_DISPATCHER_NUMBER_OF_IDLE_PRIORITIES],
+		*idle_queue_tail[EVENT_DISPATCHER_NUMBER_OF_IDLE_PRIORITIES];
+#else /* defined (USE_GENERIC_EVENT_DISPATCHER) */
 	struct LIST(Event_dispatcher_timeout_callback) *timeout_list;
 	struct LIST(Event_dispatcher_idle_callback) *idle_list;
+#endif /* defined (USE_GENERIC_EVENT_DISPATCHER) */
+#if defined (USE_EPOLL_EVENT_DISPATCHER)
+	/* Fdio descriptors are registered with epoll_descriptor. Events returned by
+		one epoll_wait are dispatched one per Event_dispatcher_do_one_event */
+	int epoll_descriptor;
+	/* eventfd allowing other threads to wake the dispatcher */
+	int wake_descriptor;
+	struct epoll_event epoll_events[EVENT_DISPATCHER_MAX_EPOLL_EVENTS];
+	int number_of_epoll_events, next_epoll_event;
+#endif /* defined (USE_EPOLL_EVENT_DISPATCHER) */
 #if defined (USE_XTAPP_CONTEXT)
 /* This implements nearly the same interface as the normal implementation
 	but uses the Xt Application Context instead, thereby allowing us to test
@@ -203,6 +260,12 @@ read from or written to.
 	int is_reentrant, signal_to_destroy;
 	struct Event_dispatcher_descriptor_callback *callback;
 	int ready_to_read, ready_to_write;
+#if defined (USE_EPOLL_EVENT_DISPATCHER)
+	/* use_epoll is set if the descriptor is watched by the event_dispatcher
+		epoll_descriptor rather than through a descriptor callback; in_epoll while
+		it is currently registered there */
+	int use_epoll, in_epoll;
+#endif /* defined (USE_EPOLL_EVENT_DISPATCHER) */
 #elif defined(WIN32_USER_INTERFACE)
 	int wantevents;
 #elif defined(USE_GTK_MAIN_STEP)
@@ -568,6 +631,9 @@ Create a single object that belongs to a specific file descriptor.
 #if defined (WX_USER_INTERFACE)
 		timeout_callback->wx_timer = (wxEventTimer *)NULL;
 #endif /* defined (WX_USER_INTERFACE) */
+#if defined (USE_GENERIC_EVENT_DISPATCHER)
+		timeout_callback->heap_index = -1;
+#endif /* defined (USE_GENERIC_EVENT_DISPATCHER) */
 		timeout_callback->access_count = 0;
 	}
 	else
@@ -720,6 +786,11 @@ Create a single object that belongs to a specific file descriptor.
 #if defined (CARBON_USER_INTERFACE)
 		idle_callback->carbon_timer_ref = (EventLoopTimerRef)NULL;
 #endif /* defined (CARBON_USER_INTERFACE) */
+#if defined (USE_GENERIC_EVENT_DISPATCHER)
+		idle_callback->previous_in_queue = (struct Event_dispatcher_idle_callback *)NULL;
+		idle_callback->next_in_queue = (struct Event_dispatcher_idle_callback *)NULL;
+		idle_callback->in_queue = 0;
+#endif /* defined (USE_GENERIC_EVENT_DISPATCHER) */
 
 	}
 	else
@@ -858,6 +929,277 @@ DECLARE_INDEXED_LIST_FUNCTIONS(Event_dispatcher_idle_callback)
 DECLARE_FIND_BY_IDENTIFIER_IN_INDEXED_LIST_FUNCTION(Event_dispatcher_idle_callback, \
 	self,struct Event_dispatcher_idle_callback *,Event_dispatcher_idle_callback_compare)
 
+#if defined (USE_GENERIC_EVENT_DISPATCHER)
+static int Event_dispatcher_timeout_callback_is_earlier(
+	struct Event_dispatcher_timeout_callback *timeout_one,
+	struct Event_dispatcher_timeout_callback *timeout_two)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Returns true if <timeout_one> is due before <timeout_two>.
+==============================================================================*/
+{
+	return ((timeout_one->timeout_s < timeout_two->timeout_s) ||
+		((timeout_one->timeout_s == timeout_two->timeout_s) &&
+			(timeout_one->timeout_ns < timeout_two->timeout_ns)));
+} /* Event_dispatcher_timeout_callback_is_earlier */
+
+static void Event_dispatcher_timeout_heap_set(
+	struct Event_dispatcher *event_dispatcher, int index,
+	struct Event_dispatcher_timeout_callback *timeout_callback)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Stores <timeout_callback> at <index> in the timeout heap.
+==============================================================================*/
+{
+	event_dispatcher->timeout_heap[index] = timeout_callback;
+	timeout_callback->heap_index = index;
+} /* Event_dispatcher_timeout_heap_set */
+
+static void Event_dispatcher_timeout_heap_sift(
+	struct Event_dispatcher *event_dispatcher, int index)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Restores the heap order for the timeout at <index> by moving it up or down.
+==============================================================================*/
+{
+	int child, parent;
+	struct Event_dispatcher_timeout_callback **heap, *timeout_callback;
+
+	heap = event_dispatcher->timeout_heap;
+	timeout_callback = heap[index];
+	while (index > 0)
+	{
+		parent = (index - 1)/2;
+		if (!Event_dispatcher_timeout_callback_is_earlier(timeout_callback, heap[parent]))
+		{
+			break;
+		}
+		Event_dispatcher_timeout_heap_set(event_dispatcher, index, heap[parent]);
+		index = parent;
+	}
+	while ((child = 2*index + 1) < event_dispatcher->number_of_timeouts)
+	{
+		if ((child + 1 < event_dispatcher->number_of_timeouts) &&
+			Event_dispatcher_timeout_callback_is_earlier(heap[child + 1], heap[child]))
+		{
+			child++;
+		}
+		if (!Event_dispatcher_timeout_callback_is_earlier(heap[child], timeout_callback))
+		{
+			break;
+		}
+		Event_dispatcher_timeout_heap_set(event_dispatcher, index, heap[child]);
+		index = child;
+	}
+	Event_dispatcher_timeout_heap_set(event_dispatcher, index, timeout_callback);
+} /* Event_dispatcher_timeout_heap_sift */
+
+static int Event_dispatcher_timeout_heap_add(
+	struct Event_dispatcher *event_dispatcher,
+	struct Event_dispatcher_timeout_callback *timeout_callback)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Adds <timeout_callback> to the timeout heap, accessing it.
+==============================================================================*/
+{
+	int new_size, return_code;
+	struct Event_dispatcher_timeout_callback **new_heap;
+
+	return_code = 1;
+	if (event_dispatcher->number_of_timeouts == event_dispatcher->timeout_heap_size)
+	{
+		new_size = 2*event_dispatcher->timeout_heap_size + 16;
+		if (REALLOCATE(new_heap, event_dispatcher->timeout_heap,
+			struct Event_dispatcher_timeout_callback *, new_size))
+		{
+			event_dispatcher->timeout_heap = new_heap;
+			event_dispatcher->timeout_heap_size = new_size;
+		}
+		else
+		{
+			display_message(ERROR_MESSAGE,
+				"Event_dispatcher_timeout_heap_add.  Could not enlarge heap");
+			return_code = 0;
+		}
+	}
+	if (return_code)
+	{
+		event_dispatcher->timeout_heap[event_dispatcher->number_of_timeouts] =
+			ACCESS(Event_dispatcher_timeout_callback)(timeout_callback);
+		Event_dispatcher_timeout_heap_sift(event_dispatcher,
+			event_dispatcher->number_of_timeouts++);
+	}
+
+	return (return_code);
+} /* Event_dispatcher_timeout_heap_add */
+
+static int Event_dispatcher_timeout_heap_remove(
+	struct Event_dispatcher *event_dispatcher,
+	struct Event_dispatcher_timeout_callback *timeout_callback)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Removes <timeout_callback> from the timeout heap and deaccesses it. Returns 0
+without error if it is not in the heap.
+==============================================================================*/
+{
+	int index, return_code;
+
+	index = timeout_callback->heap_index;
+	if ((0 <= index) && (index < event_dispatcher->number_of_timeouts) &&
+		(event_dispatcher->timeout_heap[index] == timeout_callback))
+	{
+		event_dispatcher->number_of_timeouts--;
+		if (index < event_dispatcher->number_of_timeouts)
+		{
+			Event_dispatcher_timeout_heap_set(event_dispatcher, index,
+				event_dispatcher->timeout_heap[event_dispatcher->number_of_timeouts]);
+			Event_dispatcher_timeout_heap_sift(event_dispatcher, index);
+		}
+		timeout_callback->heap_index = -1;
+		DEACCESS(Event_dispatcher_timeout_callback)(&timeout_callback);
+		return_code = 1;
+	}
+	else
+	{
+		return_code = 0;
+	}
+
+	return (return_code);
+} /* Event_dispatcher_timeout_heap_remove */
+
+static int Event_dispatcher_idle_queue_priority(
+	struct Event_dispatcher_idle_callback *idle_callback)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Returns the index of the idle queue for <idle_callback>.
+==============================================================================*/
+{
+	int priority;
+
+	priority = (int)idle_callback->priority;
+	if (priority < 0)
+	{
+		priority = 0;
+	}
+	else if (priority >= EVENT_DISPATCHER_NUMBER_OF_IDLE_PRIORITIES)
+	{
+		priority = EVENT_DISPATCHER_NUMBER_OF_IDLE_PRIORITIES - 1;
+	}
+
+	return (priority);
+} /* Event_dispatcher_idle_queue_priority */
+
+static void Event_dispatcher_idle_queue_append(
+	struct Event_dispatcher *event_dispatcher,
+	struct Event_dispatcher_idle_callback *idle_callback)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Adds <idle_callback>, which must not be queued, to the back of the queue for its
+priority, accessing it.
+==============================================================================*/
+{
+	int priority;
+
+	priority = Event_dispatcher_idle_queue_priority(idle_callback);
+	idle_callback->previous_in_queue = event_dispatcher->idle_queue_tail[priority];
+	idle_callback->next_in_queue = (struct Event_dispatcher_idle_callback *)NULL;
+	if (event_dispatcher->idle_queue_tail[priority])
+	{
+		event_dispatcher->idle_queue_tail[priority]->next_in_queue = idle_callback;
+	}
+	else
+	{
+		event_dispatcher->idle_queue_head[priority] = idle_callback;
+	}
+	event_dispatcher->idle_queue_tail[priority] = idle_callback;
+	idle_callback->in_queue = 1;
+	ACCESS(Event_dispatcher_idle_callback)(idle_callback);
+} /* Event_dispatcher_idle_queue_append */
+
+static int Event_dispatcher_idle_queue_remove(
+	struct Event_dispatcher *event_dispatcher,
+	struct Event_dispatcher_idle_callback *idle_callback)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Unlinks <idle_callback> from its idle queue and deaccesses it. Returns 0
+without error if it is not queued.
+==============================================================================*/
+{
+	int priority, return_code;
+
+	if (idle_callback->in_queue)
+	{
+		priority = Event_dispatcher_idle_queue_priority(idle_callback);
+		if (idle_callback->previous_in_queue)
+		{
+			idle_callback->previous_in_queue->next_in_queue = idle_callback->next_in_queue;
+		}
+		else
+		{
+			event_dispatcher->idle_queue_head[priority] = idle_callback->next_in_queue;
+		}
+		if (idle_callback->next_in_queue)
+		{
+			idle_callback->next_in_queue->previous_in_queue = idle_callback->previous_in_queue;
+		}
+		else
+		{
+			event_dispatcher->idle_queue_tail[priority] = idle_callback->previous_in_queue;
+		}
+		idle_callback->previous_in_queue = (struct Event_dispatcher_idle_callback *)NULL;
+		idle_callback->next_in_queue = (struct Event_dispatcher_idle_callback *)NULL;
+		idle_callback->in_queue = 0;
+		DEACCESS(Event_dispatcher_idle_callback)(&idle_callback);
+		return_code = 1;
+	}
+	else
+	{
+		return_code = 0;
+	}
+
+	return (return_code);
+} /* Event_dispatcher_idle_queue_remove */
+
+static struct Event_dispatcher_idle_callback *Event_dispatcher_idle_queue_first(
+	struct Event_dispatcher *event_dispatcher)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Returns the idle callback to call next: the front of the highest priority
+non-empty queue.
+==============================================================================*/
+{
+	int priority;
+
+	for (priority = 0; priority < EVENT_DISPATCHER_NUMBER_OF_IDLE_PRIORITIES; priority++)
+	{
+		if (event_dispatcher->idle_queue_head[priority])
+		{
+			return (event_dispatcher->idle_queue_head[priority]);
+		}
+	}
+
+	return ((struct Event_dispatcher_idle_callback *)NULL);
+} /* Event_dispatcher_idle_queue_first */
+#endif /* defined (USE_GENERIC_EVENT_DISPATCHER) */
+
 #if defined (USE_XTAPP_CONTEXT)
 void Event_dispatcher_xt_timeout_callback(
 	XtPointer timeout_callback_void, XtIntervalId *id)
@@ -1109,6 +1451,132 @@ DESCRIPTION :
 
 #endif /* defined (WX_USER_INTERFACE) */
 
+#if defined (USE_EPOLL_EVENT_DISPATCHER)
+static int Fdio_event_dispatcher_dispatch_function(void *user_data);
+
+static int Event_dispatcher_epoll_wait(struct Event_dispatcher *event_dispatcher,
+	struct Event_dispatcher_descriptor_set *descriptor_set,
+	struct timeval *timeout_ptr)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Waits until a descriptor is ready or <timeout_ptr> expires, then collects the
+ready Fdio descriptors for Event_dispatcher_dispatch_epoll_event. If there are
+descriptor callbacks, which only support fd_sets, the epoll descriptor is added
+to the <descriptor_set> and select is used; otherwise epoll_wait waits directly.
+Returns the number of ready descriptors, 0 on timeout or -1 on error.
+==============================================================================*/
+{
+	int epoll_ready, i, number_of_events, return_code, timeout_ms;
+	uint64_t wake_count;
+
+	number_of_events = 0;
+	if (0 < NUMBER_IN_LIST(Event_dispatcher_descriptor_callback)(
+		event_dispatcher->descriptor_list))
+	{
+		FD_SET(event_dispatcher->epoll_descriptor, &(descriptor_set->read_set));
+		return_code = select(FD_SETSIZE, &(descriptor_set->read_set),
+			&(descriptor_set->write_set), &(descriptor_set->error_set), timeout_ptr);
+		if (-1 < return_code)
+		{
+			epoll_ready = FD_ISSET(event_dispatcher->epoll_descriptor,
+				&(descriptor_set->read_set));
+			FD_CLR(event_dispatcher->epoll_descriptor, &(descriptor_set->read_set));
+			FOR_EACH_OBJECT_IN_LIST(Event_dispatcher_descriptor_callback)
+				(Event_dispatcher_descriptor_do_check_callback,
+				descriptor_set, event_dispatcher->descriptor_list);
+			if (epoll_ready)
+			{
+				return_code--;
+				number_of_events = epoll_wait(event_dispatcher->epoll_descriptor,
+					event_dispatcher->epoll_events, EVENT_DISPATCHER_MAX_EPOLL_EVENTS, 0);
+			}
+		}
+	}
+	else
+	{
+		return_code = 0;
+		if (timeout_ptr)
+		{
+			timeout_ms = (int)(timeout_ptr->tv_sec*1000 + (timeout_ptr->tv_usec + 999)/1000);
+		}
+		else
+		{
+			timeout_ms = -1;
+		}
+		number_of_events = epoll_wait(event_dispatcher->epoll_descriptor,
+			event_dispatcher->epoll_events, EVENT_DISPATCHER_MAX_EPOLL_EVENTS, timeout_ms);
+		if ((number_of_events < 0) && (errno != EINTR))
+		{
+			return_code = -1;
+		}
+	}
+	if (number_of_events < 0)
+	{
+		number_of_events = 0;
+	}
+	event_dispatcher->number_of_epoll_events = number_of_events;
+	event_dispatcher->next_epoll_event = 0;
+	for (i = 0; i < number_of_events; i++)
+	{
+		if (event_dispatcher->epoll_events[i].data.ptr)
+		{
+			return_code++;
+		}
+		else
+		{
+			/* Event_dispatcher_wake; just empty the counter */
+			while (0 < read(event_dispatcher->wake_descriptor, &wake_count, sizeof(wake_count)))
+			{
+			}
+		}
+	}
+
+	return (return_code);
+} /* Event_dispatcher_epoll_wait */
+
+static int Event_dispatcher_dispatch_epoll_event(
+	struct Event_dispatcher *event_dispatcher)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Dispatches the next Fdio event collected by Event_dispatcher_epoll_wait.
+Returns 1 if a callback was dispatched, 0 if there were no events left.
+==============================================================================*/
+{
+	struct epoll_event *epoll_event;
+	Fdio_id io;
+
+	while (event_dispatcher->next_epoll_event < event_dispatcher->number_of_epoll_events)
+	{
+		epoll_event = event_dispatcher->epoll_events + event_dispatcher->next_epoll_event;
+		event_dispatcher->next_epoll_event++;
+		if ((io = (Fdio_id)epoll_event->data.ptr))
+		{
+			if ((!io->read_data.function) && (!io->write_data.function))
+			{
+				/* hang up or error reported with no callbacks to handle it; stop
+					watching until a callback is set, as select would */
+				epoll_ctl(event_dispatcher->epoll_descriptor, EPOLL_CTL_DEL,
+					io->descriptor, epoll_event);
+				io->in_epoll = 0;
+				continue;
+			}
+			io->ready_to_read =
+				(0 != (epoll_event->events & (EPOLLIN | EPOLLHUP | EPOLLERR)));
+			io->ready_to_write =
+				(0 != (epoll_event->events & (EPOLLOUT | EPOLLERR)));
+			Fdio_event_dispatcher_dispatch_function((void *)io);
+			return (1);
+		}
+	}
+
+	return (0);
+} /* Event_dispatcher_dispatch_epoll_event */
+#endif /* defined (USE_EPOLL_EVENT_DISPATCHER) */
+
 /*
 Global functions
 ----------------
@@ -1123,6 +1591,12 @@ Creates a connection to a event_dispatcher of the specified type.
 ==============================================================================*/
 {
 	struct Event_dispatcher *event_dispatcher;
+#if defined (USE_GENERIC_EVENT_DISPATCHER)
+	int priority;
+#endif /* defined (USE_GENERIC_EVENT_DISPATCHER) */
+#if defined (USE_EPOLL_EVENT_DISPATCHER)
+	struct epoll_event epoll_event;
+#endif /* defined (USE_EPOLL_EVENT_DISPATCHER) */
 
 	ENTER(CREATE(Event_dispatcher));
 
@@ -1136,11 +1610,47 @@ Creates a connection to a event_dispatcher of the specified type.
 #if defined (USE_GENERIC_EVENT_DISPATCHER)
 		event_dispatcher->descriptor_list =
 			CREATE(LIST(Event_dispatcher_descriptor_callback))();
-#endif /* defined (USE_GENERIC_EVENT_DISPATCHER) */
+		event_dispatcher->timeout_heap =
+			(struct Event_dispatcher_timeout_callback **)NULL;
+		event_dispatcher->number_of_timeouts = 0;
+		event_dispatcher->timeout_heap_size = 0;
+		for (priority = 0; priority < EVENT_DISPATCHER_NUMBER_OF_IDLE_PRIORITIES; priority++)
+		{
+			event_dispatcher->idle_queue_head[priority] =
+				(struct Event_dispatcher_idle_callback *)NULL;
+			event_dispatcher->idle_queue_tail[priority] =
+				(struct Event_dispatcher_idle_callback *)NULL;
+		}
+#else /* defined (USE_GENERIC_EVENT_DISPATCHER) */
 		event_dispatcher->timeout_list =
 			CREATE(LIST(Event_dispatcher_timeout_callback))();
 		event_dispatcher->idle_list =
 			CREATE(LIST(Event_dispatcher_idle_callback))();
+#endif /* defined (USE_GENERIC_EVENT_DISPATCHER) */
+#if defined (USE_EPOLL_EVENT_DISPATCHER)
+		event_dispatcher->number_of_epoll_events = 0;
+		event_dispatcher->next_epoll_event = 0;
+		event_dispatcher->wake_descriptor = -1;
+		/* if epoll is unavailable Fdio objects fall back to descriptor callbacks */
+		event_dispatcher->epoll_descriptor = epoll_create1(EPOLL_CLOEXEC);
+		if (0 <= event_dispatcher->epoll_descriptor)
+		{
+			event_dispatcher->wake_descriptor = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+			if (0 <= event_dispatcher->wake_descriptor)
+			{
+				memset(&epoll_event, 0, sizeof(epoll_event));
+				epoll_event.events = EPOLLIN;
+				/* a NULL pointer identifies the wake descriptor */
+				epoll_event.data.ptr = NULL;
+				if (0 != epoll_ctl(event_dispatcher->epoll_descriptor, EPOLL_CTL_ADD,
+					event_dispatcher->wake_descriptor, &epoll_event))
+				{
+					close(event_dispatcher->wake_descriptor);
+					event_dispatcher->wake_descriptor = -1;
+				}
+			}
+		}
+#endif /* defined (USE_EPOLL_EVENT_DISPATCHER) */
 #if defined (USE_XTAPP_CONTEXT)
 		event_dispatcher->application_context = (XtAppContext)NULL;
 #else /* defined (USE_XTAPP_CONTEXT) */
@@ -1170,6 +1680,9 @@ Destroys a Event_dispatcher object
 {
 	int return_code;
 	struct Event_dispatcher *event_dispatcher;
+#if defined (USE_GENERIC_EVENT_DISPATCHER)
+	struct Event_dispatcher_idle_callback *idle_callback;
+#endif /* defined (USE_GENERIC_EVENT_DISPATCHER) */
 
 	ENTER(DESTROY(Event_dispatcher));
 
@@ -1193,7 +1706,20 @@ Destroys a Event_dispatcher object
 			DESTROY(LIST(Event_dispatcher_descriptor_callback))
 				(&event_dispatcher->descriptor_list);
 		}
-#endif /* defined (USE_GENERIC_EVENT_DISPATCHER) */
+		while (0 < event_dispatcher->number_of_timeouts)
+		{
+			Event_dispatcher_timeout_heap_remove(event_dispatcher,
+				event_dispatcher->timeout_heap[event_dispatcher->number_of_timeouts - 1]);
+		}
+		if (event_dispatcher->timeout_heap)
+		{
+			DEALLOCATE(event_dispatcher->timeout_heap);
+		}
+		while ((idle_callback = Event_dispatcher_idle_queue_first(event_dispatcher)))
+		{
+			Event_dispatcher_idle_queue_remove(event_dispatcher, idle_callback);
+		}
+#else /* defined (USE_GENERIC_EVENT_DISPATCHER) */
 		if (event_dispatcher->timeout_list)
 		{
 			DESTROY(LIST(Event_dispatcher_timeout_callback))
@@ -1204,6 +1730,17 @@ Destroys a Event_dispatcher object
 			DESTROY(LIST(Event_dispatcher_idle_callback))
 				(&event_dispatcher->idle_list);
 		}
+#endif /* defined (USE_GENERIC_EVENT_DISPATCHER) */
+#if defined (USE_EPOLL_EVENT_DISPATCHER)
+		if (0 <= event_dispatcher->wake_descriptor)
+		{
+			close(event_dispatcher->wake_descriptor);
+		}
+		if (0 <= event_dispatcher->epoll_descriptor)
+		{
+			close(event_dispatcher->epoll_descriptor);
+		}
+#endif /* defined (USE_EPOLL_EVENT_DISPATCHER) */
 #if ! defined (USE_XTAPP_CONTEXT)
 		if (event_dispatcher->special_idle_callback)
 		{
@@ -1735,8 +2272,7 @@ DESCRIPTION :
 					timeout_s, timeout_ns, timeout_function, user_data);
 		if (timeout_callback)
 		{
-			if (!(ADD_OBJECT_TO_LIST(Event_dispatcher_timeout_callback)(
-				timeout_callback, event_dispatcher->timeout_list)))
+			if (!Event_dispatcher_timeout_heap_add(event_dispatcher, timeout_callback))
 			{
 				DESTROY(Event_dispatcher_timeout_callback)(&timeout_callback);
 				timeout_callback = (struct Event_dispatcher_timeout_callback *)NULL;
@@ -1843,7 +2379,7 @@ DESCRIPTION :
 
 	ENTER(Event_dispatcher_remove_timeout_callback);
 
-	if (event_dispatcher && event_dispatcher->timeout_list && callback_id)
+	if (event_dispatcher && callback_id)
 	{
 #if defined (USE_GTK_MAIN_STEP)
 		gtk_timeout_remove(callback_id->gtk_timeout_id);
@@ -1856,8 +2392,7 @@ DESCRIPTION :
 		return_code = 1;
 		KillTimer(event_dispatcher->networkWindowHandle, (ULONG)callback_id);
 #elif defined (USE_GENERIC_EVENT_DISPATCHER)
-		return_code = REMOVE_OBJECT_FROM_LIST(Event_dispatcher_timeout_callback)
-			(callback_id, event_dispatcher->timeout_list);
+		return_code = Event_dispatcher_timeout_heap_remove(event_dispatcher, callback_id);
 #else /* switch (USER_INTERFACE) */
 #error remove timeout callbacks not defined on this platform
 #endif /* switch (USER_INTERFACE) */
@@ -1893,12 +2428,16 @@ DESCRIPTION :
 			idle_function, user_data, priority);
 		if (idle_callback != NULL)
 		{
+#if defined (USE_GENERIC_EVENT_DISPATCHER)
+			Event_dispatcher_idle_queue_append(event_dispatcher, idle_callback);
+#else /* defined (USE_GENERIC_EVENT_DISPATCHER) */
 			if (!(ADD_OBJECT_TO_LIST(Event_dispatcher_idle_callback)(
 				idle_callback, event_dispatcher->idle_list)))
 			{
 				DESTROY(Event_dispatcher_idle_callback)(&idle_callback);
 				idle_callback = (struct Event_dispatcher_idle_callback *)NULL;
 			}
+#endif /* defined (USE_GENERIC_EVENT_DISPATCHER) */
 #if defined (USE_XTAPP_CONTEXT)
 			else
 			{
@@ -2040,7 +2579,7 @@ DESCRIPTION :
 
 	ENTER(Event_dispatcher_remove_idle_callback);
 
-	if (event_dispatcher && event_dispatcher->timeout_list && callback_id)
+	if (event_dispatcher && callback_id)
 	{
 #if defined (USE_XTAPP_CONTEXT)
 		XtRemoveWorkProc(callback_id->xt_idle_id);
@@ -2051,8 +2590,12 @@ DESCRIPTION :
 		callback_id->carbon_timer_ref = (EventLoopTimerRef)NULL;
 #endif /* defined (USE_XTAPP_CONTEXT) */
 		callback_id->idle_function = NULL;
+#if defined (USE_GENERIC_EVENT_DISPATCHER)
+		return_code = Event_dispatcher_idle_queue_remove(event_dispatcher, callback_id);
+#else /* defined (USE_GENERIC_EVENT_DISPATCHER) */
 		return_code = REMOVE_OBJECT_FROM_LIST(Event_dispatcher_idle_callback)
 			(callback_id, event_dispatcher->idle_list);
+#endif /* defined (USE_GENERIC_EVENT_DISPATCHER) */
 	}
 	else
 	{
@@ -2077,7 +2620,6 @@ DESCRIPTION :
 	int callback_code, select_code;
 	struct Event_dispatcher_descriptor_set descriptor_set;
 	struct timeval timeofday, timeout, *timeout_ptr;
-	struct tms times_buffer;
 	struct Event_dispatcher_descriptor_callback *descriptor_callback;
 	struct Event_dispatcher_idle_callback *idle_callback;
 	struct Event_dispatcher_timeout_callback *timeout_callback;
@@ -2114,9 +2656,10 @@ DESCRIPTION :
 		FOR_EACH_OBJECT_IN_LIST(Event_dispatcher_descriptor_callback)
 			(Event_dispatcher_descriptor_do_query_callback,
 			&descriptor_set, event_dispatcher->descriptor_list);
-		timeout_callback = FIRST_OBJECT_IN_LIST_THAT(Event_dispatcher_timeout_callback)
-			((LIST_CONDITIONAL_FUNCTION(Event_dispatcher_timeout_callback) *)NULL,
-			(void *)NULL, event_dispatcher->timeout_list);
+		timeout_callback = (0 < event_dispatcher->number_of_timeouts) ?
+			event_dispatcher->timeout_heap[0] :
+			(struct Event_dispatcher_timeout_callback *)NULL;
+		idle_callback = (struct Event_dispatcher_idle_callback *)NULL;
 		if (event_dispatcher->special_idle_callback_pending && event_dispatcher->special_idle_callback)
 		{
 			timeout.tv_sec = 0;
@@ -2125,9 +2668,7 @@ DESCRIPTION :
 		}
 		else
 		{
-			idle_callback = FIRST_OBJECT_IN_LIST_THAT(Event_dispatcher_idle_callback)
-				((LIST_CONDITIONAL_FUNCTION(Event_dispatcher_idle_callback) *)NULL,
-					(void *)NULL, event_dispatcher->idle_list);
+			idle_callback = Event_dispatcher_idle_queue_first(event_dispatcher);
 			if (idle_callback)
 			{
 				timeout.tv_sec = 0;
@@ -2185,7 +2726,25 @@ DESCRIPTION :
 			(Event_dispatcher_descriptor_callback_is_pending,
 			(void *)NULL, event_dispatcher->descriptor_list)))
 		{
-			if (-1 < (select_code = select(100, &(descriptor_set.read_set),
+#if defined (USE_EPOLL_EVENT_DISPATCHER)
+			if (event_dispatcher->next_epoll_event < event_dispatcher->number_of_epoll_events)
+			{
+				/* Still dispatching the events from the last epoll_wait */
+				select_code = 1;
+			}
+			else if (0 <= event_dispatcher->epoll_descriptor)
+			{
+				select_code = Event_dispatcher_epoll_wait(event_dispatcher,
+					&descriptor_set, timeout_ptr);
+				descriptor_callback =
+					FIRST_OBJECT_IN_LIST_THAT(Event_dispatcher_descriptor_callback)
+					(Event_dispatcher_descriptor_callback_is_pending,
+					(void *)NULL, event_dispatcher->descriptor_list);
+			}
+			else
+#endif /* defined (USE_EPOLL_EVENT_DISPATCHER) */
+			/* The fd_sets can only hold descriptors below FD_SETSIZE */
+			if (-1 < (select_code = select(FD_SETSIZE, &(descriptor_set.read_set),
 				&(descriptor_set.write_set), &(descriptor_set.error_set),
 				timeout_ptr)))
 			{
@@ -2215,6 +2774,15 @@ DESCRIPTION :
 			descriptor_callback->pending = 0;
 			(*descriptor_callback->dispatch_callback)(descriptor_callback->user_data);
 		}
+#if defined (USE_EPOLL_EVENT_DISPATCHER)
+		else if (Event_dispatcher_dispatch_epoll_event(event_dispatcher))
+		{
+			if (event_dispatcher->special_idle_callback)
+			{
+				event_dispatcher->special_idle_callback_pending = 1;
+			}
+		}
+#endif /* defined (USE_EPOLL_EVENT_DISPATCHER) */
 		else
 		{
 			if (select_code == 0)
@@ -2230,11 +2798,14 @@ DESCRIPTION :
 					{
 						event_dispatcher->special_idle_callback_pending = 1;
 					}
+					/* Take it off the heap before calling it so the function may add or
+						remove timeouts, including itself */
+					ACCESS(Event_dispatcher_timeout_callback)(timeout_callback);
+					Event_dispatcher_timeout_heap_remove(event_dispatcher, timeout_callback);
 					/* Do it now */
 					callback_code = (*timeout_callback->timeout_function)(
 						timeout_callback->user_data);
-					REMOVE_OBJECT_FROM_LIST(Event_dispatcher_timeout_callback)
-						(timeout_callback, event_dispatcher->timeout_list);
+					DEACCESS(Event_dispatcher_timeout_callback)(&timeout_callback);
 				}
 				else
 				{
@@ -2259,21 +2830,14 @@ DESCRIPTION :
 							{
 								event_dispatcher->special_idle_callback_pending = 1;
 							}
-							if (IS_OBJECT_IN_LIST(Event_dispatcher_idle_callback)
-								(idle_callback, event_dispatcher->idle_list))
+							if (idle_callback->in_queue)
 							{
-								REMOVE_OBJECT_FROM_LIST(Event_dispatcher_idle_callback)
-									(idle_callback, event_dispatcher->idle_list);
+								Event_dispatcher_idle_queue_remove(event_dispatcher, idle_callback);
 								if (callback_code != 0)
 								{
-									/* Not finished so add it back in, this is done rather
-										than just leaving the old event in so that it gets
-										a new timestamp and therefore a different idle event
-										goes next.  It can't be done while it is in the list
-									   as the timestamp is part of the list identifier */
-									idle_callback->timestamp = (long)cmgui_times(&times_buffer);
-									ADD_OBJECT_TO_LIST(Event_dispatcher_idle_callback)
-										(idle_callback, event_dispatcher->idle_list);
+									/* Not finished so move it to the back of its queue so that a
+										different idle event of the same priority goes next */
+									Event_dispatcher_idle_queue_append(event_dispatcher, idle_callback);
 								}
 							}
 							DEACCESS(Event_dispatcher_idle_callback)(&idle_callback);
@@ -2376,6 +2940,36 @@ DESCRIPTION :
 	return (return_code);
 } /* Event_dispatcher_end_main_loop */
 
+#if defined (USE_GENERIC_EVENT_DISPATCHER)
+int Event_dispatcher_wake(struct Event_dispatcher *event_dispatcher)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Makes an Event_dispatcher_do_one_event waiting for descriptors return.
+==============================================================================*/
+{
+	int return_code;
+#if defined (USE_EPOLL_EVENT_DISPATCHER)
+	uint64_t one = 1;
+#endif /* defined (USE_EPOLL_EVENT_DISPATCHER) */
+
+	/* No ENTER/LEAVE or messages as this may be called from other threads */
+	return_code = 0;
+#if defined (USE_EPOLL_EVENT_DISPATCHER)
+	if (event_dispatcher && (0 <= event_dispatcher->wake_descriptor))
+	{
+		return_code = ((ssize_t)sizeof(one) == write(event_dispatcher->wake_descriptor,
+			&one, sizeof(one)));
+	}
+#else /* defined (USE_EPOLL_EVENT_DISPATCHER) */
+	USE_PARAMETER(event_dispatcher);
+#endif /* defined (USE_EPOLL_EVENT_DISPATCHER) */
+
+	return (return_code);
+} /* Event_dispatcher_wake */
+#endif /* defined (USE_GENERIC_EVENT_DISPATCHER) */
+
 
 #if defined (WX_USER_INTERFACE)
 int Event_dispatcher_set_wx_instance(struct Event_dispatcher *event_dispatcher,
@@ -2532,6 +3126,16 @@ DESCRIPTION :
 This function sets the callback and user data for a given callback_data structure.
 ==============================================================================*/
 
+#if defined (USE_EPOLL_EVENT_DISPATCHER)
+static int Fdio_update_epoll(Fdio_id io);
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Registers the events for the callbacks currently set on <io> with epoll.
+==============================================================================*/
+#endif /* defined (USE_EPOLL_EVENT_DISPATCHER) */
+
 Fdio_id Event_dispatcher_create_Fdio(struct Event_dispatcher *dispatcher,
 	cmzn_native_socket_t descriptor)
 /*******************************************************************************
@@ -2542,6 +3146,9 @@ Creates a new Fdio, given an event dispatcher.
 ==============================================================================*/
 {
 	struct cmzn_fdio *io;
+#if defined (USE_EPOLL_EVENT_DISPATCHER)
+	struct epoll_event epoll_event;
+#endif /* defined (USE_EPOLL_EVENT_DISPATCHER) */
 
 	ENTER(CREATE(Event_dispatcher_create_fdio));
 
@@ -2551,6 +3158,27 @@ Creates a new Fdio, given an event dispatcher.
 		io->event_dispatcher = dispatcher;
 		io->descriptor = descriptor;
 		io->access_count = 0;
+#if defined (USE_EPOLL_EVENT_DISPATCHER)
+		/* Watch with no events until a callback is set; descriptors epoll cannot
+			watch, such as regular files, use a descriptor callback instead */
+		if (0 <= dispatcher->epoll_descriptor)
+		{
+			memset(&epoll_event, 0, sizeof(epoll_event));
+			epoll_event.events = 0;
+			epoll_event.data.ptr = io;
+			if (0 == epoll_ctl(dispatcher->epoll_descriptor, EPOLL_CTL_ADD,
+				descriptor, &epoll_event))
+			{
+				io->use_epoll = 1;
+				io->in_epoll = 1;
+			}
+		}
+		if (io->use_epoll)
+		{
+			io->callback = (struct Event_dispatcher_descriptor_callback *)NULL;
+		}
+		else
+#endif /* defined (USE_EPOLL_EVENT_DISPATCHER) */
 		if (!(io->callback = Event_dispatcher_add_descriptor_callback(
 			io->event_dispatcher,
 			Fdio_event_dispatcher_query_function,
@@ -2591,6 +3219,28 @@ application is notified by the operating system of a closure event.
 		(*io)->signal_to_destroy = 1;
 	else
 	{
+#if defined (USE_EPOLL_EVENT_DISPATCHER)
+		if ((*io)->use_epoll)
+		{
+			struct Event_dispatcher *event_dispatcher = (*io)->event_dispatcher;
+			struct epoll_event epoll_event;
+			if ((*io)->in_epoll)
+			{
+				epoll_ctl(event_dispatcher->epoll_descriptor, EPOLL_CTL_DEL,
+					(*io)->descriptor, &epoll_event);
+			}
+			/* forget events already collected for this descriptor */
+			for (int i = event_dispatcher->next_epoll_event;
+				i < event_dispatcher->number_of_epoll_events; i++)
+			{
+				if (event_dispatcher->epoll_events[i].data.ptr == (void *)(*io))
+				{
+					event_dispatcher->epoll_events[i].data.ptr = NULL;
+				}
+			}
+		}
+		else
+#endif /* defined (USE_EPOLL_EVENT_DISPATCHER) */
 		Event_dispatcher_remove_descriptor_callback((*io)->event_dispatcher,
 			(*io)->callback);
 		DEALLOCATE(*io);
@@ -2625,6 +3275,9 @@ previously set will be cancelled.
 {
 	ENTER(Fdio_set_read_callback);
 	Fdio_set_callback(&handle->read_data, callback, user_data);
+#if defined (USE_EPOLL_EVENT_DISPATCHER)
+	Fdio_update_epoll(handle);
+#endif /* defined (USE_EPOLL_EVENT_DISPATCHER) */
 	LEAVE;
 
 	return (1);
@@ -2650,7 +3303,10 @@ previously set will be cancelled.
 ==============================================================================*/
 {
 	ENTER(Fdio_set_write_callback);
-	Fdio_set_callback(&handle->read_data, callback, user_data);
+	Fdio_set_callback(&handle->write_data, callback, user_data);
+#if defined (USE_EPOLL_EVENT_DISPATCHER)
+	Fdio_update_epoll(handle);
+#endif /* defined (USE_EPOLL_EVENT_DISPATCHER) */
 	LEAVE;
 
 	return (1);
@@ -2759,6 +3415,47 @@ This function sets the callback and user data for a given callback_data structur
 	return (1);
 } /* Fdio_set_callback */
 
+#if defined (USE_EPOLL_EVENT_DISPATCHER)
+static int Fdio_update_epoll(Fdio_id io)
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Registers the events for the callbacks currently set on <io> with epoll.
+==============================================================================*/
+{
+	int return_code;
+	struct epoll_event epoll_event;
+
+	ENTER(Fdio_update_epoll);
+	return_code = 1;
+	if (io->use_epoll)
+	{
+		memset(&epoll_event, 0, sizeof(epoll_event));
+		epoll_event.events = 0;
+		if (io->read_data.function)
+			epoll_event.events |= EPOLLIN;
+		if (io->write_data.function)
+			epoll_event.events |= EPOLLOUT;
+		epoll_event.data.ptr = io;
+		if (0 != epoll_ctl(io->event_dispatcher->epoll_descriptor,
+			(io->in_epoll) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, io->descriptor, &epoll_event))
+		{
+			display_message(ERROR_MESSAGE, "Fdio_update_epoll.  "
+				"Could not watch descriptor %d: %s", (int)io->descriptor, strerror(errno));
+			return_code = 0;
+		}
+		else
+		{
+			io->in_epoll = 1;
+		}
+	}
+	LEAVE;
+
+	return (return_code);
+} /* Fdio_update_epoll */
+#endif /* defined (USE_EPOLL_EVENT_DISPATCHER) */
+
 #elif defined(WIN32_USER_INTERFACE)
 Fdio_id Event_dispatcher_create_Fdio(struct Event_dispatcher *dispatcher,
 	cmzn_native_socket_t descriptor)
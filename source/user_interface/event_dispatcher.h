@@ -278,6 +278,19 @@ LAST MODIFIED : 4 March 2002
 DESCRIPTION :
 ==============================================================================*/
 
+#if defined (USE_GENERIC_EVENT_DISPATCHER)
+int Event_dispatcher_wake(struct Event_dispatcher *event_dispatcher);
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Makes an Event_dispatcher_do_one_event that is waiting for descriptors or
+timeouts return early. Unlike the other functions this may be called from any
+thread, e.g. by a worker thread which has finished and queued results for the
+main loop. Returns 0 if waking is not supported on this platform.
+==============================================================================*/
+#endif /* defined (USE_GENERIC_EVENT_DISPATCHER) */
+
 #if defined (WX_USER_INTERFACE)
 int Event_dispatcher_set_wx_instance(struct Event_dispatcher *event_dispatcher,
 	void *user_instance);
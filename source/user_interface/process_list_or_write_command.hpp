@@ -16,6 +16,8 @@ will process either list commands or write to comfile commands
 #define PROCESS_LIST_OR_WRITE_COMMAND_H
 
 #include <stdarg.h>
+#include <stdio.h>
+#include <string>
 
 #define MESSAGE_STRING_SIZE 1000
 static char message_string[MESSAGE_STRING_SIZE];
@@ -87,4 +89,53 @@ public:
 	}
 };
 
+class Process_write_command_to_string_class : public Process_list_or_write_command_class
+/*******************************************************************************
+LAST MODIFIED : 16 October 2026
+
+DESCRIPTION :
+Appends the commands to a string, e.g. to build a comfile in memory without
+the fixed message buffer limiting command length.
+==============================================================================*/
+{
+	 std::string &commands;
+
+public:
+	 Process_write_command_to_string_class(std::string &commands_in) :
+			commands(commands_in)
+	 {
+	 };
+
+	 int process_command(enum Message_type /*message_type*/,const char *format,...)
+	 {
+			va_list ap;
+			va_start(ap, format);
+			int length = vsnprintf(message_string, MESSAGE_STRING_SIZE, format, ap);
+			va_end(ap);
+			if (length < 0)
+			{
+				 return 0;
+			}
+			if (length < MESSAGE_STRING_SIZE)
+			{
+				 commands.append(message_string, length);
+			}
+			else
+			{
+				 std::string long_message(length + 1, '\0');
+				 va_start(ap, format);
+				 vsnprintf(&long_message[0], length + 1, format, ap);
+				 va_end(ap);
+				 commands.append(long_message.c_str(), length);
+			}
+			return 1;
+	 }
+
+	 int write_enabled()
+	{
+		 int return_code = 1;
+		 return (return_code);
+	}
+};
+
 #endif /* define PROCESS_LIST_OR_WRITE_COMMAND_H */